@@ -0,0 +1,249 @@
+/**
+ * @file AdcSampler.cpp
+ * @brief Background oversampled ADC implementation
+ */
+
+#include "AdcSampler.h"
+#include <esp_idf_version.h>
+
+#if !defined(ADC_SAMPLER_USE_DMA)
+#if ESP_IDF_VERSION_MAJOR == 4
+#define ADC_SAMPLER_USE_DMA 1
+#else
+#define ADC_SAMPLER_USE_DMA 0
+#endif
+#endif
+
+#if ADC_SAMPLER_USE_DMA
+#include <driver/adc.h>
+#include <esp_adc_cal.h>
+
+// Slowest rate the digital controller accepts; bursts are short either way
+#ifdef SOC_ADC_SAMPLE_FREQ_THRES_LOW
+static const uint32_t DMA_SAMPLE_FREQ_HZ = SOC_ADC_SAMPLE_FREQ_THRES_LOW;
+#else
+static const uint32_t DMA_SAMPLE_FREQ_HZ = 20000;
+#endif
+
+// Calibration is per unit and attenuation, so one table serves every pin
+static esp_adc_cal_characteristics_t s_cal;
+#endif
+
+// ADC1 channels (digitalPinToAnalogChannel() numbers ADC2 from here up)
+static const int8_t ADC1_CHANNELS = 10;
+
+static const uint32_t TASK_STACK = 3072;
+
+int8_t AdcSampler::addPin(uint8_t pin) {
+  if (_running || _count >= ADC_SAMPLER_MAX_PINS) return -1;
+
+  int8_t channel = digitalPinToAnalogChannel(pin);
+  if (channel < 0 || channel >= ADC1_CHANNELS) {
+    Serial.printf("[ADC] GPIO%d is not an ADC1 pin\n", pin);
+    return -1;
+  }
+
+  Pin& p = _pins[_count];
+  p.gpio = pin;
+  p.channel = (uint8_t)channel;
+  p.rawQ4 = 0;
+  p.mvQ4 = 0;
+  p.primed = false;
+  return (int8_t)_count++;
+}
+
+bool AdcSampler::begin() {
+  if (_running || _count == 0) return false;
+
+  _dma = startDma();
+  if (!_dma) {
+    analogReadResolution(12);
+    for (uint8_t i = 0; i < _count; i++) {
+      analogSetPinAttenuation(_pins[i].gpio, ADC_11db);
+    }
+  }
+
+  burst();  // Valid readings before anyone asks
+
+  if (xTaskCreate(taskEntry, "adc", TASK_STACK, this, tskIDLE_PRIORITY + 1, nullptr) != pdPASS) {
+    Serial.println("[ADC] Sampler task not started");
+    return false;
+  }
+  _running = true;
+  Serial.printf("[ADC] Sampling %d pin(s) every %dms (%s)\n",
+                _count, ADC_SAMPLER_PERIOD_MS, _dma ? "DMA" : "analogRead");
+  return true;
+}
+
+void AdcSampler::taskEntry(void* arg) {
+  AdcSampler* self = static_cast<AdcSampler*>(arg);
+  TickType_t lastWake = xTaskGetTickCount();
+  for (;;) {
+    vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(ADC_SAMPLER_PERIOD_MS));
+    self->burst();
+  }
+}
+
+uint32_t AdcSampler::millivolts(int8_t slot) const {
+  if (slot < 0 || slot >= _count) return 0;
+  return _pins[slot].mvQ4 >> 4;
+}
+
+uint16_t AdcSampler::raw(int8_t slot) const {
+  if (slot < 0 || slot >= _count) return 0;
+  return (uint16_t)(_pins[slot].rawQ4 >> 4);
+}
+
+void AdcSampler::burst() {
+  uint32_t rawAvg[ADC_SAMPLER_MAX_PINS];
+  uint32_t mvAvg[ADC_SAMPLER_MAX_PINS];
+  uint32_t count[ADC_SAMPLER_MAX_PINS];
+
+  if (_dma) {
+    if (!burstDma(rawAvg, count)) return;
+  } else {
+    burstAnalog(rawAvg, mvAvg, count);
+  }
+
+  for (uint8_t i = 0; i < _count; i++) {
+    if (count[i] == 0) continue;
+#if ADC_SAMPLER_USE_DMA
+    if (_dma) mvAvg[i] = esp_adc_cal_raw_to_voltage(rawAvg[i], &s_cal);
+#endif
+    apply(_pins[i], rawAvg[i], mvAvg[i]);
+    _samples += count[i];
+  }
+  _bursts++;
+}
+
+void AdcSampler::apply(Pin& p, uint32_t rawAvg, uint32_t mv) {
+  uint32_t rawQ4 = rawAvg << 4;
+  uint32_t mvQ4 = mv << 4;
+  if (!p.primed) {
+    p.rawQ4 = rawQ4;
+    p.mvQ4 = mvQ4;
+    p.primed = true;
+    return;
+  }
+  // 32-bit stores are atomic, readers never see a torn value
+  p.rawQ4 = (uint32_t)((int32_t)p.rawQ4 + (((int32_t)rawQ4 - (int32_t)p.rawQ4) >> ADC_SAMPLER_FILTER_SHIFT));
+  p.mvQ4 = (uint32_t)((int32_t)p.mvQ4 + (((int32_t)mvQ4 - (int32_t)p.mvQ4) >> ADC_SAMPLER_FILTER_SHIFT));
+}
+
+void AdcSampler::burstAnalog(uint32_t* rawAvg, uint32_t* mvAvg, uint32_t* count) {
+  for (uint8_t i = 0; i < _count; i++) {
+    uint32_t rawSum = 0;
+    uint32_t mvSum = 0;
+    for (uint8_t n = 0; n < ADC_SAMPLER_OVERSAMPLE; n++) {
+      rawSum += analogRead(_pins[i].gpio);
+      mvSum += analogReadMilliVolts(_pins[i].gpio);
+    }
+    rawAvg[i] = rawSum / ADC_SAMPLER_OVERSAMPLE;
+    mvAvg[i] = mvSum / ADC_SAMPLER_OVERSAMPLE;
+    count[i] = ADC_SAMPLER_OVERSAMPLE;
+  }
+}
+
+#if ADC_SAMPLER_USE_DMA
+
+bool AdcSampler::startDma() {
+  uint32_t mask = 0;
+  adc_digi_pattern_config_t pattern[ADC_SAMPLER_MAX_PINS];
+  for (uint8_t i = 0; i < _count; i++) {
+    mask |= 1UL << _pins[i].channel;
+    pattern[i].atten = ADC_ATTEN_DB_11;
+    pattern[i].channel = _pins[i].channel;
+    pattern[i].unit = 0;  // ADC1
+    pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+  }
+
+  adc_digi_init_config_t init = {};
+  init.max_store_buf_size = ADC_SAMPLER_FRAME_BYTES * 2;
+  init.conv_num_each_intr = ADC_SAMPLER_FRAME_BYTES;
+  init.adc1_chan_mask = mask;
+  init.adc2_chan_mask = 0;
+  if (adc_digi_initialize(&init) != ESP_OK) {
+    Serial.println("[ADC] DMA init failed, using analogRead");
+    return false;
+  }
+
+  adc_digi_configuration_t cfg = {};
+#if CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S2
+  cfg.conv_limit_en = true;
+  cfg.conv_limit_num = 250;
+#endif
+  cfg.pattern_num = _count;
+  cfg.adc_pattern = pattern;
+  cfg.sample_freq_hz = DMA_SAMPLE_FREQ_HZ;
+  cfg.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+#if CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S2
+  cfg.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+#else
+  cfg.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+#endif
+  if (adc_digi_controller_configure(&cfg) != ESP_OK) {
+    adc_digi_deinitialize();
+    Serial.println("[ADC] DMA config failed, using analogRead");
+    return false;
+  }
+
+  esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, 1100, &s_cal);
+  return true;
+}
+
+bool AdcSampler::burstDma(uint32_t* rawAvg, uint32_t* count) {
+  uint8_t buf[ADC_SAMPLER_FRAME_BYTES];
+  uint32_t sum[ADC_SAMPLER_MAX_PINS] = {0};
+  uint32_t len = 0;
+
+  for (uint8_t i = 0; i < _count; i++) count[i] = 0;
+
+  // Drop whatever the previous burst left in the driver's buffer
+  while (adc_digi_read_bytes(buf, sizeof(buf), &len, 0) == ESP_OK && len > 0) {}
+  len = 0;
+
+  // Converting only for the length of one frame keeps the ADC (and the
+  // DMA interrupt) idle between bursts
+  adc_digi_start();
+  esp_err_t err = adc_digi_read_bytes(buf, sizeof(buf), &len, ADC_SAMPLER_PERIOD_MS);
+  adc_digi_stop();
+
+  // ESP_ERR_INVALID_STATE only reports a driver-side overflow; data is valid
+  if ((err != ESP_OK && err != ESP_ERR_INVALID_STATE) || len == 0) return false;
+
+  for (uint32_t off = 0; off + sizeof(adc_digi_output_data_t) <= len; off += sizeof(adc_digi_output_data_t)) {
+    const adc_digi_output_data_t* d = reinterpret_cast<const adc_digi_output_data_t*>(buf + off);
+#if CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S2
+    uint8_t channel = d->type1.channel;
+    uint16_t value = d->type1.data;
+#else
+    if (d->type2.unit != 0) continue;
+    uint8_t channel = d->type2.channel;
+    uint16_t value = d->type2.data;
+#endif
+    for (uint8_t i = 0; i < _count; i++) {
+      if (_pins[i].channel == channel) {
+        sum[i] += value;
+        count[i]++;
+        break;
+      }
+    }
+  }
+
+  for (uint8_t i = 0; i < _count; i++) {
+    rawAvg[i] = count[i] > 0 ? sum[i] / count[i] : 0;
+  }
+  return true;
+}
+
+#else
+
+bool AdcSampler::startDma() {
+  return false;
+}
+
+bool AdcSampler::burstDma(uint32_t* rawAvg, uint32_t* count) {
+  return false;
+}
+
+#endif // ADC_SAMPLER_USE_DMA
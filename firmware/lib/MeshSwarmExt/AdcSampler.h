@@ -0,0 +1,115 @@
+/**
+ * @file AdcSampler.h
+ * @brief Background oversampled ADC with calibrated, filtered readings
+ *
+ * A single analogRead() is noisy enough on the ESP32 that callers end up
+ * keeping their own history buffers to smooth it. AdcSampler runs ADC1 in
+ * continuous (DMA) mode from a low-priority task instead: every
+ * ADC_SAMPLER_PERIOD_MS it converts a burst of ADC_SAMPLER_FRAME_BYTES
+ * worth of samples across all registered pins, averages them per pin,
+ * applies the eFuse calibration (esp_adc_cal) and folds the result into a
+ * short IIR filter. The DMA engine does the conversions, so the CPU only
+ * wakes once per burst; consumers read the latest value in O(1).
+ *
+ * ADC1 pins only (ADC2 is unavailable while WiFi runs). Pins must be added
+ * before begin(). Do not mix with analogRead() on the same unit.
+ *
+ * Continuous mode uses the ESP-IDF 4.4 driver (Arduino core 2.x). On other
+ * SDKs, or if the DMA driver fails to start, the task falls back to
+ * oversampled analogReadMilliVolts() bursts with the same filtering.
+ *
+ *   AdcSampler adc;
+ *   int8_t bat = adc.addPin(BAT_ADC_PIN);
+ *   adc.begin();
+ *   uint32_t mv = adc.millivolts(bat);
+ */
+
+#ifndef MESHSWARM_ADC_SAMPLER_H
+#define MESHSWARM_ADC_SAMPLER_H
+
+#include <Arduino.h>
+
+// Pins sampled by one AdcSampler
+#ifndef ADC_SAMPLER_MAX_PINS
+#define ADC_SAMPLER_MAX_PINS 4
+#endif
+
+// Interval between conversion bursts
+#ifndef ADC_SAMPLER_PERIOD_MS
+#define ADC_SAMPLER_PERIOD_MS 200
+#endif
+
+// DMA bytes converted per burst (shared by all pins)
+#ifndef ADC_SAMPLER_FRAME_BYTES
+#define ADC_SAMPLER_FRAME_BYTES 256
+#endif
+
+// Samples per pin in the analogRead fallback
+#ifndef ADC_SAMPLER_OVERSAMPLE
+#define ADC_SAMPLER_OVERSAMPLE 16
+#endif
+
+// IIR weight of each new burst average: 1 / 2^shift (0 = no filtering)
+#ifndef ADC_SAMPLER_FILTER_SHIFT
+#define ADC_SAMPLER_FILTER_SHIFT 2
+#endif
+
+class AdcSampler {
+public:
+  /**
+   * @brief Register a pin (before begin)
+   * @return Slot for millivolts()/raw(), or -1 (not an ADC1 pin, table full,
+   *         or already started)
+   */
+  int8_t addPin(uint8_t pin);
+
+  /**
+   * @brief Start sampling
+   *
+   * Runs one burst synchronously so readings are valid on return, then
+   * hands over to the background task.
+   */
+  bool begin();
+
+  bool isRunning() const { return _running; }
+  bool usesDma() const { return _dma; }
+
+  /**
+   * @brief Filtered, calibrated pin voltage in mV (0 before begin)
+   */
+  uint32_t millivolts(int8_t slot) const;
+
+  /**
+   * @brief Filtered raw reading (0-4095)
+   */
+  uint16_t raw(int8_t slot) const;
+
+  // Stats
+  uint32_t bursts() const { return _bursts; }
+  uint32_t samples() const { return _samples; }
+
+private:
+  struct Pin {
+    uint8_t gpio;
+    uint8_t channel;            // ADC1 channel
+    uint32_t rawQ4;             // Filtered raw, 4 fractional bits
+    uint32_t mvQ4;              // Filtered mV, 4 fractional bits
+    bool primed;
+  };
+
+  static void taskEntry(void* arg);
+  bool startDma();
+  void burst();
+  bool burstDma(uint32_t* rawAvg, uint32_t* count);
+  void burstAnalog(uint32_t* rawAvg, uint32_t* mvAvg, uint32_t* count);
+  void apply(Pin& p, uint32_t rawAvg, uint32_t mv);
+
+  Pin _pins[ADC_SAMPLER_MAX_PINS];
+  uint8_t _count = 0;
+  bool _running = false;
+  bool _dma = false;
+  volatile uint32_t _bursts = 0;
+  volatile uint32_t _samples = 0;
+};
+
+#endif // MESHSWARM_ADC_SAMPLER_H
@@ -0,0 +1,605 @@
+/**
+ * @file BroadcastOta.cpp
+ * @brief Broadcast OTA receiver and sender implementation
+ */
+
+#include "BroadcastOta.h"
+#include "PerfStats.h"
+#include <Preferences.h>
+#include <ProtoUtil.h>
+#include <esp_ota_ops.h>
+
+using namespace MeshProto;
+
+// NVS layout of a receiver session: offer fields plus the chunk and erased-sector bitmaps
+#define OTA_NVS_NAMESPACE "otab"
+
+// Canonical state pointer for a report's "st", or nullptr if unknown
+static const char* canonicalState(const char* st) {
+  static const char* const STATES[] = {
+    OTA_ST_RECEIVING, OTA_ST_VERIFYING, OTA_ST_COMPLETED, OTA_ST_FAILED, OTA_ST_CURRENT
+  };
+  if (!st) return nullptr;
+  for (const char* s : STATES) {
+    if (strcmp(st, s) == 0) return s;
+  }
+  return nullptr;
+}
+
+// ============== RECEIVER ==============
+
+void OtaBroadcastReceiver::begin(MeshSwarm& swarm, const char* role) {
+  _swarm = &swarm;
+  _role = role;
+
+  swarm.onCommand(OTA_CMD_OFFER, [this](const String& sender, JsonObject& args) {
+    perfStats.countIn(PERF_MSG_COMMAND);
+    onOffer(args);
+    JsonDocument response;
+    return response;
+  });
+  swarm.onCommand(OTA_CMD_CHUNK, [this](const String& sender, JsonObject& args) {
+    perfStats.countIn(PERF_MSG_COMMAND);
+    onChunk(args);
+    JsonDocument response;
+    return response;
+  });
+  swarm.onLoop([this]() { update(); });
+
+  resume();
+}
+
+void OtaBroadcastReceiver::update() {
+  if (_state == RX_VERIFYING) stepVerify();
+
+  uint32_t now = millis();
+  if (_state == RX_RECEIVING && !_reportDue && now - _lastRx >= OTA_RX_IDLE_MS &&
+      now - _lastReport >= OTA_RX_IDLE_MS) {
+    scheduleReport();
+  }
+
+  if (_reportDue && (int32_t)(now - _reportAt) >= 0) {
+    _reportDue = false;
+    sendReport();
+  }
+
+  if (_rebootAt && (int32_t)(now - _rebootAt) >= 0) {
+    Serial.println("[OTAB] Rebooting into new image");
+    ESP.restart();
+  }
+}
+
+void OtaBroadcastReceiver::onOffer(JsonObject& args) {
+  OtaOffer offer;
+  if (!offer.fromJson(args) || offer.role != _role.c_str()) return;
+  if (offer.session == _failedSession) {
+    if (_offer.session == offer.session) scheduleReport();  // Still failed; don't keep the gateway waiting
+    return;
+  }
+  _lastRx = millis();
+
+  if (_state != RX_IDLE && offer.sameImage(_offer)) {
+    _offer.round = offer.round;
+    if (_state != RX_VERIFYING) scheduleReport();
+    return;
+  }
+
+  if (!offer.force && ESP.getSketchMD5().equalsIgnoreCase(offer.md5.c_str())) {
+    if (_state == RX_RECEIVING) clearSaved();
+    _offer = offer;
+    _have.reset(0);
+    _state = RX_DONE;
+    _result = OTA_ST_CURRENT;
+    scheduleReport();
+    return;
+  }
+
+  if (_state != RX_IDLE) {
+    Serial.printf("[OTAB] Session %lu replaced by %lu\n", (unsigned long)_offer.session,
+                  (unsigned long)offer.session);
+  }
+  if (!startSession(offer)) {
+    _offer = offer;
+    finish(OTA_ST_FAILED);
+    return;
+  }
+  persist();
+  scheduleReport();
+}
+
+bool OtaBroadcastReceiver::startSession(const OtaOffer& offer) {
+  _error = nullptr;
+  _part = esp_ota_get_next_update_partition(NULL);
+  if (!_part || offer.imageSize > _part->size) {
+    Serial.printf("[OTAB] No partition for a %lu byte image\n", (unsigned long)offer.imageSize);
+    _error = "no partition";
+    return false;
+  }
+  if (offer.encoding == OTA_ENC_DELTA && !ESP.getSketchMD5().equalsIgnoreCase(offer.baseMd5.c_str())) {
+    Serial.printf("[OTAB] Delta is against %s, not the running image\n", offer.baseMd5.c_str());
+    _error = "base mismatch";
+    return false;
+  }
+
+  _offer = offer;
+  _have.reset(offer.chunks);
+  _erased.reset((offer.imageSize + OTA_SECTOR_BYTES - 1) / OTA_SECTOR_BYTES);
+  _buf.resize(offer.chunkBytes);
+  _state = RX_RECEIVING;
+  _result = nullptr;
+  _rebootAt = 0;
+  _lastRx = millis();
+
+  if (offer.encoding != OTA_ENC_RAW) {
+    const esp_partition_t* running = esp_ota_get_running_partition();
+    uint32_t baseSize = offer.encoding == OTA_ENC_DELTA ? ESP.getSketchSize() : 0;
+    _decoder.begin(offer.imageSize, baseSize,
+      [running](uint32_t offset, uint8_t* data, size_t len) {
+        return esp_partition_read(running, offset, data, len) == ESP_OK;
+      },
+      [this](uint32_t offset, const uint8_t* data, size_t len) {
+        return writeImage(offset, data, len);
+      });
+  }
+
+  static const char* const ENCODINGS[] = { "raw", "compressed", "delta" };
+  Serial.printf("[OTAB] Session %lu: %lu bytes (%s) in %u chunks -> %s\n", (unsigned long)offer.session,
+                (unsigned long)offer.size, ENCODINGS[offer.encoding], offer.chunks, _part->label);
+  return true;
+}
+
+bool OtaBroadcastReceiver::writeImage(uint32_t offset, const uint8_t* data, size_t len) {
+  // Each sector is erased on first touch and never again this session
+  for (uint32_t s = offset / OTA_SECTOR_BYTES; s <= (offset + len - 1) / OTA_SECTOR_BYTES; s++) {
+    if (_erased.has(s)) continue;
+    if (esp_partition_erase_range(_part, s * OTA_SECTOR_BYTES, OTA_SECTOR_BYTES) != ESP_OK) return false;
+    _erased.set(s);
+  }
+  return esp_partition_write(_part, offset, data, len) == ESP_OK;
+}
+
+void OtaBroadcastReceiver::onChunk(JsonObject& args) {
+  if (_state != RX_RECEIVING || (args["s"] | 0UL) != _offer.session) return;
+  uint32_t index = args["i"] | 0xFFFFFFFFUL;
+  if (index >= _offer.chunks) return;
+  _lastRx = millis();
+
+  if (_have.has(index)) {
+    _duplicates++;
+    return;
+  }
+
+  uint16_t len = _offer.chunkLength(index);
+  if (base64Decode(args["d"] | "", _buf.data(), _buf.size()) != len) {
+    _rejected++;
+    return;
+  }
+
+  if (_offer.encoding == OTA_ENC_RAW) {
+    if (!writeImage(index * _offer.chunkBytes, _buf.data(), len)) {
+      _rejected++;
+      return;
+    }
+  } else {
+    PatchResult result = _decoder.apply(_buf.data(), len);
+    if (result == PATCH_BAD_SEGMENT) {
+      // Transport damage fails the base64 length check; this is a bad image or base
+      Serial.printf("[OTAB] Chunk %lu does not decode\n", (unsigned long)index);
+      finish(OTA_ST_FAILED, "decode error");
+      return;
+    }
+    if (result != PATCH_OK) {
+      _rejected++;
+      return;
+    }
+  }
+
+  _have.set(index);
+  if (++_unsaved >= OTA_PERSIST_EVERY) persist();
+
+  if (_have.complete()) {
+    persist();
+    _decoder.end();
+    _state = RX_VERIFYING;
+    _verifyOffset = 0;
+    _md5.begin();
+    Serial.printf("[OTAB] All %u chunks in, verifying\n", _offer.chunks);
+  }
+}
+
+void OtaBroadcastReceiver::stepVerify() {
+  uint32_t budget = OTA_VERIFY_BYTES_PER_LOOP;
+  while (budget > 0 && _verifyOffset < _offer.imageSize) {
+    uint32_t len = _offer.imageSize - _verifyOffset;
+    if (len > _buf.size()) len = _buf.size();
+    if (esp_partition_read(_part, _verifyOffset, _buf.data(), len) != ESP_OK) {
+      finish(OTA_ST_FAILED, "read error");
+      return;
+    }
+    _md5.add(_buf.data(), len);
+    _verifyOffset += len;
+    budget -= len < budget ? len : budget;
+  }
+  if (_verifyOffset < _offer.imageSize) return;
+
+  _md5.calculate();
+  String md5 = _md5.toString();
+  if (!md5.equalsIgnoreCase(_offer.md5.c_str())) {
+    Serial.printf("[OTAB] MD5 mismatch: got %s, want %s\n", md5.c_str(), _offer.md5.c_str());
+    finish(OTA_ST_FAILED, "md5 mismatch");
+    return;
+  }
+  if (esp_ota_set_boot_partition(_part) != ESP_OK) {
+    Serial.println("[OTAB] Image rejected by bootloader check");
+    finish(OTA_ST_FAILED, "boot rejected");
+    return;
+  }
+  finish(OTA_ST_COMPLETED);
+  _rebootAt = millis() + OTA_REBOOT_DELAY_MS;
+}
+
+void OtaBroadcastReceiver::finish(const char* state, const char* error) {
+  _state = RX_DONE;
+  _result = state;
+  if (error) _error = error;
+  _decoder.end();
+  if (state == OTA_ST_FAILED) {
+    _failedSession = _offer.session;
+    _have.reset(0);
+  }
+  clearSaved();
+  _reportDue = false;
+  sendReport();
+  Serial.printf("[OTAB] Session %lu %s\n", (unsigned long)_offer.session, state);
+}
+
+void OtaBroadcastReceiver::scheduleReport() {
+  if (_reportDue) return;
+  _reportDue = true;
+  _reportAt = millis() + random(OTA_REPORT_JITTER_MS);
+}
+
+void OtaBroadcastReceiver::sendReport() {
+  const char* state = _state == RX_DONE ? _result
+                    : _state == RX_VERIFYING ? OTA_ST_VERIFYING : OTA_ST_RECEIVING;
+  if (!state || !_offer.session) return;
+
+  JsonDocument doc;
+  doc["s"] = _offer.session;
+  doc["id"] = _swarm->getNodeId();
+  doc["st"] = state;
+  doc["got"] = (state == OTA_ST_COMPLETED || state == OTA_ST_CURRENT) ? _offer.chunks : _have.count();
+  doc["n"] = _offer.chunks;
+  if (_state == RX_RECEIVING) {
+    std::vector<ChunkRange> gaps;
+    _have.missing(gaps, OTA_REPORT_MAX_RANGES);
+    writeRanges(doc["g"].to<JsonArray>(), gaps);
+  }
+  if (state == OTA_ST_FAILED && _error) doc["e"] = _error;
+
+  JsonObject args = doc.as<JsonObject>();
+  perfStats.countOut(PERF_MSG_COMMAND);
+  _swarm->sendCommand(OTA_BCAST_SERVER, OTA_CMD_REPORT, args);
+  _lastReport = millis();
+}
+
+void OtaBroadcastReceiver::persist() {
+  _unsaved = 0;
+  Preferences prefs;
+  if (!prefs.begin(OTA_NVS_NAMESPACE, false)) return;
+  prefs.putUInt("sid", _offer.session);
+  prefs.putString("md5", _offer.md5.c_str());
+  prefs.putUInt("size", _offer.size);
+  prefs.putUShort("cs", _offer.chunkBytes);
+  prefs.putUChar("enc", _offer.encoding);
+  prefs.putUInt("isize", _offer.imageSize);
+  prefs.putString("base", _offer.baseMd5.c_str());
+  prefs.putBytes("map", _have.data(), _have.bytes());
+  prefs.putBytes("ers", _erased.data(), _erased.bytes());
+  prefs.end();
+}
+
+void OtaBroadcastReceiver::resume() {
+  Preferences prefs;
+  if (!prefs.begin(OTA_NVS_NAMESPACE, true)) return;
+  OtaOffer offer;
+  offer.session = prefs.getUInt("sid", 0);
+  offer.role = _role.c_str();
+  offer.md5 = prefs.getString("md5", "").c_str();
+  offer.size = prefs.getUInt("size", 0);
+  offer.chunkBytes = prefs.getUShort("cs", 0);
+  offer.chunks = OtaOffer::chunkCount(offer.size, offer.chunkBytes);
+  offer.encoding = prefs.getUChar("enc", OTA_ENC_RAW);
+  offer.imageSize = prefs.getUInt("isize", offer.size);
+  offer.baseMd5 = prefs.getString("base", "").c_str();
+  std::vector<uint8_t> bits(prefs.getBytesLength("map"));
+  if (!bits.empty()) prefs.getBytes("map", bits.data(), bits.size());
+  std::vector<uint8_t> erased(prefs.getBytesLength("ers"));
+  if (!erased.empty()) prefs.getBytes("ers", erased.data(), erased.size());
+  prefs.end();
+
+  if (!offer.session) return;
+  // Already running it: the reboot into the image beat the NVS clear.
+  // Sectors erased after the last save hold no saved output, so erasing them again is safe.
+  if (ESP.getSketchMD5().equalsIgnoreCase(offer.md5.c_str()) || !startSession(offer) ||
+      !_have.restore(offer.chunks, bits.data(), bits.size()) ||
+      !_erased.restore(_erased.size(), erased.data(), erased.size())) {
+    _state = RX_IDLE;
+    _reportDue = false;
+    _decoder.end();
+    clearSaved();
+    return;
+  }
+
+  Serial.printf("[OTAB] Resuming session %lu: %u/%u chunks\n", (unsigned long)offer.session,
+                _have.count(), offer.chunks);
+  scheduleReport();
+  if (_have.complete()) {
+    _state = RX_VERIFYING;
+    _verifyOffset = 0;
+    _md5.begin();
+  }
+}
+
+void OtaBroadcastReceiver::clearSaved() {
+  Preferences prefs;
+  if (!prefs.begin(OTA_NVS_NAMESPACE, false)) return;
+  prefs.clear();
+  prefs.end();
+}
+
+void OtaBroadcastReceiver::printStatus() const {
+  static const char* const NAMES[] = { "idle", "receiving", "verifying", "done" };
+  Serial.println("\n--- BROADCAST OTA ---");
+  Serial.printf("State: %s%s%s%s%s\n", NAMES[_state], _result ? " " : "", _result ? _result : "",
+                _error ? ", " : "", _error ? _error : "");
+  if (_offer.session) {
+    Serial.printf("Session: %lu round %u  md5 %s\n", (unsigned long)_offer.session,
+                  _offer.round, _offer.md5.c_str());
+    if (_offer.encoding != OTA_ENC_RAW) {
+      Serial.printf("Encoded: %lu bytes for a %lu byte image (%s)\n", (unsigned long)_offer.size,
+                    (unsigned long)_offer.imageSize, _offer.encoding == OTA_ENC_DELTA ? "delta" : "compressed");
+    }
+    Serial.printf("Chunks: %u/%u  duplicates %lu  rejected %lu\n", _have.count(),
+                  _offer.chunks, (unsigned long)_duplicates, (unsigned long)_rejected);
+  }
+  Serial.println("---------------------\n");
+}
+
+// ============== SENDER ==============
+
+const uint8_t* OtaPartitionSource::acquire(uint16_t index, uint16_t len) {
+  if (!_part || len > _buf.size()) return nullptr;
+  if (esp_partition_read(_part, (uint32_t)index * _chunkBytes, _buf.data(), len) != ESP_OK) return nullptr;
+  return _buf.data();
+}
+
+void OtaBroadcastSender::begin(MeshSwarm& swarm) {
+  _swarm = &swarm;
+  swarm.onCommand(OTA_CMD_REPORT, [this](const String& sender, JsonObject& args) {
+    perfStats.countIn(PERF_MSG_COMMAND);
+    onReport(args);
+    JsonDocument response;
+    return response;
+  });
+  swarm.onLoop([this]() { update(); });
+}
+
+bool OtaBroadcastSender::start(const OtaOffer& offer, const esp_partition_t* image) {
+  if (_phase != TX_IDLE || !image || offer.size > image->size) return false;
+  _partitionSource.begin(image, offer.chunkBytes);
+  return start(offer, _partitionSource);
+}
+
+bool OtaBroadcastSender::start(const OtaOffer& offer, OtaChunkSource& source) {
+  if (!_swarm || _phase != TX_IDLE || !offer.chunks) return false;
+
+  _offer = offer;
+  _offer.round = 0;
+  _source = &source;
+  _resend.reset(offer.chunks);
+  _nodes.clear();
+  _text.resize(base64Length(offer.chunkBytes) + 1);
+  _startedAt = millis();
+  _interval = OTA_CHUNK_INTERVAL_MS;
+  _passSent = 0;
+  _chunksSent = 0;
+  _reports = 0;
+  _stalls = 0;
+  _holds = 0;
+
+  Serial.printf("[OTAB] Broadcasting session %lu (%s, %lu bytes, %u chunks)\n",
+                (unsigned long)offer.session, offer.role.c_str(), (unsigned long)offer.size,
+                offer.chunks);
+  beginRound();
+  return true;
+}
+
+void OtaBroadcastSender::holdOff(uint32_t ms) {
+  if (_phase != TX_SEND) return;
+  _holdUntil = millis() + ms;
+  _holds++;
+}
+
+void OtaBroadcastSender::update() {
+  uint32_t now = millis();
+  switch (_phase) {
+    case TX_IDLE:
+      break;
+
+    case TX_COLLECT:
+      if (now - _phaseAt >= OTA_REPORT_WINDOW_MS) endCollect();
+      break;
+
+    case TX_SEND: {
+      if (_source->failed()) {
+        Serial.println("[OTAB] Chunk source failed, closing session");
+        finish("image lost");
+        break;
+      }
+      if (now - _lastChunkAt < _interval) break;
+      if ((int32_t)(_holdUntil - now) > 0) break;
+      _cursor = _resend.next(_cursor);
+      if (_cursor >= _resend.size()) {
+        beginRound();  // The next offer asks everyone what this pass missed
+        break;
+      }
+
+      // Keep the source a few chunks ahead of the cursor
+      uint16_t ahead = _cursor;
+      for (uint8_t k = 0; k < OTA_PREFETCH_AHEAD && ahead < _resend.size(); k++) {
+        _source->prefetch(ahead);
+        ahead = _resend.next(ahead + 1);
+      }
+
+      uint16_t len = _offer.chunkLength(_cursor);
+      const uint8_t* data = _source->acquire(_cursor, len);
+      if (!data) {
+        _stalls++;  // Source behind: airtime waits rather than buffering more
+        break;
+      }
+      sendChunk(_cursor, data, len);
+      _source->release(_cursor);
+      _resend.clear(_cursor);
+      _cursor++;
+      _passSent++;
+      _lastChunkAt = now;
+      break;
+    }
+  }
+}
+
+void OtaBroadcastSender::beginRound() {
+  _offer.round++;
+  JsonDocument doc;
+  _offer.toJson(doc.to<JsonObject>());
+  JsonObject args = doc.as<JsonObject>();
+  perfStats.countOut(PERF_MSG_COMMAND);
+  _swarm->sendCommand("*", OTA_CMD_OFFER, args);
+  _phase = TX_COLLECT;
+  _phaseAt = millis();
+}
+
+void OtaBroadcastSender::endCollect() {
+  pace();
+  if (!_resend.empty()) {
+    _phase = TX_SEND;
+    _cursor = 0;
+    _passSent = 0;
+    Serial.printf("[OTAB] Round %u: %u chunks for %u nodes, %lu ms apart\n", _offer.round,
+                  _resend.count(), (unsigned)_nodes.size(), (unsigned long)_interval);
+    return;
+  }
+
+  // Nothing to send: done once every node still answering has a final state
+  uint32_t now = millis();
+  bool waiting = false;
+  for (auto& kv : _nodes) {
+    if (!otaStateFinal(kv.second.state) && now - kv.second.lastReport < OTA_NODE_LOST_MS) {
+      waiting = true;
+    }
+  }
+
+  bool noNodes = _nodes.empty() && now - _startedAt >= OTA_NO_NODES_MS;
+  if ((!_nodes.empty() && !waiting) || noNodes || _offer.round >= OTA_BCAST_MAX_ROUNDS) {
+    finish();
+    return;
+  }
+  beginRound();
+}
+
+void OtaBroadcastSender::pace() {
+  // Gaps after a pass are chunks slow or distant receivers dropped: back off
+  // while they pile up, recover once passes come back nearly clean
+  if (_passSent == 0) return;
+  uint32_t lossPct = (uint32_t)_resend.count() * 100 / _passSent;
+  if (lossPct > OTA_LOSS_HIGH_PCT && _interval < OTA_CHUNK_INTERVAL_MAX_MS) {
+    _interval = _interval * 2 < OTA_CHUNK_INTERVAL_MAX_MS ? _interval * 2 : OTA_CHUNK_INTERVAL_MAX_MS;
+  } else if (lossPct < OTA_LOSS_LOW_PCT && _interval > OTA_CHUNK_INTERVAL_MS) {
+    _interval = _interval * 3 / 4 > OTA_CHUNK_INTERVAL_MS ? _interval * 3 / 4 : OTA_CHUNK_INTERVAL_MS;
+  }
+}
+
+void OtaBroadcastSender::sendChunk(uint16_t index, const uint8_t* data, uint16_t len) {
+  base64Encode(data, len, _text.data());
+
+  // Same keys every chunk, so the document's pool is reused rather than regrown
+  _chunkDoc["s"] = _offer.session;
+  _chunkDoc["i"] = index;
+  _chunkDoc["d"] = (const char*)_text.data();
+  JsonObject args = _chunkDoc.as<JsonObject>();
+  perfStats.countOut(PERF_MSG_COMMAND);
+  _swarm->sendCommand("*", OTA_CMD_CHUNK, args);
+  _chunksSent++;
+}
+
+void OtaBroadcastSender::onReport(JsonObject& args) {
+  if (_phase == TX_IDLE || (args["s"] | 0UL) != _offer.session) return;
+  uint32_t nodeId = args["id"] | 0UL;
+  const char* state = canonicalState(args["st"] | "");
+  if (!nodeId || !state) return;
+  _reports++;
+
+  NodeProgress& node = _nodes[nodeId];
+  node.lastReport = millis();
+  if (otaStateFinal(node.state)) return;  // Completed, failed and skipped stick
+
+  // Mid-session and now running the image: its completed report was lost
+  if (state == OTA_ST_CURRENT && node.state) state = OTA_ST_COMPLETED;
+  if (state == OTA_ST_RECEIVING) readRanges(args["g"].as<JsonArrayConst>(), _resend);
+
+  bool changed = state != node.state;
+  node.state = state;
+  node.got = args["got"] | 0;
+  if (state == OTA_ST_FAILED) strlcpy(node.error, args["e"] | "", sizeof(node.error));
+  progress(nodeId, node, changed);
+}
+
+void OtaBroadcastSender::progress(uint32_t nodeId, NodeProgress& node, bool changed) {
+  uint32_t now = millis();
+  if (!changed && now - node.lastProgress < OTA_PROGRESS_MIN_MS) return;
+  node.lastProgress = now;
+  if (_onProgress) _onProgress(_offer.session, nodeId, node.state, node.got, _offer.chunks, node.error);
+}
+
+void OtaBroadcastSender::finish(const char* reason) {
+  uint16_t completed = 0;
+  uint16_t failed = 0;
+  for (auto& kv : _nodes) {
+    NodeProgress& node = kv.second;
+    if (!otaStateFinal(node.state)) {
+      node.state = OTA_ST_FAILED;  // Stopped answering or ran out of rounds
+      strlcpy(node.error, reason, sizeof(node.error));
+      progress(kv.first, node, true);
+    }
+    if (node.state == OTA_ST_FAILED) failed++;
+    else completed++;
+  }
+
+  Serial.printf("[OTAB] Session %lu done after %u rounds: %u ok, %u failed, %lu chunks sent\n",
+                (unsigned long)_offer.session, _offer.round, completed, failed,
+                (unsigned long)_chunksSent);
+  _phase = TX_IDLE;
+  if (_onDone) _onDone(_offer.session, completed, failed);
+}
+
+void OtaBroadcastSender::printStatus() const {
+  static const char* const NAMES[] = { "idle", "collecting reports", "sending" };
+  Serial.println("\n--- BROADCAST OTA ---");
+  Serial.printf("Phase: %s\n", NAMES[_phase]);
+  if (_phase != TX_IDLE) {
+    Serial.printf("Session: %lu (%s) round %u, %lu bytes for a %lu byte image\n",
+                  (unsigned long)_offer.session, _offer.role.c_str(), _offer.round,
+                  (unsigned long)_offer.size, (unsigned long)_offer.imageSize);
+    Serial.printf("Sent: %lu chunks of %u, %u queued  Reports: %lu\n", (unsigned long)_chunksSent,
+                  _offer.chunks, _resend.count(), (unsigned long)_reports);
+    Serial.printf("Pacing: %lu ms  Source stalls: %lu  Urgent holds: %lu\n", (unsigned long)_interval,
+                  (unsigned long)_stalls, (unsigned long)_holds);
+    for (auto& kv : _nodes) {
+      Serial.printf("  %08lx %-11s %u/%u %s\n", (unsigned long)kv.first,
+                    kv.second.state ? kv.second.state : "-", kv.second.got, _offer.chunks,
+                    kv.second.error);
+    }
+  }
+  Serial.println("---------------------\n");
+}
@@ -0,0 +1,330 @@
+/**
+ * @file BroadcastOta.h
+ * @brief Broadcast OTA over the MeshSwarm command protocol
+ *
+ * The unicast OTA in MeshSwarm sends the whole image to one node at a time.
+ * Here the gateway streams each chunk once to every node, and nodes of the
+ * offered type keep what they need (MeshSwarmProto/OtaChunks.h):
+ *
+ *   gateway -> "*"      ota_offer  {s, r, role, hw, md5, size, cs, n, f}
+ *   node    -> Gateway  ota_report {s, id, st, got, n, g:[[first,count],...]}
+ *   gateway -> "*"      ota_chunk  {s, i, d}       x every chunk someone lacks
+ *   ... next round: offer, reports, resend the union of the gaps ...
+ *
+ * Receivers write chunks straight into the spare OTA partition and keep the
+ * chunk bitmap in NVS, so a reboot mid-transfer resumes where it stopped.
+ * Compressed and delta offers (enc in the offer) carry MeshSwarmProto
+ * OtaPatch.h segments instead; each one is decoded on arrival through a
+ * 4 KB window, copying unchanged code from the running partition for a
+ * delta. When every chunk is in, the partition is MD5-checked against the
+ * offer before it is made the boot partition.
+ *
+ * Node:
+ *   otaReceiver.begin(swarm, NODE_TYPE);
+ *
+ * Gateway:
+ *   otaSender.begin(swarm);
+ *   otaSender.onProgress([](uint32_t session, uint32_t nodeId, const char* state,
+ *                           uint16_t got, uint16_t chunks, const char* error) { ... });
+ *   otaSender.start(offer, partitionHoldingTheImage);   // or any OtaChunkSource
+ *
+ * The sender only needs chunk bytes just before it sends them. A source
+ * that fetches them on demand (the gateway's HTTP range relay) keeps the
+ * gateway from staging the image at all; when it falls behind, the send
+ * cursor waits for it.
+ */
+
+#ifndef MESHSWARM_BROADCAST_OTA_H
+#define MESHSWARM_BROADCAST_OTA_H
+
+#include <Arduino.h>
+#include <MD5Builder.h>
+#include <MeshSwarm.h>
+#include <OtaChunks.h>
+#include <OtaPatch.h>
+#include <esp_partition.h>
+#include <functional>
+#include <map>
+#include <vector>
+
+#define OTA_CMD_OFFER  "ota_offer"
+#define OTA_CMD_CHUNK  "ota_chunk"
+#define OTA_CMD_REPORT "ota_report"
+
+// Node name reports are sent to (the gateway)
+#ifndef OTA_BCAST_SERVER
+#define OTA_BCAST_SERVER "Gateway"
+#endif
+
+// ---- Receiver ----
+
+// Reports wait a random 0..jitter after an offer, so 25 nodes don't answer at once
+#ifndef OTA_REPORT_JITTER_MS
+#define OTA_REPORT_JITTER_MS 2000
+#endif
+
+// No chunk or offer for this long while receiving: report anyway (lost offer)
+#ifndef OTA_RX_IDLE_MS
+#define OTA_RX_IDLE_MS 30000
+#endif
+
+// New chunks between bitmap saves to NVS
+#ifndef OTA_PERSIST_EVERY
+#define OTA_PERSIST_EVERY 32
+#endif
+
+// Image bytes hashed per loop() while verifying
+#ifndef OTA_VERIFY_BYTES_PER_LOOP
+#define OTA_VERIFY_BYTES_PER_LOOP 4096
+#endif
+
+// Time for the completed report to leave before restarting
+#ifndef OTA_REBOOT_DELAY_MS
+#define OTA_REBOOT_DELAY_MS 3000
+#endif
+
+// ---- Sender ----
+
+// Gap between chunk broadcasts (512 B / 40 ms = 12.5 KB/s on air)
+#ifndef OTA_CHUNK_INTERVAL_MS
+#define OTA_CHUNK_INTERVAL_MS 40
+#endif
+
+// Chunks held back after an urgent write is seen, so it doesn't queue behind them
+#ifndef OTA_URGENT_HOLD_MS
+#define OTA_URGENT_HOLD_MS 500
+#endif
+
+// Slowest pacing when receivers keep losing chunks
+#ifndef OTA_CHUNK_INTERVAL_MAX_MS
+#define OTA_CHUNK_INTERVAL_MAX_MS 320
+#endif
+
+// Share of a pass reported missing that doubles the gap / lets it shrink again
+#ifndef OTA_LOSS_HIGH_PCT
+#define OTA_LOSS_HIGH_PCT 20
+#endif
+#ifndef OTA_LOSS_LOW_PCT
+#define OTA_LOSS_LOW_PCT 5
+#endif
+
+// Chunks past the send cursor a source is asked to have ready
+#ifndef OTA_PREFETCH_AHEAD
+#define OTA_PREFETCH_AHEAD 8
+#endif
+
+// How long reports are collected after an offer
+#ifndef OTA_REPORT_WINDOW_MS
+#define OTA_REPORT_WINDOW_MS (OTA_REPORT_JITTER_MS + 2000)
+#endif
+
+// Rounds before the session is closed with whatever nodes finished
+#ifndef OTA_BCAST_MAX_ROUNDS
+#define OTA_BCAST_MAX_ROUNDS 40
+#endif
+
+// Node silent this long no longer holds the session open
+#ifndef OTA_NODE_LOST_MS
+#define OTA_NODE_LOST_MS 120000
+#endif
+
+// Session with no node answering at all is closed after this
+#ifndef OTA_NO_NODES_MS
+#define OTA_NO_NODES_MS 300000
+#endif
+
+// Minimum gap between progress callbacks for one node (state changes always pass)
+#ifndef OTA_PROGRESS_MIN_MS
+#define OTA_PROGRESS_MIN_MS 5000
+#endif
+
+#define OTA_SECTOR_BYTES 4096
+
+class OtaBroadcastReceiver {
+public:
+  /**
+   * @brief Register the offer/chunk handlers and resume a saved session
+   * @param role NODE_TYPE; offers for other types are ignored
+   */
+  void begin(MeshSwarm& swarm, const char* role);
+
+  void update();
+
+  bool active() const { return _state == RX_RECEIVING || _state == RX_VERIFYING; }
+  uint32_t session() const { return _offer.session; }
+  uint16_t received() const { return _have.count(); }
+  uint16_t chunks() const { return _offer.chunks; }
+
+  void printStatus() const;
+
+private:
+  enum RxState : uint8_t { RX_IDLE, RX_RECEIVING, RX_VERIFYING, RX_DONE };
+
+  MeshSwarm* _swarm = nullptr;
+  String _role;
+  RxState _state = RX_IDLE;
+  const char* _result = nullptr;   // Final report state once RX_DONE
+  const char* _error = nullptr;    // Why, when _result is failed
+  uint32_t _failedSession = 0;     // Not retried after a bad hash
+
+  MeshProto::OtaOffer _offer;
+  MeshProto::ChunkMap _have;
+  MeshProto::ChunkMap _erased;     // Sectors erased this session
+  const esp_partition_t* _part = nullptr;
+  std::vector<uint8_t> _buf;       // One chunk
+  MeshProto::PatchDecoder _decoder;
+
+  uint16_t _unsaved = 0;
+  bool _reportDue = false;
+  uint32_t _reportAt = 0;
+  uint32_t _lastReport = 0;
+  uint32_t _lastRx = 0;
+  uint32_t _rebootAt = 0;
+
+  MD5Builder _md5;
+  uint32_t _verifyOffset = 0;
+
+  uint32_t _duplicates = 0;
+  uint32_t _rejected = 0;
+
+  void onOffer(JsonObject& args);
+  void onChunk(JsonObject& args);
+  bool startSession(const MeshProto::OtaOffer& offer);
+  bool writeImage(uint32_t offset, const uint8_t* data, size_t len);
+  void stepVerify();
+  void finish(const char* state, const char* error = nullptr);
+  void scheduleReport();
+  void sendReport();
+
+  void persist();
+  void resume();
+  void clearSaved();
+};
+
+/**
+ * @brief Where the sender gets chunk bytes
+ *
+ * Called from the mesh loop only. prefetch() names chunks in the order they
+ * will be sent; acquire() returns nullptr while a chunk isn't there yet and
+ * the sender asks again on a later loop.
+ */
+class OtaChunkSource {
+public:
+  virtual ~OtaChunkSource() {}
+  virtual void prefetch(uint16_t index) {}
+  virtual const uint8_t* acquire(uint16_t index, uint16_t len) = 0;
+  virtual void release(uint16_t index) {}
+  // Chunks will never arrive; the session is closed
+  virtual bool failed() const { return false; }
+};
+
+/**
+ * @brief Image already written to a partition
+ */
+class OtaPartitionSource : public OtaChunkSource {
+public:
+  void begin(const esp_partition_t* part, uint16_t chunkBytes) {
+    _part = part;
+    _chunkBytes = chunkBytes;
+    _buf.resize(chunkBytes);
+  }
+
+  const uint8_t* acquire(uint16_t index, uint16_t len) override;
+
+private:
+  const esp_partition_t* _part = nullptr;
+  uint16_t _chunkBytes = 0;
+  std::vector<uint8_t> _buf;
+};
+
+class OtaBroadcastSender {
+public:
+  using ProgressHandler = std::function<void(uint32_t session, uint32_t nodeId, const char* state,
+                                             uint16_t got, uint16_t chunks, const char* error)>;
+  using DoneHandler = std::function<void(uint32_t session, uint16_t completed, uint16_t failed)>;
+
+  /**
+   * @brief Register the report handler and the loop hook
+   */
+  void begin(MeshSwarm& swarm);
+
+  void onProgress(ProgressHandler handler) { _onProgress = handler; }
+  void onDone(DoneHandler handler) { _onDone = handler; }
+
+  /**
+   * @brief Start distributing an image already written to a partition
+   * @param image Partition holding offer.size bytes of the image from offset 0
+   * @return false if a session is running or the offer does not fit
+   */
+  bool start(const MeshProto::OtaOffer& offer, const esp_partition_t* image);
+
+  /**
+   * @brief Start distributing chunks from a source that outlives the session
+   */
+  bool start(const MeshProto::OtaOffer& offer, OtaChunkSource& source);
+
+  /**
+   * @brief Drop the session without a done callback
+   */
+  void stop() { _phase = TX_IDLE; }
+
+  /**
+   * @brief Send no chunks for ms (an urgent write, see UrgentState.h, is crossing the mesh)
+   *
+   * painlessMesh has one FIFO per hop, so chunks already queued still go
+   * first; holding back only keeps new ones from piling on top of the write.
+   */
+  void holdOff(uint32_t ms = OTA_URGENT_HOLD_MS);
+
+  void update();
+
+  bool active() const { return _phase != TX_IDLE; }
+
+  void printStatus() const;
+
+private:
+  enum TxPhase : uint8_t { TX_IDLE, TX_COLLECT, TX_SEND };
+
+  struct NodeProgress {
+    const char* state = nullptr;
+    uint16_t got = 0;
+    uint32_t lastReport = 0;
+    uint32_t lastProgress = 0;
+    char error[OTA_ERROR_LEN] = "";
+  };
+
+  MeshSwarm* _swarm = nullptr;
+  ProgressHandler _onProgress;
+  DoneHandler _onDone;
+
+  TxPhase _phase = TX_IDLE;
+  MeshProto::OtaOffer _offer;
+  OtaChunkSource* _source = nullptr;
+  OtaPartitionSource _partitionSource;
+  MeshProto::ChunkMap _resend;     // Union of every node's gaps
+  std::map<uint32_t, NodeProgress> _nodes;
+  std::vector<char> _text;         // Base64 of one chunk, reused
+  JsonDocument _chunkDoc;          // Chunk command args, reused
+
+  uint32_t _startedAt = 0;
+  uint32_t _phaseAt = 0;
+  uint32_t _lastChunkAt = 0;
+  uint16_t _cursor = 0;
+  uint32_t _interval = OTA_CHUNK_INTERVAL_MS;
+  uint16_t _passSent = 0;          // Chunks sent in the pass before this round
+  uint32_t _chunksSent = 0;
+  uint32_t _reports = 0;
+  uint32_t _stalls = 0;            // Loops the cursor waited on the source
+  uint32_t _holdUntil = 0;
+  uint32_t _holds = 0;
+
+  void onReport(JsonObject& args);
+  void beginRound();
+  void endCollect();
+  void pace();
+  void sendChunk(uint16_t index, const uint8_t* data, uint16_t len);
+  void finish(const char* reason = "no answer");
+  void progress(uint32_t nodeId, NodeProgress& node, bool changed);
+};
+
+#endif // MESHSWARM_BROADCAST_OTA_H
@@ -0,0 +1,44 @@
+/**
+ * @file DriftClock.cpp
+ * @brief Drift-compensated mesh clock implementation
+ */
+
+#include "DriftClock.h"
+
+void DriftClock::reset(uint64_t unixMs, uint32_t localMillis) {
+  _baseUnixMs = unixMs;
+  _baseMillis = localMillis;
+  _valid = true;
+}
+
+void DriftClock::sample(uint64_t unixMs, uint32_t localMillis) {
+  _samples++;
+  if (!_valid) {
+    reset(unixMs, localMillis);
+    return;
+  }
+
+  int64_t error = (int64_t)unixMs - (int64_t)at(localMillis);
+  uint32_t interval = localMillis - _baseMillis;
+  _lastErrorMs = (int32_t)error;
+
+  if (error <= TIME_STEP_THRESHOLD_MS && error >= -TIME_STEP_THRESHOLD_MS &&
+      interval >= TIME_DRIFT_MIN_INTERVAL_MS) {
+    // Residual over the interval is drift the current estimate missed.
+    // Take the first estimate at half weight, then smooth harder.
+    float residualPpm = (float)error * 1e6f / (float)interval;
+    float gain = _driftSamples == 0 ? 0.5f : 0.25f;
+    _driftPpm += gain * residualPpm;
+    if (_driftPpm > TIME_DRIFT_MAX_PPM) _driftPpm = TIME_DRIFT_MAX_PPM;
+    if (_driftPpm < -TIME_DRIFT_MAX_PPM) _driftPpm = -TIME_DRIFT_MAX_PPM;
+    _driftSamples++;
+  }
+
+  reset(unixMs, localMillis);
+}
+
+uint64_t DriftClock::at(uint32_t localMillis) const {
+  uint32_t elapsed = localMillis - _baseMillis;
+  int64_t correction = (int64_t)((float)elapsed * _driftPpm * 1e-6f);
+  return _baseUnixMs + elapsed + correction;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file DriftClock.h
+ * @brief Millisecond wall clock disciplined by mesh time samples
+ *
+ * Holds a (unix ms, millis()) base and an estimate of the local crystal's
+ * drift in ppm. Between syncs the clock interpolates with the drift
+ * correction applied, so sync intervals can be long (minutes) without the
+ * display wandering. Each sample rebases the clock; the residual error over
+ * the interval since the previous sample updates the drift estimate.
+ */
+
+#ifndef MESHSWARM_DRIFT_CLOCK_H
+#define MESHSWARM_DRIFT_CLOCK_H
+
+#include <Arduino.h>
+
+// Largest drift accepted from the estimator (cheap crystals are ~20-50 ppm)
+#ifndef TIME_DRIFT_MAX_PPM
+#define TIME_DRIFT_MAX_PPM 500
+#endif
+
+// Errors above this step the clock and leave the drift estimate alone
+#ifndef TIME_STEP_THRESHOLD_MS
+#define TIME_STEP_THRESHOLD_MS 2000
+#endif
+
+// Shorter intervals are too noisy (RTT asymmetry) to estimate drift from
+#ifndef TIME_DRIFT_MIN_INTERVAL_MS
+#define TIME_DRIFT_MIN_INTERVAL_MS 60000
+#endif
+
+class DriftClock {
+public:
+  /**
+   * @brief Set the clock without touching the drift estimate (manual set)
+   */
+  void reset(uint64_t unixMs, uint32_t localMillis);
+
+  /**
+   * @brief Apply a sync sample: unixMs was the true time at localMillis
+   */
+  void sample(uint64_t unixMs, uint32_t localMillis);
+
+  bool valid() const { return _valid; }
+
+  /**
+   * @brief Unix time in ms at a given millis() reading
+   */
+  uint64_t at(uint32_t localMillis) const;
+  uint64_t nowMs() const { return at(millis()); }
+  uint32_t now() const { return (uint32_t)(nowMs() / 1000); }
+
+  float driftPpm() const { return _driftPpm; }
+  int32_t lastErrorMs() const { return _lastErrorMs; }
+  uint32_t samples() const { return _samples; }
+
+private:
+  uint64_t _baseUnixMs = 0;
+  uint32_t _baseMillis = 0;
+  float _driftPpm = 0;
+  int32_t _lastErrorMs = 0;
+  uint32_t _samples = 0;
+  uint32_t _driftSamples = 0;
+  bool _valid = false;
+};
+
+#endif // MESHSWARM_DRIFT_CLOCK_H
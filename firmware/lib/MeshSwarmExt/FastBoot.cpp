@@ -0,0 +1,182 @@
+/**
+ * @file FastBoot.cpp
+ * @brief Boot profiling and warm-boot cache implementation
+ */
+
+#include "FastBoot.h"
+#include <WiFi.h>
+#include <esp_attr.h>
+#include <esp_system.h>
+#include <esp_timer.h>
+
+namespace {
+
+const uint32_t CACHE_MAGIC = 0x46424331;  // "FBC1"
+
+struct MeshCache {
+  uint32_t magic;
+  uint32_t checksum;
+  uint8_t channel;
+  uint8_t peerCount;
+  uint32_t coordinatorId;
+  uint32_t gatewayId;
+  uint32_t peers[FAST_BOOT_MAX_PEERS];
+};
+
+// Survives software, panic, watchdog and brownout resets; garbage after power-on
+RTC_NOINIT_ATTR MeshCache s_rtc;
+
+// Copy of the previous run's cache (s_rtc is overwritten as the mesh comes up)
+MeshCache s_previous;
+
+uint32_t checksumOf(const MeshCache& c) {
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(&c) + 2 * sizeof(uint32_t);
+  const size_t len = sizeof(MeshCache) - 2 * sizeof(uint32_t);
+  uint32_t h = 2166136261u;  // FNV-1a
+  for (size_t i = 0; i < len; i++) {
+    h = (h ^ p[i]) * 16777619u;
+  }
+  return h;
+}
+
+uint32_t nowMs() {
+  return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+}  // namespace
+
+void FastBoot::begin() {
+  esp_reset_reason_t reason = esp_reset_reason();
+  bool warmReset = true;
+  switch (reason) {
+    case ESP_RST_POWERON:  _reason = "power-on"; warmReset = false; break;
+    case ESP_RST_SW:       _reason = "software"; break;
+    case ESP_RST_PANIC:    _reason = "panic"; break;
+    case ESP_RST_INT_WDT:
+    case ESP_RST_TASK_WDT:
+    case ESP_RST_WDT:      _reason = "watchdog"; break;
+    case ESP_RST_BROWNOUT: _reason = "brownout"; _brownout = true; break;
+    case ESP_RST_DEEPSLEEP: _reason = "deep sleep"; break;
+    case ESP_RST_EXT:      _reason = "external"; warmReset = false; break;
+    default:               _reason = "other"; warmReset = false; break;
+  }
+
+  bool valid = s_rtc.magic == CACHE_MAGIC && s_rtc.checksum == checksumOf(s_rtc) &&
+               s_rtc.peerCount <= FAST_BOOT_MAX_PEERS;
+  _warm = warmReset && valid;
+  if (_warm) {
+    s_previous = s_rtc;
+  } else {
+    memset(&s_previous, 0, sizeof(s_previous));
+  }
+
+  mark("start");
+}
+
+void FastBoot::mark(const char* phase) {
+  if (_markCount >= FAST_BOOT_MAX_MARKS) return;
+  _marks[_markCount].name = phase;
+  _marks[_markCount].ms = nowMs();
+  _markCount++;
+}
+
+void FastBoot::markOnce(const char* phase) {
+  if (markAt(phase) >= 0) return;
+  mark(phase);
+  Serial.printf("[BOOT] %s at %lu ms\n", phase, (unsigned long)nowMs());
+}
+
+int32_t FastBoot::markAt(const char* phase) const {
+  for (uint8_t i = 0; i < _markCount; i++) {
+    if (strcmp(_marks[i].name, phase) == 0) return (int32_t)_marks[i].ms;
+  }
+  return -1;
+}
+
+void FastBoot::report() const {
+  Serial.printf("[BOOT] %s boot (%s), phases since app start:\n",
+                _warm ? "Warm" : "Cold", _reason);
+  if (_warm) {
+    Serial.printf("[BOOT]   cached: ch %u, gateway %u, coord %u, %u peers\n",
+                  s_previous.channel, (unsigned)s_previous.gatewayId,
+                  (unsigned)s_previous.coordinatorId, s_previous.peerCount);
+  }
+  uint32_t prev = 0;
+  for (uint8_t i = 0; i < _markCount; i++) {
+    Serial.printf("[BOOT]   %-12s %6lu ms  (+%lu)\n", _marks[i].name,
+                  (unsigned long)_marks[i].ms, (unsigned long)(_marks[i].ms - prev));
+    prev = _marks[i].ms;
+  }
+}
+
+void FastBoot::attach(MeshSwarm& swarm) {
+  _swarm = &swarm;
+  _lastSave = millis();
+  swarm.onLoop([this]() { update(); });
+}
+
+void FastBoot::update() {
+  if (_swarm == nullptr) return;
+
+  if (!_reported && _swarm->getPeerCount() > 0) {
+    mark("first_peer");
+    report();
+    _reported = true;
+  }
+
+  if (_warm && !_rejoined) {
+    uint32_t back = 0;
+    for (auto& kv : _swarm->getPeers()) {
+      if (!kv.second.alive || !wasCached(kv.first)) continue;
+      if (s_previous.gatewayId == 0 || kv.first == s_previous.gatewayId) {
+        back = kv.first;
+        break;
+      }
+    }
+    if (back != 0) {
+      _rejoined = true;
+      markOnce("rejoin");
+      if (_onRejoin) _onRejoin(back);
+    }
+  }
+
+  if (millis() - _lastSave >= FAST_BOOT_SAVE_INTERVAL_MS) {
+    _lastSave = millis();
+    save();
+  }
+}
+
+void FastBoot::save() {
+  MeshCache c;
+  memset(&c, 0, sizeof(c));
+  c.channel = (uint8_t)WiFi.channel();
+  c.coordinatorId = _swarm->isCoordinator() ? _swarm->getNodeId() : 0;
+  for (auto& kv : _swarm->getPeers()) {
+    const Peer& p = kv.second;
+    if (!p.alive) continue;
+    if (p.name == FAST_BOOT_GATEWAY_NAME) c.gatewayId = kv.first;
+    if (c.coordinatorId == 0 && p.role == "COORD") c.coordinatorId = kv.first;
+    if (c.peerCount < FAST_BOOT_MAX_PEERS) c.peers[c.peerCount++] = kv.first;
+  }
+  if (c.peerCount == 0) return;  // Keep the last useful snapshot while alone
+
+  c.magic = CACHE_MAGIC;
+  c.checksum = checksumOf(c);
+  s_rtc = c;
+}
+
+bool FastBoot::wasCached(uint32_t id) const {
+  for (uint8_t i = 0; i < s_previous.peerCount; i++) {
+    if (s_previous.peers[i] == id) return true;
+  }
+  return false;
+}
+
+uint8_t FastBoot::cachedChannel() const { return s_previous.channel; }
+uint32_t FastBoot::cachedGatewayId() const { return s_previous.gatewayId; }
+uint32_t FastBoot::cachedCoordinatorId() const { return s_previous.coordinatorId; }
+uint8_t FastBoot::cachedPeerCount() const { return s_previous.peerCount; }
+
+uint32_t FastBoot::cachedPeer(uint8_t index) const {
+  return index < s_previous.peerCount ? s_previous.peers[index] : 0;
+}
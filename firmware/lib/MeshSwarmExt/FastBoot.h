@@ -0,0 +1,145 @@
+/**
+ * @file FastBoot.h
+ * @brief Boot phase profiling and warm-boot mesh parameter cache
+ *
+ * Two jobs, both about getting back on the mesh quickly after an OTA
+ * restart, crash or brownout:
+ *
+ *   - Profiling: mark() named phases during setup() and after (first
+ *     peer, first setState). report() prints the time of each phase since
+ *     app start and the gap from the previous one.
+ *
+ *   - Warm-boot cache: the WiFi channel, the coordinator and gateway ids
+ *     and the alive peer ids are kept in RTC memory that survives every
+ *     reset except power-on. On a warm boot isWarmBoot() lets setup() skip
+ *     cold-start waits (serial monitor attach, sensor warmup, splash
+ *     screens), and onRejoin() fires as soon as a cached peer is back, so
+ *     follow-up work (time sync, first reports) doesn't wait for a retry
+ *     timer.
+ *
+ * MeshSwarm::begin() takes no channel or root hint, so the cached channel
+ * is reported rather than applied.
+ *
+ *   FastBoot fastBoot;
+ *   fastBoot.begin();                 // First line of setup()
+ *   ...
+ *   fastBoot.mark("mesh");
+ *   fastBoot.attach(swarm);           // Tracks first peer, refreshes cache
+ */
+
+#ifndef MESHSWARM_FAST_BOOT_H
+#define MESHSWARM_FAST_BOOT_H
+
+#include <Arduino.h>
+#include <MeshSwarm.h>
+
+// Phases recorded per boot
+#ifndef FAST_BOOT_MAX_MARKS
+#define FAST_BOOT_MAX_MARKS 12
+#endif
+
+// Peer ids kept across warm boots
+#ifndef FAST_BOOT_MAX_PEERS
+#define FAST_BOOT_MAX_PEERS 16
+#endif
+
+// How often the RTC cache is refreshed from the live mesh
+#ifndef FAST_BOOT_SAVE_INTERVAL_MS
+#define FAST_BOOT_SAVE_INTERVAL_MS 5000
+#endif
+
+// Node name treated as the gateway
+#ifndef FAST_BOOT_GATEWAY_NAME
+#define FAST_BOOT_GATEWAY_NAME "Gateway"
+#endif
+
+class FastBoot {
+public:
+  typedef void (*RejoinCallback)(uint32_t peerId);
+
+  /**
+   * @brief Read the reset reason and validate the RTC cache
+   *
+   * Call at the top of setup() (no output; see report()); records the
+   * "start" mark.
+   */
+  void begin();
+
+  /**
+   * @brief True if the chip reset without losing power and the cache is valid
+   */
+  bool isWarmBoot() const { return _warm; }
+
+  /**
+   * @brief True for a brownout reset (peripherals may have lost power too)
+   */
+  bool wasBrownout() const { return _brownout; }
+
+  const char* resetReason() const { return _reason; }
+
+  /**
+   * @brief Record a phase (name must outlive the FastBoot, e.g. a literal)
+   */
+  void mark(const char* phase);
+
+  /**
+   * @brief Record a phase only the first time it is reached
+   */
+  void markOnce(const char* phase);
+
+  /**
+   * @brief Milliseconds since app start at the named mark, or -1
+   */
+  int32_t markAt(const char* phase) const;
+
+  /**
+   * @brief Print the phase breakdown
+   */
+  void report() const;
+
+  /**
+   * @brief Follow the mesh: marks "first_peer", fires onRejoin, refreshes the cache
+   *
+   * Registers update() on the MeshSwarm loop.
+   */
+  void attach(MeshSwarm& swarm);
+
+  /**
+   * @brief Called once, when the first peer from the cached set reappears
+   * (gateway preferred); not called on cold boot
+   */
+  void onRejoin(RejoinCallback callback) { _onRejoin = callback; }
+
+  void update();
+
+  // Cached mesh parameters from the previous run (valid on warm boot)
+  uint8_t cachedChannel() const;
+  uint32_t cachedGatewayId() const;
+  uint32_t cachedCoordinatorId() const;
+  uint8_t cachedPeerCount() const;
+  uint32_t cachedPeer(uint8_t index) const;
+
+private:
+  struct Mark {
+    const char* name;
+    uint32_t ms;
+  };
+
+  void save();
+  bool wasCached(uint32_t id) const;
+
+  MeshSwarm* _swarm = nullptr;
+  RejoinCallback _onRejoin = nullptr;
+
+  Mark _marks[FAST_BOOT_MAX_MARKS];
+  uint8_t _markCount = 0;
+
+  const char* _reason = "unknown";
+  bool _warm = false;
+  bool _brownout = false;
+  bool _rejoined = false;
+  bool _reported = false;
+  unsigned long _lastSave = 0;
+};
+
+#endif // MESHSWARM_FAST_BOOT_H
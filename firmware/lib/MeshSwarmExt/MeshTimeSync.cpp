@@ -0,0 +1,110 @@
+/**
+ * @file MeshTimeSync.cpp
+ * @brief Mesh time sync server and client implementation
+ */
+
+#include "MeshTimeSync.h"
+#include "PerfStats.h"
+#include <sys/time.h>
+
+void MeshTimeSync::serve(MeshSwarm& swarm, std::function<bool()> timeValid) {
+  swarm.onCommand(TIME_SYNC_COMMAND, [timeValid](const String& sender, JsonObject& args) {
+    perfStats.countIn(PERF_MSG_COMMAND);
+    JsonDocument response;
+    response["q"] = args["q"];
+    if (!timeValid || !timeValid()) {
+      response["ok"] = false;
+      return response;
+    }
+
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    response["ok"] = true;
+    response["s"] = (uint32_t)tv.tv_sec;
+    response["ms"] = (uint16_t)(tv.tv_usec / 1000);
+    return response;
+  });
+}
+
+void MeshTimeClient::begin(MeshSwarm& swarm, SampleHandler onSample, const char* server) {
+  _swarm = &swarm;
+  _onSample = onSample;
+  _server = server;
+  _nextAt = millis();
+  swarm.onLoop([this]() { update(); });
+}
+
+void MeshTimeClient::update() {
+  if (!_swarm) return;
+
+  if (_inFlight) {
+    // Backstop in case the command layer never reports the timeout
+    if (millis() - _sentAt < TIME_SYNC_TIMEOUT_MS * 2) return;
+    _inFlight = false;
+    _seq++;
+    if (_burstLeft == 0) {
+      finishBurst();
+      return;
+    }
+  }
+
+  if ((int32_t)(millis() - _nextAt) < 0) return;
+
+  if (_burstLeft == 0) {
+    _burstLeft = TIME_SYNC_BURST;
+    _haveBest = false;
+  }
+  send();
+}
+
+void MeshTimeClient::send() {
+  uint16_t seq = ++_seq;
+  JsonDocument doc;
+  doc["q"] = seq;
+  JsonObject args = doc.as<JsonObject>();
+
+  _inFlight = true;
+  _burstLeft--;
+  _sentAt = millis();
+  perfStats.countOut(PERF_MSG_COMMAND);
+  _swarm->sendCommand(_server, TIME_SYNC_COMMAND, args,
+                      [this, seq](bool success, const String& node, JsonObject& result) {
+                        onResponse(seq, success, result);
+                      },
+                      TIME_SYNC_TIMEOUT_MS);
+}
+
+void MeshTimeClient::onResponse(uint16_t seq, bool success, JsonObject& result) {
+  if (seq != _seq) return;  // Late reply to an exchange that already timed out
+  uint32_t now = millis();
+  uint32_t rtt = now - _sentAt;
+  _inFlight = false;
+
+  if (success && (result["ok"] | false) && (result["q"] | 0) == seq && rtt <= TIME_SYNC_MAX_RTT_MS) {
+    uint64_t serverMs = (uint64_t)(result["s"] | 0UL) * 1000 + (result["ms"] | 0);
+    if (!_haveBest || rtt < _bestRtt) {
+      _haveBest = true;
+      _bestUnixMs = serverMs + rtt / 2;
+      _bestAt = now;
+      _bestRtt = rtt;
+    }
+  }
+
+  if (_burstLeft == 0) {
+    finishBurst();
+  } else {
+    _nextAt = now;  // Next exchange on the following loop tick
+  }
+}
+
+void MeshTimeClient::finishBurst() {
+  if (_haveBest) {
+    _synced = true;
+    _lastRtt = _bestRtt;
+    _syncs++;
+    if (_onSample) _onSample(_bestUnixMs, _bestAt, _bestRtt);
+  } else {
+    _failures++;
+  }
+  _nextAt = millis() + (_synced ? TIME_SYNC_INTERVAL_MS : TIME_SYNC_RETRY_MS);
+}
@@ -0,0 +1,125 @@
+/**
+ * @file MeshTimeSync.h
+ * @brief RTT-compensated time sync over the MeshSwarm command protocol
+ *
+ * Replaces the gateway's "time" shared-state key with a request/response
+ * exchange, NTP-style:
+ *
+ *   client  t0 = millis()  -> timesync {q:<seq>}
+ *   gateway                <- {ok:true, s:<unix sec>, ms:<0-999>, q:<seq>}
+ *   client  t3 = millis(),  rtt = t3 - t0,  time at t3 = server + rtt / 2
+ *
+ * A sync is a short burst of exchanges; the lowest-RTT sample wins, since
+ * it has the least room for queueing asymmetry. Time no longer lives in
+ * the shared state store, so it is not replayed by state sync, versioned,
+ * or stored on every node.
+ *
+ * Gateway:
+ *   MeshTimeSync::serve(swarm, []() { return uplink.isTimeSynced(); });
+ *
+ * Client:
+ *   timeClient.begin(swarm, [](uint64_t unixMs, uint32_t atMillis, uint32_t rttMs) {
+ *     clock.sample(unixMs, atMillis);
+ *   });
+ */
+
+#ifndef MESHSWARM_MESH_TIME_SYNC_H
+#define MESHSWARM_MESH_TIME_SYNC_H
+
+#include <Arduino.h>
+#include <MeshSwarm.h>
+#include <functional>
+
+#ifndef TIME_SYNC_COMMAND
+#define TIME_SYNC_COMMAND "timesync"
+#endif
+
+// Node name of the time server (the gateway)
+#ifndef TIME_SYNC_SERVER
+#define TIME_SYNC_SERVER "Gateway"
+#endif
+
+// Resync interval once locked; DriftClock covers the gap
+#ifndef TIME_SYNC_INTERVAL_MS
+#define TIME_SYNC_INTERVAL_MS 600000  // 10 minutes
+#endif
+
+// Retry interval until the first successful sync
+#ifndef TIME_SYNC_RETRY_MS
+#define TIME_SYNC_RETRY_MS 10000
+#endif
+
+// Exchanges per sync (lowest RTT is kept)
+#ifndef TIME_SYNC_BURST
+#define TIME_SYNC_BURST 3
+#endif
+
+#ifndef TIME_SYNC_TIMEOUT_MS
+#define TIME_SYNC_TIMEOUT_MS 3000
+#endif
+
+// Samples with a longer round trip are discarded
+#ifndef TIME_SYNC_MAX_RTT_MS
+#define TIME_SYNC_MAX_RTT_MS 1500
+#endif
+
+namespace MeshTimeSync {
+
+/**
+ * @brief Answer timesync requests from this node's system clock
+ * @param timeValid Returns true once the system clock holds real time (NTP)
+ */
+void serve(MeshSwarm& swarm, std::function<bool()> timeValid);
+
+}  // namespace MeshTimeSync
+
+class MeshTimeClient {
+public:
+  using SampleHandler = std::function<void(uint64_t unixMs, uint32_t atMillis, uint32_t rttMs)>;
+
+  /**
+   * @brief Start syncing (registers update() on the MeshSwarm loop)
+   * @param onSample Called with the best sample of each burst
+   */
+  void begin(MeshSwarm& swarm, SampleHandler onSample, const char* server = TIME_SYNC_SERVER);
+
+  /**
+   * @brief Start a new burst on the next loop tick
+   */
+  void requestNow() { _nextAt = millis(); }
+
+  void update();
+
+  bool synced() const { return _synced; }
+  uint32_t lastRtt() const { return _lastRtt; }
+  uint32_t syncs() const { return _syncs; }
+  uint32_t failures() const { return _failures; }
+
+private:
+  MeshSwarm* _swarm = nullptr;
+  SampleHandler _onSample;
+  String _server;
+
+  bool _inFlight = false;
+  uint16_t _seq = 0;
+  uint8_t _burstLeft = 0;
+  uint32_t _sentAt = 0;
+  uint32_t _nextAt = 0;
+
+  // Best sample of the current burst
+  bool _haveBest = false;
+  uint64_t _bestUnixMs = 0;
+  uint32_t _bestAt = 0;
+  uint32_t _bestRtt = 0;
+
+  bool _synced = false;
+  uint32_t _lastRtt = 0;
+  uint32_t _syncs = 0;
+  uint32_t _failures = 0;
+
+  void send();
+  void onResponse(uint16_t seq, bool success, JsonObject& result);
+  void finishBurst();
+};
+
+#endif // MESHSWARM_MESH_TIME_SYNC_H
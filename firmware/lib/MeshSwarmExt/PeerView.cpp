@@ -0,0 +1,58 @@
+/**
+ * @file PeerView.cpp
+ * @brief Ordered alive-peer snapshot implementation
+ */
+
+#include "PeerView.h"
+
+uint8_t PeerView::intern(const String& s) {
+  uint8_t index = _names.intern(s.c_str());
+  if (index != MeshProto::NameTable::NONE) return index;
+
+  // Pool full of names no longer listed: start over from the current entries
+  MeshProto::NameTable old = _names;
+  _names.clear();
+  for (Entry& e : _entries) {
+    e.name = _names.intern(old.str(e.name));
+    e.role = _names.intern(old.str(e.role));
+  }
+  for (Entry& e : _scratch) {
+    e.name = _names.intern(old.str(e.name));
+    e.role = _names.intern(old.str(e.role));
+  }
+  return _names.intern(s.c_str());
+}
+
+bool PeerView::refresh(MeshSwarm& swarm) {
+  _scratch.clear();
+  for (auto& kv : swarm.getPeers()) {
+    if (!kv.second.alive) continue;
+    uint8_t name = intern(kv.second.name);
+    uint8_t role = intern(kv.second.role);
+    if (kv.second.name != _names.str(name)) name = intern(kv.second.name);  // Pool was rebuilt
+    _scratch.push_back(Entry{kv.first, name, role});
+  }
+
+  bool changed = _scratch.size() != _entries.size();
+  for (size_t i = 0; !changed && i < _scratch.size(); i++) {
+    const Entry& a = _scratch[i];
+    const Entry& b = _entries[i];
+    changed = a.id != b.id || a.name != b.name || a.role != b.role;
+  }
+  if (!changed) return false;
+
+  _entries.swap(_scratch);
+  _generation++;
+  return true;
+}
+
+int PeerView::indexOf(uint32_t id) const {
+  // Entries are in ascending id order (std::map order)
+  size_t lo = 0, hi = _entries.size();
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (_entries[mid].id < id) lo = mid + 1;
+    else hi = mid;
+  }
+  return (lo < _entries.size() && _entries[lo].id == id) ? (int)lo : -1;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file PeerView.h
+ * @brief Ordered snapshot of alive peers with positional lookup
+ *
+ * MeshSwarm keeps peers in a std::map keyed by node id, so "the Nth alive
+ * peer" means walking the map from the start. PeerView copies the alive
+ * peers into a vector once per refresh() (in node id order, the same order
+ * the map iterates), after which at(index) and page lookups are O(1).
+ *
+ * refresh() reports whether anything visible changed, and generation()
+ * increments when it did, so UI code can skip work on quiet ticks.
+ *
+ * Entries are 6 bytes: names and roles are interned once in a
+ * MeshProto::NameTable (a fleet has a handful of each), so a refresh
+ * compares bytes instead of Strings and copies nothing to the heap.
+ *
+ *   PeerView peers;
+ *   if (peers.refresh(swarm)) redrawList();
+ *   const PeerView::Entry& e = peers.at(page * PER_PAGE + row);
+ *   tft.print(peers.name(e));
+ */
+
+#ifndef MESHSWARM_PEER_VIEW_H
+#define MESHSWARM_PEER_VIEW_H
+
+#include <Arduino.h>
+#include <MeshSwarm.h>
+#include <Membership.h>
+#include <vector>
+
+class PeerView {
+public:
+  struct Entry {
+    uint32_t id;
+    uint8_t name;   // NameTable indexes
+    uint8_t role;
+  };
+
+  /**
+   * @brief Re-read the peer map
+   * @return true if the alive set, order, names or roles changed
+   */
+  bool refresh(MeshSwarm& swarm);
+
+  size_t size() const { return _entries.size(); }
+  bool empty() const { return _entries.empty(); }
+  const Entry& at(size_t index) const { return _entries[index]; }
+  const char* name(const Entry& e) const { return _names.str(e.name); }
+  const char* role(const Entry& e) const { return _names.str(e.role); }
+
+  /**
+   * @brief Number of pages of perPage entries (at least 1)
+   */
+  size_t pageCount(size_t perPage) const {
+    return _entries.empty() ? 1 : (_entries.size() + perPage - 1) / perPage;
+  }
+
+  /**
+   * @brief Position of a node id, or -1
+   */
+  int indexOf(uint32_t id) const;
+
+  uint32_t generation() const { return _generation; }
+
+private:
+  std::vector<Entry> _entries;
+  std::vector<Entry> _scratch;
+  MeshProto::NameTable _names;
+  uint32_t _generation = 0;
+
+  uint8_t intern(const String& s);
+};
+
+#endif // MESHSWARM_PEER_VIEW_H
@@ -0,0 +1,184 @@
+/**
+ * @file PerfStats.cpp
+ * @brief Hot-path counters implementation
+ */
+
+#include "PerfStats.h"
+
+PerfStats perfStats;
+
+// Upper bounds of all but the last histogram bucket
+static const uint32_t HIST_LIMITS_US[PERF_HIST_BUCKETS - 1] = {
+  500, 1000, 2000, 5000, 10000, 20000, 50000
+};
+
+static const char* const TIMER_NAMES[PERF_TIMERS] = { "update", "watcher", "frame" };
+static const char* const MSG_TYPE_NAMES[PERF_MSG_TYPES] = { "state", "cmd" };
+
+void PerfStats::attach(MeshSwarm& swarm) {
+  _swarm = &swarm;
+
+  swarm.onLoop([this]() { update(); });
+
+  swarm.watchState("*", [this](const String& key, const String& value, const String& oldValue) {
+    countIn(PERF_MSG_STATE);
+  });
+
+  swarm.onCommand(PERF_COMMAND, [this](const String& sender, JsonObject& args) {
+    countIn(PERF_MSG_COMMAND);
+    JsonDocument response;
+    JsonObject out = response.to<JsonObject>();
+    if (_windows > 0) toJson(_last, out);  // No window fields until one closes
+    // Node vitals, so the gateway can uplink this node's telemetry from the reply
+    out["uptime"] = millis() / 1000;
+    out["heap_free"] = ESP.getFreeHeap();
+    out["peer_count"] = _swarm->getPeerCount();
+    return response;
+  });
+}
+
+void PerfStats::update() {
+  uint32_t nowUs = micros();
+  uint32_t nowMs = millis();
+
+  if (_windowStart == 0) {
+    // First tick: nothing to measure against yet
+    _windowStart = nowMs;
+    _lastTickUs = nowUs;
+    sampleHeap();
+    return;
+  }
+
+  uint32_t period = nowUs - _lastTickUs;
+  _lastTickUs = nowUs;
+
+  _loops++;
+  _loopTotalUs += period;
+  if (period > _loopMaxUs) _loopMaxUs = period;
+
+  uint8_t bucket = 0;
+  while (bucket < PERF_HIST_BUCKETS - 1 && period >= HIST_LIMITS_US[bucket]) bucket++;
+  _hist[bucket]++;
+
+  if (nowMs - _lastHeapSample >= PERF_HEAP_SAMPLE_MS) sampleHeap();
+  if (nowMs - _windowStart >= PERF_WINDOW_MS) closeWindow(nowMs);
+}
+
+void PerfStats::sampleHeap() {
+  _lastHeapSample = millis();
+  uint32_t block = ESP.getMaxAllocHeap();
+  if (_minBlock == 0 || block < _minBlock) _minBlock = block;
+}
+
+void PerfStats::closeWindow(uint32_t nowMs) {
+  PerfSummary s = {};
+  s.windowMs = nowMs - _windowStart;
+  s.loops = _loops;
+  s.loopAvgUs = _loops > 0 ? (uint32_t)(_loopTotalUs / _loops) : 0;
+  s.loopMaxUs = _loopMaxUs;
+  memcpy(s.timerMaxUs, _timerMax, sizeof(s.timerMaxUs));
+  s.heapMin = ESP.getMinFreeHeap();
+  s.heapMaxBlock = _minBlock;
+  memcpy(s.loopHist, _hist, sizeof(s.loopHist));
+  memcpy(s.msgIn, _msgIn, sizeof(s.msgIn));
+  memcpy(s.msgOut, _msgOut, sizeof(s.msgOut));
+  _last = s;
+  _windows++;
+
+  _windowStart = nowMs;
+  _loops = 0;
+  _loopTotalUs = 0;
+  _loopMaxUs = 0;
+  _minBlock = 0;
+  memset(_hist, 0, sizeof(_hist));
+  memset(_timerMax, 0, sizeof(_timerMax));
+  memset(_msgIn, 0, sizeof(_msgIn));
+  memset(_msgOut, 0, sizeof(_msgOut));
+  sampleHeap();
+
+  if (_swarm) {
+    _swarm->setHeartbeatData("loop_max", s.loopMaxUs);
+    _swarm->setHeartbeatData("heap_min", s.heapMin);
+  }
+}
+
+void PerfStats::print() const {
+  const PerfSummary& s = _last;
+  Serial.println("\n--- PERF ---");
+  if (_windows == 0) {
+    Serial.println("No window closed yet");
+    Serial.println("------------\n");
+    return;
+  }
+  Serial.printf("Window: %lu ms, %lu loops\n", (unsigned long)s.windowMs, (unsigned long)s.loops);
+  Serial.printf("Loop: avg %lu us, max %lu us\n", (unsigned long)s.loopAvgUs, (unsigned long)s.loopMaxUs);
+  Serial.print("Hist (<0.5/1/2/5/10/20/50/more ms):");
+  for (uint8_t i = 0; i < PERF_HIST_BUCKETS; i++) {
+    Serial.printf(" %lu", (unsigned long)s.loopHist[i]);
+  }
+  Serial.println();
+  for (uint8_t i = 0; i < PERF_TIMERS; i++) {
+    Serial.printf("Max %s: %lu us\n", TIMER_NAMES[i], (unsigned long)s.timerMaxUs[i]);
+  }
+  for (uint8_t i = 0; i < PERF_MSG_TYPES; i++) {
+    Serial.printf("Msgs %s: %u in, %u out\n", MSG_TYPE_NAMES[i], s.msgIn[i], s.msgOut[i]);
+  }
+  Serial.printf("Heap: min %lu, largest block %lu\n",
+                (unsigned long)s.heapMin, (unsigned long)s.heapMaxBlock);
+  Serial.println("------------\n");
+}
+
+void PerfStats::toJson(const PerfSummary& s, JsonObject out) {
+  out["win_ms"] = s.windowMs;
+  out["loops"] = s.loops;
+  out["loop_avg_us"] = s.loopAvgUs;
+  out["loop_max_us"] = s.loopMaxUs;
+  out["update_max_us"] = s.timerMaxUs[PERF_UPDATE];
+  out["watcher_max_us"] = s.timerMaxUs[PERF_WATCHERS];
+  out["frame_max_us"] = s.timerMaxUs[PERF_FRAME];
+  out["heap_min"] = s.heapMin;
+  out["heap_max_block"] = s.heapMaxBlock;
+
+  JsonArray hist = out["loop_hist"].to<JsonArray>();
+  for (uint8_t i = 0; i < PERF_HIST_BUCKETS; i++) hist.add(s.loopHist[i]);
+
+  JsonObject in = out["msg_in"].to<JsonObject>();
+  JsonObject sent = out["msg_out"].to<JsonObject>();
+  for (uint8_t i = 0; i < PERF_MSG_TYPES; i++) {
+    in[MSG_TYPE_NAMES[i]] = s.msgIn[i];
+    sent[MSG_TYPE_NAMES[i]] = s.msgOut[i];
+  }
+}
+
+bool PerfStats::fromJson(JsonObjectConst in, PerfSummary& out) {
+  if (!in["win_ms"].is<uint32_t>()) return false;
+
+  out = {};
+  out.windowMs = in["win_ms"];
+  out.loops = in["loops"] | 0UL;
+  out.loopAvgUs = in["loop_avg_us"] | 0UL;
+  out.loopMaxUs = in["loop_max_us"] | 0UL;
+  out.timerMaxUs[PERF_UPDATE] = in["update_max_us"] | 0UL;
+  out.timerMaxUs[PERF_WATCHERS] = in["watcher_max_us"] | 0UL;
+  out.timerMaxUs[PERF_FRAME] = in["frame_max_us"] | 0UL;
+  out.heapMin = in["heap_min"] | 0UL;
+  out.heapMaxBlock = in["heap_max_block"] | 0UL;
+
+  JsonArrayConst hist = in["loop_hist"];
+  for (uint8_t i = 0; i < PERF_HIST_BUCKETS && i < hist.size(); i++) {
+    out.loopHist[i] = hist[i] | 0UL;
+  }
+  for (uint8_t i = 0; i < PERF_MSG_TYPES; i++) {
+    out.msgIn[i] = in["msg_in"][MSG_TYPE_NAMES[i]] | 0;
+    out.msgOut[i] = in["msg_out"][MSG_TYPE_NAMES[i]] | 0;
+  }
+  return true;
+}
+
+const char* PerfStats::timerName(uint8_t timer) {
+  return timer < PERF_TIMERS ? TIMER_NAMES[timer] : "?";
+}
+
+const char* PerfStats::msgTypeName(uint8_t type) {
+  return type < PERF_MSG_TYPES ? MSG_TYPE_NAMES[type] : "?";
+}
@@ -0,0 +1,154 @@
+/**
+ * @file PerfStats.h
+ * @brief Hot-path counters: loop timing, handler timing, message and heap stats
+ *
+ * One global (perfStats) collects, per reporting window:
+ *
+ *   - Loop period histogram, average and max: time between consecutive
+ *     MeshSwarm loop ticks, so a node whose loop() is just swarm.update()
+ *     needs nothing beyond attach()
+ *   - Max time of swarm.update(), state watcher dispatch and display
+ *     frames, recorded with PerfScope where those run
+ *   - State and command messages in and out
+ *   - Lowest free heap since boot and the smallest largest-free-block
+ *     seen in the window (fragmentation)
+ *
+ * Every call on the hot path is an increment or a compare; heap is sampled
+ * once per PERF_HEAP_SAMPLE_MS. When a window closes, last() holds its
+ * summary, the headline numbers go into the heartbeat, and the "perf"
+ * command returns it as JSON with the node's uptime, free heap and peer
+ * count (the gateway pulls it as the node's telemetry).
+ *
+ *   perfStats.attach(swarm);
+ *   ...
+ *   { PerfScope scope(PERF_FRAME); display.render(); }
+ */
+
+#ifndef MESHSWARM_PERF_STATS_H
+#define MESHSWARM_PERF_STATS_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <MeshSwarm.h>
+
+// Reporting window
+#ifndef PERF_WINDOW_MS
+#define PERF_WINDOW_MS 30000
+#endif
+
+// Heap low-water sampling period
+#ifndef PERF_HEAP_SAMPLE_MS
+#define PERF_HEAP_SAMPLE_MS 1000
+#endif
+
+// Command that returns the last window as JSON
+#define PERF_COMMAND "perf"
+
+// Loop histogram buckets: <0.5, <1, <2, <5, <10, <20, <50 ms and the rest
+#define PERF_HIST_BUCKETS 8
+
+enum PerfTimer : uint8_t {
+  PERF_UPDATE,    // swarm.update()
+  PERF_WATCHERS,  // State watcher dispatch
+  PERF_FRAME,     // Display frame
+  PERF_TIMERS
+};
+
+enum PerfMsgType : uint8_t {
+  PERF_MSG_STATE,
+  PERF_MSG_COMMAND,
+  PERF_MSG_TYPES
+};
+
+/**
+ * @brief One closed window (plain data, copied into gateway uplink records)
+ */
+struct PerfSummary {
+  uint32_t windowMs;
+  uint32_t loops;
+  uint32_t loopAvgUs;
+  uint32_t loopMaxUs;
+  uint32_t timerMaxUs[PERF_TIMERS];
+  uint32_t heapMin;        // Lowest free heap since boot
+  uint32_t heapMaxBlock;   // Smallest largest-free-block sampled in the window
+  uint32_t loopHist[PERF_HIST_BUCKETS];
+  uint16_t msgIn[PERF_MSG_TYPES];
+  uint16_t msgOut[PERF_MSG_TYPES];
+};
+
+class PerfStats {
+public:
+  /**
+   * @brief Tick on the MeshSwarm loop, count state changes, serve "perf"
+   */
+  void attach(MeshSwarm& swarm);
+
+  /**
+   * @brief Loop tick (called by attach(); call directly if not attached)
+   */
+  void update();
+
+  void record(PerfTimer timer, uint32_t us) {
+    if (us > _timerMax[timer]) _timerMax[timer] = us;
+  }
+
+  void countIn(PerfMsgType type, uint16_t n = 1) { _msgIn[type] += n; }
+  void countOut(PerfMsgType type, uint16_t n = 1) { _msgOut[type] += n; }
+
+  /**
+   * @brief Last closed window (all zero until the first one closes)
+   */
+  const PerfSummary& last() const { return _last; }
+  uint32_t windows() const { return _windows; }
+
+  /**
+   * @brief Print the last window to Serial
+   */
+  void print() const;
+
+  static void toJson(const PerfSummary& s, JsonObject out);
+  static bool fromJson(JsonObjectConst in, PerfSummary& out);
+
+  static const char* timerName(uint8_t timer);
+  static const char* msgTypeName(uint8_t type);
+
+private:
+  void sampleHeap();
+  void closeWindow(uint32_t nowMs);
+
+  MeshSwarm* _swarm = nullptr;
+
+  uint32_t _lastTickUs = 0;
+  uint32_t _windowStart = 0;
+  uint32_t _lastHeapSample = 0;
+
+  // Current window
+  uint32_t _loops = 0;
+  uint64_t _loopTotalUs = 0;
+  uint32_t _loopMaxUs = 0;
+  uint32_t _hist[PERF_HIST_BUCKETS] = {0};
+  uint32_t _timerMax[PERF_TIMERS] = {0};
+  uint32_t _minBlock = 0;
+  uint16_t _msgIn[PERF_MSG_TYPES] = {0};
+  uint16_t _msgOut[PERF_MSG_TYPES] = {0};
+
+  PerfSummary _last = {};
+  uint32_t _windows = 0;
+};
+
+extern PerfStats perfStats;
+
+/**
+ * @brief Records the lifetime of the scope into one PerfStats timer
+ */
+class PerfScope {
+public:
+  explicit PerfScope(PerfTimer timer) : _timer(timer), _start(micros()) {}
+  ~PerfScope() { perfStats.record(_timer, micros() - _start); }
+
+private:
+  PerfTimer _timer;
+  uint32_t _start;
+};
+
+#endif // MESHSWARM_PERF_STATS_H
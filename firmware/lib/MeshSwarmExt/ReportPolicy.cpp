@@ -0,0 +1,60 @@
+/**
+ * @file ReportPolicy.cpp
+ * @brief Sensor report policy implementation
+ */
+
+#include "ReportPolicy.h"
+
+ReportPolicy::ReportPolicy(float deadband, unsigned long minIntervalMs,
+                           unsigned long maxIntervalMs, float smoothing,
+                           float hysteresis)
+  : _deadband(deadband)
+  , _minIntervalMs(minIntervalMs)
+  , _maxIntervalMs(maxIntervalMs)
+  , _smoothing(smoothing > 0.0f && smoothing <= 1.0f ? smoothing : 1.0f)
+  , _hysteresis(hysteresis)
+{
+}
+
+void ReportPolicy::reset() {
+  _smoothed = NAN;
+  _reported = NAN;
+  _direction = 0;
+}
+
+bool ReportPolicy::update(float reading, unsigned long now) {
+  if (isnan(reading)) return false;
+
+  if (isnan(_smoothed)) {
+    _smoothed = reading;
+  } else {
+    _smoothed += _smoothing * (reading - _smoothed);
+  }
+
+  bool send;
+  int8_t direction = 0;
+  if (isnan(_reported)) {
+    send = true;  // First value always goes out
+  } else {
+    float change = _smoothed - _reported;
+    direction = change > 0.0f ? 1 : (change < 0.0f ? -1 : 0);
+    float needed = _deadband;
+    if (direction != 0 && direction == -_direction) needed += _hysteresis;
+
+    bool changed = fabsf(change) >= needed && direction != 0;
+    unsigned long since = now - _sentAt;
+    send = (changed && since >= _minIntervalMs) ||
+           (_maxIntervalMs > 0 && since >= _maxIntervalMs);
+  }
+
+  if (!send) {
+    _suppressed++;
+    return false;
+  }
+
+  if (direction != 0) _direction = direction;
+  _reported = _smoothed;
+  _sentAt = now;
+  _sent++;
+  return true;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file ReportPolicy.h
+ * @brief Decides when a sensor value is worth publishing
+ *
+ * One policy per published value. Feed every reading to update(); it
+ * returns true when the (optionally smoothed) value should go out, and
+ * value() is then the number to publish. A reading is sent when:
+ *
+ *   - it moved at least `deadband` from the last sent value
+ *     (deadband + `hysteresis` if it reverses the last direction, so a
+ *     value hovering at an edge does not flip back and forth), and
+ *     at least `minIntervalMs` passed since the last send; or
+ *   - `maxIntervalMs` passed since the last send (refresh, 0 = never).
+ *
+ * A change held back by minIntervalMs is sent on the first update()
+ * after the interval, so rate limiting delays updates but never drops
+ * the final value.
+ *
+ *   ReportPolicy temp(0.5f, 10000, 300000, 0.5f);
+ *   if (temp.update(reading)) publish(temp.value());
+ */
+
+#ifndef MESHSWARM_REPORT_POLICY_H
+#define MESHSWARM_REPORT_POLICY_H
+
+#include <Arduino.h>
+
+class ReportPolicy {
+public:
+  /**
+   * @param deadband Smallest change worth sending (same unit as the value)
+   * @param minIntervalMs Shortest time between sends
+   * @param maxIntervalMs Resend an unchanged value after this long (0 = never)
+   * @param smoothing EMA weight of a new reading, 0 < a <= 1 (1 = off)
+   * @param hysteresis Extra change needed to reverse direction
+   */
+  ReportPolicy(float deadband, unsigned long minIntervalMs = 0,
+               unsigned long maxIntervalMs = 0, float smoothing = 1.0f,
+               float hysteresis = 0.0f);
+
+  /**
+   * @brief Feed a reading
+   * @return true if value() should be published now (counted as sent)
+   */
+  bool update(float reading, unsigned long now);
+  bool update(float reading) { return update(reading, millis()); }
+
+  /**
+   * @brief Smoothed value (what update() decided on)
+   */
+  float value() const { return _smoothed; }
+
+  /**
+   * @brief Last value reported as sent (NAN before the first)
+   */
+  float reported() const { return _reported; }
+
+  /**
+   * @brief Forget history; the next reading is sent unconditionally
+   */
+  void reset();
+
+  uint32_t sent() const { return _sent; }
+  uint32_t suppressed() const { return _suppressed; }
+
+private:
+  float _deadband;
+  unsigned long _minIntervalMs;
+  unsigned long _maxIntervalMs;
+  float _smoothing;
+  float _hysteresis;
+
+  float _smoothed = NAN;
+  float _reported = NAN;
+  int8_t _direction = 0;        // Sign of the last sent change
+  unsigned long _sentAt = 0;
+  uint32_t _sent = 0;
+  uint32_t _suppressed = 0;
+};
+
+#endif // MESHSWARM_REPORT_POLICY_H
@@ -0,0 +1,88 @@
+/**
+ * @file StateBatch.cpp
+ * @brief State write coalescing implementation
+ */
+
+#include "StateBatch.h"
+#include "PerfStats.h"
+
+// setStates() takes a braced list, so groups are sent in fixed-size chunks
+static const size_t SET_STATES_GROUP = 4;
+
+void StateBatch::attach() {
+  _swarm.onLoop([this]() { update(); });
+}
+
+void StateBatch::enableAutoFlush(unsigned long windowMs) {
+  _autoFlush = true;
+  _windowMs = windowMs;
+}
+
+void StateBatch::disableAutoFlush() {
+  _autoFlush = false;
+  if (_depth == 0) flush();
+}
+
+void StateBatch::commit() {
+  if (_depth == 0) return;
+  _depth--;
+  if (_depth == 0 && !_autoFlush) flush();
+}
+
+void StateBatch::set(const String& key, const String& value) {
+  _writes++;
+
+  if (_depth == 0 && !_autoFlush) {
+    _swarm.setState(key, value);
+    _messages++;
+    perfStats.countOut(PERF_MSG_STATE);
+    return;
+  }
+
+  for (size_t i = 0; i < _count; i++) {
+    if (_staged[i].key == key) {
+      _staged[i].value = value;
+      return;
+    }
+  }
+
+  if (_count >= STATE_BATCH_MAX_KEYS) flush();
+  if (_count == 0) _firstWriteAt = millis();
+  _staged[_count].key = key;
+  _staged[_count].value = value;
+  _count++;
+}
+
+void StateBatch::flush() {
+  for (size_t i = 0; i < _count; i += SET_STATES_GROUP) {
+    size_t n = _count - i;
+    send(i, n < SET_STATES_GROUP ? n : SET_STATES_GROUP);
+  }
+  _count = 0;
+}
+
+void StateBatch::update() {
+  if (!_autoFlush || _depth > 0 || _count == 0) return;
+  if (millis() - _firstWriteAt >= _windowMs) flush();
+}
+
+void StateBatch::send(size_t start, size_t n) {
+  const Staged* s = &_staged[start];
+  switch (n) {
+    case 1:
+      _swarm.setState(s[0].key, s[0].value);
+      break;
+    case 2:
+      _swarm.setStates({{s[0].key, s[0].value}, {s[1].key, s[1].value}});
+      break;
+    case 3:
+      _swarm.setStates({{s[0].key, s[0].value}, {s[1].key, s[1].value}, {s[2].key, s[2].value}});
+      break;
+    default:
+      _swarm.setStates({{s[0].key, s[0].value}, {s[1].key, s[1].value},
+                        {s[2].key, s[2].value}, {s[3].key, s[3].value}});
+      break;
+  }
+  _messages++;
+  perfStats.countOut(PERF_MSG_STATE);
+}
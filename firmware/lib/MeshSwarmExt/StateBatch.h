@@ -0,0 +1,98 @@
+/**
+ * @file StateBatch.h
+ * @brief Coalesces state writes into one MSG_STATE_SET
+ *
+ * Sensor nodes often publish a base key and its zone variant together
+ * ("light" + "light_<zone>"). Routing those writes through a StateBatch
+ * merges them into one swarm.setStates() broadcast, last writer wins per key.
+ *
+ * Two ways to batch:
+ *
+ *   Explicit scope:
+ *     batch.beginBatch();
+ *     batch.set("temp", t);
+ *     batch.set(zoneKey, t);
+ *     batch.commit();            // one broadcast
+ *
+ *   Automatic window (attach() + enableAutoFlush(ms)):
+ *     every set() is staged and flushed on the first loop tick
+ *     at least ms after the first staged write (0 = next tick)
+ *
+ * Outside a scope with auto flush disabled, set() writes through.
+ */
+
+#ifndef MESHSWARM_STATE_BATCH_H
+#define MESHSWARM_STATE_BATCH_H
+
+#include <Arduino.h>
+#include <MeshSwarm.h>
+
+// Keys staged before a batch is flushed early
+#ifndef STATE_BATCH_MAX_KEYS
+#define STATE_BATCH_MAX_KEYS 8
+#endif
+
+class StateBatch {
+public:
+  explicit StateBatch(MeshSwarm& swarm) : _swarm(swarm) {}
+
+  /**
+   * @brief Register update() on the MeshSwarm loop (needed for auto flush)
+   */
+  void attach();
+
+  /**
+   * @brief Stage every set() and flush after windowMs (0 = next loop tick)
+   */
+  void enableAutoFlush(unsigned long windowMs = 0);
+  void disableAutoFlush();
+
+  /**
+   * @brief Open a batch scope (nestable; the outermost commit() flushes)
+   */
+  void beginBatch() { _depth++; }
+
+  /**
+   * @brief Close a batch scope
+   */
+  void commit();
+
+  /**
+   * @brief Write a key, staged if a scope or auto flush is active
+   */
+  void set(const String& key, const String& value);
+
+  /**
+   * @brief Send staged writes now
+   */
+  void flush();
+
+  /**
+   * @brief Flush when the auto flush window has elapsed
+   */
+  void update();
+
+  size_t pending() const { return _count; }
+  uint32_t writes() const { return _writes; }
+  uint32_t messages() const { return _messages; }
+
+private:
+  struct Staged {
+    String key;
+    String value;
+  };
+
+  MeshSwarm& _swarm;
+  Staged _staged[STATE_BATCH_MAX_KEYS];
+  size_t _count = 0;
+  uint8_t _depth = 0;
+  bool _autoFlush = false;
+  unsigned long _windowMs = 0;
+  unsigned long _firstWriteAt = 0;
+  uint32_t _writes = 0;
+  uint32_t _messages = 0;
+
+  void send(size_t start, size_t n);
+};
+
+#endif // MESHSWARM_STATE_BATCH_H
@@ -0,0 +1,127 @@
+/**
+ * @file StateCache.cpp
+ * @brief Hash-indexed state cache implementation
+ */
+
+#include "StateCache.h"
+#include <string.h>
+
+const uint16_t StateCache::NONE;
+
+uint32_t StateCache::hashKey(const char* key, size_t len) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= (uint8_t)key[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// Bucket holding the key, or the empty bucket where it would go
+uint16_t StateCache::probe(const char* key, size_t len, uint32_t hash) const {
+  size_t mask = _table.size() - 1;
+  for (size_t i = hash & mask;; i = (i + 1) & mask) {
+    uint16_t slot = _table[i];
+    if (slot == NONE) return (uint16_t)i;
+    const Item& item = _items[slot];
+    if (item.hash == hash && item.key.length() == len && memcmp(item.key.c_str(), key, len) == 0) {
+      return (uint16_t)i;
+    }
+  }
+}
+
+void StateCache::rehash(size_t buckets) {
+  _table.assign(buckets, NONE);
+  for (size_t slot = 0; slot < _items.size(); slot++) {
+    const Item& item = _items[slot];
+    if (item.key.length() == 0) continue;  // Free slot
+    _table[probe(item.key.c_str(), item.key.length(), item.hash)] = (uint16_t)slot;
+  }
+}
+
+uint16_t StateCache::find(const String& key) const {
+  if (_table.empty()) return NONE;
+  return _table[probe(key.c_str(), key.length(), hashKey(key.c_str(), key.length()))];
+}
+
+uint16_t StateCache::set(const String& key, const String& value, uint32_t origin) {
+  uint32_t hash = hashKey(key.c_str(), key.length());
+
+  if (!_table.empty()) {
+    uint16_t slot = _table[probe(key.c_str(), key.length(), hash)];
+    if (slot != NONE) {
+      Item& item = _items[slot];
+      item.origin = origin;
+      if (item.value != value) {
+        item.value = value;
+        item.updatedAt = millis();
+        item.changes++;
+        _version++;
+      }
+      return slot;
+    }
+  }
+
+  uint16_t slot;
+  if (!_free.empty()) {
+    // Reuse a removed slot; its change counter carries on so rows showing it redraw
+    slot = _free.back();
+    _free.pop_back();
+    Item& item = _items[slot];
+    item.key = key;
+    item.value = value;
+    item.origin = origin;
+    item.updatedAt = millis();
+    item.changes++;
+    item.hash = hash;
+  } else {
+    if (_items.size() >= STATE_CACHE_MAX_KEYS) return NONE;
+
+    // Keep the table at most half full
+    if ((_items.size() + 1) * 2 > _table.size()) {
+      rehash(_table.empty() ? 32 : _table.size() * 2);
+    }
+
+    slot = (uint16_t)_items.size();
+    _items.push_back(Item{key, value, origin, (uint32_t)millis(), 1, hash});
+  }
+  _table[probe(key.c_str(), key.length(), hash)] = slot;
+  _version++;
+  return slot;
+}
+
+uint16_t StateCache::remove(const String& key) {
+  if (_table.empty()) return NONE;
+  size_t mask = _table.size() - 1;
+  size_t hole = probe(key.c_str(), key.length(), hashKey(key.c_str(), key.length()));
+  uint16_t slot = _table[hole];
+  if (slot == NONE) return NONE;
+
+  // Backward-shift deletion: pull later entries of the probe run into the
+  // hole, so lookups never need tombstones
+  for (size_t i = (hole + 1) & mask; _table[i] != NONE; i = (i + 1) & mask) {
+    size_t home = _items[_table[i]].hash & mask;
+    // Movable unless its home lies cyclically in (hole, i]
+    bool stays = hole <= i ? (home > hole && home <= i) : (home > hole || home <= i);
+    if (stays) continue;
+    _table[hole] = _table[i];
+    hole = i;
+  }
+  _table[hole] = NONE;
+
+  Item& item = _items[slot];
+  item.key = String();
+  item.value = String();
+  item.updatedAt = millis();
+  item.changes++;
+  _free.push_back(slot);
+  _version++;
+  return slot;
+}
+
+void StateCache::clear() {
+  _items.clear();
+  _table.clear();
+  _free.clear();
+  _version++;
+}
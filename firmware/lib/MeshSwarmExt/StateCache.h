@@ -0,0 +1,100 @@
+/**
+ * @file StateCache.h
+ * @brief Hash-indexed local copy of mesh state with stable slots
+ *
+ * Keeps every key/value seen through watchState() in first-seen order.
+ * A key's slot index never changes until it is removed or the cache is
+ * cleared, so UI code can hold a slot instead of searching by key. A
+ * removed key (deleted or expired upstream, delivered as an empty value)
+ * frees its slot for the next new key. Lookups go through an open-addressing
+ * hash table (FNV-1a, linear probing) over the slots, so set() and find()
+ * cost one hash plus, on average, about one String compare, whatever the
+ * number of keys.
+ *
+ * Every item carries a change counter; compare it against a cached copy
+ * to tell whether a slot changed without comparing strings.
+ *
+ *   StateCache cache;
+ *   swarm.watchState("*", [](const String& key, const String& value, const String& old) {
+ *     if (value.length() == 0) cache.remove(key);
+ *     else cache.set(key, value);
+ *   });
+ *   uint16_t slot = cache.find("temp");
+ *   if (slot != StateCache::NONE) Serial.println(cache.at(slot).value);
+ */
+
+#ifndef MESHSWARM_STATE_CACHE_H
+#define MESHSWARM_STATE_CACHE_H
+
+#include <Arduino.h>
+#include <vector>
+
+// Keys kept before set() starts refusing new ones
+#ifndef STATE_CACHE_MAX_KEYS
+#define STATE_CACHE_MAX_KEYS 512
+#endif
+
+class StateCache {
+public:
+  static const uint16_t NONE = 0xFFFF;
+
+  struct Item {
+    String key;
+    String value;
+    uint32_t origin;
+    uint32_t updatedAt;   // millis() of the last change
+    uint16_t changes;     // Incremented on every value change
+    uint32_t hash;
+  };
+
+  /**
+   * @brief Insert or update a key
+   * @return The key's slot, or NONE if the cache is full
+   */
+  uint16_t set(const String& key, const String& value, uint32_t origin = 0);
+
+  /**
+   * @brief Drop a key; its slot is reused by a later new key
+   * @return The freed slot, or NONE if the key was unknown
+   */
+  uint16_t remove(const String& key);
+
+  /**
+   * @brief Slot of a key, or NONE
+   */
+  uint16_t find(const String& key) const;
+
+  const Item& at(uint16_t slot) const { return _items[slot]; }
+
+  /**
+   * @brief A key lives in this slot (false once removed; key is then empty)
+   */
+  bool used(uint16_t slot) const { return slot < _items.size() && _items[slot].key.length() > 0; }
+
+  // Slots handed out so far (used or free), and keys currently held
+  size_t size() const { return _items.size(); }
+  size_t count() const { return _items.size() - _free.size(); }
+  bool empty() const { return count() == 0; }
+
+  /**
+   * @brief Drop all keys (invalidates every slot)
+   */
+  void clear();
+
+  /**
+   * @brief Incremented on every set() or remove() that changed something
+   */
+  uint32_t version() const { return _version; }
+
+private:
+  std::vector<Item> _items;
+  std::vector<uint16_t> _table;   // Slot per bucket, NONE = empty; size is a power of two
+  std::vector<uint16_t> _free;    // Removed slots, reused first
+  uint32_t _version = 0;
+
+  static uint32_t hashKey(const char* key, size_t len);
+  uint16_t probe(const char* key, size_t len, uint32_t hash) const;
+  void rehash(size_t buckets);
+};
+
+#endif // MESHSWARM_STATE_CACHE_H
@@ -0,0 +1,137 @@
+/**
+ * @file StateWatchers.cpp
+ * @brief Prefix-indexed state watcher dispatch implementation
+ */
+
+#include "StateWatchers.h"
+#include "PerfStats.h"
+#include <algorithm>
+#include <string.h>
+
+// Compare a stored prefix with the first len characters of key
+static int comparePrefix(const String& prefix, const char* key, size_t len) {
+  int cmp = strncmp(prefix.c_str(), key, len);
+  if (cmp != 0) return cmp;
+  return prefix.length() > len ? 1 : 0;
+}
+
+void StateWatchers::attach(MeshSwarm& swarm) {
+  swarm.watchState("*", [this](const String& key, const String& value, const String& oldValue) {
+    dispatch(key, value, oldValue);
+  });
+}
+
+void StateWatchers::on(const char* pattern, Callback cb) {
+  if (!pattern || !cb) return;
+  if (_depth > 0) {
+    // The index is being walked; inserting would move the watchers under it
+    _pending.push_back({String(pattern), cb});
+    return;
+  }
+  add(pattern, cb);
+}
+
+void StateWatchers::add(const char* pattern, Callback cb) {
+  Watcher w;
+  w.order = _nextOrder++;
+  w.cb = cb;
+
+  const char* wild = strpbrk(pattern, "*?");
+  if (!wild) {
+    w.prefix = pattern;
+    insertSorted(_exact, std::move(w));
+    return;
+  }
+
+  size_t len = wild - pattern;
+  w.prefix = String(pattern).substring(0, len);
+  // "prefix*" needs no further check; anything else is matched as a glob
+  if (!(wild[0] == '*' && wild[1] == '\0')) w.glob = pattern;
+  insertSorted(_prefixed, std::move(w));
+
+  auto it = std::lower_bound(_prefixLengths.begin(), _prefixLengths.end(), (uint16_t)len);
+  if (it == _prefixLengths.end() || *it != len) _prefixLengths.insert(it, (uint16_t)len);
+}
+
+void StateWatchers::dispatch(const String& key, const String& value, const String& oldValue) {
+  PerfScope scope(PERF_WATCHERS);
+  _dispatched++;
+
+  // Local, not a member: a callback that writes state dispatches again
+  Matches matched;
+  const char* k = key.c_str();
+  size_t keyLen = key.length();
+
+  collect(_exact, k, keyLen, false, matched);
+  for (uint16_t len : _prefixLengths) {
+    if (len > keyLen) break;
+    collect(_prefixed, k, len, true, matched);
+  }
+
+  if (matched.count == 0) return;
+  if (matched.count > 1) {
+    std::sort(matched.begin(), matched.end(),
+              [](const Watcher* a, const Watcher* b) { return a->order < b->order; });
+  }
+
+  _depth++;
+  for (const Watcher* w : matched) {
+    w->cb(key, value, oldValue);
+    _delivered++;
+  }
+  _depth--;
+
+  if (_depth == 0 && !_pending.empty()) {
+    std::vector<PendingOn> pending;
+    pending.swap(_pending);
+    for (PendingOn& p : pending) add(p.pattern.c_str(), p.cb);
+  }
+}
+
+void StateWatchers::Matches::push(const Watcher* w) {
+  if (count < STATE_WATCHERS_INLINE_MATCHES) {
+    inline_[count++] = w;
+    return;
+  }
+  if (spill.empty()) spill.assign(inline_, inline_ + count);
+  spill.push_back(w);
+  count++;
+}
+
+void StateWatchers::insertSorted(std::vector<Watcher>& list, Watcher&& w) {
+  auto it = std::upper_bound(list.begin(), list.end(), w,
+                             [](const Watcher& a, const Watcher& b) { return a.prefix < b.prefix; });
+  list.insert(it, std::move(w));
+}
+
+void StateWatchers::collect(const std::vector<Watcher>& list, const char* key, size_t len, bool checkGlob,
+                            Matches& out) {
+  auto it = std::lower_bound(list.begin(), list.end(), len,
+                             [key](const Watcher& w, size_t n) { return comparePrefix(w.prefix, key, n) < 0; });
+  for (; it != list.end() && comparePrefix(it->prefix, key, len) == 0; ++it) {
+    if (checkGlob && it->glob.length() > 0 && !globMatch(it->glob.c_str(), key)) continue;
+    out.push(&*it);
+  }
+}
+
+bool StateWatchers::globMatch(const char* pattern, const char* text) {
+  const char* star = nullptr;
+  const char* resume = nullptr;
+
+  while (*text) {
+    if (*pattern == '?' || *pattern == *text) {
+      pattern++;
+      text++;
+    } else if (*pattern == '*') {
+      star = pattern++;
+      resume = text;
+    } else if (star) {
+      pattern = star + 1;
+      text = ++resume;
+    } else {
+      return false;
+    }
+  }
+  while (*pattern == '*') pattern++;
+  return *pattern == '\0';
+}
@@ -0,0 +1,98 @@
+/**
+ * @file StateWatchers.h
+ * @brief Prefix-indexed state watcher dispatch on top of MeshSwarm
+ *
+ * Replaces the watchState("*") + startsWith() chains in node code with
+ * pattern watchers:
+ *
+ *   watchers.on("temp", ...);          exact key
+ *   watchers.on("temp_*", ...);        prefix
+ *   watchers.on("light_*_state", ...); glob ('*' and '?'), indexed by its literal prefix
+ *   watchers.on("*", ...);             every key (same as watchState("*"))
+ *
+ * Exact keys and literal prefixes live in sorted vectors. A state change
+ * costs one binary search per distinct prefix length plus the callbacks
+ * that actually match, instead of one call per wildcard lambda.
+ * Callbacks fire in registration order.
+ *
+ * MeshSwarm sees a single "*" watcher (registered by attach()).
+ * Callbacks may write state (dispatch re-enters) and call on(); patterns
+ * registered from a callback take effect once the outermost dispatch returns.
+ */
+
+#ifndef MESHSWARM_STATE_WATCHERS_H
+#define MESHSWARM_STATE_WATCHERS_H
+
+#include <Arduino.h>
+#include <MeshSwarm.h>
+#include <functional>
+#include <vector>
+
+// Matches dispatch() collects on the stack before spilling to the heap
+#ifndef STATE_WATCHERS_INLINE_MATCHES
+#define STATE_WATCHERS_INLINE_MATCHES 8
+#endif
+
+class StateWatchers {
+public:
+  using Callback = std::function<void(const String& key, const String& value, const String& oldValue)>;
+
+  /**
+   * @brief Route MeshSwarm state changes through this index
+   */
+  void attach(MeshSwarm& swarm);
+
+  /**
+   * @brief Register a watcher for an exact key, prefix ("temp_*") or glob
+   */
+  void on(const char* pattern, Callback cb);
+
+  /**
+   * @brief Invoke every watcher whose pattern matches key
+   */
+  void dispatch(const String& key, const String& value, const String& oldValue);
+
+  size_t size() const { return _exact.size() + _prefixed.size(); }
+  uint32_t dispatched() const { return _dispatched; }
+  uint32_t delivered() const { return _delivered; }
+
+private:
+  struct Watcher {
+    String prefix;       // Exact key, or literal text before the first wildcard
+    String glob;         // Full pattern when it has wildcards past a trailing '*'
+    uint16_t order;
+    Callback cb;
+  };
+
+  std::vector<Watcher> _exact;            // Sorted by prefix
+  std::vector<Watcher> _prefixed;         // Sorted by prefix
+  std::vector<uint16_t> _prefixLengths;   // Distinct prefix lengths, ascending
+  struct Matches {
+    const Watcher* inline_[STATE_WATCHERS_INLINE_MATCHES];
+    std::vector<const Watcher*> spill;
+    size_t count = 0;
+
+    void push(const Watcher* w);
+    const Watcher** begin() { return spill.empty() ? inline_ : spill.data(); }
+    const Watcher** end() { return begin() + count; }
+  };
+
+  struct PendingOn {
+    String pattern;
+    Callback cb;
+  };
+
+  std::vector<PendingOn> _pending;        // on() calls made during dispatch
+  uint8_t _depth = 0;                     // Nested dispatch() calls in progress
+  uint16_t _nextOrder = 0;
+  uint32_t _dispatched = 0;
+  uint32_t _delivered = 0;
+
+  static void insertSorted(std::vector<Watcher>& list, Watcher&& w);
+  static bool globMatch(const char* pattern, const char* text);
+  void add(const char* pattern, Callback cb);
+  static void collect(const std::vector<Watcher>& list, const char* key, size_t len, bool checkGlob,
+                      Matches& out);
+};
+
+#endif // MESHSWARM_STATE_WATCHERS_H
@@ -0,0 +1,70 @@
+/**
+ * @file UrgentState.cpp
+ * @brief Stamped actuator writes and latency recording
+ */
+
+#include "UrgentState.h"
+#include "PerfStats.h"
+
+namespace {
+
+uint32_t meshTimeUs(MeshSwarm& swarm) {
+  return (uint32_t)swarm.getMesh().getNodeTime();
+}
+
+}  // namespace
+
+// ---- UrgentState ----
+
+bool UrgentState::set(const String& key, const String& value) {
+  if (!_swarm) return false;
+  String stamp((unsigned long)meshTimeUs(*_swarm));
+  String stampKey = key + URGENT_STAMP_SUFFIX;
+  _writes++;
+  perfStats.countOut(PERF_MSG_STATE);
+#ifdef MESHSWARM_LANES
+  return _swarm->setStates({{key, value}, {stampKey, stamp}}, MeshProto::LANE_CONTROL);
+#else
+  return _swarm->setStates({{key, value}, {stampKey, stamp}});
+#endif
+}
+
+bool UrgentState::isStamp(const String& key) {
+  return key.endsWith(URGENT_STAMP_SUFFIX);
+}
+
+// ---- LatencyWatch ----
+
+void LatencyWatch::begin(MeshSwarm& swarm, const String& key, SampleHandler onSample) {
+  _swarm = &swarm;
+  _key = key;
+  _onSample = onSample;
+  swarm.watchState(key + URGENT_STAMP_SUFFIX,
+                   [this](const String& k, const String& value, const String& oldValue) { onStamp(value); });
+}
+
+void LatencyWatch::onStamp(const String& value) {
+  if (value.length() == 0) return;  // Key deleted or expired
+  uint32_t stamp = strtoul(value.c_str(), nullptr, 10);
+
+  // Node time is kept in step across the mesh, but not exactly: a stamp a
+  // little in the future is a fast delivery; further out is an old stamp
+  // that wrapped
+  int32_t us = (int32_t)(meshTimeUs(*_swarm) - stamp);
+  uint32_t ms = us > 0 ? (uint32_t)us / 1000 : 0;
+  if (ms > URGENT_LATENCY_MAX_MS || us < -(int32_t)URGENT_LATENCY_MAX_MS * 1000) {
+    _stale++;
+    return;
+  }
+
+  _last = ms;
+  _stats.add(ms);
+  if (_onSample) _onSample(ms);
+}
+
+void LatencyWatch::print() const {
+  Serial.printf("[LAT] %s: %lu samples, last %lu ms, avg %lu ms, p50 <%lu ms, p95 <%lu ms, max %lu ms, %lu stale\n",
+                _key.c_str(), (unsigned long)_stats.count, (unsigned long)_last,
+                (unsigned long)_stats.avgMs(), (unsigned long)_stats.percentileMs(50),
+                (unsigned long)_stats.percentileMs(95), (unsigned long)_stats.maxMs, (unsigned long)_stale);
+}
@@ -0,0 +1,94 @@
+/**
+ * @file UrgentState.h
+ * @brief Stamped actuator writes and end-to-end latency at the receiver
+ *
+ * UrgentState::set() writes an actuator key together with a companion stamp
+ * key in one swarm.setStates() message:
+ *
+ *   {"led":"1", "led_t":"<sender mesh time, us>"}
+ *
+ * With a lane-aware MeshSwarm (MESHSWARM_LANES, see MeshSwarmProto/SendLanes.h)
+ * the message goes on the control lane, ahead of state sync, telemetry and
+ * OTA chunks. Without one it is an ordinary set, and the stamp still lets
+ * the receiver measure what the press costs today.
+ *
+ * LatencyWatch on the receiving node watches the stamp key and records
+ * mesh time now minus the stamp, using painlessMesh's synchronised node
+ * time, so both ends read the same clock:
+ *
+ *   Button:  urgent.begin(swarm);  urgent.set("led", newLed);
+ *   LED:     ledLatency.begin(swarm, "led");   // ledLatency.stats().percentileMs(95)
+ *
+ * A stamp older than URGENT_LATENCY_MAX_MS is a value replayed by a join
+ * sync, not a press, and is skipped. Nodes that join within that window of
+ * a press record the replay as one long sample.
+ */
+
+#ifndef MESHSWARM_URGENT_STATE_H
+#define MESHSWARM_URGENT_STATE_H
+
+#include <Arduino.h>
+#include <MeshSwarm.h>
+#include <SendLanes.h>
+#include <functional>
+
+// Companion key suffix carrying the sender's mesh time
+#ifndef URGENT_STAMP_SUFFIX
+#define URGENT_STAMP_SUFFIX "_t"
+#endif
+
+// Older stamps are replays, not latency
+#ifndef URGENT_LATENCY_MAX_MS
+#define URGENT_LATENCY_MAX_MS 30000
+#endif
+
+class UrgentState {
+public:
+  void begin(MeshSwarm& swarm) { _swarm = &swarm; }
+
+  /**
+   * @brief Write key and its stamp in one message, on the control lane if MeshSwarm has lanes
+   */
+  bool set(const String& key, const String& value);
+
+  uint32_t writes() const { return _writes; }
+
+  /**
+   * @brief True for a companion stamp key (what bulk senders yield to)
+   */
+  static bool isStamp(const String& key);
+
+private:
+  MeshSwarm* _swarm = nullptr;
+  uint32_t _writes = 0;
+};
+
+class LatencyWatch {
+public:
+  using SampleHandler = std::function<void(uint32_t ms)>;
+
+  /**
+   * @brief Record the delay of every stamped write of key
+   * @param onSample Called with each accepted sample (optional)
+   */
+  void begin(MeshSwarm& swarm, const String& key, SampleHandler onSample = nullptr);
+
+  const MeshProto::LatencyStats& stats() const { return _stats; }
+  uint32_t last() const { return _last; }
+  uint32_t stale() const { return _stale; }
+  void clear() { _stats.clear(); }
+
+  void print() const;
+
+private:
+  MeshSwarm* _swarm = nullptr;
+  String _key;
+  SampleHandler _onSample;
+  MeshProto::LatencyStats _stats;
+  uint32_t _last = 0;
+  uint32_t _stale = 0;
+
+  void onStamp(const String& value);
+};
+
+#endif // MESHSWARM_URGENT_STATE_H
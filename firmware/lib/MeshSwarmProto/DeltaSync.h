@@ -0,0 +1,315 @@
+/**
+ * @file DeltaSync.h
+ * @brief Digest-based delta state sync for MeshSwarm shared state
+ *
+ * Replaces "broadcast everything" on join with a two-message exchange:
+ *
+ *   joiner    -> MSG_STATE_DIGEST  {t:7, n:<count>, d:<base64 (hash,version,origin)...>}
+ *   responder -> MSG_STATE_DELTA   {t:8, s:[[key,value,version,origin],...], w:<base64 hashes>, end:1}
+ *   joiner    -> MSG_STATE_DELTA   {t:8, s:[...]}           (only the keys listed in w)
+ *
+ * The digest carries each key's (version, origin) pair, which is the
+ * per-key version vector MeshSwarm already resolves conflicts with
+ * (higher version wins, lower origin breaks ties). The responder sends only
+ * entries the joiner lacks or holds an older copy of, split into messages
+ * of at most DELTA_MSG_MAX_BYTES, and lists in "w" the keys where the
+ * joiner is ahead. A digest with "full":1 (too many keys to summarize)
+ * tells the responder to fall back to the existing MSG_STATE_SYNC.
+ *
+ * The engine is transport-agnostic: it reads any map of key -> entry
+ * where the entry exposes .value, .version and .origin (MeshSwarm's
+ * StateEntry), and hands finished JsonDocuments to a send callback.
+ */
+
+#ifndef MESHSWARM_DELTA_SYNC_H
+#define MESHSWARM_DELTA_SYNC_H
+
+#include <ArduinoJson.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "ProtoUtil.h"
+
+// Above this many keys the digest is skipped in favour of a full sync
+#ifndef DELTA_DIGEST_MAX_KEYS
+#define DELTA_DIGEST_MAX_KEYS 128
+#endif
+
+// Upper bound per delta message (matches JSON_MSG_STATE_SYNC_SIZE)
+#ifndef DELTA_MSG_MAX_BYTES
+#define DELTA_MSG_MAX_BYTES 1024
+#endif
+
+namespace MeshProto {
+
+const uint8_t MSG_STATE_DIGEST = 7;
+const uint8_t MSG_STATE_DELTA  = 8;
+
+struct DigestItem {
+  uint32_t hash;
+  uint32_t version;
+  uint32_t origin;
+};
+
+/**
+ * @class StateDigest
+ * @brief Sorted (hash, version, origin) summary of a state map
+ */
+class StateDigest {
+public:
+  static const size_t ITEM_BYTES = 12;
+
+  /**
+   * @brief Collect the digest of a local state map
+   */
+  template <typename Map>
+  void collect(const Map& state) {
+    _items.clear();
+    _full = false;
+    _items.reserve(state.size());
+    for (const auto& kv : state) {
+      _items.push_back({ keyHash(kv.first.c_str()), kv.second.version, kv.second.origin });
+    }
+    sort();
+  }
+
+  /**
+   * @brief Write a MSG_STATE_DIGEST message for a local state map
+   * @return false if the state was too large and "full" was requested instead
+   */
+  template <typename Map>
+  bool build(const Map& state, JsonObject msg, size_t maxKeys = DELTA_DIGEST_MAX_KEYS) {
+    msg["t"] = MSG_STATE_DIGEST;
+    if (state.size() > maxKeys) {
+      msg["full"] = 1;
+      return false;
+    }
+
+    collect(state);
+    std::vector<uint8_t> raw(_items.size() * ITEM_BYTES);
+    for (size_t i = 0; i < _items.size(); i++) {
+      putU32(&raw[i * ITEM_BYTES], _items[i].hash);
+      putU32(&raw[i * ITEM_BYTES + 4], _items[i].version);
+      putU32(&raw[i * ITEM_BYTES + 8], _items[i].origin);
+    }
+    std::vector<char> text(base64Length(raw.size()) + 1);
+    base64Encode(raw.data(), raw.size(), text.data());
+
+    msg["n"] = _items.size();
+    msg["d"] = text.data();
+    return true;
+  }
+
+  /**
+   * @brief Decode a received MSG_STATE_DIGEST
+   * @return false if the sender asked for a full sync or the digest is malformed
+   */
+  bool parse(JsonObjectConst msg) {
+    _items.clear();
+    _full = msg["full"] | 0;
+    if (_full) return false;
+
+    size_t n = msg["n"] | 0;
+    const char* text = msg["d"] | "";
+    // n is off the wire: bound it before allocating (a digest never holds
+    // more keys than build() sends, or than its text decodes to)
+    if (n > DELTA_DIGEST_MAX_KEYS || n * ITEM_BYTES > strlen(text) * 3 / 4) {
+      _full = true;
+      return false;
+    }
+    std::vector<uint8_t> raw(n * ITEM_BYTES);
+    if (n > 0 && base64Decode(text, raw.data(), raw.size()) != raw.size()) {
+      _full = true;
+      return false;
+    }
+
+    _items.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+      const uint8_t* p = &raw[i * ITEM_BYTES];
+      _items.push_back({ getU32(p), getU32(p + 4), getU32(p + 8) });
+    }
+    sort();
+    return true;
+  }
+
+  bool wantsFull() const { return _full; }
+  size_t size() const { return _items.size(); }
+  const std::vector<DigestItem>& items() const { return _items; }
+
+  /**
+   * @brief Binary search by key hash
+   */
+  const DigestItem* find(uint32_t hash) const {
+    auto it = std::lower_bound(_items.begin(), _items.end(), hash,
+                               [](const DigestItem& d, uint32_t h) { return d.hash < h; });
+    return (it != _items.end() && it->hash == hash) ? &*it : nullptr;
+  }
+
+private:
+  std::vector<DigestItem> _items;
+  bool _full = false;
+
+  void sort() {
+    std::sort(_items.begin(), _items.end(),
+              [](const DigestItem& a, const DigestItem& b) { return a.hash < b.hash; });
+  }
+};
+
+/**
+ * @class DeltaWriter
+ * @brief Packs state entries into size-bounded MSG_STATE_DELTA messages
+ */
+template <typename Send>
+class DeltaWriter {
+public:
+  DeltaWriter(Send& send, size_t maxBytes) : _send(send), _maxBytes(maxBytes) { start(); }
+
+  void add(const char* key, const char* value, uint32_t version, uint32_t origin) {
+    JsonArray e = _entries.add<JsonArray>();
+    e.add(key);
+    e.add(value);
+    e.add(version);
+    e.add(origin);
+    _count++;
+    _total++;
+
+    if (_count > 1 && measureJson(_doc) > _maxBytes) {
+      // Move the entry that overflowed into the next message
+      _entries.remove(_count - 1);
+      _count--;
+      _total--;
+      emit();
+      add(key, value, version, origin);
+    }
+  }
+
+  /**
+   * @brief Send the last message, optionally listing wanted key hashes
+   */
+  void finish(const std::vector<uint32_t>* wants = nullptr) {
+    if (wants && !wants->empty()) {
+      std::vector<uint8_t> raw(wants->size() * 4);
+      for (size_t i = 0; i < wants->size(); i++) putU32(&raw[i * 4], (*wants)[i]);
+      std::vector<char> text(base64Length(raw.size()) + 1);
+      base64Encode(raw.data(), raw.size(), text.data());
+      _doc["w"] = text.data();
+    }
+    _doc["end"] = 1;
+    emit();
+  }
+
+  size_t total() const { return _total; }
+  size_t messages() const { return _messages; }
+
+private:
+  Send& _send;
+  size_t _maxBytes;
+  JsonDocument _doc;
+  JsonArray _entries;
+  size_t _count = 0;
+  size_t _total = 0;
+  size_t _messages = 0;
+
+  void start() {
+    _doc.clear();
+    _doc["t"] = MSG_STATE_DELTA;
+    _entries = _doc["s"].to<JsonArray>();
+    _count = 0;
+  }
+
+  void emit() {
+    _send(_doc);
+    _messages++;
+    start();
+  }
+};
+
+/**
+ * @brief Responder side: send what the peer is missing, ask for what it has newer
+ * @param state  Local state map (key -> entry with value/version/origin)
+ * @param peer   Parsed digest from the joining node
+ * @param send   Callable taking JsonDocument& (e.g. mesh.sendSingle(serialize))
+ * @return Number of entries sent
+ */
+template <typename Map, typename Send>
+size_t sendDelta(const Map& state, const StateDigest& peer, Send send,
+                 size_t maxBytes = DELTA_MSG_MAX_BYTES) {
+  DeltaWriter<Send> writer(send, maxBytes);
+
+  StateDigest local;
+  local.collect(state);
+
+  for (const auto& kv : state) {
+    const DigestItem* theirs = peer.find(keyHash(kv.first.c_str()));
+    if (!theirs || isNewer(kv.second.version, kv.second.origin, theirs->version, theirs->origin)) {
+      writer.add(kv.first.c_str(), kv.second.value.c_str(), kv.second.version, kv.second.origin);
+    }
+  }
+
+  // Keys the peer has that we lack or hold an older copy of
+  std::vector<uint32_t> wants;
+  for (const DigestItem& theirs : peer.items()) {
+    const DigestItem* mine = local.find(theirs.hash);
+    if (!mine || isNewer(theirs.version, theirs.origin, mine->version, mine->origin)) {
+      wants.push_back(theirs.hash);
+    }
+  }
+
+  writer.finish(&wants);
+  return writer.total();
+}
+
+/**
+ * @brief Joiner side: apply entries from a MSG_STATE_DELTA
+ * @param apply Callable (const char* key, const char* value, uint32_t version, uint32_t origin);
+ *              it should apply MeshSwarm's usual conflict rule and fire watchers
+ * @return Number of entries in the message
+ */
+template <typename Apply>
+size_t applyDelta(JsonObjectConst msg, Apply apply) {
+  size_t n = 0;
+  for (JsonArrayConst e : msg["s"].as<JsonArrayConst>()) {
+    apply(e[0].as<const char*>(), e[1].as<const char*>(), e[2].as<uint32_t>(), e[3].as<uint32_t>());
+    n++;
+  }
+  return n;
+}
+
+/**
+ * @brief Extract the "w" list of wanted key hashes from a MSG_STATE_DELTA
+ */
+inline bool parseWants(JsonObjectConst msg, std::vector<uint32_t>& hashes) {
+  hashes.clear();
+  const char* text = msg["w"] | "";
+  size_t len = strlen(text);
+  if (len == 0) return false;
+
+  std::vector<uint8_t> raw((len / 4) * 3);
+  size_t bytes = base64Decode(text, raw.data(), raw.size());
+  for (size_t i = 0; i + 4 <= bytes; i += 4) hashes.push_back(getU32(&raw[i]));
+  std::sort(hashes.begin(), hashes.end());
+  return !hashes.empty();
+}
+
+/**
+ * @brief Joiner side: answer the responder's "w" list with those entries
+ * @return Number of entries sent
+ */
+template <typename Map, typename Send>
+size_t sendWanted(const Map& state, const std::vector<uint32_t>& hashes, Send send,
+                  size_t maxBytes = DELTA_MSG_MAX_BYTES) {
+  if (hashes.empty()) return 0;
+
+  DeltaWriter<Send> writer(send, maxBytes);
+  for (const auto& kv : state) {
+    if (std::binary_search(hashes.begin(), hashes.end(), keyHash(kv.first.c_str()))) {
+      writer.add(kv.first.c_str(), kv.second.value.c_str(), kv.second.version, kv.second.origin);
+    }
+  }
+  writer.finish();
+  return writer.total();
+}
+
+}  // namespace MeshProto
+
+#endif // MESHSWARM_DELTA_SYNC_H
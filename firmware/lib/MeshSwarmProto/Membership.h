@@ -0,0 +1,356 @@
+/**
+ * @file Membership.h
+ * @brief Scalable membership: adaptive heartbeats, gossip digest, compact peers
+ *
+ * Every MeshSwarm node floods a heartbeat every 5 s, so the mesh carries
+ * N heartbeats per interval over ~N hops each: O(N^2) airtime that grows
+ * faster than anything else as nodes are added. Three changes bring the
+ * per-node rate down without slowing joins:
+ *
+ *   Adaptive   HeartbeatPacer doubles the interval after each heartbeat up to
+ *              HEARTBEAT_MAX_MS and drops back to HEARTBEAT_MIN_MS when a new
+ *              peer shows up (Trickle). Each heartbeat announces the interval
+ *              ("hb", seconds); peers time a node out after HEARTBEAT_MISSES
+ *              of its own intervals, not a fixed 15 s.
+ *   Piggyback  Any message from a peer is a sign of life (PeerTable::heard()),
+ *              and a node that broadcast anything within its interval skips
+ *              the heartbeat. Chatty sensors rarely heartbeat at all.
+ *   Gossip     Each heartbeat carries the heartbeat counters of up to
+ *              GOSSIP_PEERS other peers, rotating ("m", 6 bytes each). A peer
+ *              whose own heartbeat was lost on the way still counts as alive
+ *              when a neighbour reports a newer counter for it.
+ *
+ *   {"t":1,"name":"PIR","role":"PEER","up":..,"peers":..,"states":..,
+ *    "hb":20,"s":117,"m":"<base64 (id u32, seq u16) x n>"}
+ *
+ * Peers live in a PeerTable: one 16-byte record per node in a sorted vector,
+ * with names and roles interned in a shared pool (a fleet has a handful of
+ * distinct node names and two roles), instead of a std::map node with two
+ * Strings each.
+ *
+ * Nodes still running the fixed schedule time peers out after 15 s, so raise
+ * HEARTBEAT_MAX_MS above 5000 only once every node understands "hb".
+ */
+
+#ifndef MESHSWARM_MEMBERSHIP_H
+#define MESHSWARM_MEMBERSHIP_H
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "ProtoUtil.h"
+
+// Heartbeat interval range; the interval doubles while membership is stable
+#ifndef HEARTBEAT_MIN_MS
+#define HEARTBEAT_MIN_MS 5000
+#endif
+
+#ifndef HEARTBEAT_MAX_MS
+#define HEARTBEAT_MAX_MS 30000
+#endif
+
+// Announced intervals a peer may miss before it is marked dead
+#ifndef HEARTBEAT_MISSES
+#define HEARTBEAT_MISSES 3
+#endif
+
+// Peer counters carried per heartbeat (0 = no gossip)
+#ifndef GOSSIP_PEERS
+#define GOSSIP_PEERS 4
+#endif
+
+// Bytes for interned peer names and roles (including terminators)
+#ifndef PEER_NAME_POOL
+#define PEER_NAME_POOL 256
+#endif
+
+// Dead peers are kept (shown as not alive) this long, then forgotten
+#ifndef PEER_FORGET_MS
+#define PEER_FORGET_MS 600000
+#endif
+
+namespace MeshProto {
+
+/**
+ * @brief Small string pool: each distinct string is stored once, named by a byte
+ */
+class NameTable {
+public:
+  static const uint8_t NONE = 0xFF;
+
+  /**
+   * @return Index of s, added if new; NONE if the pool is full
+   */
+  uint8_t intern(const char* s) {
+    for (uint8_t i = 0; i < _count; i++) {
+      if (strcmp(_pool + _offsets[i], s) == 0) return i;
+    }
+    size_t len = strlen(s) + 1;
+    if (_count >= NONE || _used + len > PEER_NAME_POOL) return NONE;
+    _offsets[_count] = (uint16_t)_used;
+    memcpy(_pool + _used, s, len);
+    _used += len;
+    return _count++;
+  }
+
+  const char* str(uint8_t index) const { return index < _count ? _pool + _offsets[index] : "?"; }
+  uint8_t count() const { return _count; }
+  size_t used() const { return _used; }
+  void clear() { _count = 0; _used = 0; }
+
+private:
+  char _pool[PEER_NAME_POOL];
+  uint16_t _offsets[NONE];
+  uint8_t _count = 0;
+  size_t _used = 0;
+};
+
+struct PeerRecord {
+  uint32_t id;
+  uint32_t lastSeen;     // millis() of the last sign of life
+  uint16_t seq;          // Its heartbeat counter (gossip compares these)
+  uint8_t intervalS;     // Announced heartbeat interval; 0 = fixed schedule
+  uint8_t name;          // NameTable indexes
+  uint8_t role;
+  bool alive;
+
+  uint32_t timeoutMs() const {
+    uint32_t interval = intervalS ? intervalS * 1000UL : HEARTBEAT_MIN_MS;
+    return HEARTBEAT_MISSES * interval;
+  }
+};
+
+class PeerTable {
+public:
+  static const size_t GOSSIP_ITEM_BYTES = 6;
+
+  /**
+   * @brief A heartbeat from id
+   * @param intervalMs Announced interval, 0 for a node on the fixed schedule
+   * @return true if id is new or back from dead (it may not know us yet)
+   */
+  bool heartbeat(uint32_t id, const char* name, const char* role, uint16_t seq, uint32_t intervalMs,
+                 uint32_t now) {
+    auto it = lowerBound(id);
+    bool fresh = it == _peers.end() || it->id != id;
+    if (fresh) {
+      PeerRecord rec = {};
+      rec.id = id;
+      it = _peers.insert(it, rec);
+    }
+    PeerRecord& p = *it;
+    uint8_t nameIndex = intern(name);
+    uint8_t roleIndex = intern(role);
+    if (strcmp(_names.str(nameIndex), name) != 0) nameIndex = intern(name);  // Pool was rebuilt
+    bool arrived = fresh || !p.alive;
+    bool changed = arrived || p.name != nameIndex || p.role != roleIndex;
+    p.name = nameIndex;
+    p.role = roleIndex;
+    p.seq = seq;
+    uint32_t s = intervalMs / 1000;
+    p.intervalS = (uint8_t)(s > 255 ? 255 : s);
+    p.lastSeen = now;
+    p.alive = true;
+    if (changed) _generation++;
+    return arrived;
+  }
+
+  /**
+   * @brief Any other message from id: liveness for a known peer
+   * @return true if id is a known, alive peer
+   */
+  bool heard(uint32_t id, uint32_t now) {
+    auto it = lowerBound(id);
+    if (it == _peers.end() || it->id != id || !it->alive) return false;
+    it->lastSeen = now;
+    return true;
+  }
+
+  /**
+   * @brief Mark peers dead after HEARTBEAT_MISSES silent intervals; forget old dead ones
+   * @return Peers that died in this call
+   */
+  size_t expire(uint32_t now) {
+    size_t died = 0;
+    for (auto it = _peers.begin(); it != _peers.end();) {
+      uint32_t silent = now - it->lastSeen;
+      if (it->alive && silent > it->timeoutMs()) {
+        it->alive = false;
+        died++;
+        _generation++;
+      }
+      if (!it->alive && silent > PEER_FORGET_MS) {
+        it = _peers.erase(it);
+        _generation++;
+      } else {
+        ++it;
+      }
+    }
+    return died;
+  }
+
+  const PeerRecord* find(uint32_t id) const {
+    auto it = std::lower_bound(_peers.begin(), _peers.end(), id,
+                               [](const PeerRecord& p, uint32_t v) { return p.id < v; });
+    return it != _peers.end() && it->id == id ? &*it : nullptr;
+  }
+
+  // Records in id order (alive and recently dead)
+  const std::vector<PeerRecord>& records() const { return _peers; }
+  const char* name(const PeerRecord& p) const { return _names.str(p.name); }
+  const char* role(const PeerRecord& p) const { return _names.str(p.role); }
+
+  size_t aliveCount() const {
+    size_t n = 0;
+    for (const PeerRecord& p : _peers) n += p.alive ? 1 : 0;
+    return n;
+  }
+
+  /**
+   * @brief Lowest alive id, or 0 if no peer is alive
+   */
+  uint32_t lowestAlive() const {
+    for (const PeerRecord& p : _peers) {
+      if (p.alive) return p.id;
+    }
+    return 0;
+  }
+
+  /**
+   * @brief Bumped when a peer joins, dies, is forgotten or changes name/role
+   */
+  uint32_t generation() const { return _generation; }
+
+  // ---- Gossip ----
+
+  /**
+   * @brief Write (id, seq) for up to maxItems alive peers, continuing the rotation
+   * @param out At least maxItems * GOSSIP_ITEM_BYTES bytes
+   * @return Items written
+   */
+  size_t writeGossip(uint8_t* out, size_t maxItems) {
+    size_t n = 0;
+    size_t total = _peers.size();
+    for (size_t k = 0; k < total && n < maxItems; k++) {
+      const PeerRecord& p = _peers[(_gossipAt + k) % total];
+      if (!p.alive) continue;
+      putU32(out + n * GOSSIP_ITEM_BYTES, p.id);
+      out[n * GOSSIP_ITEM_BYTES + 4] = (uint8_t)(p.seq >> 8);
+      out[n * GOSSIP_ITEM_BYTES + 5] = (uint8_t)p.seq;
+      n++;
+      if (n == maxItems) _gossipAt = (_gossipAt + k + 1) % total;
+    }
+    return n;
+  }
+
+  /**
+   * @brief Apply a neighbour's gossip: a newer counter than ours means the peer is alive
+   * @param fresh Called with the id of each peer refreshed this way
+   * @return Items that refreshed a peer
+   */
+  template <typename Fn>
+  size_t readGossip(const uint8_t* data, size_t len, uint32_t now, Fn&& fresh) {
+    size_t refreshed = 0;
+    for (size_t off = 0; off + GOSSIP_ITEM_BYTES <= len; off += GOSSIP_ITEM_BYTES) {
+      uint32_t id = getU32(data + off);
+      uint16_t seq = (uint16_t)((data[off + 4] << 8) | data[off + 5]);
+      auto it = lowerBound(id);
+      // Only peers we have a record for; a newer counter proves a heartbeat we missed.
+      // A dead peer's counter stops, so gossip can't keep it alive.
+      if (it == _peers.end() || it->id != id || (int16_t)(seq - it->seq) <= 0) continue;
+      it->seq = seq;
+      it->lastSeen = now;
+      if (!it->alive) {
+        it->alive = true;
+        _generation++;
+      }
+      refreshed++;
+      fresh(id);
+    }
+    return refreshed;
+  }
+
+private:
+  std::vector<PeerRecord> _peers;   // Sorted by id
+  NameTable _names;
+  uint32_t _generation = 0;
+  size_t _gossipAt = 0;
+
+  std::vector<PeerRecord>::iterator lowerBound(uint32_t id) {
+    return std::lower_bound(_peers.begin(), _peers.end(), id,
+                            [](const PeerRecord& p, uint32_t v) { return p.id < v; });
+  }
+
+  // Full pool: rebuild it from the names still referenced, then retry
+  uint8_t intern(const char* s) {
+    uint8_t index = _names.intern(s);
+    if (index != NameTable::NONE) return index;
+
+    NameTable old = _names;
+    _names.clear();
+    for (PeerRecord& p : _peers) {
+      p.name = _names.intern(old.str(p.name));
+      p.role = _names.intern(old.str(p.role));
+    }
+    return _names.intern(s);
+  }
+};
+
+/**
+ * @brief When to heartbeat: Trickle-style doubling, reset by membership changes
+ */
+class HeartbeatPacer {
+public:
+  void begin(uint32_t now, uint32_t minMs = HEARTBEAT_MIN_MS, uint32_t maxMs = HEARTBEAT_MAX_MS) {
+    _min = minMs;
+    _max = maxMs < minMs ? minMs : maxMs;
+    _interval = _min;
+    _lastBeat = now;
+    _lastSpoke = now;
+  }
+
+  /**
+   * @brief A heartbeat is due: silent for the interval, or none sent for HEARTBEAT_MAX_MS
+   *
+   * Other broadcasts carry liveness but not names, roles or gossip, so a
+   * heartbeat still goes out at least every max interval.
+   */
+  bool due(uint32_t now) const {
+    return now - _lastSpoke >= _interval || now - _lastBeat >= _max;
+  }
+
+  /**
+   * @brief A heartbeat was sent; the next interval doubles (announce interval() in it)
+   */
+  void sent(uint32_t now) {
+    _lastBeat = now;
+    _lastSpoke = now;
+    _interval = _interval * 2 > _max ? _max : _interval * 2;
+  }
+
+  /**
+   * @brief Any other broadcast was sent (peers count it as a sign of life)
+   */
+  void spoke(uint32_t now) { _lastSpoke = now; }
+
+  /**
+   * @brief Membership changed: back to the shortest interval so newcomers learn us fast
+   *
+   * Nodes heartbeat at random phases, so a join doesn't make them all send at once.
+   */
+  void unsettle() { _interval = _min; }
+
+  uint32_t interval() const { return _interval; }
+
+private:
+  uint32_t _min = HEARTBEAT_MIN_MS;
+  uint32_t _max = HEARTBEAT_MAX_MS;
+  uint32_t _interval = HEARTBEAT_MIN_MS;
+  uint32_t _lastBeat = 0;
+  uint32_t _lastSpoke = 0;
+};
+
+}  // namespace MeshProto
+
+#endif // MESHSWARM_MEMBERSHIP_H
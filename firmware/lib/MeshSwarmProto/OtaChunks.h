@@ -0,0 +1,274 @@
+/**
+ * @file OtaChunks.h
+ * @brief Broadcast OTA building blocks: image offer, chunk bitmap, gap ranges
+ *
+ * One image is sent once to every node of a type, and each node asks only
+ * for what it missed:
+ *
+ *   sender   -> offer  {s:<session>, r:<round>, role, hw, md5, size, cs:<chunk bytes>, n:<chunks>, f:<force>,
+ *                       enc:<encoding>, isize:<image bytes>, base:<running image md5>}
+ *   receiver -> report {s, id, st:<state>, got:<received>, n, g:[[first,count],...], e:<why it failed>}
+ *   sender   -> chunk  {s, i:<index>, d:<base64>}               (broadcast, no reply)
+ *
+ * Every round opens with the offer, which doubles as "report now": nodes
+ * that joined late or rebooted pick the session up there, and the rest
+ * say what the previous round left missing.
+ *
+ * Receivers keep a ChunkMap (one bit per chunk, 300 bytes for a 1.2 MB
+ * image), which is small enough to persist so a session resumes after a
+ * reboot. A report lists the first OTA_REPORT_MAX_RANGES missing ranges.
+ * The sender folds every report into one ChunkMap of chunks to resend, so
+ * a chunk that several nodes lost goes out once per round.
+ *
+ * With enc set, the chunks are OtaPatch.h segments rather than raw image
+ * bytes: size and n describe the encoded stream, isize and md5 the image it
+ * decodes to. A delta (enc 2) only applies on nodes running base.
+ */
+
+#ifndef MESHSWARM_OTA_CHUNKS_H
+#define MESHSWARM_OTA_CHUNKS_H
+
+#include <ArduinoJson.h>
+#include <string.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Payload per chunk: 512 bytes is ~700 chars of base64, which keeps a
+// chunk message inside the 1 KB bound the other MeshSwarm messages use
+#ifndef OTA_CHUNK_BYTES
+#define OTA_CHUNK_BYTES 512
+#endif
+
+// Missing ranges per report; the rest follow in later rounds
+#ifndef OTA_REPORT_MAX_RANGES
+#define OTA_REPORT_MAX_RANGES 16
+#endif
+
+// Report "e" (why a node failed) is at most OTA_ERROR_LEN - 1 chars
+#define OTA_ERROR_LEN 24
+
+namespace MeshProto {
+
+// Receiver states carried in report "st"
+const char* const OTA_ST_RECEIVING = "downloading";
+const char* const OTA_ST_VERIFYING = "verifying";
+const char* const OTA_ST_COMPLETED = "completed";
+const char* const OTA_ST_FAILED    = "failed";
+const char* const OTA_ST_CURRENT   = "skipped";  // Already running this image
+
+// Offer "enc"
+enum OtaEncoding : uint8_t {
+  OTA_ENC_RAW        = 0,  // Chunks are image bytes
+  OTA_ENC_COMPRESSED = 1,  // OtaPatch.h segments without base copies
+  OTA_ENC_DELTA      = 2   // OtaPatch.h segments against the running image
+};
+
+inline bool otaStateFinal(const char* st) {
+  return st && (strcmp(st, OTA_ST_COMPLETED) == 0 || strcmp(st, OTA_ST_FAILED) == 0 ||
+                strcmp(st, OTA_ST_CURRENT) == 0);
+}
+
+/**
+ * @brief Image being distributed (the offer message)
+ */
+struct OtaOffer {
+  uint32_t session = 0;       // Server update id
+  std::string role;           // NODE_TYPE the image is for
+  std::string hardware;       // "ESP32"
+  std::string md5;            // Hex MD5 of the whole image
+  uint32_t size = 0;          // Bytes sent in chunks (the image, unless encoded)
+  uint16_t chunkBytes = OTA_CHUNK_BYTES;
+  uint16_t chunks = 0;
+  bool force = false;         // Install even if the node already runs this MD5
+  uint16_t round = 0;         // Sender's round counter, not part of the image
+  uint8_t encoding = OTA_ENC_RAW;
+  uint32_t imageSize = 0;     // Decoded image bytes
+  std::string baseMd5;        // Image a delta applies to
+
+  static uint16_t chunkCount(uint32_t size, uint16_t chunkBytes) {
+    return chunkBytes ? (uint16_t)((size + chunkBytes - 1) / chunkBytes) : 0;
+  }
+
+  uint16_t chunkLength(uint16_t index) const {
+    uint32_t start = (uint32_t)index * chunkBytes;
+    if (start >= size) return 0;
+    return (uint16_t)(size - start < chunkBytes ? size - start : chunkBytes);
+  }
+
+  void toJson(JsonObject out) const {
+    out["s"] = session;
+    out["r"] = round;
+    out["role"] = role.c_str();
+    out["hw"] = hardware.c_str();
+    out["md5"] = md5.c_str();
+    out["size"] = size;
+    out["cs"] = chunkBytes;
+    out["n"] = chunks;
+    if (force) out["f"] = 1;
+    if (encoding != OTA_ENC_RAW) {
+      out["enc"] = encoding;
+      out["isize"] = imageSize;
+    }
+    if (encoding == OTA_ENC_DELTA) out["base"] = baseMd5.c_str();
+  }
+
+  /**
+   * @return false if fields are missing or inconsistent
+   */
+  bool fromJson(JsonObjectConst in) {
+    session = in["s"] | 0UL;
+    role = in["role"] | "";
+    hardware = in["hw"] | "ESP32";
+    md5 = in["md5"] | "";
+    size = in["size"] | 0UL;
+    chunkBytes = in["cs"] | 0;
+    chunks = in["n"] | 0;
+    force = (in["f"] | 0) != 0;
+    round = in["r"] | 0;
+    encoding = in["enc"] | 0;
+    imageSize = encoding == OTA_ENC_RAW ? size : (in["isize"] | 0UL);
+    baseMd5 = in["base"] | "";
+    if (encoding > OTA_ENC_DELTA || imageSize == 0) return false;
+    if (encoding == OTA_ENC_DELTA && baseMd5.size() != 32) return false;
+    return session != 0 && !role.empty() && md5.size() == 32 && size > 0 &&
+           chunkBytes > 0 && chunks == chunkCount(size, chunkBytes);
+  }
+
+  bool sameImage(const OtaOffer& o) const {
+    return session == o.session && md5 == o.md5 && size == o.size && chunkBytes == o.chunkBytes &&
+           encoding == o.encoding;
+  }
+};
+
+typedef std::pair<uint16_t, uint16_t> ChunkRange;  // (first, count)
+
+/**
+ * @brief One bit per chunk with a running count of set bits
+ */
+class ChunkMap {
+public:
+  void reset(uint16_t chunks) {
+    _n = chunks;
+    _set = 0;
+    _bits.assign((chunks + 7) / 8, 0);
+  }
+
+  uint16_t size() const { return _n; }
+  uint16_t count() const { return _set; }
+  bool complete() const { return _n > 0 && _set == _n; }
+  bool empty() const { return _set == 0; }
+
+  bool has(uint16_t i) const { return i < _n && (_bits[i >> 3] & (1 << (i & 7))); }
+
+  /**
+   * @return true if the bit was newly set
+   */
+  bool set(uint16_t i) {
+    if (i >= _n || has(i)) return false;
+    _bits[i >> 3] |= (uint8_t)(1 << (i & 7));
+    _set++;
+    return true;
+  }
+
+  void clear(uint16_t i) {
+    if (!has(i)) return;
+    _bits[i >> 3] &= (uint8_t)~(1 << (i & 7));
+    _set--;
+  }
+
+  void setRange(uint16_t first, uint16_t count) {
+    for (uint32_t i = first; i < (uint32_t)first + count && i < _n; i++) set((uint16_t)i);
+  }
+
+  void setAll() { setRange(0, _n); }
+
+  /**
+   * @brief First set bit at or after from, or size() if none
+   */
+  uint16_t next(uint16_t from) const {
+    for (uint32_t i = from; i < _n; i++) {
+      if (!(i & 7) && _bits[i >> 3] == 0) { i += 7; continue; }
+      if (has((uint16_t)i)) return (uint16_t)i;
+    }
+    return _n;
+  }
+
+  /**
+   * @brief Ranges of clear bits, at most maxRanges
+   * @return true if every missing chunk is listed
+   */
+  bool missing(std::vector<ChunkRange>& out, size_t maxRanges) const {
+    out.clear();
+    uint32_t i = 0;
+    while (i < _n) {
+      if (has((uint16_t)i)) { i++; continue; }
+      uint32_t first = i;
+      while (i < _n && !has((uint16_t)i)) i++;
+      if (out.size() == maxRanges) return false;
+      out.push_back(ChunkRange((uint16_t)first, (uint16_t)(i - first)));
+    }
+    return true;
+  }
+
+  // Raw bits for persistence
+  const uint8_t* data() const { return _bits.data(); }
+  size_t bytes() const { return _bits.size(); }
+
+  /**
+   * @brief Load bits saved from data(); fails on a size mismatch
+   */
+  bool restore(uint16_t chunks, const uint8_t* data, size_t len) {
+    reset(chunks);
+    if (len != _bits.size()) return false;
+    for (size_t b = 0; b < len; b++) {
+      _bits[b] = data[b];
+      for (uint8_t m = data[b]; m; m &= (uint8_t)(m - 1)) _set++;
+    }
+    // Ignore stray bits past the last chunk
+    for (uint32_t i = _n; i < _bits.size() * 8; i++) {
+      if (_bits[i >> 3] & (1 << (i & 7))) {
+        _bits[i >> 3] &= (uint8_t)~(1 << (i & 7));
+        _set--;
+      }
+    }
+    return true;
+  }
+
+private:
+  std::vector<uint8_t> _bits;
+  uint16_t _n = 0;
+  uint16_t _set = 0;
+};
+
+/**
+ * @brief Write ranges as [[first,count],...]
+ */
+inline void writeRanges(JsonArray out, const std::vector<ChunkRange>& ranges) {
+  for (const ChunkRange& r : ranges) {
+    JsonArray pair = out.add<JsonArray>();
+    pair.add(r.first);
+    pair.add(r.second);
+  }
+}
+
+/**
+ * @brief Mark every chunk in a report's ranges
+ * @return Number of chunks named, clamped to the map
+ */
+inline uint32_t readRanges(JsonArrayConst ranges, ChunkMap& into) {
+  uint32_t named = 0;
+  for (JsonArrayConst pair : ranges) {
+    uint32_t first = pair[0] | 0UL;
+    uint32_t count = pair[1] | 0UL;
+    if (first >= into.size() || count == 0) continue;
+    if (count > (uint32_t)into.size() - first) count = into.size() - first;
+    into.setRange((uint16_t)first, (uint16_t)count);
+    named += count;
+  }
+  return named;
+}
+
+}  // namespace MeshProto
+
+#endif // MESHSWARM_OTA_CHUNKS_H
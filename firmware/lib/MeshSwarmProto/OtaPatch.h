@@ -0,0 +1,216 @@
+/**
+ * @file OtaPatch.h
+ * @brief Compressed and delta OTA images, decoded one chunk at a time
+ *
+ * Broadcast chunks arrive in any order and some only in a later round, so a
+ * single compressed stream would stall on the first gap. Instead every chunk
+ * is a self-contained segment that rebuilds a known range of the image:
+ *
+ *   segment = varint(offset) varint(length) op... [zero padding to the chunk size]
+ *
+ *   op byte  kk LLLLLL   L = 1..63 is the length, L = 0 means a varint length follows
+ *     kk=0  literal   L bytes follow
+ *     kk=1  backref   varint distance into this segment's last OTA_PATCH_WINDOW bytes
+ *     kk=2  base      zigzag varint (source - output offset) into the running image
+ *     kk=3  run       one byte follows, repeated L times
+ *
+ * Base copies make a delta image: unchanged code is a few bytes per run,
+ * however far it moved. Without a running image (compressed only) the
+ * encoder uses literals, backrefs and runs.
+ *
+ * Output goes through a ring of OTA_PATCH_WINDOW bytes and is flushed to
+ * the writer in order, so RAM is fixed whatever the segment covers. The
+ * encoder is server/api/app/firmware_codec.py.
+ */
+
+#ifndef MESHSWARM_OTA_PATCH_H
+#define MESHSWARM_OTA_PATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <functional>
+#include <vector>
+
+// Backref reach and output ring size; the encoder must use the same value
+#ifndef OTA_PATCH_WINDOW
+#define OTA_PATCH_WINDOW 4096
+#endif
+
+// Bytes of the running image read per step of a base copy
+#ifndef OTA_PATCH_READ_BYTES
+#define OTA_PATCH_READ_BYTES 256
+#endif
+
+namespace MeshProto {
+
+enum PatchOp : uint8_t {
+  PATCH_OP_LITERAL = 0,
+  PATCH_OP_BACKREF = 1,
+  PATCH_OP_BASE    = 2,
+  PATCH_OP_RUN     = 3
+};
+
+enum PatchResult : uint8_t {
+  PATCH_OK = 0,
+  PATCH_BAD_SEGMENT,   // Malformed, or reaches outside the image or base
+  PATCH_IO_ERROR       // Reader or writer failed; the chunk can be retried
+};
+
+/**
+ * @brief LEB128 varint; advances pos
+ */
+inline bool readVarint(const uint8_t* data, size_t len, size_t& pos, uint32_t& out) {
+  out = 0;
+  for (uint8_t shift = 0; shift < 35; shift += 7) {
+    if (pos >= len) return false;
+    uint8_t b = data[pos++];
+    out |= (uint32_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) return true;
+  }
+  return false;
+}
+
+class PatchDecoder {
+public:
+  typedef std::function<bool(uint32_t offset, uint8_t* data, size_t len)> Reader;
+  typedef std::function<bool(uint32_t offset, const uint8_t* data, size_t len)> Writer;
+
+  /**
+   * @param imageSize Decoded image bytes; segments must stay inside it
+   * @param baseSize Running image bytes base copies may read, 0 for none
+   */
+  void begin(uint32_t imageSize, uint32_t baseSize, Reader readBase, Writer write) {
+    _imageSize = imageSize;
+    _baseSize = baseSize;
+    _read = readBase;
+    _write = write;
+    _ring.assign(OTA_PATCH_WINDOW, 0);
+    _scratch.assign(baseSize ? OTA_PATCH_READ_BYTES : 0, 0);
+  }
+
+  void end() {
+    std::vector<uint8_t>().swap(_ring);
+    std::vector<uint8_t>().swap(_scratch);
+  }
+
+  /**
+   * @brief Decode one segment and write its range of the image
+   */
+  PatchResult apply(const uint8_t* seg, size_t len) {
+    if (_ring.empty()) return PATCH_IO_ERROR;
+    size_t pos = 0;
+    uint32_t offset, outLen;
+    if (!readVarint(seg, len, pos, offset) || !readVarint(seg, len, pos, outLen)) return PATCH_BAD_SEGMENT;
+    if (outLen == 0 || offset > _imageSize || outLen > _imageSize - offset) return PATCH_BAD_SEGMENT;
+
+    _start = offset;
+    _produced = 0;
+    _flushed = 0;
+    _ioError = false;
+
+    while (_produced < outLen) {
+      if (pos >= len) return PATCH_BAD_SEGMENT;
+      uint8_t op = seg[pos++];
+      uint32_t n = op & 0x3F;
+      if (n == 0 && !readVarint(seg, len, pos, n)) return PATCH_BAD_SEGMENT;
+      if (n == 0 || n > outLen - _produced) return PATCH_BAD_SEGMENT;
+
+      switch (op >> 6) {
+        case PATCH_OP_LITERAL:
+          if (len - pos < n) return PATCH_BAD_SEGMENT;
+          put(seg + pos, n);
+          pos += n;
+          break;
+
+        case PATCH_OP_BACKREF: {
+          uint32_t dist;
+          if (!readVarint(seg, len, pos, dist)) return PATCH_BAD_SEGMENT;
+          if (dist == 0 || dist > _produced || dist > OTA_PATCH_WINDOW) return PATCH_BAD_SEGMENT;
+          // Byte at a time: a distance shorter than the length repeats a pattern
+          for (uint32_t k = 0; k < n && !_ioError; k++) {
+            uint8_t b = _ring[(_produced - dist) % OTA_PATCH_WINDOW];
+            put(&b, 1);
+          }
+          break;
+        }
+
+        case PATCH_OP_BASE: {
+          uint32_t zz;
+          if (!readVarint(seg, len, pos, zz)) return PATCH_BAD_SEGMENT;
+          int64_t delta = (zz & 1) ? -(int64_t)(zz >> 1) - 1 : (int64_t)(zz >> 1);
+          int64_t src = (int64_t)_start + _produced + delta;
+          if (src < 0 || src + n > _baseSize) return PATCH_BAD_SEGMENT;
+          while (n > 0 && !_ioError) {
+            size_t step = n < _scratch.size() ? n : _scratch.size();
+            if (!_read((uint32_t)src, _scratch.data(), step)) return PATCH_IO_ERROR;
+            put(_scratch.data(), step);
+            src += step;
+            n -= step;
+          }
+          break;
+        }
+
+        case PATCH_OP_RUN: {
+          if (pos >= len) return PATCH_BAD_SEGMENT;
+          uint8_t b = seg[pos++];
+          uint8_t fill[64];
+          memset(fill, b, sizeof(fill));
+          while (n > 0 && !_ioError) {
+            size_t step = n < sizeof(fill) ? n : sizeof(fill);
+            put(fill, step);
+            n -= step;
+          }
+          break;
+        }
+      }
+      if (_ioError) return PATCH_IO_ERROR;
+    }
+
+    flush();
+    return _ioError ? PATCH_IO_ERROR : PATCH_OK;
+  }
+
+private:
+  uint32_t _imageSize = 0;
+  uint32_t _baseSize = 0;
+  Reader _read;
+  Writer _write;
+  std::vector<uint8_t> _ring;
+  std::vector<uint8_t> _scratch;
+
+  uint32_t _start = 0;      // Image offset of the current segment
+  uint32_t _produced = 0;   // Segment bytes decoded so far
+  uint32_t _flushed = 0;    // Segment bytes handed to the writer
+  bool _ioError = false;
+
+  void put(const uint8_t* data, size_t n) {
+    while (n > 0 && !_ioError) {
+      if (_produced - _flushed == OTA_PATCH_WINDOW) flush();
+      size_t at = _produced % OTA_PATCH_WINDOW;
+      size_t room = OTA_PATCH_WINDOW - (_produced - _flushed);
+      size_t step = OTA_PATCH_WINDOW - at;
+      if (step > room) step = room;
+      if (step > n) step = n;
+      memcpy(&_ring[at], data, step);
+      _produced += step;
+      data += step;
+      n -= step;
+    }
+  }
+
+  // Hand out everything decoded since the last flush; the ring keeps it as backref history
+  void flush() {
+    while (_flushed < _produced && !_ioError) {
+      size_t at = _flushed % OTA_PATCH_WINDOW;
+      size_t step = OTA_PATCH_WINDOW - at;
+      if (step > _produced - _flushed) step = _produced - _flushed;
+      if (!_write(_start + _flushed, &_ring[at], step)) _ioError = true;
+      _flushed += step;
+    }
+  }
+};
+
+}  // namespace MeshProto
+
+#endif // MESHSWARM_OTA_PATCH_H
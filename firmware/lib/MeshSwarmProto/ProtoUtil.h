@@ -0,0 +1,107 @@
+/**
+ * @file ProtoUtil.h
+ * @brief Small helpers shared by the MeshSwarmProto engines
+ *
+ * Key hashing and a compact base64 codec for packing binary digests
+ * into JSON string fields. No Arduino dependency, so the same code runs
+ * in the native test/simulator environment.
+ */
+
+#ifndef MESHSWARM_PROTO_UTIL_H
+#define MESHSWARM_PROTO_UTIL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace MeshProto {
+
+/**
+ * @brief FNV-1a 32-bit hash of a state key
+ */
+inline uint32_t keyHash(const char* key) {
+  uint32_t h = 2166136261u;
+  while (*key) {
+    h ^= (uint8_t)*key++;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+/**
+ * @brief MeshSwarm conflict rule: higher version wins, lower origin breaks ties
+ * @return true if (version, origin) should replace (curVersion, curOrigin)
+ */
+inline bool isNewer(uint32_t version, uint32_t origin, uint32_t curVersion, uint32_t curOrigin) {
+  if (version != curVersion) return version > curVersion;
+  return origin < curOrigin;
+}
+
+inline void putU32(uint8_t* p, uint32_t v) {
+  p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+
+inline uint32_t getU32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Encoded length (without terminator) for len input bytes
+ */
+inline size_t base64Length(size_t len) { return ((len + 2) / 3) * 4; }
+
+/**
+ * @brief Base64-encode len bytes into out (must hold base64Length(len) + 1)
+ */
+inline void base64Encode(const uint8_t* in, size_t len, char* out) {
+  static const char tbl[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  size_t o = 0;
+  for (size_t i = 0; i < len; i += 3) {
+    uint32_t n = (uint32_t)in[i] << 16;
+    if (i + 1 < len) n |= (uint32_t)in[i + 1] << 8;
+    if (i + 2 < len) n |= in[i + 2];
+    out[o++] = tbl[(n >> 18) & 63];
+    out[o++] = tbl[(n >> 12) & 63];
+    out[o++] = i + 1 < len ? tbl[(n >> 6) & 63] : '=';
+    out[o++] = i + 2 < len ? tbl[n & 63] : '=';
+  }
+  out[o] = '\0';
+}
+
+/**
+ * @brief Decode base64 text into out (capacity outMax bytes)
+ * @return Bytes written, or 0 on malformed input / overflow
+ */
+inline size_t base64Decode(const char* in, uint8_t* out, size_t outMax) {
+  auto val = [](char c) -> int {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+  };
+
+  size_t len = strlen(in);
+  if (len % 4 != 0) return 0;
+
+  size_t o = 0;
+  for (size_t i = 0; i < len; i += 4) {
+    int a = val(in[i]), b = val(in[i + 1]);
+    int c = in[i + 2] == '=' ? 0 : val(in[i + 2]);
+    int d = in[i + 3] == '=' ? 0 : val(in[i + 3]);
+    if (a < 0 || b < 0 || c < 0 || d < 0) return 0;
+
+    uint32_t n = ((uint32_t)a << 18) | ((uint32_t)b << 12) | ((uint32_t)c << 6) | (uint32_t)d;
+    size_t bytes = in[i + 2] == '=' ? 1 : (in[i + 3] == '=' ? 2 : 3);
+    if (o + bytes > outMax) return 0;
+    out[o++] = n >> 16;
+    if (bytes > 1) out[o++] = n >> 8;
+    if (bytes > 2) out[o++] = n;
+  }
+  return o;
+}
+
+}  // namespace MeshProto
+
+#endif // MESHSWARM_PROTO_UTIL_H
@@ -0,0 +1,265 @@
+/**
+ * @file SendLanes.h
+ * @brief Priority lanes for the send path, and latency stats to verify them
+ *
+ * painlessMesh hands every message to one FIFO per connection, and every hop
+ * forwards in arrival order. During an OTA rollout a button press waits
+ * behind every chunk already queued on each hop of its path, so switching a
+ * light takes seconds. SendLanes replaces that FIFO with one queue per class,
+ * served strictly in order:
+ *
+ *   LANE_CONTROL    Actuator changes and commands (setState urgent, "u":1)
+ *   LANE_STATE      State sets and syncs, heartbeats
+ *   LANE_TELEMETRY  Telemetry records
+ *   LANE_BULK       OTA chunks
+ *
+ * Each lane holds at most its own bound; a full lane refuses the message
+ * (counted as overflow) instead of delaying the lanes above it. pump() hands
+ * messages on while an airtime budget allows: a token bucket refilled at
+ * airBytesPerS, so a node doesn't queue more than its link drains and the
+ * lane order still decides who goes next. Control is never held back; it
+ * may run the budget into debt, which the lower lanes then wait out.
+ *
+ *   lanes.begin();
+ *   lanes.push(LANE_BULK, chunk, chunk.length(), millis());
+ *   lanes.pump(millis(), [](String& msg, uint8_t lane) { mesh.sendBroadcast(msg); });
+ *
+ * Lanes only help where messages queue, and in a mesh that is every hop:
+ * forwarding nodes have to queue by the lane a message carries, not just its
+ * origin. LatencyStats records end-to-end delays (button -> LED) so the
+ * effect can be measured on the fleet.
+ */
+
+#ifndef MESHSWARM_SEND_LANES_H
+#define MESHSWARM_SEND_LANES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <deque>
+#include <utility>
+
+// Messages each lane holds before it refuses more
+#ifndef LANE_QUEUE_MAX
+#define LANE_QUEUE_MAX 16
+#endif
+
+// Airtime budget handed to the transport, and the burst it may bank (0 = no budget)
+#ifndef LANE_AIR_BYTES_PER_S
+#define LANE_AIR_BYTES_PER_S 20000
+#endif
+
+#ifndef LANE_AIR_BURST_BYTES
+#define LANE_AIR_BURST_BYTES 4096
+#endif
+
+// LatencyStats histogram: <10, <20, <50, <100, <200, <500, <1000, <2000, <5000 ms and the rest
+#define LATENCY_BUCKETS 10
+
+namespace MeshProto {
+
+enum Lane : uint8_t {
+  LANE_CONTROL,
+  LANE_STATE,
+  LANE_TELEMETRY,
+  LANE_BULK,
+  LANES
+};
+
+inline const char* laneName(uint8_t lane) {
+  switch (lane) {
+    case LANE_CONTROL: return "control";
+    case LANE_STATE: return "state";
+    case LANE_TELEMETRY: return "telemetry";
+    case LANE_BULK: return "bulk";
+    default: return "?";
+  }
+}
+
+struct LaneStats {
+  uint32_t sent = 0;
+  uint32_t overflow = 0;      // Refused because the lane was full
+  uint16_t depthMax = 0;
+  uint32_t waitMaxMs = 0;     // Time from push() to send
+  uint64_t waitTotalMs = 0;
+
+  uint32_t waitAvgMs() const { return sent ? (uint32_t)(waitTotalMs / sent) : 0; }
+};
+
+/**
+ * @brief Per-class send queues, served in lane order under an airtime budget
+ * @tparam T Queued message (moved in and out)
+ */
+template <typename T>
+class SendLanes {
+public:
+  /**
+   * @param perLane       Messages each lane holds
+   * @param airBytesPerS  Budget refill rate; 0 hands everything on at once
+   * @param burstBytes    Budget a quiet node may bank
+   */
+  void begin(uint16_t perLane = LANE_QUEUE_MAX, uint32_t airBytesPerS = LANE_AIR_BYTES_PER_S,
+             uint32_t burstBytes = LANE_AIR_BURST_BYTES) {
+    _perLane = perLane ? perLane : 1;
+    _rate = airBytesPerS;
+    _burst = (int32_t)burstBytes;
+    _tokens = _burst;
+    _refilled = false;
+  }
+
+  /**
+   * @return False if the lane is full (the message is dropped and counted)
+   */
+  bool push(uint8_t lane, T item, uint16_t bytes, uint32_t now) {
+    if (lane >= LANES) lane = LANE_BULK;
+    std::deque<Item>& q = _queues[lane];
+    if (q.size() >= _perLane) {
+      _stats[lane].overflow++;
+      return false;
+    }
+    q.push_back(Item{std::move(item), bytes, now});
+    if (q.size() > _stats[lane].depthMax) _stats[lane].depthMax = (uint16_t)q.size();
+    return true;
+  }
+
+  /**
+   * @brief Hand queued messages to send(T&, uint8_t lane), highest lane first
+   *
+   * Stops at the first message the budget can't cover, so a lower lane never
+   * overtakes a higher one that is waiting.
+   *
+   * @param max Messages to hand on at most (1 = the transport takes one at a time)
+   * @return Messages handed on
+   */
+  template <typename Fn>
+  uint16_t pump(uint32_t now, Fn send, uint16_t max = 0xFFFF) {
+    refill(now);
+    uint16_t n = 0;
+    for (uint8_t lane = 0; lane < LANES && n < max; lane++) {
+      std::deque<Item>& q = _queues[lane];
+      while (!q.empty() && n < max) {
+        if (_rate && lane != LANE_CONTROL && _tokens <= 0) return n;
+        Item item = std::move(q.front());
+        q.pop_front();
+        if (_rate) {
+          _tokens -= item.bytes;
+          if (_tokens < -_burst) _tokens = -_burst;
+        }
+        LaneStats& st = _stats[lane];
+        uint32_t wait = now - item.at;
+        st.sent++;
+        st.waitTotalMs += wait;
+        if (wait > st.waitMaxMs) st.waitMaxMs = wait;
+        send(item.item, lane);
+        n++;
+      }
+    }
+    return n;
+  }
+
+  size_t pending(uint8_t lane) const { return lane < LANES ? _queues[lane].size() : 0; }
+
+  size_t pending() const {
+    size_t n = 0;
+    for (const std::deque<Item>& q : _queues) n += q.size();
+    return n;
+  }
+
+  bool empty() const { return pending() == 0; }
+
+  const LaneStats& stats(uint8_t lane) const { return _stats[lane < LANES ? lane : (uint8_t)LANE_BULK]; }
+  void resetStats() {
+    for (LaneStats& st : _stats) st = LaneStats();
+  }
+
+  void clear() {
+    for (std::deque<Item>& q : _queues) q.clear();
+  }
+
+private:
+  struct Item {
+    T item;
+    uint16_t bytes;
+    uint32_t at;
+  };
+
+  std::deque<Item> _queues[LANES];
+  LaneStats _stats[LANES];
+  uint16_t _perLane = LANE_QUEUE_MAX;
+  uint32_t _rate = LANE_AIR_BYTES_PER_S;
+  int32_t _burst = LANE_AIR_BURST_BYTES;
+  int32_t _tokens = LANE_AIR_BURST_BYTES;
+  uint32_t _refillAt = 0;
+  bool _refilled = false;
+
+  void refill(uint32_t now) {
+    if (!_rate) return;
+    if (!_refilled) {
+      _refillAt = now;
+      _refilled = true;
+      return;
+    }
+    uint32_t elapsed = now - _refillAt;
+    uint32_t add = (uint32_t)((uint64_t)elapsed * _rate / 1000);
+    if (add == 0) return;
+    // Advance only by the time the added bytes account for, so slow pumps don't lose budget
+    _refillAt += (uint32_t)((uint64_t)add * 1000 / _rate);
+    int64_t tokens = (int64_t)_tokens + add;
+    _tokens = tokens > _burst ? _burst : (int32_t)tokens;
+  }
+};
+
+/**
+ * @brief End-to-end delay histogram (plain data, cheap enough for a watcher)
+ *
+ * Percentiles are read from the histogram, so they come back as the upper
+ * edge of the bucket they fall in; max and average are exact.
+ */
+struct LatencyStats {
+  uint32_t count = 0;
+  uint32_t maxMs = 0;
+  uint64_t totalMs = 0;
+  uint32_t hist[LATENCY_BUCKETS] = {0};
+
+  static uint32_t bucketEdge(uint8_t bucket) {
+    static const uint32_t edges[LATENCY_BUCKETS - 1] = {10, 20, 50, 100, 200, 500, 1000, 2000, 5000};
+    return bucket < LATENCY_BUCKETS - 1 ? edges[bucket] : UINT32_MAX;
+  }
+
+  void add(uint32_t ms) {
+    uint8_t b = 0;
+    while (b < LATENCY_BUCKETS - 1 && ms >= bucketEdge(b)) b++;
+    hist[b]++;
+    count++;
+    totalMs += ms;
+    if (ms > maxMs) maxMs = ms;
+  }
+
+  void merge(const LatencyStats& o) {
+    for (uint8_t b = 0; b < LATENCY_BUCKETS; b++) hist[b] += o.hist[b];
+    count += o.count;
+    totalMs += o.totalMs;
+    if (o.maxMs > maxMs) maxMs = o.maxMs;
+  }
+
+  uint32_t avgMs() const { return count ? (uint32_t)(totalMs / count) : 0; }
+
+  /**
+   * @return Upper bucket edge below which pct percent of samples fall (capped at max)
+   */
+  uint32_t percentileMs(uint8_t pct) const {
+    if (!count) return 0;
+    uint32_t want = (uint32_t)(((uint64_t)count * pct + 99) / 100);
+    uint32_t seen = 0;
+    for (uint8_t b = 0; b < LATENCY_BUCKETS; b++) {
+      seen += hist[b];
+      if (seen >= want) return bucketEdge(b) < maxMs ? bucketEdge(b) : maxMs;
+    }
+    return maxMs;
+  }
+
+  void clear() { *this = LatencyStats(); }
+};
+
+}  // namespace MeshProto
+
+#endif // MESHSWARM_SEND_LANES_H
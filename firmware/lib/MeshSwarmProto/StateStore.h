@@ -0,0 +1,359 @@
+/**
+ * @file StateStore.h
+ * @brief Bounded shared state: per-key TTLs, LRU eviction, tombstones
+ *
+ * MeshSwarm's state map only grows: every zone key a node has ever seen is
+ * kept, synced to joiners and cached by displays, long after the hardware
+ * that wrote it is gone. StateStore holds the same (value, version, origin)
+ * entries under the same conflict rule (isNewer) and bounds them three ways:
+ *
+ *   TTL         expire("temp_*", 3 * HEARTBEAT_MS): an entry is dropped once
+ *               its origin has been silent that long (heard() on every
+ *               heartbeat). Entries this node wrote never expire.
+ *   LRU         at maxKeys, a new key evicts the least recently written or
+ *               read entry that isn't pinned (pin("led")). Tombstones go first.
+ *   Tombstones  remove() writes an empty value with the next version. It
+ *               propagates like any set, replaces the value everywhere, and
+ *               is purged after STATE_TOMBSTONE_MS, by when every node that
+ *               was online has seen it.
+ *
+ * Expiry and eviction are local: each node sees the same silent origins, so
+ * nothing is sent. Watchers should hear a dropped or deleted key as an
+ * empty value (onDrop()).
+ *
+ * Str is the key/value string type (Arduino String, std::string). entries()
+ * is a std::map with .value/.version/.origin, so DeltaSync reads it as is.
+ */
+
+#ifndef MESHSWARM_STATE_STORE_H
+#define MESHSWARM_STATE_STORE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <vector>
+#include "ProtoUtil.h"
+
+// Entries kept before new keys evict old ones
+#ifndef STATE_STORE_MAX_KEYS
+#define STATE_STORE_MAX_KEYS 128
+#endif
+
+// How long a delete is remembered (and keeps a stale copy from coming back)
+#ifndef STATE_TOMBSTONE_MS
+#define STATE_TOMBSTONE_MS 600000
+#endif
+
+namespace MeshProto {
+
+enum StoreDrop : uint8_t {
+  STORE_EXPIRED = 0,   // Origin silent past the key's TTL
+  STORE_EVICTED,       // Made room for a newer key
+  STORE_PURGED         // Tombstone aged out (the key was already empty)
+};
+
+template <typename Str>
+struct StoreEntry {
+  Str value;                 // Empty for a tombstone
+  uint32_t version = 0;
+  uint32_t origin = 0;
+  unsigned long timestamp = 0;   // Local time of the last change
+  unsigned long usedAt = 0;      // Last change or read, for LRU
+  uint32_t ttlMs = 0;        // 0 = never expires
+  bool pinned = false;
+
+  bool deleted() const { return value.length() == 0; }
+};
+
+struct StoreStats {
+  uint32_t expired = 0;
+  uint32_t evicted = 0;
+  uint32_t purged = 0;
+  uint32_t rejected = 0;   // New keys refused: store full of pinned keys
+};
+
+template <typename Str>
+class StateStore {
+public:
+  typedef StoreEntry<Str> Entry;
+  typedef std::map<Str, Entry> Map;
+  typedef std::function<void(const Str& key, const Str& oldValue, StoreDrop why)> DropHandler;
+
+  /**
+   * @param selfId This node's id; its own entries never expire
+   */
+  void begin(uint32_t selfId, size_t maxKeys = STATE_STORE_MAX_KEYS) {
+    _self = selfId;
+    _maxKeys = maxKeys ? maxKeys : 1;
+  }
+
+  /**
+   * @brief Expire keys matching pattern once their origin is silent for silentMs
+   * @param pattern Exact key, or prefix ending in '*' ("*" matches all)
+   */
+  void expire(const char* pattern, uint32_t silentMs) { addRule(pattern, silentMs, false); }
+
+  /**
+   * @brief Never evict keys matching pattern (they still honour a TTL)
+   */
+  void pin(const char* pattern) { addRule(pattern, 0, true); }
+
+  /**
+   * @brief Called for every entry dropped by expiry, eviction or purge
+   */
+  void onDrop(DropHandler handler) { _onDrop = handler; }
+
+  /**
+   * @brief Note that a node is alive (heartbeat or any message from it)
+   */
+  void heard(uint32_t origin, unsigned long now) {
+    if (_minTtl == 0) return;  // Nothing expires, nothing to track
+    // Back from a gap of our own: everyone was silent, not gone, so restart their clocks
+    if (_heardAny && now - _lastHeard > _minTtl / 2) {
+      for (Heard& h : _heard) h.at = now;
+    }
+    auto it = findHeard(origin);
+    if (it != _heard.end() && it->origin == origin) it->at = now;
+    else _heard.insert(it, Heard{origin, now});
+    _lastHeard = now;
+    _heardAny = true;
+  }
+
+  /**
+   * @brief Local write: next version, origin = self. An empty value deletes
+   * @param oldValue Set to the previous value (empty if none)
+   * @return true if the value changed; out holds the new entry
+   */
+  bool setLocal(const Str& key, const Str& value, unsigned long now, Entry* out = nullptr,
+                Str* oldValue = nullptr) {
+    auto it = _entries.find(key);
+    uint32_t version = 1;
+    if (it != _entries.end()) {
+      if (it->second.value == value) {
+        it->second.usedAt = now;
+        return false;
+      }
+      version = it->second.version + 1;
+    } else if (value.length() == 0 || !makeRoom()) {
+      return false;  // Nothing to delete, or no room
+    }
+    return write(key, value, version, _self, now, out, oldValue);
+  }
+
+  /**
+   * @brief Delete a key everywhere (tombstone with the next version)
+   */
+  bool remove(const Str& key, unsigned long now, Entry* out = nullptr, Str* oldValue = nullptr) {
+    return setLocal(key, Str(), now, out, oldValue);
+  }
+
+  /**
+   * @brief Received entry, kept if newer than ours
+   * @return true if stored
+   */
+  bool applyRemote(const Str& key, const Str& value, uint32_t version, uint32_t origin,
+                   unsigned long now, Str* oldValue = nullptr) {
+    auto it = _entries.find(key);
+    if (it != _entries.end()) {
+      if (!isNewer(version, origin, it->second.version, it->second.origin)) return false;
+    } else {
+      // A tombstone for a key we never had isn't worth evicting a live one for
+      if (value.length() == 0 && _entries.size() >= _maxKeys) return false;
+      // Nor is a copy of an expired key still held by a node that hasn't swept yet
+      Entry probe;
+      probe.origin = origin;
+      probe.timestamp = now;
+      classify(key, probe);
+      if (expired(probe, now)) return false;
+      if (!makeRoom()) return false;
+    }
+    return write(key, value, version, origin, now, nullptr, oldValue);
+  }
+
+  /**
+   * @brief Live entry, or nullptr (unknown or deleted); counts as a use for LRU
+   */
+  const Entry* get(const Str& key, unsigned long now) {
+    auto it = _entries.find(key);
+    if (it == _entries.end() || it->second.deleted()) return nullptr;
+    it->second.usedAt = now;
+    return &it->second;
+  }
+
+  /**
+   * @brief Entry including tombstones, without touching LRU order
+   */
+  const Entry* peek(const Str& key) const {
+    auto it = _entries.find(key);
+    return it == _entries.end() ? nullptr : &it->second;
+  }
+
+  /**
+   * @brief Drop expired entries and aged tombstones; call about once a second
+   * @return Entries dropped
+   */
+  size_t sweep(unsigned long now) {
+    struct Dropped { Str key; Str old; StoreDrop why; };
+    std::vector<Dropped> dropped;
+    size_t count = 0;
+    for (auto it = _entries.begin(); it != _entries.end();) {
+      const Entry& e = it->second;
+      if (e.deleted() ? now - e.timestamp >= STATE_TOMBSTONE_MS : expired(e, now)) {
+        StoreDrop why = e.deleted() ? STORE_PURGED : STORE_EXPIRED;
+        if (why == STORE_PURGED) _stats.purged++;
+        else _stats.expired++;
+        if (_onDrop) dropped.push_back({it->first, e.value, why});
+        it = _entries.erase(it);
+        count++;
+      } else {
+        ++it;
+      }
+    }
+    for (auto it = _heard.begin(); it != _heard.end();) {
+      it = now - it->at > STATE_TOMBSTONE_MS ? _heard.erase(it) : std::next(it);
+    }
+    // Handlers run once the sweep is done, so they may write to the store
+    for (const Dropped& d : dropped) _onDrop(d.key, d.old, d.why);
+    return count;
+  }
+
+  const Map& entries() const { return _entries; }
+  size_t size() const { return _entries.size(); }
+  size_t maxKeys() const { return _maxKeys; }
+  const StoreStats& stats() const { return _stats; }
+
+  /**
+   * @brief Entries holding a value (not tombstones)
+   */
+  size_t live() const {
+    size_t n = 0;
+    for (const auto& kv : _entries) n += kv.second.deleted() ? 0 : 1;
+    return n;
+  }
+
+private:
+  struct Rule {
+    std::vector<char> prefix;   // Without the '*', terminated
+    bool wildcard;
+    uint32_t ttlMs;
+    bool pinned;
+  };
+
+  struct Heard {
+    uint32_t origin;
+    unsigned long at;
+  };
+
+  Map _entries;
+  std::vector<Heard> _heard;   // Sorted by origin; one per node, so no map node overhead
+  std::vector<Rule> _rules;
+  DropHandler _onDrop;
+  StoreStats _stats;
+  unsigned long _lastHeard = 0;  // Last heard anyone
+  bool _heardAny = false;
+  uint32_t _minTtl = 0;
+  uint32_t _self = 0;
+  size_t _maxKeys = STATE_STORE_MAX_KEYS;
+
+  void addRule(const char* pattern, uint32_t ttlMs, bool pinned) {
+    size_t len = strlen(pattern);
+    Rule rule;
+    rule.wildcard = len > 0 && pattern[len - 1] == '*';
+    if (rule.wildcard) len--;
+    rule.prefix.assign(pattern, pattern + len);
+    rule.prefix.push_back('\0');
+    rule.ttlMs = ttlMs;
+    rule.pinned = pinned;
+    _rules.push_back(rule);
+    if (ttlMs && (_minTtl == 0 || ttlMs < _minTtl)) _minTtl = ttlMs;
+    for (auto& kv : _entries) classify(kv.first, kv.second);
+  }
+
+  typename std::vector<Heard>::iterator findHeard(uint32_t origin) {
+    return std::lower_bound(_heard.begin(), _heard.end(), origin,
+                            [](const Heard& h, uint32_t o) { return h.origin < o; });
+  }
+
+  static bool matches(const Rule& rule, const char* key) {
+    size_t len = rule.prefix.size() - 1;
+    if (strncmp(key, rule.prefix.data(), len) != 0) return false;
+    return rule.wildcard || key[len] == '\0';
+  }
+
+  // Rules are resolved once per key, not on every sweep
+  void classify(const Str& key, Entry& e) const {
+    e.ttlMs = 0;
+    e.pinned = false;
+    for (const Rule& rule : _rules) {
+      if (!matches(rule, key.c_str())) continue;
+      if (rule.pinned) e.pinned = true;
+      else if (e.ttlMs == 0 || rule.ttlMs < e.ttlMs) e.ttlMs = rule.ttlMs;
+    }
+  }
+
+  bool expired(const Entry& e, unsigned long now) const {
+    if (e.ttlMs == 0 || e.origin == _self) return false;
+    // Hearing nobody means we are the one cut off: nothing expires until we're back
+    if (_heardAny && now - _lastHeard > _minTtl / 2) return false;
+    // Timed from the origin's last heartbeat, not from when a copy arrived
+    // (that would restart the clock each time a peer resyncs it); an origin
+    // we never heard from is timed from arrival
+    auto h = std::lower_bound(_heard.begin(), _heard.end(), e.origin,
+                              [](const Heard& x, uint32_t o) { return x.origin < o; });
+    unsigned long last = h != _heard.end() && h->origin == e.origin ? h->at : e.timestamp;
+    return (long)(now - last) > (long)e.ttlMs;
+  }
+
+  bool write(const Str& key, const Str& value, uint32_t version, uint32_t origin, unsigned long now,
+             Entry* out, Str* oldValue) {
+    auto it = _entries.find(key);
+    bool fresh = it == _entries.end();
+    Entry& e = fresh ? _entries[key] : it->second;
+    if (oldValue) *oldValue = e.value;
+    if (fresh) classify(key, e);
+    e.value = value;
+    e.version = version;
+    e.origin = origin;
+    e.timestamp = now;
+    e.usedAt = now;
+    if (out) *out = e;
+    return true;
+  }
+
+  // Evict until a new key fits: a tombstone if any, else the LRU unpinned entry
+  bool makeRoom() {
+    while (_entries.size() >= _maxKeys) {
+      auto victim = _entries.end();
+      for (auto it = _entries.begin(); it != _entries.end(); ++it) {
+        const Entry& e = it->second;
+        if (e.pinned && !e.deleted()) continue;
+        if (victim == _entries.end() || (e.deleted() && !victim->second.deleted()) ||
+            (e.deleted() == victim->second.deleted() && (long)(victim->second.usedAt - e.usedAt) > 0)) {
+          victim = it;
+        }
+      }
+      if (victim == _entries.end()) {
+        _stats.rejected++;
+        return false;
+      }
+      bool tombstone = victim->second.deleted();
+      Str evictedKey = victim->first;
+      Str old = victim->second.value;
+      _entries.erase(victim);
+      if (tombstone) {
+        _stats.purged++;
+      } else {
+        _stats.evicted++;
+      }
+      if (_onDrop) _onDrop(evictedKey, old, tombstone ? STORE_PURGED : STORE_EVICTED);
+    }
+    return true;
+  }
+};
+
+}  // namespace MeshProto
+
+#endif // MESHSWARM_STATE_STORE_H
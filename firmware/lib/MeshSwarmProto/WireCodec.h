@@ -0,0 +1,388 @@
+/**
+ * @file WireCodec.h
+ * @brief Compact binary wire encoding for MeshSwarm messages
+ *
+ * A MessagePack-style encoding of the same JSON documents MeshSwarm
+ * already builds, tuned for its traffic:
+ *
+ *   - Common field names and state keys come from a fixed dictionary and
+ *     cost one byte ("value", "version", "heap_free", "temp", ...)
+ *   - Integers are LEB128 varints; small ones fit in the tag byte
+ *   - Numeric strings ("72", "1700000000"), which is how most state values
+ *     travel, are stored as varints and restored as strings on decode
+ *
+ * painlessMesh carries text, so a frame is '~' followed by base64 of
+ * [WIRE_VERSION][payload]. JSON frames always start with '{', so
+ * decodeMessage() accepts both and mixed fleets interoperate: roll out
+ * decoders everywhere first, then flip MESHSWARM_WIRE_FORMAT.
+ *
+ * The dictionary is part of the wire version. Append-only changes
+ * still require bumping WIRE_VERSION.
+ */
+
+#ifndef MESHSWARM_WIRE_CODEC_H
+#define MESHSWARM_WIRE_CODEC_H
+
+#include <ArduinoJson.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "ProtoUtil.h"
+
+// 0 = JSON text (default), 1 = binary frames. Select per mesh.
+#ifndef MESHSWARM_WIRE_FORMAT
+#define MESHSWARM_WIRE_FORMAT 0
+#endif
+
+// Nesting limit for decode (MeshSwarm messages are at most 3 deep)
+#ifndef WIRE_MAX_DEPTH
+#define WIRE_MAX_DEPTH 8
+#endif
+
+namespace MeshProto {
+
+const uint8_t WIRE_VERSION = 1;
+const char WIRE_BINARY_MARK = '~';
+
+// Shared string dictionary (index = code). Max 32 entries.
+static const char* const WIRE_DICT[] = {
+  "t", "key", "value", "version", "origin", "name", "role", "uptime",
+  "heap_free", "peer_count", "state", "firmware", "id", "from", "cmd", "args",
+  "COORD", "NODE", "temp", "humidity", "motion", "light", "led", "time",
+  "s", "d", "n", "w", "end", "data", "ok", "result",
+};
+const uint8_t WIRE_DICT_SIZE = sizeof(WIRE_DICT) / sizeof(WIRE_DICT[0]);
+static_assert(sizeof(WIRE_DICT) / sizeof(WIRE_DICT[0]) <= 32, "dictionary codes are 5 bits");
+
+namespace wire {
+
+// Tag layout
+const uint8_t T_FIXINT   = 0x00;  // 0x00-0x7F: integer 0..127
+const uint8_t T_FIXMAP   = 0x80;  // 0x80-0x8F: map, n < 16
+const uint8_t T_FIXARR   = 0x90;  // 0x90-0x9F: array, n < 16
+const uint8_t T_FIXSTR   = 0xA0;  // 0xA0-0xBF: string, len < 32
+const uint8_t T_NULL     = 0xC0;
+const uint8_t T_FALSE    = 0xC2;
+const uint8_t T_TRUE     = 0xC3;
+const uint8_t T_FLOAT32  = 0xCA;
+const uint8_t T_FLOAT64  = 0xCB;
+const uint8_t T_UINT     = 0xCC;  // + varint
+const uint8_t T_NEGINT   = 0xCD;  // + varint of (-1 - value)
+const uint8_t T_NUMSTR   = 0xCE;  // + varint, decodes to its decimal string
+const uint8_t T_STR      = 0xD9;  // + varint len + bytes
+const uint8_t T_ARR      = 0xDC;  // + varint count
+const uint8_t T_MAP      = 0xDE;  // + varint count
+const uint8_t T_DICT     = 0xE0;  // 0xE0-0xFF: dictionary string
+
+class Writer {
+public:
+  std::vector<uint8_t> buf;
+
+  void byte(uint8_t b) { buf.push_back(b); }
+
+  void varint(uint64_t v) {
+    while (v >= 0x80) {
+      byte((uint8_t)(v | 0x80));
+      v >>= 7;
+    }
+    byte((uint8_t)v);
+  }
+
+  void uint(uint64_t v) {
+    if (v < 0x80) { byte((uint8_t)v); return; }
+    byte(T_UINT);
+    varint(v);
+  }
+
+  void str(const char* s) {
+    for (uint8_t i = 0; i < WIRE_DICT_SIZE; i++) {
+      if (strcmp(s, WIRE_DICT[i]) == 0) { byte(T_DICT | i); return; }
+    }
+
+    uint64_t num;
+    if (numericString(s, num)) {
+      byte(T_NUMSTR);
+      varint(num);
+      return;
+    }
+
+    size_t len = strlen(s);
+    if (len < 32) {
+      byte((uint8_t)(T_FIXSTR | len));
+    } else {
+      byte(T_STR);
+      varint(len);
+    }
+    buf.insert(buf.end(), s, s + len);
+  }
+
+  void value(JsonVariantConst v) {
+    if (v.isNull()) { byte(T_NULL); return; }
+    if (v.is<bool>()) { byte(v.as<bool>() ? T_TRUE : T_FALSE); return; }
+    if (v.is<uint64_t>()) { uint(v.as<uint64_t>()); return; }
+    if (v.is<int64_t>()) {
+      byte(T_NEGINT);
+      varint((uint64_t)(-1 - v.as<int64_t>()));
+      return;
+    }
+    if (v.is<double>()) {
+      double d = v.as<double>();
+      float f = (float)d;
+      if ((double)f == d) {
+        byte(T_FLOAT32);
+        raw(&f, sizeof(f));
+      } else {
+        byte(T_FLOAT64);
+        raw(&d, sizeof(d));
+      }
+      return;
+    }
+    if (v.is<const char*>()) { str(v.as<const char*>()); return; }
+
+    if (v.is<JsonArrayConst>()) {
+      JsonArrayConst arr = v.as<JsonArrayConst>();
+      size_t n = arr.size();
+      if (n < 16) byte((uint8_t)(T_FIXARR | n)); else { byte(T_ARR); varint(n); }
+      for (JsonVariantConst e : arr) value(e);
+      return;
+    }
+
+    if (v.is<JsonObjectConst>()) {
+      JsonObjectConst obj = v.as<JsonObjectConst>();
+      size_t n = obj.size();
+      if (n < 16) byte((uint8_t)(T_FIXMAP | n)); else { byte(T_MAP); varint(n); }
+      for (JsonPairConst kv : obj) {
+        str(kv.key().c_str());
+        value(kv.value());
+      }
+      return;
+    }
+
+    byte(T_NULL);
+  }
+
+private:
+  void raw(const void* p, size_t n) {
+    const uint8_t* b = (const uint8_t*)p;
+    buf.insert(buf.end(), b, b + n);
+  }
+
+  // Canonical decimal only ("0", "42"; not "042", "+1", "1.0"), so decode is exact
+  static bool numericString(const char* s, uint64_t& out) {
+    size_t len = strlen(s);
+    if (len == 0 || len > 19) return false;
+    if (len > 1 && s[0] == '0') return false;
+    uint64_t v = 0;
+    for (size_t i = 0; i < len; i++) {
+      if (s[i] < '0' || s[i] > '9') return false;
+      v = v * 10 + (s[i] - '0');
+    }
+    out = v;
+    return true;
+  }
+};
+
+class Reader {
+public:
+  Reader(const uint8_t* p, size_t n) : _p(p), _end(p + n) {}
+
+  bool ok() const { return _ok; }
+  bool atEnd() const { return _p == _end; }
+
+  bool value(JsonVariant dst, int depth = 0) {
+    if (depth > WIRE_MAX_DEPTH) return fail();
+    uint8_t tag;
+    if (!byte(tag)) return false;
+
+    if (tag < 0x80) { dst.set((uint32_t)tag); return true; }
+    if ((tag & 0xF0) == T_FIXMAP) return map(dst, tag & 0x0F, depth);
+    if ((tag & 0xF0) == T_FIXARR) return array(dst, tag & 0x0F, depth);
+    if ((tag & 0xE0) == T_FIXSTR || (tag & 0xE0) == T_DICT || tag == T_STR || tag == T_NUMSTR) {
+      std::string s;
+      if (!strTagged(tag, s)) return false;
+      dst.set(s);
+      return true;
+    }
+
+    uint64_t n;
+    switch (tag) {
+      case T_NULL:  dst.clear(); return true;
+      case T_FALSE: dst.set(false); return true;
+      case T_TRUE:  dst.set(true); return true;
+      case T_UINT:
+        if (!varint(n)) return false;
+        dst.set(n);
+        return true;
+      case T_NEGINT:
+        if (!varint(n)) return false;
+        dst.set(-1 - (int64_t)n);
+        return true;
+      case T_FLOAT32: {
+        float f;
+        if (!raw(&f, sizeof(f))) return false;
+        dst.set(f);
+        return true;
+      }
+      case T_FLOAT64: {
+        double d;
+        if (!raw(&d, sizeof(d))) return false;
+        dst.set(d);
+        return true;
+      }
+      case T_ARR:
+        if (!varint(n)) return false;
+        return array(dst, n, depth);
+      case T_MAP:
+        if (!varint(n)) return false;
+        return map(dst, n, depth);
+    }
+    return fail();
+  }
+
+private:
+  const uint8_t* _p;
+  const uint8_t* _end;
+  bool _ok = true;
+
+  bool fail() { _ok = false; return false; }
+
+  bool byte(uint8_t& b) {
+    if (_p >= _end) return fail();
+    b = *_p++;
+    return true;
+  }
+
+  bool raw(void* out, size_t n) {
+    if ((size_t)(_end - _p) < n) return fail();
+    memcpy(out, _p, n);
+    _p += n;
+    return true;
+  }
+
+  bool varint(uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      uint8_t b;
+      if (!byte(b)) return false;
+      v |= (uint64_t)(b & 0x7F) << shift;
+      if (!(b & 0x80)) return true;
+    }
+    return fail();
+  }
+
+  bool strTagged(uint8_t tag, std::string& s) {
+    uint64_t len;
+    if ((tag & 0xE0) == T_DICT) {
+      uint8_t code = tag & 0x1F;
+      if (code >= WIRE_DICT_SIZE) return fail();
+      s = WIRE_DICT[code];
+      return true;
+    }
+    if (tag == T_NUMSTR) {
+      if (!varint(len)) return false;
+      char tmp[24];
+      snprintf(tmp, sizeof(tmp), "%llu", (unsigned long long)len);
+      s = tmp;
+      return true;
+    }
+    if ((tag & 0xE0) == T_FIXSTR) {
+      len = tag & 0x1F;
+    } else if (!varint(len)) {
+      return false;
+    }
+    if ((uint64_t)(_end - _p) < len) return fail();
+    s.assign((const char*)_p, len);
+    _p += len;
+    return true;
+  }
+
+  bool array(JsonVariant dst, uint64_t n, int depth) {
+    JsonArray arr = dst.to<JsonArray>();
+    for (uint64_t i = 0; i < n; i++) {
+      if (!value(arr.add<JsonVariant>(), depth + 1)) return false;
+    }
+    return true;
+  }
+
+  bool map(JsonVariant dst, uint64_t n, int depth) {
+    JsonObject obj = dst.to<JsonObject>();
+    for (uint64_t i = 0; i < n; i++) {
+      uint8_t tag;
+      std::string key;
+      if (!byte(tag) || !strTagged(tag, key)) return fail();
+      if (!value(obj[key].to<JsonVariant>(), depth + 1)) return false;
+    }
+    return true;
+  }
+};
+
+}  // namespace wire
+
+/**
+ * @brief Encode a message document as a binary frame ("~" + base64)
+ */
+inline std::string encodeBinary(JsonVariantConst msg) {
+  wire::Writer w;
+  w.byte(WIRE_VERSION);
+  w.value(msg);
+
+  std::vector<char> text(1 + base64Length(w.buf.size()) + 1);
+  text[0] = WIRE_BINARY_MARK;
+  base64Encode(w.buf.data(), w.buf.size(), text.data() + 1);
+  return std::string(text.data(), text.size() - 1);
+}
+
+/**
+ * @brief Encode with the mesh-wide format selected by MESHSWARM_WIRE_FORMAT
+ * @param peersSupportBinary false while any peer still advertises wire version 0
+ */
+inline std::string encodeMessage(JsonVariantConst msg, bool peersSupportBinary = true) {
+#if MESHSWARM_WIRE_FORMAT
+  if (peersSupportBinary) return encodeBinary(msg);
+#endif
+  (void)peersSupportBinary;
+  std::string out;
+  serializeJson(msg, out);
+  return out;
+}
+
+/**
+ * @brief Wire version of a received frame: 0 for JSON, else the binary version byte
+ */
+inline uint8_t wireVersion(const char* text) {
+  if (!text || text[0] != WIRE_BINARY_MARK) return 0;
+  uint8_t head[3];
+  char quad[5] = {0};
+  strncpy(quad, text + 1, 4);
+  return base64Decode(quad, head, sizeof(head)) > 0 ? head[0] : 0xFF;
+}
+
+/**
+ * @brief Decode a received frame, JSON or binary
+ * @return DeserializationError::Ok, or InvalidInput for a malformed binary
+ *         frame or one from a different wire version (see wireVersion())
+ */
+inline DeserializationError decodeMessage(const char* text, JsonDocument& doc) {
+  if (!text || text[0] != WIRE_BINARY_MARK) {
+    return deserializeJson(doc, text);
+  }
+
+  const char* b64 = text + 1;
+  size_t cap = (strlen(b64) / 4) * 3;
+  std::vector<uint8_t> raw(cap > 0 ? cap : 1);
+  size_t n = base64Decode(b64, raw.data(), raw.size());
+  if (n < 2) return DeserializationError::InvalidInput;
+  if (raw[0] != WIRE_VERSION) return DeserializationError::InvalidInput;
+
+  doc.clear();
+  wire::Reader r(raw.data() + 1, n - 1);
+  if (!r.value(doc.to<JsonVariant>()) || !r.atEnd()) {
+    return DeserializationError::InvalidInput;
+  }
+  if (doc.overflowed()) return DeserializationError::NoMemory;
+  return DeserializationError::Ok;
+}
+
+}  // namespace MeshProto
+
+#endif // MESHSWARM_WIRE_CODEC_H
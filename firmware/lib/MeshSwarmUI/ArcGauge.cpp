@@ -0,0 +1,166 @@
+/**
+ * ArcGauge - Scanline filled arcs and a delta-updating arc gauge widget
+ *
+ * Implementation of sector geometry and value mapping.
+ */
+
+#include "ArcGauge.h"
+
+namespace {
+
+// Smallest s with s * s >= n (n >= 0)
+int32_t ceilSqrt(int32_t n) {
+  if (n <= 0) return 0;
+  int32_t s = 0;
+  for (int32_t bit = 1 << 15; bit > 0; bit >>= 1) {
+    int32_t t = s | bit;
+    if (t * t <= n) s = t;
+  }
+  return (s * s == n) ? s : s + 1;
+}
+
+// Largest s with s * s <= n (n >= 0)
+int32_t floorSqrt(int32_t n) {
+  if (n <= 0) return 0;
+  int32_t s = 0;
+  for (int32_t bit = 1 << 15; bit > 0; bit >>= 1) {
+    int32_t t = s | bit;
+    if (t * t <= n) s = t;
+  }
+  return s;
+}
+
+}  // namespace
+
+namespace ArcRaster {
+
+Sector::Sector(int16_t radius, int16_t thickness, int16_t startHalfDeg, int16_t sweepHalfDeg,
+               bool openStart, bool openEnd)
+  : _openStart(openStart)
+  , _openEnd(openEnd)
+  , _empty(false)
+  , _top(0)
+  , _bottom(0)
+  , _left(0)
+  , _right(0)
+{
+  // Normalize to a clockwise sweep
+  if (sweepHalfDeg < 0) {
+    startHalfDeg += sweepHalfDeg;
+    sweepHalfDeg = -sweepHalfDeg;
+    _openStart = openEnd;
+    _openEnd = openStart;
+  }
+  if (sweepHalfDeg > FixedTrig::STEPS) sweepHalfDeg = FixedTrig::STEPS;
+  startHalfDeg = FixedTrig::wrap(startHalfDeg);
+  _sweep = sweepHalfDeg;
+
+  // Ring edges at pixel-center distance r + 0.5 and inner - 0.5
+  int16_t inner = radius - thickness + 1;
+  _outer2 = (int32_t)radius * radius + radius;
+  _inner2 = (inner > 0) ? (int32_t)inner * inner - inner : -1;
+
+  _u0x = FixedTrig::sinQ14(startHalfDeg);
+  _u0y = -FixedTrig::cosQ14(startHalfDeg);
+  _u1x = FixedTrig::sinQ14(startHalfDeg + _sweep);
+  _u1y = -FixedTrig::cosQ14(startHalfDeg + _sweep);
+
+  if (radius <= 0 || thickness <= 0 || (_sweep == 0 && (_openStart || _openEnd))) {
+    _empty = true;
+    return;
+  }
+
+  // Bounding box: both ends on both edges, plus any axis extreme inside the sweep
+  _top = _bottom = _left = _right = 0;
+  bool first = true;
+  int16_t edges[2] = { radius, (inner > 0) ? inner : (int16_t)0 };
+  for (int e = 0; e < 2; e++) {
+    int16_t ends[2] = { startHalfDeg, (int16_t)(startHalfDeg + _sweep) };
+    for (int k = 0; k < 2; k++) {
+      int16_t x = (int16_t)FixedTrig::scale(FixedTrig::sinQ14(ends[k]), edges[e]);
+      int16_t y = (int16_t)-FixedTrig::scale(FixedTrig::cosQ14(ends[k]), edges[e]);
+      if (first || x < _left) _left = x;
+      if (first || x > _right) _right = x;
+      if (first || y < _top) _top = y;
+      if (first || y > _bottom) _bottom = y;
+      first = false;
+    }
+  }
+  for (int16_t axis = 0; axis < FixedTrig::STEPS; axis += FixedTrig::QUARTER) {
+    if (FixedTrig::wrap(axis - startHalfDeg) <= _sweep) includeBounds(axis, radius);
+  }
+
+  // One pixel of slack for rounding; contains() does the exact test
+  _left = (_left - 1 < -radius) ? -radius : _left - 1;
+  _right = (_right + 1 > radius) ? radius : _right + 1;
+  _top = (_top - 1 < -radius) ? -radius : _top - 1;
+  _bottom = (_bottom + 1 > radius) ? radius : _bottom + 1;
+}
+
+void Sector::includeBounds(int16_t halfDeg, int16_t radius) {
+  int16_t x = (int16_t)FixedTrig::scale(FixedTrig::sinQ14(halfDeg), radius);
+  int16_t y = (int16_t)-FixedTrig::scale(FixedTrig::cosQ14(halfDeg), radius);
+  if (x < _left) _left = x;
+  if (x > _right) _right = x;
+  if (y < _top) _top = y;
+  if (y > _bottom) _bottom = y;
+}
+
+bool Sector::row(int16_t dy, int16_t& outer, int16_t& inner) const {
+  int32_t dy2 = (int32_t)dy * dy;
+  if (dy2 > _outer2) return false;
+  outer = (int16_t)floorSqrt(_outer2 - dy2);
+  inner = (_inner2 - dy2 > 0) ? (int16_t)ceilSqrt(_inner2 - dy2) : -1;
+  return inner <= outer;
+}
+
+bool Sector::contains(int16_t dx, int16_t dy) const {
+  if (dx == 0 && dy == 0) return true;  // Apex of a pie slice
+
+  int32_t c0 = _u0x * dy - _u0y * dx;   // > 0: clockwise of the start ray
+  int32_t c1 = dx * _u1y - dy * _u1x;   // > 0: counter-clockwise of the end ray
+
+  if (c0 == 0 && _u0x * dx + _u0y * dy > 0) return !_openStart;
+  if (c1 == 0 && _u1x * dx + _u1y * dy > 0) return !_openEnd;
+
+  if (_sweep <= FixedTrig::STEPS / 2) return c0 > 0 && c1 > 0;
+  return c0 > 0 || c1 > 0;
+}
+
+}  // namespace ArcRaster
+
+ArcGauge::ArcGauge(int16_t cx, int16_t cy, int16_t radius, int16_t thickness,
+                   int16_t startDeg, int16_t sweepDeg)
+  : _cx(cx)
+  , _cy(cy)
+  , _radius(radius)
+  , _thickness(thickness)
+  , _start(startDeg * 2)
+  , _span((sweepDeg < 0 ? -sweepDeg : sweepDeg) * 2)
+  , _dir(sweepDeg < 0 ? -1 : 1)
+  , _min(0)
+  , _max(100)
+  , _fill(0xFFFF)
+  , _track(0x2104)
+  , _shown(0)
+  , _drawn(false)
+{
+}
+
+void ArcGauge::setRange(float minValue, float maxValue) {
+  _min = minValue;
+  _max = maxValue;
+  _drawn = false;
+}
+
+void ArcGauge::setColors(uint16_t fill, uint16_t track) {
+  _fill = fill;
+  _track = track;
+  _drawn = false;
+}
+
+int16_t ArcGauge::toOffset(float value) const {
+  if (_max <= _min || value <= _min) return 0;
+  if (value >= _max) return _span;
+  return (int16_t)((value - _min) * _span / (_max - _min) + 0.5f);
+}
@@ -0,0 +1,221 @@
+/**
+ * ArcGauge - Scanline filled arcs and a delta-updating arc gauge widget
+ *
+ * ArcRaster::fill() draws a filled ring sector as horizontal runs: for each
+ * row inside the sector's bounding box it intersects the row with the ring
+ * (integer square roots) and keeps the pixels between the two boundary rays
+ * (integer cross products against FixedTrig directions). Each run is one
+ * drawFastHLine(), so a gauge costs a few hundred short transactions
+ * instead of one drawPixel() per sample, and there are no gaps between
+ * samples.
+ *
+ * ArcGauge remembers the value on screen. Moving from A to B repaints only
+ * the sector between them: fill color when growing, track color when
+ * shrinking.
+ *
+ * Angles are in degrees, clock convention (0 = 12 o'clock, clockwise).
+ * A negative sweep runs counter-clockwise from the start angle.
+ *
+ * Works with any Adafruit_GFX-style target (TFT_eSPI, DIYables_TFT_Round,
+ * sprites) that provides drawFastHLine().
+ *
+ * Usage:
+ *   ArcGauge temp(CENTER_X, CENTER_Y, 95, 12, 290, 140);  // Across the top
+ *   temp.setRange(0, 40);
+ *   temp.setColors(COLOR_ARC_TEMP, COLOR_ARC_BG);
+ *
+ *   temp.draw(tft);               // Whole gauge, after clearing the screen
+ *   temp.setValue(tft, 21.5);     // Repaints only the changed sector
+ */
+
+#ifndef ARC_GAUGE_H
+#define ARC_GAUGE_H
+
+#include <stdint.h>
+#include "FixedTrig.h"
+
+namespace ArcRaster {
+
+/**
+ * Ring sector geometry, prepared once per fill
+ */
+class Sector {
+public:
+  /**
+   * @param radius Outer radius (pixels)
+   * @param thickness Ring thickness (pixels, inner radius = radius - thickness + 1)
+   * @param startHalfDeg Start angle in half-degrees (clock convention)
+   * @param sweepHalfDeg Signed sweep in half-degrees (negative = counter-clockwise)
+   * @param openStart,openEnd Exclude the start / end boundary ray
+   */
+  Sector(int16_t radius, int16_t thickness, int16_t startHalfDeg, int16_t sweepHalfDeg,
+         bool openStart = false, bool openEnd = false);
+
+  bool empty() const { return _empty; }
+
+  // Bounding box relative to the center
+  int16_t top() const { return _top; }
+  int16_t bottom() const { return _bottom; }
+  int16_t left() const { return _left; }
+  int16_t right() const { return _right; }
+
+  /**
+   * Ring intersection of row dy: [-outer, -inner] and [inner, outer]
+   * (inner < 0 means the row is one run [-outer, outer])
+   * @return false if the row misses the ring
+   */
+  bool row(int16_t dy, int16_t& outer, int16_t& inner) const;
+
+  /**
+   * True if the pixel at (dx, dy) from the center lies between the rays
+   */
+  bool contains(int16_t dx, int16_t dy) const;
+
+private:
+  int32_t _outer2, _inner2;
+  int32_t _u0x, _u0y, _u1x, _u1y;  // Q14 start / end directions (clockwise order)
+  int16_t _sweep;                  // Clockwise sweep, half-degrees (0..720)
+  bool _openStart, _openEnd;
+  bool _empty;
+  int16_t _top, _bottom, _left, _right;
+
+  void includeBounds(int16_t halfDeg, int16_t radius);
+};
+
+template <class GFX>
+void emitRun(GFX& gfx, int16_t cx, int16_t cy, int16_t dy, int16_t from, int16_t to,
+             const Sector& sector, uint16_t color) {
+  int16_t runStart = 0;
+  bool inRun = false;
+  for (int16_t dx = from; dx <= to; dx++) {
+    bool in = sector.contains(dx, dy);
+    if (in && !inRun) {
+      runStart = dx;
+      inRun = true;
+    } else if (!in && inRun) {
+      gfx.drawFastHLine(cx + runStart, cy + dy, dx - runStart, color);
+      inRun = false;
+    }
+  }
+  if (inRun) gfx.drawFastHLine(cx + runStart, cy + dy, to - runStart + 1, color);
+}
+
+/**
+ * Fill a ring sector with horizontal runs
+ */
+template <class GFX>
+void fill(GFX& gfx, int16_t cx, int16_t cy, const Sector& sector, uint16_t color) {
+  if (sector.empty()) return;
+
+  for (int16_t dy = sector.top(); dy <= sector.bottom(); dy++) {
+    int16_t outer, inner;
+    if (!sector.row(dy, outer, inner)) continue;
+
+    int16_t lo = (-outer > sector.left()) ? -outer : sector.left();
+    int16_t hi = (outer < sector.right()) ? outer : sector.right();
+    if (inner < 0) {
+      if (lo <= hi) emitRun(gfx, cx, cy, dy, lo, hi, sector, color);
+    } else {
+      if (lo <= -inner) emitRun(gfx, cx, cy, dy, lo, (-inner < hi) ? -inner : hi, sector, color);
+      if (inner <= hi) emitRun(gfx, cx, cy, dy, (inner > lo) ? inner : lo, hi, sector, color);
+    }
+  }
+}
+
+/**
+ * Fill a ring sector (angles in degrees, clock convention)
+ */
+template <class GFX>
+void fill(GFX& gfx, int16_t cx, int16_t cy, int16_t radius, int16_t thickness,
+          int16_t startDeg, int16_t sweepDeg, uint16_t color) {
+  fill(gfx, cx, cy, Sector(radius, thickness, startDeg * 2, sweepDeg * 2), color);
+}
+
+}  // namespace ArcRaster
+
+class ArcGauge {
+public:
+  /**
+   * @param cx,cy Center
+   * @param radius Outer radius
+   * @param thickness Ring thickness
+   * @param startDeg Angle of the minimum value (clock convention)
+   * @param sweepDeg Degrees from minimum to maximum (negative = counter-clockwise)
+   */
+  ArcGauge(int16_t cx, int16_t cy, int16_t radius, int16_t thickness,
+           int16_t startDeg, int16_t sweepDeg);
+
+  void setRange(float minValue, float maxValue);
+  void setColors(uint16_t fill, uint16_t track);
+
+  /**
+   * Forget what is on screen (next setValue() draws the whole gauge)
+   */
+  void invalidate() { _drawn = false; }
+
+  /**
+   * Draw the whole gauge at its current value
+   */
+  template <class GFX>
+  void draw(GFX& gfx) {
+    if (_shown > 0) {
+      fillOffsets(gfx, 0, _shown, false, _fill);
+      fillOffsets(gfx, _shown, _span, true, _track);
+    } else {
+      fillOffsets(gfx, 0, _span, false, _track);
+    }
+    _drawn = true;
+  }
+
+  /**
+   * Move the gauge to a value, repainting only the sector that changed
+   * @return true if anything was drawn
+   */
+  template <class GFX>
+  bool setValue(GFX& gfx, float value) {
+    int16_t target = toOffset(value);
+    if (!_drawn) {
+      _shown = target;
+      draw(gfx);
+      return true;
+    }
+    if (target == _shown) return false;
+
+    if (target > _shown) {
+      fillOffsets(gfx, _shown, target, false, _fill);
+    } else {
+      // Keep the ray at the new value filled, unless the gauge is now empty
+      fillOffsets(gfx, target, _shown, target > 0, _track);
+    }
+    _shown = target;
+    return true;
+  }
+
+  float getMin() const { return _min; }
+  float getMax() const { return _max; }
+
+private:
+  int16_t _cx, _cy, _radius, _thickness;
+  int16_t _start;   // Half-degrees
+  int16_t _span;    // Half-degrees from minimum to maximum (unsigned)
+  int8_t _dir;      // +1 clockwise, -1 counter-clockwise
+  float _min, _max;
+  uint16_t _fill, _track;
+  int16_t _shown;   // Offset on screen, half-degrees along the gauge
+  bool _drawn;
+
+  int16_t toOffset(float value) const;
+
+  /**
+   * Paint gauge offsets [from, to] (from excluded if openFrom)
+   */
+  template <class GFX>
+  void fillOffsets(GFX& gfx, int16_t from, int16_t to, bool openFrom, uint16_t color) {
+    ArcRaster::Sector sector = (_dir > 0)
+      ? ArcRaster::Sector(_radius, _thickness, _start + from, to - from, openFrom, false)
+      : ArcRaster::Sector(_radius, _thickness, _start - to, to - from, false, openFrom);
+    ArcRaster::fill(gfx, _cx, _cy, sector, color);
+  }
+};
+
+#endif // ARC_GAUGE_H
@@ -0,0 +1,142 @@
+/**
+ * ClockHand - Scanline-rasterized analog clock hand with delta erase
+ *
+ * Implementation of the polygon rasterizer and color blending.
+ */
+
+#include "ClockHand.h"
+
+namespace {
+
+// Sub-pixel precision: coordinates are in 1/16 pixel, pixel centers at +8
+constexpr int32_t SUB = 16;
+constexpr int32_t HALF = SUB / 2;
+
+// Floor division that rounds toward -infinity for negative numerators
+int32_t floorDiv(int32_t a, int32_t b) {
+  return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+int32_t ceilDiv(int32_t a, int32_t b) {
+  return -floorDiv(-a, b);
+}
+
+}  // namespace
+
+ClockHand::ClockHand(int16_t cx, int16_t cy, int16_t length, uint8_t width, uint16_t color,
+                     uint8_t tipWidth)
+  : _cx(cx)
+  , _cy(cy)
+  , _length(length)
+  , _width(width)
+  , _tipWidth(tipWidth ? tipWidth : width)
+  , _color(color)
+  , _antialias(CLOCK_HAND_ANTIALIAS)
+  , _front(0)
+  , _back(1)
+  , _shown(false)
+  , _pending(false)
+  , _placed(false)
+  , _angle(-1)
+{
+  _spans[0].rows = 0;
+  _spans[1].rows = 0;
+}
+
+void ClockHand::reset() {
+  _shown = false;
+}
+
+bool ClockHand::moveTo(int16_t halfDeg) {
+  halfDeg = FixedTrig::wrap(halfDeg);
+  if (_placed && halfDeg == _angle) return false;
+
+  rasterize(halfDeg, _spans[_back]);
+  _angle = halfDeg;
+  _pending = true;
+  _placed = true;
+  return true;
+}
+
+void ClockHand::rasterize(int16_t halfDeg, Spans& out) const {
+  int32_t s = FixedTrig::sinQ14(halfDeg);
+  int32_t c = FixedTrig::cosQ14(halfDeg);
+
+  // Half widths in sub-pixels; at least ~0.6 px so 1 px hands stay solid
+  int32_t hubHalf = _width * HALF;
+  int32_t tipHalf = _tipWidth * HALF;
+  if (hubHalf < 10) hubHalf = 10;
+  if (tipHalf < 10) tipHalf = 10;
+
+  // Direction is (s, -c) on screen; perpendicular is (c, s)
+  int32_t hx = _cx * SUB + HALF;
+  int32_t hy = _cy * SUB + HALF;
+  int32_t tx = hx + FixedTrig::scale(s, _length * SUB);
+  int32_t ty = hy - FixedTrig::scale(c, _length * SUB);
+  int32_t hpx = FixedTrig::scale(c, hubHalf), hpy = FixedTrig::scale(s, hubHalf);
+  int32_t tpx = FixedTrig::scale(c, tipHalf), tpy = FixedTrig::scale(s, tipHalf);
+
+  const int32_t px[4] = { hx + hpx, tx + tpx, tx - tpx, hx - hpx };
+  const int32_t py[4] = { hy + hpy, ty + tpy, ty - tpy, hy - hpy };
+
+  int32_t minY = py[0], maxY = py[0];
+  for (int k = 1; k < 4; k++) {
+    if (py[k] < minY) minY = py[k];
+    if (py[k] > maxY) maxY = py[k];
+  }
+
+  // Rows whose pixel centers fall inside the polygon
+  int32_t firstRow = ceilDiv(minY - HALF, SUB);
+  int32_t lastRow = floorDiv(maxY - HALF, SUB);
+  if (lastRow - firstRow + 1 > CLOCK_HAND_MAX_ROWS) lastRow = firstRow + CLOCK_HAND_MAX_ROWS - 1;
+
+  out.y0 = (int16_t)firstRow;
+  out.rows = 0;
+  for (int32_t row = firstRow; row <= lastRow; row++) {
+    int32_t sy = row * SUB + HALF;
+    int32_t minX = INT32_MAX, maxX = INT32_MIN;
+
+    for (int k = 0; k < 4; k++) {
+      int32_t x0 = px[k], y0 = py[k];
+      int32_t x1 = px[(k + 1) & 3], y1 = py[(k + 1) & 3];
+      if ((sy < y0 && sy < y1) || (sy > y0 && sy > y1)) continue;
+
+      int32_t x;
+      if (y0 == y1) {
+        if (x0 < minX) minX = x0;
+        if (x0 > maxX) maxX = x0;
+        x = x1;
+      } else {
+        x = x0 + (sy - y0) * (x1 - x0) / (y1 - y0);
+      }
+      if (x < minX) minX = x;
+      if (x > maxX) maxX = x;
+    }
+    if (minX > maxX) minX = maxX = hx;  // Cannot happen for a convex quad
+
+    int16_t i = out.rows++;
+    int32_t xl = ceilDiv(minX - HALF, SUB);
+    int32_t xr = floorDiv(maxX - HALF, SUB);
+    if (xl > xr) {
+      // Sliver between pixel centers: keep the nearest pixel so thin hands stay connected
+      xl = xr = floorDiv((minX + maxX) / 2, SUB);
+    }
+    out.xl[i] = (int16_t)xl;
+    out.xr[i] = (int16_t)xr;
+
+    // Fraction of the neighbouring pixel covered by the edge, 0..255
+    int32_t left = xl * SUB - minX;
+    int32_t right = maxX - (xr + 1) * SUB;
+    out.al[i] = (uint8_t)(left <= 0 ? 0 : (left >= SUB ? 255 : left * 16));
+    out.ar[i] = (uint8_t)(right <= 0 ? 0 : (right >= SUB ? 255 : right * 16));
+  }
+  if (out.rows == 0) out.y0 = _cy;
+}
+
+uint16_t ClockHand::blend565(uint16_t fg, uint16_t bg, uint8_t alpha) {
+  uint32_t a = alpha ? alpha + 1 : 0;  // 255 maps to fg exactly, 0 to bg
+  uint32_t r = (((fg >> 11) & 0x1F) * a + ((bg >> 11) & 0x1F) * (256 - a)) >> 8;
+  uint32_t g = (((fg >> 5) & 0x3F) * a + ((bg >> 5) & 0x3F) * (256 - a)) >> 8;
+  uint32_t b = ((fg & 0x1F) * a + (bg & 0x1F) * (256 - a)) >> 8;
+  return (uint16_t)((r << 11) | (g << 5) | b);
+}
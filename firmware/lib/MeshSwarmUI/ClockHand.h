@@ -0,0 +1,161 @@
+/**
+ * ClockHand - Scanline-rasterized analog clock hand with delta erase
+ *
+ * A hand is a convex polygon (a wedge from the hub to the tip) converted
+ * once per move into one horizontal span per screen row, using FixedTrig
+ * and 1/16-pixel fixed point. Drawing is one drawFastHLine() per row
+ * instead of 2*width drawLine() calls.
+ *
+ * The spans of the hand currently on screen are kept, so moving the hand
+ * erases only the pixels the old position covered and the new one does
+ * not, rather than overdrawing the whole old hand with background.
+ *
+ * Optional anti-aliasing blends one edge pixel per side of each span
+ * toward the background color (which must be a solid fill).
+ *
+ * Works with any Adafruit_GFX-style target (TFT_eSPI, DIYables_TFT_Round,
+ * sprites) that provides drawFastHLine() and drawPixel().
+ *
+ * Usage:
+ *   ClockHand secHand(CENTER_X, CENTER_Y, SEC_HAND_LEN, 1, COLOR_SECOND);
+ *
+ *   // Each tick: move all hands, erase all, then draw back to front
+ *   secHand.moveTo(FixedTrig::fromSeconds(sec));
+ *   secHand.erase(tft, COLOR_BG);
+ *   secHand.draw(tft, COLOR_BG);
+ *
+ *   // After clearing the screen:
+ *   secHand.reset();
+ */
+
+#ifndef CLOCK_HAND_H
+#define CLOCK_HAND_H
+
+#include <stdint.h>
+#include "FixedTrig.h"
+
+// Rows stored per hand position (must cover 2 * length + width)
+#ifndef CLOCK_HAND_MAX_ROWS
+#define CLOCK_HAND_MAX_ROWS 160
+#endif
+
+// Default anti-aliasing for new hands (0 = off, 1 = blend edge pixels)
+#ifndef CLOCK_HAND_ANTIALIAS
+#define CLOCK_HAND_ANTIALIAS 0
+#endif
+
+class ClockHand {
+public:
+  /**
+   * @param cx,cy Hub position
+   * @param length Hub to tip, in pixels
+   * @param width Width at the hub, in pixels
+   * @param color Hand color (RGB565)
+   * @param tipWidth Width at the tip (0 = same as width)
+   */
+  ClockHand(int16_t cx, int16_t cy, int16_t length, uint8_t width, uint16_t color,
+            uint8_t tipWidth = 0);
+
+  void setAntialias(bool enabled) { _antialias = enabled; }
+
+  /**
+   * Forget what is on screen (call after the face is cleared)
+   */
+  void reset();
+
+  /**
+   * Rasterize the hand at a new angle (half-degrees, see FixedTrig)
+   * @return true if the position changed
+   */
+  bool moveTo(int16_t halfDeg);
+
+  /**
+   * Erase pixels of the on-screen hand that the new position does not cover
+   */
+  template <class GFX>
+  void erase(GFX& gfx, uint16_t bg) {
+    if (!_shown || !_pending) return;  // Nothing on screen, or not moving
+    const Spans& from = _spans[_front];
+    const Spans& to = _spans[_back];
+    int16_t pad = _antialias ? 1 : 0;
+
+    for (int16_t i = 0; i < from.rows; i++) {
+      int16_t y = from.y0 + i;
+      int16_t ol = from.xl[i] - pad;
+      int16_t orr = from.xr[i] + pad;
+
+      int16_t j = y - to.y0;
+      if (j >= 0 && j < to.rows) {
+        int16_t nl = to.xl[j] - pad;
+        int16_t nr = to.xr[j] + pad;
+        // Old span minus new span: up to one piece on each side
+        int16_t leftEnd = (orr < nl - 1) ? orr : nl - 1;
+        if (leftEnd >= ol) gfx.drawFastHLine(ol, y, leftEnd - ol + 1, bg);
+        int16_t rightStart = (ol > nr + 1) ? ol : nr + 1;
+        if (orr >= rightStart) gfx.drawFastHLine(rightStart, y, orr - rightStart + 1, bg);
+      } else {
+        gfx.drawFastHLine(ol, y, orr - ol + 1, bg);
+      }
+    }
+  }
+
+  /**
+   * Draw the hand at its latest position and make it the on-screen one
+   * @param bg Background used for anti-aliased edge pixels
+   */
+  template <class GFX>
+  void draw(GFX& gfx, uint16_t bg) {
+    if (_pending) {
+      _front = _back;
+      _back ^= 1;
+      _pending = false;
+    }
+    if (!_placed) return;
+
+    const Spans& s = _spans[_front];
+    for (int16_t i = 0; i < s.rows; i++) {
+      int16_t y = s.y0 + i;
+      gfx.drawFastHLine(s.xl[i], y, s.xr[i] - s.xl[i] + 1, _color);
+      if (_antialias) {
+        // Always written, even at zero coverage: erase() treats them as covered
+        gfx.drawPixel(s.xl[i] - 1, y, blend565(_color, bg, s.al[i]));
+        gfx.drawPixel(s.xr[i] + 1, y, blend565(_color, bg, s.ar[i]));
+      }
+    }
+    _shown = true;
+  }
+
+  int16_t angle() const { return _angle; }
+
+  /**
+   * Mix two RGB565 colors (alpha 0 = bg, 255 = fg)
+   */
+  static uint16_t blend565(uint16_t fg, uint16_t bg, uint8_t alpha);
+
+private:
+  struct Spans {
+    int16_t y0;
+    int16_t rows;
+    int16_t xl[CLOCK_HAND_MAX_ROWS];
+    int16_t xr[CLOCK_HAND_MAX_ROWS];
+    uint8_t al[CLOCK_HAND_MAX_ROWS];  // Edge coverage left of xl
+    uint8_t ar[CLOCK_HAND_MAX_ROWS];  // Edge coverage right of xr
+  };
+
+  int16_t _cx, _cy, _length;
+  uint8_t _width, _tipWidth;
+  uint16_t _color;
+  bool _antialias;
+
+  Spans _spans[2];
+  uint8_t _front;    // Spans on screen (valid when _shown)
+  uint8_t _back;     // Spans from the latest moveTo() (valid when _pending)
+  bool _shown;
+  bool _pending;
+  bool _placed;      // moveTo() has been called at least once
+  int16_t _angle;
+
+  void rasterize(int16_t halfDeg, Spans& out) const;
+};
+
+#endif // CLOCK_HAND_H
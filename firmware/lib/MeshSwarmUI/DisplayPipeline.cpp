@@ -0,0 +1,114 @@
+/**
+ * DisplayPipeline - Double-buffered SPI DMA pixel pipeline for TFT_eSPI
+ *
+ * Implementation of buffer rotation and DMA submission.
+ */
+
+// Nodes that include only the TFT-independent parts of MeshSwarmUI
+// (FixedTrig, ClockHand) do not have TFT_eSPI in their lib_deps
+#if __has_include(<TFT_eSPI.h>)
+
+#include "DisplayPipeline.h"
+#include <esp_heap_caps.h>
+
+DisplayPipeline::DisplayPipeline()
+  : _tft(nullptr)
+  , _bufferPixels(0)
+  , _next(0)
+  , _dma(false)
+  , _inWrite(false)
+  , _transfers(0)
+  , _bytesSent(0)
+  , _waitMicros(0)
+{
+  _buffers[0] = nullptr;
+  _buffers[1] = nullptr;
+}
+
+bool DisplayPipeline::begin(TFT_eSPI& tft, size_t bufferPixels) {
+  _tft = &tft;
+  if (_dma) return true;
+
+  _bufferPixels = bufferPixels;
+  for (int i = 0; i < 2; i++) {
+    _buffers[i] = (uint16_t*)heap_caps_malloc(bufferPixels * sizeof(uint16_t), MALLOC_CAP_DMA);
+  }
+
+  if (_buffers[0] == nullptr || _buffers[1] == nullptr || !tft.initDMA()) {
+    for (int i = 0; i < 2; i++) {
+      heap_caps_free(_buffers[i]);
+      _buffers[i] = nullptr;
+    }
+    Serial.println("[DISPLAY] DMA unavailable, using blocking pushes");
+    return false;
+  }
+
+  _dma = true;
+  Serial.printf("[DISPLAY] DMA pipeline: 2 x %u px buffers\n", (unsigned)bufferPixels);
+  return true;
+}
+
+void DisplayPipeline::pushRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                               const uint16_t* src, size_t stride) {
+  if (_tft == nullptr || w <= 0 || h <= 0) return;
+
+  if (!_dma) {
+    // Sprite pixels are already in panel byte order
+    bool swap = _tft->getSwapBytes();
+    _tft->setSwapBytes(false);
+    if (stride == (size_t)w) {
+      _tft->pushImage(x, y, w, h, (uint16_t*)src);
+    } else {
+      for (int16_t row = 0; row < h; row++) {
+        _tft->pushImage(x, y + row, w, 1, (uint16_t*)(src + (size_t)row * stride));
+      }
+    }
+    _tft->setSwapBytes(swap);
+    _transfers++;
+    _bytesSent += (uint32_t)w * h * 2;
+    return;
+  }
+
+  int16_t rowsPerBand = _bufferPixels / w;
+  if (rowsPerBand <= 0) return;  // Wider than a buffer
+
+  if (!_inWrite) {
+    _tft->startWrite();
+    _inWrite = true;
+  }
+
+  bool swap = _tft->getSwapBytes();
+  _tft->setSwapBytes(false);
+
+  for (int16_t row = 0; row < h; row += rowsPerBand) {
+    int16_t rows = (h - row < rowsPerBand) ? (h - row) : rowsPerBand;
+
+    // Only one transfer is ever in flight, and it uses the other buffer
+    uint16_t* buffer = _buffers[_next];
+    _next ^= 1;
+    for (int16_t r = 0; r < rows; r++) {
+      memcpy(buffer + (size_t)r * w, src + (size_t)(row + r) * stride, w * sizeof(uint16_t));
+    }
+
+    // pushImageDMA waits for the previous transfer before queueing
+    uint32_t start = micros();
+    _tft->pushImageDMA(x, y + row, w, rows, buffer);
+    _waitMicros += micros() - start;
+    _transfers++;
+    _bytesSent += (uint32_t)w * rows * 2;
+  }
+
+  _tft->setSwapBytes(swap);
+}
+
+void DisplayPipeline::finish() {
+  if (!_inWrite) return;
+
+  uint32_t start = micros();
+  _tft->dmaWait();
+  _tft->endWrite();
+  _waitMicros += micros() - start;
+  _inWrite = false;
+}
+
+#endif // __has_include(<TFT_eSPI.h>)
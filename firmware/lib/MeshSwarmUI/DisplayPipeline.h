@@ -0,0 +1,83 @@
+/**
+ * DisplayPipeline - Double-buffered SPI DMA pixel pipeline for TFT_eSPI
+ *
+ * Blocking TFT_eSPI calls keep the CPU in the SPI driver for the whole
+ * transfer. The pipeline instead owns two DMA-capable buffers: the caller's
+ * pixels are copied into the free buffer and queued with pushImageDMA(),
+ * and the call returns while the transfer runs. The next pushRect() fills
+ * the other buffer and only waits if the previous transfer is still going,
+ * so drawing, copying and swarm.update() overlap the SPI traffic.
+ *
+ * Rectangles larger than one buffer are sent in row bands.
+ *
+ * The panel bus is busy while a transfer is in flight, so any direct
+ * TFT_eSPI drawing must call finish() first. If DMA cannot be initialized
+ * the pipeline falls back to blocking pushImage() with the same API.
+ *
+ * Usage:
+ *   DisplayPipeline pipeline;
+ *   pipeline.begin(tft);
+ *   pipeline.pushRect(x, y, w, h, sprite.getPointer(), sprite.width());
+ *   ...
+ *   pipeline.finish();   // Before drawing with tft directly
+ */
+
+#ifndef DISPLAY_PIPELINE_H
+#define DISPLAY_PIPELINE_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+
+// Pixels per DMA buffer (two are allocated). 9600 = 240x40 lines, 19.2 KB each.
+#ifndef DISPLAY_DMA_BUFFER_PIXELS
+#define DISPLAY_DMA_BUFFER_PIXELS 9600
+#endif
+
+class DisplayPipeline {
+public:
+  DisplayPipeline();
+
+  /**
+   * Allocate the DMA buffers and enable TFT_eSPI DMA (call once at boot)
+   * @return true if DMA is active (false = blocking fallback)
+   */
+  bool begin(TFT_eSPI& tft, size_t bufferPixels = DISPLAY_DMA_BUFFER_PIXELS);
+
+  bool isDma() const { return _dma; }
+
+  /**
+   * Queue a rectangle of pixels in panel byte order (as stored by TFT_eSprite)
+   * @param src First pixel of the rectangle
+   * @param stride Pixels per source row (>= w)
+   */
+  void pushRect(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* src, size_t stride);
+
+  /**
+   * Wait for the transfer in flight and release the bus
+   */
+  void finish();
+
+  /**
+   * True while a transfer may still be running
+   */
+  bool isBusy() const { return _inWrite; }
+
+  // Stats
+  uint32_t transfers() const { return _transfers; }
+  uint32_t bytesSent() const { return _bytesSent; }
+  uint32_t waitMicros() const { return _waitMicros; }  // Time spent blocked on the bus
+
+private:
+  TFT_eSPI* _tft;
+  uint16_t* _buffers[2];
+  size_t _bufferPixels;
+  uint8_t _next;
+  bool _dma;
+  bool _inWrite;
+
+  uint32_t _transfers;
+  uint32_t _bytesSent;
+  uint32_t _waitMicros;
+};
+
+#endif // DISPLAY_PIPELINE_H
@@ -0,0 +1,98 @@
+/**
+ * FixedTrig - Compile-time fixed-point sine table for dial geometry
+ *
+ * One quarter wave of sin() in Q14 (16384 = 1.0) at half-degree steps,
+ * folded to cover the full circle: 720 positions, which hits every clock
+ * position exactly (6 deg per second/minute, 0.5 deg per hour-hand minute).
+ * Lookups are a table read and a multiply, no float and no libm.
+ *
+ * Angles are in half-degrees (0..719), clock convention: 0 = 12 o'clock,
+ * increasing clockwise, screen y pointing down.
+ *
+ * Usage:
+ *   int16_t x, y;
+ *   FixedTrig::dialPoint(CENTER_X, CENTER_Y, SEC_HAND_LEN, FixedTrig::fromSeconds(sec), x, y);
+ */
+
+#ifndef FIXED_TRIG_H
+#define FIXED_TRIG_H
+
+#include <stdint.h>
+
+namespace FixedTrig {
+
+constexpr int32_t ONE = 16384;          // Q14 1.0
+constexpr int16_t STEPS = 720;          // Half-degrees per turn
+constexpr int16_t QUARTER = STEPS / 4;
+
+// sin(i * 0.5 deg) for i = 0..180, Q14
+constexpr int16_t QUARTER_SINE[QUARTER + 1] = {
+      0,   143,   286,   429,   572,   715,   857,  1000,  1143,  1285,  1428,  1570,
+   1713,  1855,  1997,  2139,  2280,  2422,  2563,  2704,  2845,  2986,  3126,  3266,
+   3406,  3546,  3686,  3825,  3964,  4102,  4240,  4378,  4516,  4653,  4790,  4927,
+   5063,  5199,  5334,  5469,  5604,  5738,  5872,  6005,  6138,  6270,  6402,  6533,
+   6664,  6794,  6924,  7053,  7182,  7311,  7438,  7565,  7692,  7818,  7943,  8068,
+   8192,  8316,  8438,  8561,  8682,  8803,  8923,  9043,  9162,  9280,  9397,  9514,
+   9630,  9746,  9860,  9974, 10087, 10199, 10311, 10422, 10531, 10641, 10749, 10856,
+  10963, 11069, 11174, 11278, 11381, 11484, 11585, 11686, 11786, 11885, 11982, 12080,
+  12176, 12271, 12365, 12458, 12551, 12642, 12733, 12822, 12911, 12998, 13085, 13170,
+  13255, 13338, 13421, 13502, 13583, 13662, 13741, 13818, 13894, 13970, 14044, 14117,
+  14189, 14260, 14330, 14399, 14466, 14533, 14598, 14663, 14726, 14788, 14849, 14909,
+  14968, 15025, 15082, 15137, 15191, 15244, 15296, 15346, 15396, 15444, 15491, 15537,
+  15582, 15626, 15668, 15709, 15749, 15788, 15826, 15862, 15897, 15931, 15964, 15996,
+  16026, 16055, 16083, 16110, 16135, 16159, 16182, 16204, 16225, 16244, 16262, 16279,
+  16294, 16309, 16322, 16333, 16344, 16353, 16362, 16368, 16374, 16378, 16382, 16383,
+  16384
+};
+
+/** Wrap any half-degree angle into 0..719 */
+constexpr int16_t wrap(int32_t halfDeg) {
+  return (int16_t)(((halfDeg % STEPS) + STEPS) % STEPS);
+}
+
+/** sin(halfDeg / 2 degrees) in Q14 */
+constexpr int32_t sinQ14(int32_t halfDeg) {
+  return wrap(halfDeg) <= QUARTER         ? QUARTER_SINE[wrap(halfDeg)]
+       : wrap(halfDeg) <= 2 * QUARTER     ? QUARTER_SINE[2 * QUARTER - wrap(halfDeg)]
+       : wrap(halfDeg) <= 3 * QUARTER     ? -QUARTER_SINE[wrap(halfDeg) - 2 * QUARTER]
+       :                                    -QUARTER_SINE[STEPS - wrap(halfDeg)];
+}
+
+/** cos(halfDeg / 2 degrees) in Q14 */
+constexpr int32_t cosQ14(int32_t halfDeg) {
+  return sinQ14(halfDeg + QUARTER);
+}
+
+/** Scale a Q14 value by an integer length, rounded to nearest */
+constexpr int32_t scale(int32_t q14, int32_t length) {
+  return (q14 * length + (q14 * length >= 0 ? ONE / 2 : -ONE / 2)) / ONE;
+}
+
+// Angle helpers for dial positions
+constexpr int16_t fromDegrees(int32_t deg) { return wrap(deg * 2); }
+constexpr int16_t fromSeconds(int32_t sec) { return wrap(sec * 12); }      // 6 deg each
+constexpr int16_t fromMinutes(int32_t min, int32_t sec = 0) {              // + 0.1 deg per sec
+  return wrap(min * 12 + sec / 5);
+}
+constexpr int16_t fromHours(int32_t hour, int32_t min = 0) {               // + 0.5 deg per min
+  return wrap((hour % 12) * 60 + min);
+}
+
+/** Point at distance r from (cx, cy) at a clock angle */
+inline void dialPoint(int16_t cx, int16_t cy, int16_t r, int16_t halfDeg, int16_t& x, int16_t& y) {
+  x = cx + (int16_t)scale(sinQ14(halfDeg), r);
+  y = cy - (int16_t)scale(cosQ14(halfDeg), r);
+}
+
+inline void dialPoint(int cx, int cy, int r, int halfDeg, int* x, int* y) {
+  *x = cx + (int)scale(sinQ14(halfDeg), r);
+  *y = cy - (int)scale(cosQ14(halfDeg), r);
+}
+
+static_assert(QUARTER_SINE[QUARTER] == ONE, "sine table must end at 1.0");
+static_assert(sinQ14(fromDegrees(270)) == -ONE, "quadrant folding");
+static_assert(cosQ14(fromDegrees(180)) == -ONE, "quadrant folding");
+
+}  // namespace FixedTrig
+
+#endif // FIXED_TRIG_H
@@ -0,0 +1,114 @@
+/**
+ * GlyphAtlas - Pre-rendered digit glyphs blitted as one window write
+ *
+ * Implementation of cell rasterization and string composition.
+ */
+
+#include "GlyphAtlas.h"
+#include <stdlib.h>
+
+const char GlyphAtlas::CHARSET[] = "0123456789:-. ";
+
+namespace {
+
+// Columns of the classic 5x7 GFX font, bit 0 = top row (CHARSET order)
+const uint8_t FONT_COLUMNS[][5] = {
+  { 0x3E, 0x51, 0x49, 0x45, 0x3E },  // 0
+  { 0x00, 0x42, 0x7F, 0x40, 0x00 },  // 1
+  { 0x42, 0x61, 0x51, 0x49, 0x46 },  // 2
+  { 0x21, 0x41, 0x45, 0x4B, 0x31 },  // 3
+  { 0x18, 0x14, 0x12, 0x7F, 0x10 },  // 4
+  { 0x27, 0x45, 0x45, 0x45, 0x39 },  // 5
+  { 0x3C, 0x4A, 0x49, 0x49, 0x30 },  // 6
+  { 0x01, 0x71, 0x09, 0x05, 0x03 },  // 7
+  { 0x36, 0x49, 0x49, 0x49, 0x36 },  // 8
+  { 0x06, 0x49, 0x49, 0x29, 0x1E },  // 9
+  { 0x00, 0x36, 0x36, 0x00, 0x00 },  // :
+  { 0x08, 0x08, 0x08, 0x08, 0x08 },  // -
+  { 0x00, 0x60, 0x60, 0x00, 0x00 },  // .
+  { 0x00, 0x00, 0x00, 0x00, 0x00 },  // space
+};
+
+const uint8_t CELL_COUNT = sizeof(FONT_COLUMNS) / sizeof(FONT_COLUMNS[0]);
+
+}  // namespace
+
+GlyphAtlas::GlyphAtlas()
+  : _size(1)
+  , _fg(0xFFFF)
+  , _bg(0x0000)
+  , _cells(nullptr)
+  , _scratch(nullptr)
+{
+}
+
+GlyphAtlas::~GlyphAtlas() {
+  release();
+}
+
+void GlyphAtlas::release() {
+  free(_cells);
+  free(_scratch);
+  _cells = nullptr;
+  _scratch = nullptr;
+}
+
+bool GlyphAtlas::begin(uint8_t size, uint16_t fg, uint16_t bg) {
+  release();
+  _size = size > 0 ? size : 1;
+  _fg = fg;
+  _bg = bg;
+
+  const int16_t cw = cellWidth();
+  const int16_t ch = cellHeight();
+  const size_t cellPixels = (size_t)cw * ch;
+
+  _cells = (uint16_t*)malloc(cellPixels * CELL_COUNT * sizeof(uint16_t));
+  _scratch = (uint16_t*)malloc(cellPixels * GLYPH_ATLAS_MAX_CHARS * sizeof(uint16_t));
+  if (_cells == nullptr || _scratch == nullptr) {
+    release();
+    return false;
+  }
+
+  for (uint8_t i = 0; i < CELL_COUNT; i++) {
+    uint16_t* cell = _cells + i * cellPixels;
+    for (int16_t y = 0; y < ch; y++) {
+      uint8_t row = y / _size;
+      for (int16_t x = 0; x < cw; x++) {
+        uint8_t col = x / _size;
+        bool on = col < 5 && ((FONT_COLUMNS[i][col] >> row) & 1);
+        cell[y * cw + x] = on ? fg : bg;
+      }
+    }
+  }
+  return true;
+}
+
+int8_t GlyphAtlas::cellOf(char c) {
+  const char* p = strchr(CHARSET, c);
+  return (c != '\0' && p != nullptr) ? (int8_t)(p - CHARSET) : -1;
+}
+
+bool GlyphAtlas::covers(const char* text) const {
+  if (_cells == nullptr || text == nullptr) return false;
+  size_t len = strlen(text);
+  if (len == 0 || len > GLYPH_ATLAS_MAX_CHARS) return false;
+  for (size_t i = 0; i < len; i++) {
+    if (cellOf(text[i]) < 0) return false;
+  }
+  return true;
+}
+
+void GlyphAtlas::compose(const char* text, size_t len) {
+  const int16_t cw = cellWidth();
+  const int16_t ch = cellHeight();
+  const size_t rowPixels = len * cw;
+
+  for (size_t i = 0; i < len; i++) {
+    const uint16_t* cell = _cells + (size_t)cellOf(text[i]) * cw * ch;
+    uint16_t* dst = _scratch + i * cw;
+    for (int16_t y = 0; y < ch; y++) {
+      memcpy(dst + y * rowPixels, cell + y * cw, cw * sizeof(uint16_t));
+    }
+  }
+}
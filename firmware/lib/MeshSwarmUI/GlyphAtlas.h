@@ -0,0 +1,122 @@
+/**
+ * GlyphAtlas - Pre-rendered digit glyphs blitted as one window write
+ *
+ * Scaled built-in GFX text (setTextSize(2) and up) is drawn as one
+ * fillRect() per font pixel, so a two-digit update is a couple of hundred
+ * tiny SPI transactions. The atlas rasterizes the digits, ':', '-', '.'
+ * and space once at boot, at one scale and colour pair, into RGB565 cells.
+ * draw() copies the cells for a string side by side into a scratch buffer
+ * and pushes the whole field with a single window write (pushImage() on
+ * TFT_eSPI, drawRGBBitmap() on Adafruit_GFX-style drivers).
+ *
+ * The glyph shapes and 6x8 cell (including the spacing column) match the
+ * classic 5x7 GFX font drawn with a background colour, so atlas output is
+ * interchangeable with print(). Strings with other characters, strings
+ * longer than GLYPH_ATLAS_MAX_CHARS, or an atlas whose buffers could not be
+ * allocated fall back to setTextSize()/print() with the same result.
+ *
+ * Usage:
+ *   GlyphAtlas digits;
+ *   digits.begin(2, COLOR_TEXT, COLOR_BG);   // After tft.begin()
+ *
+ *   char buf[4];
+ *   snprintf(buf, sizeof(buf), "%02d", min);
+ *   digits.draw(tft, x, y, buf);             // Paints cells incl. background
+ */
+
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#include <Arduino.h>
+#include <string.h>
+
+#if __has_include(<TFT_eSPI.h>)
+#include <TFT_eSPI.h>
+#define GLYPH_ATLAS_HAS_TFT_ESPI 1
+#endif
+
+// Longest string composed into one push (scratch buffer size)
+#ifndef GLYPH_ATLAS_MAX_CHARS
+#define GLYPH_ATLAS_MAX_CHARS 8
+#endif
+
+namespace GlyphBlit {
+
+// Adafruit_GFX-style targets: one address window for the whole block
+template <class G>
+inline void push(G& gfx, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t* pixels) {
+  gfx.drawRGBBitmap(x, y, pixels, w, h);
+}
+
+#ifdef GLYPH_ATLAS_HAS_TFT_ESPI
+// TFT_eSPI: atlas pixels are native RGB565, the panel wants high byte first
+inline void push(TFT_eSPI& tft, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t* pixels) {
+  bool swap = tft.getSwapBytes();
+  tft.setSwapBytes(true);
+  tft.pushImage(x, y, w, h, pixels);
+  tft.setSwapBytes(swap);
+}
+#endif
+
+}  // namespace GlyphBlit
+
+class GlyphAtlas {
+public:
+  // Characters held by the atlas, in cell order
+  static const char CHARSET[];
+
+  GlyphAtlas();
+  ~GlyphAtlas();
+
+  /**
+   * Rasterize the charset (call again to change scale or colours)
+   * @param size Text scale, as for setTextSize()
+   * @return false if the buffers could not be allocated (draw() falls back)
+   */
+  bool begin(uint8_t size, uint16_t fg, uint16_t bg);
+
+  /**
+   * Free the cell and scratch buffers
+   */
+  void release();
+
+  bool isReady() const { return _cells != nullptr; }
+
+  int16_t cellWidth() const { return 6 * _size; }
+  int16_t cellHeight() const { return 8 * _size; }
+  int16_t textWidth(const char* text) const { return (int16_t)strlen(text) * cellWidth(); }
+
+  /**
+   * True if draw() would blit text from the atlas
+   */
+  bool covers(const char* text) const;
+
+  /**
+   * Draw text with its top-left corner at (x, y), background included
+   */
+  template <class G>
+  void draw(G& gfx, int16_t x, int16_t y, const char* text) {
+    if (!covers(text)) {
+      gfx.setTextSize(_size);
+      gfx.setTextColor(_fg, _bg);
+      gfx.setCursor(x, y);
+      gfx.print(text);
+      return;
+    }
+    size_t len = strlen(text);
+    compose(text, len);
+    GlyphBlit::push(gfx, x, y, (int16_t)(len * cellWidth()), cellHeight(), _scratch);
+  }
+
+private:
+  static int8_t cellOf(char c);
+  void compose(const char* text, size_t len);
+
+  uint8_t _size;
+  uint16_t _fg;
+  uint16_t _bg;
+  uint16_t* _cells;     // One cellWidth x cellHeight block per CHARSET entry
+  uint16_t* _scratch;   // GLYPH_ATLAS_MAX_CHARS cells side by side
+};
+
+#endif // GLYPH_ATLAS_H
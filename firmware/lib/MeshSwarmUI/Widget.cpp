@@ -0,0 +1,141 @@
+/**
+ * Widget - Retained-mode widgets, widget tree and frame scheduler
+ *
+ * Implementation of dirty tracking, key binding and frame pacing.
+ */
+
+// Widgets draw with TFT_eSPI; see DisplayPipeline.cpp
+#if __has_include(<TFT_eSPI.h>)
+
+#include "Widget.h"
+
+Widget::Widget(int16_t x, int16_t y, int16_t w, int16_t h)
+  : _x(x)
+  , _y(y)
+  , _w(w)
+  , _h(h)
+  , _key(nullptr)
+  , _dirty(true)
+  , _stale(true)
+{
+}
+
+WidgetTree::WidgetTree()
+  : _count(0)
+{
+}
+
+bool WidgetTree::add(Widget* widget) {
+  if (widget == nullptr || _count >= UI_MAX_WIDGETS) return false;
+  _widgets[_count++] = widget;
+  widget->_dirty = true;
+  widget->_stale = true;
+  return true;
+}
+
+void WidgetTree::clear() {
+  _count = 0;
+}
+
+void WidgetTree::bindKey(Widget* widget, const char* key) {
+  if (widget != nullptr) widget->_key = key;
+}
+
+bool WidgetTree::notifyKey(const String& key) {
+  bool any = false;
+  for (uint8_t i = 0; i < _count; i++) {
+    const char* bound = _widgets[i]->_key;
+    if (bound == nullptr) continue;
+    if ((bound[0] == '*' && bound[1] == '\0') || key == bound) {
+      _widgets[i]->_stale = true;
+      any = true;
+    }
+  }
+  return any;
+}
+
+void WidgetTree::markAllStale() {
+  for (uint8_t i = 0; i < _count; i++) {
+    _widgets[i]->_stale = true;
+  }
+}
+
+void WidgetTree::invalidateAll() {
+  for (uint8_t i = 0; i < _count; i++) {
+    _widgets[i]->_dirty = true;
+  }
+}
+
+bool WidgetTree::hasWork() const {
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_widgets[i]->_dirty || _widgets[i]->_stale) return true;
+  }
+  return false;
+}
+
+uint8_t WidgetTree::render(TFT_eSPI& tft) {
+  return paint(tft, nullptr, nullptr);
+}
+
+uint8_t WidgetTree::render(TFT_eSPI& tft, TFT_eSprite& tile, DisplayPipeline& pipeline) {
+  return paint(tft, &tile, &pipeline);
+}
+
+uint8_t WidgetTree::paint(TFT_eSPI& tft, TFT_eSprite* tile, DisplayPipeline* pipeline) {
+  uint8_t painted = 0;
+  for (uint8_t i = 0; i < _count; i++) {
+    Widget* w = _widgets[i];
+    if (w->_stale) {
+      w->_stale = false;
+      if (w->refresh()) w->_dirty = true;
+    }
+    if (!w->_dirty) continue;
+    w->_dirty = false;
+    painted++;
+
+    if (tile != nullptr && w->isOpaque() && w->_w <= tile->width() && w->_h <= tile->height()) {
+      // Draw at the tile's corner, then queue the rectangle; pushRect()
+      // copies it out, so the tile is free again for the next widget
+      int16_t x = w->_x;
+      int16_t y = w->_y;
+      w->_x = 0;
+      w->_y = 0;
+      w->draw(*tile);
+      w->_x = x;
+      w->_y = y;
+      pipeline->pushRect(x, y, w->_w, w->_h, (const uint16_t*)tile->getPointer(), tile->width());
+    } else {
+      if (pipeline != nullptr) pipeline->finish();  // Keep paint order with queued widgets
+      w->draw(tft);
+    }
+  }
+  return painted;
+}
+
+bool WidgetTree::touch(int16_t x, int16_t y) {
+  for (int i = _count - 1; i >= 0; i--) {
+    if (_widgets[i]->contains(x, y) && _widgets[i]->onTouch(x, y)) return true;
+  }
+  return false;
+}
+
+FrameScheduler::FrameScheduler(uint32_t intervalMs)
+  : _intervalMs(intervalMs)
+  , _lastFrame(0)
+  , _pending(true)
+  , _frames(0)
+  , _requests(0)
+{
+}
+
+bool FrameScheduler::due() const {
+  return _pending && (_frames == 0 || millis() - _lastFrame >= _intervalMs);
+}
+
+void FrameScheduler::done() {
+  _pending = false;
+  _lastFrame = millis();
+  _frames++;
+}
+
+#endif // __has_include(<TFT_eSPI.h>)
@@ -0,0 +1,214 @@
+/**
+ * Widget - Retained-mode widgets, widget tree and frame scheduler
+ *
+ * A Widget owns a screen rectangle and knows how to paint it. Instead of
+ * redrawing whole screens whenever anything changes, the application:
+ *
+ *   1. Marks widgets stale when the data they show may have changed
+ *      (WidgetTree::notifyKey() for state keys, markAllStale() for polled
+ *      data such as uptime and the peer list)
+ *   2. Asks the FrameScheduler for a frame
+ *   3. On the frame, WidgetTree::render() calls refresh() on each stale
+ *      widget. refresh() compares the model against what was last drawn
+ *      and returns true only if the visible output changed; only those
+ *      widgets (plus any invalidated ones) are painted.
+ *
+ * Any number of state changes between frames coalesce into one partial
+ * repaint, and the scheduler caps frames at UI_FRAME_INTERVAL_MS.
+ *
+ * Widgets are statically allocated by the application; the tree only
+ * stores pointers and never allocates.
+ *
+ * Usage:
+ *   class UptimeLabel : public Widget { ... refresh() / draw() ... };
+ *   UptimeLabel uptime(5, 17, 120, 10);
+ *
+ *   tree.add(&uptime);
+ *   tree.bindKey(&tempLabel, "temp");
+ *   ...
+ *   tree.notifyKey(key); scheduler.request();   // From a state watcher
+ *   if (scheduler.due()) { tree.render(tft); scheduler.done(); }
+ *
+ * With an off-screen tile and a DisplayPipeline, render(tft, tile, pipeline)
+ * draws each opaque widget that fits the tile off-screen and sends it with
+ * one DMA push, so a repaint never shows a half-drawn widget and the loop
+ * goes back to swarm.update() while the panel is written.
+ */
+
+#ifndef WIDGET_H
+#define WIDGET_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include "DisplayPipeline.h"
+
+// Widgets per tree
+#ifndef UI_MAX_WIDGETS
+#define UI_MAX_WIDGETS 24
+#endif
+
+// Minimum time between frames (ms)
+#ifndef UI_FRAME_INTERVAL_MS
+#define UI_FRAME_INTERVAL_MS 100
+#endif
+
+class Widget {
+public:
+  Widget(int16_t x, int16_t y, int16_t w, int16_t h);
+  virtual ~Widget() {}
+
+  /**
+   * Reload bound data; return true if what draw() would paint changed
+   */
+  virtual bool refresh() { return false; }
+
+  /**
+   * Paint the widget's whole rectangle
+   * Draw relative to _x/_y: when painting into a tile, the tree moves the
+   * origin to the tile's corner for the duration of the call.
+   */
+  virtual void draw(TFT_eSPI& tft) = 0;
+
+  /**
+   * True if draw() paints every pixel of the rectangle
+   * Only opaque widgets go through a tile; the others are drawn straight
+   * onto the panel, over what is already there.
+   */
+  virtual bool isOpaque() const { return true; }
+
+  /**
+   * Handle a touch inside the widget's rectangle
+   * @return true if handled
+   */
+  virtual bool onTouch(int16_t x, int16_t y) { return false; }
+
+  void invalidate() { _dirty = true; }
+  void markStale() { _stale = true; }
+
+  bool isDirty() const { return _dirty; }
+  bool isStale() const { return _stale; }
+
+  bool contains(int16_t px, int16_t py) const {
+    return px >= _x && px < _x + _w && py >= _y && py < _y + _h;
+  }
+
+  int16_t x() const { return _x; }
+  int16_t y() const { return _y; }
+  int16_t width() const { return _w; }
+  int16_t height() const { return _h; }
+
+protected:
+  int16_t _x, _y, _w, _h;
+
+private:
+  friend class WidgetTree;
+  const char* _key;  // Bound state key ("*" = any, nullptr = none)
+  bool _dirty;
+  bool _stale;
+};
+
+class WidgetTree {
+public:
+  WidgetTree();
+
+  /**
+   * Add a widget (painted in insertion order, last on top)
+   * @return false if the tree is full
+   */
+  bool add(Widget* widget);
+
+  /**
+   * Remove all widgets (e.g. on a view change)
+   */
+  void clear();
+
+  /**
+   * Bind a widget to a state key; notifyKey(key) then marks it stale
+   * @param key Exact key, or "*" for any key (pointer must stay valid)
+   */
+  void bindKey(Widget* widget, const char* key);
+
+  /**
+   * Mark widgets bound to this key (and to "*") stale
+   * @return true if any widget was affected
+   */
+  bool notifyKey(const String& key);
+
+  /**
+   * Mark every widget stale (periodic polling of unbound data)
+   */
+  void markAllStale();
+
+  /**
+   * Force every widget to repaint on the next render
+   */
+  void invalidateAll();
+
+  /**
+   * True if render() may have something to paint
+   */
+  bool hasWork() const;
+
+  /**
+   * Refresh stale widgets and paint those whose output changed
+   * @return Number of widgets painted
+   */
+  uint8_t render(TFT_eSPI& tft);
+
+  /**
+   * Same as render(tft), painting opaque widgets that fit the tile off-screen
+   * and sending them through the pipeline. Other widgets wait for the bus
+   * and draw straight to the panel.
+   * @param tile 16-bit sprite, allocated once by the application
+   */
+  uint8_t render(TFT_eSPI& tft, TFT_eSprite& tile, DisplayPipeline& pipeline);
+
+  /**
+   * Deliver a touch to the topmost widget under it
+   * @return true if a widget handled it
+   */
+  bool touch(int16_t x, int16_t y);
+
+  uint8_t count() const { return _count; }
+
+private:
+  Widget* _widgets[UI_MAX_WIDGETS];
+  uint8_t _count;
+
+  uint8_t paint(TFT_eSPI& tft, TFT_eSprite* tile, DisplayPipeline* pipeline);
+};
+
+class FrameScheduler {
+public:
+  explicit FrameScheduler(uint32_t intervalMs = UI_FRAME_INTERVAL_MS);
+
+  /**
+   * Ask for a frame (any number of requests before the frame coalesce)
+   */
+  void request() { _pending = true; _requests++; }
+
+  /**
+   * True when a frame was requested and the frame interval has passed
+   */
+  bool due() const;
+
+  /**
+   * Record that the frame was rendered
+   */
+  void done();
+
+  bool isPending() const { return _pending; }
+
+  // Stats
+  uint32_t frames() const { return _frames; }
+  uint32_t requests() const { return _requests; }
+
+private:
+  uint32_t _intervalMs;
+  uint32_t _lastFrame;
+  bool _pending;
+  uint32_t _frames;
+  uint32_t _requests;
+};
+
+#endif // WIDGET_H
@@ -0,0 +1,69 @@
+/**
+ * @file Bench.h
+ * @brief Timing loop and result lines for the microbenchmarks
+ *
+ * Each benchmark runs its body in doubling batches until one batch takes at
+ * least BENCH_MIN_US, then reports that batch. Results go to Serial as one
+ * JSON object per line, all starting with {"bench": so they can be picked
+ * out of the MeshSwarm log:
+ *
+ *   {"bench":"sync_parse","codec":"json","n":64,"iters":512,"ns_op":41210,"bytes":3551}
+ *
+ * n is the benchmark's size parameter (keys, peers or watchers), bytes the
+ * encoded size where there is one (0 otherwise).
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <Arduino.h>
+
+// Minimum measured batch
+#ifndef BENCH_MIN_US
+#define BENCH_MIN_US 200000UL
+#endif
+
+// Batch cap, keeps slow bodies from running for minutes
+#ifndef BENCH_MAX_ITERS
+#define BENCH_MAX_ITERS 1000000UL
+#endif
+
+struct BenchResult {
+  uint32_t iters;
+  uint32_t elapsedUs;
+
+  double nsPerOp() const { return iters ? (double)elapsedUs * 1000.0 / iters : 0.0; }
+};
+
+/**
+ * @brief Time fn(i) for i = 0..iters-1, growing iters until the batch is long enough
+ */
+template <typename Fn>
+BenchResult benchRun(Fn fn) {
+  fn(0);  // Warm up caches and first-use allocations
+
+  BenchResult r = { 1, 0 };
+  for (;;) {
+    unsigned long start = micros();
+    for (uint32_t i = 0; i < r.iters; i++) fn(i);
+    r.elapsedUs = (uint32_t)(micros() - start);
+
+    if (r.elapsedUs >= BENCH_MIN_US || r.iters >= BENCH_MAX_ITERS) return r;
+    r.iters *= 2;
+    yield();  // Keep the task watchdog fed between batches
+  }
+}
+
+/**
+ * @brief Print one result line
+ * @param codec Variant being measured ("json", "binary", "map", ...) or nullptr
+ */
+inline void benchReport(const char* name, const char* codec, uint32_t n,
+                        const BenchResult& r, size_t bytes = 0) {
+  Serial.printf("{\"bench\":\"%s\"", name);
+  if (codec) Serial.printf(",\"codec\":\"%s\"", codec);
+  Serial.printf(",\"n\":%lu,\"iters\":%lu,\"ns_op\":%.0f,\"bytes\":%lu}\n",
+                (unsigned long)n, (unsigned long)r.iters, r.nsPerOp(), (unsigned long)bytes);
+}
+
+#endif // BENCH_H
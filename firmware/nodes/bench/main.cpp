@@ -0,0 +1,339 @@
+/**
+ * MeshSwarm Microbenchmarks
+ *
+ * Times the MeshSwarm hot paths with today's representations
+ * (std::map state and peer tables, ArduinoJson documents, "*" watcher
+ * chains) next to the MeshSwarmExt/MeshSwarmProto alternatives, and prints
+ * one JSON line per result (Bench.h):
+ *
+ *   set_state        swarm.setState() on 16 keys: version bump, local
+ *                    dispatch, encode and send
+ *   encode_state_set one STATE_SET document, json vs binary (WireCodec)
+ *   sync_serialize   full STATE_SYNC from a std::map<String,String> at 16/64/256 keys
+ *   sync_parse       the same message back into the map
+ *   peer_lookup      find() in a std::map<uint32_t, Peer> of 16/64/256 peers
+ *   peer_scan        one pass over that map counting alive peers
+ *   adapter_notify   MeshSwarmAdapter::notifyCallbacks() with 8 callbacks
+ *   watch_dispatch   one state change against 8 node-style patterns: a chain
+ *                    of "*" lambdas vs the StateWatchers prefix index
+ *   set_state        again with the 8 "*" lambdas registered on the swarm
+ *
+ * Build and run:
+ *   pio run -e bench -t upload && pio device monitor -e bench
+ *   pio run -e bench_native && .pio/build/bench_native/program
+ *
+ * On the device the node joins the mesh and set_state broadcasts, so run
+ * it with the rest of the fleet out of range. On the host the swarm is the
+ * meshsim stand-in on a one-node network: compare host numbers with each
+ * other, not with the device.
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <MeshSwarm.h>
+#include <StateWatchers.h>
+#include <WireCodec.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "Bench.h"
+#include "../touch169/mesh/MeshSwarmAdapter.h"
+
+#ifdef BENCH_HOST
+#include "../meshsim/SimNetwork.h"
+#endif
+
+// ============== BUILD-TIME CONFIGURATION ==============
+#ifndef NODE_NAME
+#define NODE_NAME "Bench"
+#endif
+
+#ifndef NODE_TYPE
+#define NODE_TYPE "bench"
+#endif
+
+// Node id for the host run (the device uses its mesh id)
+#define BENCH_HOST_NODE_ID 1000001
+
+// ============== GLOBALS ==============
+MeshSwarm swarm;
+
+// MeshSwarmAdapter keeps notifyCallbacks() private
+struct AdapterBench {
+  static void notify(MeshSwarmAdapter& adapter, uint8_t key, const MeshReading& reading) {
+    adapter.notifyCallbacks((MeshSwarmAdapter::SensorKey)key, reading);
+  }
+};
+
+static const uint32_t SIZES[] = { 16, 64, 256 };
+
+// Keys as the sensor nodes publish them, zone suffixes for the bigger tables
+static const char* const KEY_KINDS[] = {
+  "temp", "humidity", "light", "light_state", "motion", "led", "heap_free", "uptime"
+};
+
+// Patterns from the display and watcher nodes
+static const char* const WATCH_PATTERNS[] = {
+  "temp_*", "humidity_*", "light_*", "light_state_*", "motion_*", "led", "time", "zone_*"
+};
+
+static const size_t KIND_COUNT = sizeof(KEY_KINDS) / sizeof(KEY_KINDS[0]);
+static const size_t PATTERN_COUNT = sizeof(WATCH_PATTERNS) / sizeof(WATCH_PATTERNS[0]);
+
+static volatile uint32_t sink = 0;  // Keeps results from being optimized away
+
+static String benchKey(uint32_t i) {
+  String key = KEY_KINDS[i % KIND_COUNT];
+  if (i >= KIND_COUNT) key += String("_z") + String(i / KIND_COUNT);
+  return key;
+}
+
+static String benchValue(uint32_t i) {
+  switch (i % 4) {
+    case 0: return String(18.0f + (i % 70) / 10.0f, 1);
+    case 1: return String((int)(30 + i % 40));
+    case 2: return (i & 1) ? "1" : "0";
+    default: return String(1700000000UL + i);
+  }
+}
+
+static void stateSetDoc(JsonDocument& doc, const String& key, const String& value, uint32_t version) {
+  doc.clear();
+  doc["t"] = 2;
+  doc["key"] = key.c_str();
+  doc["value"] = value.c_str();
+  doc["version"] = version;
+  doc["origin"] = swarm.getNodeId();
+}
+
+static void stateSyncDoc(JsonDocument& doc, const std::map<String, String>& state) {
+  doc.clear();
+  doc["t"] = 3;
+  JsonArray states = doc["states"].to<JsonArray>();
+  uint32_t version = 1;
+  for (const auto& kv : state) {
+    JsonObject e = states.add<JsonObject>();
+    e["key"] = kv.first.c_str();
+    e["value"] = kv.second.c_str();
+    e["version"] = version++;
+    e["origin"] = swarm.getNodeId();
+  }
+}
+
+static size_t syncIntoMap(JsonDocument& doc, std::map<String, String>& state) {
+  size_t n = 0;
+  for (JsonObject e : doc["states"].as<JsonArray>()) {
+    state[String(e["key"].as<const char*>())] = String(e["value"].as<const char*>());
+    n++;
+  }
+  return n;
+}
+
+// ============== BENCHMARKS ==============
+
+static void benchSetState(const char* codec, uint32_t watchers) {
+  std::vector<String> keys;
+  for (uint32_t i = 0; i < 16; i++) keys.push_back(String("bench_") + benchKey(i));
+  const String values[2] = { "0", "1" };
+
+  BenchResult r = benchRun([&](uint32_t i) {
+    swarm.setState(keys[i % 16], values[(i / 16) & 1]);
+  });
+  benchReport("set_state", codec, watchers, r);
+}
+
+static void benchEncodeStateSet() {
+  JsonDocument doc;
+  String key = "temp_z3";
+  String value = "21.5";
+  size_t bytes = 0;
+
+  BenchResult json = benchRun([&](uint32_t i) {
+    stateSetDoc(doc, key, value, i + 1);
+    std::string out;
+    serializeJson(doc, out);
+    bytes = out.size();
+  });
+  benchReport("encode_state_set", "json", 1, json, bytes);
+
+  BenchResult binary = benchRun([&](uint32_t i) {
+    stateSetDoc(doc, key, value, i + 1);
+    bytes = MeshProto::encodeBinary(doc).size();
+  });
+  benchReport("encode_state_set", "binary", 1, binary, bytes);
+}
+
+static void benchStateSync(uint32_t keys) {
+  std::map<String, String> state;
+  for (uint32_t i = 0; i < keys; i++) state[benchKey(i)] = benchValue(i);
+
+  JsonDocument doc;
+  std::string json;
+  std::string binary;
+
+  BenchResult r = benchRun([&](uint32_t i) {
+    stateSyncDoc(doc, state);
+    json.clear();
+    serializeJson(doc, json);
+  });
+  benchReport("sync_serialize", "json", keys, r, json.size());
+
+  r = benchRun([&](uint32_t i) {
+    stateSyncDoc(doc, state);
+    binary = MeshProto::encodeBinary(doc);
+  });
+  benchReport("sync_serialize", "binary", keys, r, binary.size());
+
+  std::map<String, String> received;
+  r = benchRun([&](uint32_t i) {
+    deserializeJson(doc, json.c_str());
+    sink += syncIntoMap(doc, received);
+  });
+  benchReport("sync_parse", "json", keys, r, json.size());
+
+  r = benchRun([&](uint32_t i) {
+    MeshProto::decodeMessage(binary.c_str(), doc);
+    sink += syncIntoMap(doc, received);
+  });
+  benchReport("sync_parse", "binary", keys, r, binary.size());
+}
+
+static void benchWatchDispatch() {
+  std::vector<String> keys;
+  for (uint32_t i = 0; i < 16; i++) keys.push_back(benchKey(i + KIND_COUNT));
+  const String value = "1";
+  const String oldValue = "0";
+
+  // What a node with several watchState("*") + startsWith() handlers runs
+  std::vector<StateWatchers::Callback> chain;
+  for (size_t p = 0; p < PATTERN_COUNT; p++) {
+    String pattern = WATCH_PATTERNS[p];
+    bool prefix = pattern.endsWith("*");
+    String literal = prefix ? pattern.substring(0, pattern.length() - 1) : pattern;
+    chain.push_back([prefix, literal](const String& key, const String& value, const String& oldValue) {
+      if (prefix ? key.startsWith(literal) : key == literal) sink++;
+    });
+  }
+
+  BenchResult r = benchRun([&](uint32_t i) {
+    const String& key = keys[i % keys.size()];
+    for (size_t c = 0; c < chain.size(); c++) chain[c](key, value, oldValue);
+  });
+  benchReport("watch_dispatch", "wildcard", PATTERN_COUNT, r);
+
+  StateWatchers watchers;
+  for (size_t p = 0; p < PATTERN_COUNT; p++) {
+    watchers.on(WATCH_PATTERNS[p], [](const String& key, const String& value, const String& oldValue) {
+      sink++;
+    });
+  }
+
+  r = benchRun([&](uint32_t i) {
+    watchers.dispatch(keys[i % keys.size()], value, oldValue);
+  });
+  benchReport("watch_dispatch", "prefix", PATTERN_COUNT, r);
+
+  // Same chain on the swarm itself; MeshSwarm has no unwatch, so this runs last
+  for (size_t c = 0; c < chain.size(); c++) swarm.watchState("*", chain[c]);
+  benchSetState("wildcard", PATTERN_COUNT);
+}
+
+static void benchPeers(uint32_t count) {
+  std::map<uint32_t, Peer> peers;
+  std::vector<uint32_t> ids;
+  uint32_t id = 0x9E3779B9;
+  for (uint32_t i = 0; i < count; i++) {
+    id = id * 1664525 + 1013904223;  // Scattered like mesh ids
+    Peer p = Peer();
+    p.name = String("Node") + String(i);
+    p.alive = (i % 8) != 0;
+    peers[id] = p;
+    ids.push_back(id);
+  }
+
+  BenchResult r = benchRun([&](uint32_t i) {
+    auto it = peers.find(ids[(i * 7) % count]);
+    if (it != peers.end() && it->second.alive) sink++;
+  });
+  benchReport("peer_lookup", "map", count, r);
+
+  r = benchRun([&](uint32_t i) {
+    uint32_t alive = 0;
+    for (auto& kv : peers) {
+      if (kv.second.alive) alive++;
+    }
+    sink += alive;
+  });
+  benchReport("peer_scan", "map", count, r);
+}
+
+static void onBenchChange(const MeshReading& value) {
+  sink++;
+}
+
+static void benchAdapterNotify() {
+  static const char* const ADAPTER_KEYS[] = { "temp", "humid", "light", "motion", "led" };
+
+  MeshSwarmAdapter adapter(swarm);
+  for (int i = 0; i < 8; i++) adapter.onStateChange(ADAPTER_KEYS[i % 5], onBenchChange);
+
+  MeshReading reading;
+  reading.value = 21.5f;
+  reading.valid = true;
+  BenchResult r = benchRun([&](uint32_t i) {
+    AdapterBench::notify(adapter, i % 5, reading);
+  });
+  benchReport("adapter_notify", nullptr, 8, r);
+}
+
+static void runBenchmarks() {
+#ifdef BENCH_HOST
+  Serial.printf("{\"bench\":\"env\",\"platform\":\"native\",\"min_us\":%lu}\n",
+                (unsigned long)BENCH_MIN_US);
+#else
+  Serial.printf("{\"bench\":\"env\",\"platform\":\"esp32\",\"cpu_mhz\":%lu,\"free_heap\":%lu,\"min_us\":%lu}\n",
+                (unsigned long)ESP.getCpuFreqMHz(), (unsigned long)ESP.getFreeHeap(),
+                (unsigned long)BENCH_MIN_US);
+#endif
+
+  benchSetState("meshswarm", 0);
+  benchEncodeStateSet();
+  for (uint32_t n : SIZES) benchStateSync(n);
+  for (uint32_t n : SIZES) benchPeers(n);
+  benchAdapterNotify();
+  benchWatchDispatch();
+
+  Serial.printf("{\"bench\":\"done\",\"sink\":%lu}\n", (unsigned long)sink);
+}
+
+// ============== SETUP ==============
+void setup() {
+  Serial.begin(115200);
+  delay(2000);  // Let the serial monitor attach
+
+  swarm.begin(NODE_NAME);
+  runBenchmarks();
+}
+
+// ============== LOOP ==============
+void loop() {
+  swarm.update();
+}
+
+#ifdef BENCH_HOST
+// One-node network: sends have nowhere to go, millis()/micros() use the wall clock
+int main() {
+  Serial.setEnabled(true);
+
+  SimConfig config;
+  config.nodes = 1;
+  SimNetwork net(config);
+  uint16_t index = net.addNode(&swarm, BENCH_HOST_NODE_ID, []() {});
+  swarm.simBind(net, index, BENCH_HOST_NODE_ID);
+  net.join(index);
+
+  swarm.begin(NODE_NAME);
+  runBenchmarks();
+  return 0;
+}
+#endif
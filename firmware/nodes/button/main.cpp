@@ -1,7 +1,9 @@
 /**
  * Button Input Node
  *
- * Press button to toggle shared LED state across mesh network.
+ * Press button to toggle shared LED state across mesh network. The write
+ * goes through UrgentState: stamped with mesh time so LED nodes can report
+ * the press latency, and on the control lane where MeshSwarm has lanes.
  *
  * Hardware:
  *   - ESP32 (original dual-core)
@@ -13,6 +15,9 @@
 
 #include <Arduino.h>
 #include <MeshSwarm.h>
+#include <PerfStats.h>
+#include <UrgentState.h>
+#include <BroadcastOta.h>
 #include <esp_ota_ops.h>
 
 // ============== BUILD-TIME CONFIGURATION ==============
@@ -43,6 +48,8 @@
 
 // ============== GLOBALS ==============
 MeshSwarm swarm;
+OtaBroadcastReceiver otaReceiver;
+UrgentState urgent;
 
 bool lastBootButtonState = HIGH;
 bool lastExtButtonState = HIGH;
@@ -57,7 +64,7 @@ void toggleLed(const char* source) {
 
   String currentLed = swarm.getState("led", "0");
   String newLed = (currentLed == "1") ? "0" : "1";
-  swarm.setState("led", newLed);
+  urgent.set("led", newLed);
   buttonPressCount++;
   Serial.printf("[BUTTON] %s pressed! LED: %s -> %s (count: %lu)\n",
                 source, currentLed.c_str(), newLed.c_str(), buttonPressCount);
@@ -95,8 +102,11 @@ void setup() {
   esp_ota_mark_app_valid_cancel_rollback();
 
   swarm.begin(NODE_NAME);
+  perfStats.attach(swarm);
   swarm.enableTelemetry(true);
   swarm.enableOTAReceive(NODE_TYPE);
+  otaReceiver.begin(swarm, NODE_TYPE);  // Broadcast jobs; resumes a saved session
+  urgent.begin(swarm);
 
   // Button setup - both use internal pull-up
   pinMode(BOOT_BUTTON_PIN, INPUT_PULLUP);
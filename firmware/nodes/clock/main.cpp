@@ -42,6 +42,14 @@
 #define MESHSWARM_ENABLE_DISPLAY 0
 
 #include <MeshSwarm.h>
+#include <PerfStats.h>
+#include <BroadcastOta.h>
+#include <StateWatchers.h>
+#include <DriftClock.h>
+#include <MeshTimeSync.h>
+#include <ClockHand.h>
+#include <ArcGauge.h>
+#include <GlyphAtlas.h>
 #include <esp_ota_ops.h>
 #include <DIYables_TFT_Round.h>
 #include <time.h>
@@ -166,6 +174,8 @@ enum MenuItem {
 
 // ============== GLOBALS ==============
 MeshSwarm swarm;
+OtaBroadcastReceiver otaReceiver;
+StateWatchers watchers;  // Zone-suffixed key watchers (temp_*, motion_*)
 DIYables_TFT_GC9A01_Round tft(TFT_RST, TFT_DC, TFT_CS);
 
 // Sensor data from mesh
@@ -180,14 +190,21 @@ int lastHour = -1;
 bool timeValid = false;
 
 // Mesh-based time (received from gateway or set manually)
-unsigned long meshTimeBase = 0;      // Unix timestamp when we got mesh time
-unsigned long meshTimeMillis = 0;    // millis() when we got mesh time
+DriftClock meshClock;                // Mesh time base + drift estimate
+MeshTimeClient timeClient;           // RTT-compensated sync with the gateway
 bool hasMeshTime = false;
 
-// Previous hand positions for efficient redraw
-float prevSecAngle = -999;
-float prevMinAngle = -999;
-float prevHourAngle = -999;
+// Clock hands (each keeps its on-screen spans, so a move erases only what changed)
+ClockHand hourHand(CENTER_X, CENTER_Y, HOUR_HAND_LEN, 5, COLOR_HOUR);
+ClockHand minHand(CENTER_X, CENTER_Y, MIN_HAND_LEN, 3, COLOR_MINUTE);
+ClockHand secHand(CENTER_X, CENTER_Y, SEC_HAND_LEN, 1, COLOR_SECOND);
+
+// Sensor screen gauges (a value change repaints only the sector between old and new)
+ArcGauge tempGauge(CENTER_X, CENTER_Y + 20, 95, 12, 290, 140);    // Across the top, clockwise
+ArcGauge humidGauge(CENTER_X, CENTER_Y + 20, 95, 12, 250, -140);  // Across the bottom, counter-clockwise
+
+// Digital time digits, rasterized once at boot and pushed as one window per field
+GlyphAtlas timeDigits;
 
 // Screen and mode state
 ScreenMode currentScreen = SCREEN_CLOCK;
@@ -249,8 +266,6 @@ unsigned long lastMotionTime = 0;
 
 // ============== FORWARD DECLARATIONS ==============
 void drawClockFace();
-void drawHand(float angle, int length, uint16_t color, int width);
-void eraseHand(float angle, int length, int width);
 void updateClock();
 void drawDateDisplay();
 void drawDigitalHours(int hour);
@@ -259,6 +274,8 @@ void drawDigitalSeconds(int sec);
 void drawDigitalColons();
 bool getMeshTime(struct tm* timeinfo);
 void setMeshTime(unsigned long unixTime);
+void applyMeshTimeSample(uint64_t unixMs, uint32_t atMillis);
+void onMeshTimeSynced();
 
 // Button and screen functions
 void handleButtons();
@@ -268,7 +285,6 @@ void drawSetTimeHour();
 void drawSetTimeMinute();
 void drawSensorScreen();
 void updateSensorScreen();
-void drawArc(int cx, int cy, int r, int thickness, float startAngle, float endAngle, uint16_t color);
 void enterSetTimeMode();
 void exitSetTimeMode();
 void switchScreen(ScreenMode screen);
@@ -328,6 +344,15 @@ void setup() {
   tft.setRotation(0);
   tft.fillScreen(COLOR_BG);
 
+  tempGauge.setRange(0, 40);
+  tempGauge.setColors(COLOR_ARC_TEMP, COLOR_ARC_BG);
+  humidGauge.setRange(0, 100);
+  humidGauge.setColors(COLOR_ARC_HUMID, COLOR_ARC_BG);
+
+  if (!timeDigits.begin(2, COLOR_TEXT, COLOR_BG)) {
+    Serial.println("[CLOCK] Glyph atlas allocation failed, using text drawing");
+  }
+
   // Draw initial clock face
   drawClockFace();
   tft.setTextColor(COLOR_TEXT, COLOR_BG);
@@ -337,8 +362,10 @@ void setup() {
 
   // Initialize mesh
   swarm.begin(NODE_NAME);
+  perfStats.attach(swarm);
   swarm.enableTelemetry(true);
   swarm.enableOTAReceive(NODE_TYPE);
+  otaReceiver.begin(swarm, NODE_TYPE);  // Broadcast jobs; resumes a saved session
 
   // Watch for temperature updates
   swarm.watchState("temp", [](const String& key, const String& value, const String& oldValue) {
@@ -354,44 +381,46 @@ void setup() {
     Serial.printf("[CLOCK] Humidity: %s %%\n", value.c_str());
   });
 
-  // Watch for time sync from gateway
+  // RTT-compensated time sync from gateway
+  timeClient.begin(swarm, [](uint64_t unixMs, uint32_t atMillis, uint32_t rttMs) {
+    applyMeshTimeSample(unixMs, atMillis);
+    Serial.printf("[CLOCK] Time synced from mesh: %lu (rtt %lu ms, drift %.1f ppm)\n",
+                  (unsigned long)(unixMs / 1000), (unsigned long)rttMs, meshClock.driftPpm());
+    onMeshTimeSynced();
+  });
+
+  // Legacy "time" state from gateways without timesync (ignored once synced)
   swarm.watchState("time", [](const String& key, const String& value, const String& oldValue) {
     unsigned long unixTime = value.toInt();
-    if (unixTime > 1700000000) {  // Sanity check: after Nov 2023
+    if (!timeClient.synced() && unixTime > 1700000000) {  // Sanity check: after Nov 2023
       setMeshTime(unixTime);
-      Serial.printf("[CLOCK] Time synced from mesh: %lu\n", unixTime);
-
-      // If we're in set time mode or waiting, exit to clock display
-      if (clockMode != MODE_NORMAL) {
-        clockMode = MODE_NORMAL;
-        timeValid = true;
-        screenChanged = true;
-        currentScreen = SCREEN_CLOCK;
-        Serial.println("[CLOCK] Exiting set time mode - received gateway time");
-      }
-      startupTimeoutChecked = true;  // Don't auto-enter set time mode
+      Serial.printf("[CLOCK] Time synced from mesh state: %lu\n", unixTime);
+      onMeshTimeSynced();
     }
   });
 
   // Also watch zone-specific variants
-  swarm.watchState("*", [](const String& key, const String& value, const String& oldValue) {
-    if (key.startsWith("temp_") && meshTemp == "--") {
+  watchers.on("temp_*", [](const String& key, const String& value, const String& oldValue) {
+    if (meshTemp == "--") {
       meshTemp = value;
       hasSensorData = true;
     }
-    if (key.startsWith("humidity_") && meshHumid == "--") {
+  });
+  watchers.on("humidity_*", [](const String& key, const String& value, const String& oldValue) {
+    if (meshHumid == "--") {
       meshHumid = value;
       hasSensorData = true;
     }
-    // Catch zone-specific motion keys (motion_zone1, etc.)
-    if (key.startsWith("motion_")) {
-      meshMotion = value;
-      if (value == "1") {
-        lastMotionTime = millis();
-      }
-      Serial.printf("[CLOCK] Motion (%s): %s\n", key.c_str(), value.c_str());
+  });
+  // Catch zone-specific motion keys (motion_zone1, etc.)
+  watchers.on("motion_*", [](const String& key, const String& value, const String& oldValue) {
+    meshMotion = value;
+    if (value == "1") {
+      lastMotionTime = millis();
     }
+    Serial.printf("[CLOCK] Motion (%s): %s\n", key.c_str(), value.c_str());
   });
+  watchers.attach(swarm);
 
   // Watch for light sensor updates
   swarm.watchState("light", [](const String& key, const String& value, const String& oldValue) {
@@ -522,11 +551,9 @@ void drawClockFace() {
 
   // Draw hour ticks
   for (int i = 0; i < 12; i++) {
-    float angle = i * 30 * PI / 180;
-    int x1 = CENTER_X + cos(angle - PI/2) * (CLOCK_RADIUS - 8);
-    int y1 = CENTER_Y + sin(angle - PI/2) * (CLOCK_RADIUS - 8);
-    int x2 = CENTER_X + cos(angle - PI/2) * (CLOCK_RADIUS - 2);
-    int y2 = CENTER_Y + sin(angle - PI/2) * (CLOCK_RADIUS - 2);
+    int x1, y1, x2, y2;
+    FixedTrig::dialPoint(CENTER_X, CENTER_Y, CLOCK_RADIUS - 8, FixedTrig::fromHours(i), &x1, &y1);
+    FixedTrig::dialPoint(CENTER_X, CENTER_Y, CLOCK_RADIUS - 2, FixedTrig::fromHours(i), &x2, &y2);
     tft.drawLine(x1, y1, x2, y2, COLOR_TICK);
   }
 
@@ -534,26 +561,6 @@ void drawClockFace() {
   tft.fillCircle(CENTER_X, CENTER_Y, 5, COLOR_HOUR);
 }
 
-void drawHand(float angle, int length, uint16_t color, int width) {
-  float rad = (angle - 90) * PI / 180;
-  int x = CENTER_X + cos(rad) * length;
-  int y = CENTER_Y + sin(rad) * length;
-
-  if (width > 1) {
-    // Draw thick line for hour/minute hands
-    for (int w = -width/2; w <= width/2; w++) {
-      tft.drawLine(CENTER_X + w, CENTER_Y, x + w, y, color);
-      tft.drawLine(CENTER_X, CENTER_Y + w, x, y + w, color);
-    }
-  } else {
-    tft.drawLine(CENTER_X, CENTER_Y, x, y, color);
-  }
-}
-
-void eraseHand(float angle, int length, int width) {
-  drawHand(angle, length, COLOR_BG, width + 2);
-}
-
 void updateClock() {
   struct tm timeinfo;
 
@@ -565,9 +572,9 @@ void updateClock() {
     lastSec = -1;
     lastMin = -1;
     lastHour = -1;
-    prevSecAngle = -999;
-    prevMinAngle = -999;
-    prevHourAngle = -999;
+    hourHand.reset();
+    minHand.reset();
+    secHand.reset();
   }
 
   // Try mesh time first, then NTP
@@ -603,6 +610,9 @@ void updateClock() {
     lastSec = -1;
     lastMin = -1;
     lastHour = -1;
+    hourHand.reset();
+    minHand.reset();
+    secHand.reset();
   }
 
   int sec = timeinfo.tm_sec;
@@ -612,35 +622,24 @@ void updateClock() {
   // Only update if time changed
   if (sec == lastSec) return;
 
-  // Calculate angles
-  float secAngle = sec * 6;  // 360/60 = 6 degrees per second
-  float minAngle = min * 6 + sec * 0.1;  // Smooth minute hand
-  float hourAngle = hour * 30 + min * 0.5;  // 360/12 = 30 degrees per hour
+  // Move hands (half-degree steps: smooth minute and hour hands)
+  secHand.moveTo(FixedTrig::fromSeconds(sec));
+  minHand.moveTo(FixedTrig::fromMinutes(min, sec));
+  hourHand.moveTo(FixedTrig::fromHours(hour, min));
 
-  // Erase old hands (in reverse order: second, minute, hour)
-  if (prevSecAngle != -999) {
-    eraseHand(prevSecAngle, SEC_HAND_LEN, 1);
-  }
-  if (prevMinAngle != -999 && (min != lastMin || lastMin == -1)) {
-    eraseHand(prevMinAngle, MIN_HAND_LEN, 3);
-  }
-  if (prevHourAngle != -999 && (hour != lastHour || min != lastMin || lastHour == -1)) {
-    eraseHand(prevHourAngle, HOUR_HAND_LEN, 5);
-  }
+  // Erase only pixels the hands have left (second, minute, hour)
+  secHand.erase(tft, COLOR_BG);
+  minHand.erase(tft, COLOR_BG);
+  hourHand.erase(tft, COLOR_BG);
 
-  // Draw new hands (hour, minute, second)
-  drawHand(hourAngle, HOUR_HAND_LEN, COLOR_HOUR, 5);
-  drawHand(minAngle, MIN_HAND_LEN, COLOR_MINUTE, 3);
-  drawHand(secAngle, SEC_HAND_LEN, COLOR_SECOND, 1);
+  // Draw hands (hour, minute, second) - also repairs overlaps erased above
+  hourHand.draw(tft, COLOR_BG);
+  minHand.draw(tft, COLOR_BG);
+  secHand.draw(tft, COLOR_BG);
 
   // Redraw center dot
   tft.fillCircle(CENTER_X, CENTER_Y, 5, COLOR_SECOND);
 
-  // Store previous angles
-  prevSecAngle = secAngle;
-  prevMinAngle = minAngle;
-  prevHourAngle = hourAngle;
-
   // Update digital time display - only redraw changed parts to avoid flashing
   if (lastHour == -1) {
     drawDigitalColons();  // Draw colons once on first run
@@ -681,59 +680,71 @@ void drawDateDisplay() {
 
 // ============== DIGITAL TIME FUNCTIONS ==============
 
+// Each field is two 12x16 atlas cells; the cells include their background,
+// so no clearing fillRect is needed
+
+void drawDigitalField(int16_t x, int value) {
+  char buf[4];
+  snprintf(buf, sizeof(buf), "%02d", value);
+  timeDigits.draw(tft, x, 200, buf);
+}
+
 void drawDigitalHours(int hour) {
-  tft.fillRect(CENTER_X - 48, 200, 24, 16, COLOR_BG);
-  tft.setTextSize(2);
-  tft.setTextColor(COLOR_TEXT, COLOR_BG);
-  tft.setCursor(CENTER_X - 48, 200);
-  tft.printf("%02d", hour);
+  drawDigitalField(CENTER_X - 48, hour);
 }
 
 void drawDigitalMinutes(int min) {
-  tft.fillRect(CENTER_X - 12, 200, 24, 16, COLOR_BG);
-  tft.setTextSize(2);
-  tft.setTextColor(COLOR_TEXT, COLOR_BG);
-  tft.setCursor(CENTER_X - 12, 200);
-  tft.printf("%02d", min);
+  drawDigitalField(CENTER_X - 12, min);
 }
 
 void drawDigitalSeconds(int sec) {
-  tft.fillRect(CENTER_X + 24, 200, 24, 16, COLOR_BG);
-  tft.setTextSize(2);
-  tft.setTextColor(COLOR_TEXT, COLOR_BG);
-  tft.setCursor(CENTER_X + 24, 200);
-  tft.printf("%02d", sec);
+  drawDigitalField(CENTER_X + 24, sec);
 }
 
 void drawDigitalColons() {
-  tft.setTextSize(2);
-  tft.setTextColor(COLOR_TEXT, COLOR_BG);
-  tft.setCursor(CENTER_X - 24, 200);
-  tft.print(":");
-  tft.setCursor(CENTER_X + 12, 200);
-  tft.print(":");
+  timeDigits.draw(tft, CENTER_X - 24, 200, ":");
+  timeDigits.draw(tft, CENTER_X + 12, 200, ":");
 }
 
 // ============== MESH TIME FUNCTIONS ==============
 
-void setMeshTime(unsigned long unixTime) {
-  meshTimeBase = unixTime;
-  meshTimeMillis = millis();
-  hasMeshTime = true;
-
+void setSystemTimeMs(uint64_t unixMs) {
   // Also set the system time so getLocalTime() works
   struct timeval tv;
-  tv.tv_sec = unixTime;
-  tv.tv_usec = 0;
+  tv.tv_sec = unixMs / 1000;
+  tv.tv_usec = (unixMs % 1000) * 1000;
   settimeofday(&tv, NULL);
 }
 
+void setMeshTime(unsigned long unixTime) {
+  meshClock.reset((uint64_t)unixTime * 1000, millis());
+  hasMeshTime = true;
+  setSystemTimeMs((uint64_t)unixTime * 1000);
+}
+
+void applyMeshTimeSample(uint64_t unixMs, uint32_t atMillis) {
+  meshClock.sample(unixMs, atMillis);
+  hasMeshTime = true;
+  setSystemTimeMs(meshClock.nowMs());
+}
+
+void onMeshTimeSynced() {
+  // If we're in set time mode or waiting, exit to clock display
+  if (clockMode != MODE_NORMAL) {
+    clockMode = MODE_NORMAL;
+    timeValid = true;
+    screenChanged = true;
+    currentScreen = SCREEN_CLOCK;
+    Serial.println("[CLOCK] Exiting set time mode - received gateway time");
+  }
+  startupTimeoutChecked = true;  // Don't auto-enter set time mode
+}
+
 bool getMeshTime(struct tm* timeinfo) {
   if (!hasMeshTime) return false;
 
-  // Calculate current time based on mesh time + elapsed millis
-  unsigned long elapsed = (millis() - meshTimeMillis) / 1000;
-  time_t currentTime = meshTimeBase + elapsed + GMT_OFFSET_SEC + DAYLIGHT_OFFSET;
+  // Drift-corrected mesh time, interpolated from the last sync
+  time_t currentTime = (time_t)meshClock.now() + GMT_OFFSET_SEC + DAYLIGHT_OFFSET;
 
   // Convert to struct tm
   struct tm* t = localtime(&currentTime);
@@ -1161,20 +1172,6 @@ void updateSetTimeScreen() {
 
 // ============== SENSOR SCREEN ==============
 
-void drawArc(int cx, int cy, int r, int thickness, float startAngle, float endAngle, uint16_t color) {
-  // Draw arc using line segments
-  float step = 2.0;  // Degrees per segment
-  for (float angle = startAngle; angle <= endAngle; angle += step) {
-    float rad = angle * PI / 180.0;
-    for (int t = 0; t < thickness; t++) {
-      int rr = r - t;
-      int x = cx + cos(rad) * rr;
-      int y = cy + sin(rad) * rr;
-      tft.drawPixel(x, y, color);
-    }
-  }
-}
-
 void drawSensorScreen() {
   tft.fillScreen(COLOR_BG);
 
@@ -1184,12 +1181,9 @@ void drawSensorScreen() {
   tft.setCursor(CENTER_X - 45, 15);
   tft.print("SENSORS");
 
-  // Draw background arcs (thermometer style bars on sides)
-  // Temperature arc: left side (200° to 340°)
-  drawArc(CENTER_X, CENTER_Y + 20, 95, 12, 200, 340, COLOR_ARC_BG);
-
-  // Humidity arc: right side (160° to 20°) - draws same arc, fills opposite direction
-  drawArc(CENTER_X, CENTER_Y + 20, 95, 12, 20, 160, COLOR_ARC_BG);
+  // Draw gauges at their last values (updateSensorScreen moves them from there)
+  tempGauge.draw(tft);
+  humidGauge.draw(tft);
 
   // Labels at bottom of arcs
   tft.setTextSize(1);
@@ -1223,15 +1217,8 @@ void updateSensorScreen() {
     float tempVal = meshTemp.toFloat();
     if (meshTemp == "--") tempVal = 0;
 
-    // Map temperature (0-40°C) to arc angle (200° up to 340°) - bottom to top
-    // At 0°C: starts at 200° (bottom-left), at 40°C: fills to 340° (top-left)
-    float tempAngle = 200 + (tempVal / 40.0) * 140;
-    if (tempAngle > 340) tempAngle = 340;
-    if (tempAngle < 200) tempAngle = 200;
-
-    // Redraw temperature arc (left side) - fill from 200° up to tempAngle
-    drawArc(CENTER_X, CENTER_Y + 20, 95, 12, 200, 340, COLOR_ARC_BG);
-    drawArc(CENTER_X, CENTER_Y + 20, 95, 12, 200, tempAngle, COLOR_ARC_TEMP);
+    // Temperature arc (0-40°C) - repaints only the change since the last value
+    tempGauge.setValue(tft, tempVal);
 
     // Temperature value - centered, above humidity
     tft.fillRect(CENTER_X - 50, CENTER_Y - 25, 100, 40, COLOR_BG);
@@ -1254,15 +1241,8 @@ void updateSensorScreen() {
     float humidVal = meshHumid.toFloat();
     if (meshHumid == "--") humidVal = 0;
 
-    // Map humidity (0-100%) to arc angle (160° down to 20°) - bottom to top
-    // At 0%: starts at 160° (bottom-right), at 100%: fills to 20° (top-right)
-    float humidAngle = 160 - (humidVal / 100.0) * 140;
-    if (humidAngle < 20) humidAngle = 20;
-    if (humidAngle > 160) humidAngle = 160;
-
-    // Redraw humidity arc (right side) - fill from 160° up to humidAngle
-    drawArc(CENTER_X, CENTER_Y + 20, 95, 12, 20, 160, COLOR_ARC_BG);
-    drawArc(CENTER_X, CENTER_Y + 20, 95, 12, humidAngle, 160, COLOR_ARC_HUMID);
+    // Humidity arc (0-100%) - repaints only the change since the last value
+    humidGauge.setValue(tft, humidVal);
 
     // Humidity value - centered, below temperature
     tft.fillRect(CENTER_X - 50, CENTER_Y + 20, 100, 40, COLOR_BG);
@@ -1318,22 +1298,20 @@ void switchScreen(ScreenMode screen) {
 // ============== MENU SYSTEM ==============
 
 void getMenuIconPosition(int index, int* x, int* y) {
-  // 8 items, starting at top (270°), going clockwise
-  // Angles: 270, 315, 0, 45, 90, 135, 180, 225
-  float angle = (270.0 + index * 45.0) * PI / 180.0;
-  *x = CENTER_X + cos(angle) * MENU_RADIUS;
-  *y = CENTER_Y + sin(angle) * MENU_RADIUS;
+  // 8 items, starting at top (12 o'clock), going clockwise every 45°
+  FixedTrig::dialPoint(CENTER_X, CENTER_Y, MENU_RADIUS, FixedTrig::fromDegrees(index * 45), x, y);
 }
 
 // Draw clock icon - circle with two hands
 void drawClockIcon(int cx, int cy, uint16_t color) {
   tft.drawCircle(cx, cy, 8, color);
   // Hour hand (short, pointing to 10)
-  float hourAngle = (300 - 90) * PI / 180;
-  tft.drawLine(cx, cy, cx + cos(hourAngle) * 4, cy + sin(hourAngle) * 4, color);
+  int x, y;
+  FixedTrig::dialPoint(cx, cy, 4, FixedTrig::fromDegrees(300), &x, &y);
+  tft.drawLine(cx, cy, x, y, color);
   // Minute hand (long, pointing to 2)
-  float minAngle = (60 - 90) * PI / 180;
-  tft.drawLine(cx, cy, cx + cos(minAngle) * 6, cy + sin(minAngle) * 6, color);
+  FixedTrig::dialPoint(cx, cy, 6, FixedTrig::fromDegrees(60), &x, &y);
+  tft.drawLine(cx, cy, x, y, color);
 }
 
 // Draw thermometer icon - vertical line with bulb at bottom
@@ -1355,11 +1333,9 @@ void drawGearIcon(int cx, int cy, uint16_t color) {
   tft.drawCircle(cx, cy, 4, color);
   // Draw 6 teeth around the gear
   for (int i = 0; i < 6; i++) {
-    float angle = i * 60 * PI / 180;
-    int x1 = cx + cos(angle) * 5;
-    int y1 = cy + sin(angle) * 5;
-    int x2 = cx + cos(angle) * 8;
-    int y2 = cy + sin(angle) * 8;
+    int x1, y1, x2, y2;
+    FixedTrig::dialPoint(cx, cy, 5, FixedTrig::fromDegrees(i * 60 + 90), &x1, &y1);
+    FixedTrig::dialPoint(cx, cy, 8, FixedTrig::fromDegrees(i * 60 + 90), &x2, &y2);
     tft.drawLine(x1, y1, x2, y2, color);
   }
 }
@@ -1405,11 +1381,9 @@ void drawLedIcon(int cx, int cy, uint16_t color) {
   tft.fillCircle(cx, cy, 4, color);
   // Radiating lines
   for (int i = 0; i < 8; i++) {
-    float angle = i * 45 * PI / 180;
-    int x1 = cx + cos(angle) * 5;
-    int y1 = cy + sin(angle) * 5;
-    int x2 = cx + cos(angle) * 8;
-    int y2 = cy + sin(angle) * 8;
+    int x1, y1, x2, y2;
+    FixedTrig::dialPoint(cx, cy, 5, FixedTrig::fromDegrees(i * 45), &x1, &y1);
+    FixedTrig::dialPoint(cx, cy, 8, FixedTrig::fromDegrees(i * 45), &x2, &y2);
     tft.drawLine(x1, y1, x2, y2, color);
   }
 }
@@ -1418,11 +1392,10 @@ void drawLedIcon(int cx, int cy, uint16_t color) {
 void drawMotionIcon(int cx, int cy, uint16_t color) {
   // Three arcs representing motion waves
   for (int r = 3; r <= 7; r += 2) {
-    // Draw arc from -45 to 45 degrees (facing right)
-    for (float a = -45; a <= 45; a += 10) {
-      float rad = a * PI / 180;
-      int x = cx + cos(rad) * r;
-      int y = cy + sin(rad) * r;
+    // Draw arc from 1:30 to 4:30 (facing right)
+    for (int a = 45; a <= 135; a += 10) {
+      int x, y;
+      FixedTrig::dialPoint(cx, cy, r, FixedTrig::fromDegrees(a), &x, &y);
       tft.drawPixel(x, y, color);
     }
   }
@@ -1465,9 +1438,7 @@ void drawMenu() {
     uint16_t color;
     if (i == menuSelection) {
       // Selected item - draw highlight arc behind it
-      float startAngle = 270.0 + i * 45.0 - 20.0;
-      float endAngle = 270.0 + i * 45.0 + 20.0;
-      drawArc(CENTER_X, CENTER_Y, MENU_RADIUS + 12, 6, startAngle, endAngle, COLOR_MENU_SEL);
+      ArcRaster::fill(tft, CENTER_X, CENTER_Y, MENU_RADIUS + 12, 6, i * 45 - 20, 40, COLOR_MENU_SEL);
       color = COLOR_MENU_SEL;
     } else {
       color = COLOR_MENU_ICON;
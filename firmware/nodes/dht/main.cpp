@@ -15,6 +15,10 @@
 
 #include <Arduino.h>
 #include <MeshSwarm.h>
+#include <PerfStats.h>
+#include <BroadcastOta.h>
+#include <StateBatch.h>
+#include <ReportPolicy.h>
 #include <DHT.h>
 #include <esp_ota_ops.h>
 
@@ -48,9 +52,44 @@
 #define SENSOR_ZONE     "zone1"   // Zone identifier for this sensor
 #endif
 
+// ============== REPORT POLICY ==============
+// Publish on a deadband change, at most every REPORT_MIN_INTERVAL_MS, and
+// refresh an unchanged value every REPORT_MAX_INTERVAL_MS
+#ifndef TEMP_DEADBAND
+#define TEMP_DEADBAND          0.5f    // °C
+#endif
+
+#ifndef HUMIDITY_DEADBAND
+#define HUMIDITY_DEADBAND      1.0f    // %RH
+#endif
+
+#ifndef REPORT_MIN_INTERVAL_MS
+#define REPORT_MIN_INTERVAL_MS 15000
+#endif
+
+#ifndef REPORT_MAX_INTERVAL_MS
+#define REPORT_MAX_INTERVAL_MS 300000
+#endif
+
+// EMA weight of each reading (1.0 = no smoothing)
+#ifndef REPORT_SMOOTHING
+#define REPORT_SMOOTHING       0.5f
+#endif
+
+// Extra change needed to reverse direction (damps HVAC cycling at an edge)
+#ifndef REPORT_HYSTERESIS
+#define REPORT_HYSTERESIS      0.2f
+#endif
+
 // ============== GLOBALS ==============
 MeshSwarm swarm;
+OtaBroadcastReceiver otaReceiver;
+StateBatch stateBatch(swarm);  // Base + zone keys go out as one message
 DHT dht(DHT_PIN, DHT_TYPE);
+ReportPolicy tempPolicy(TEMP_DEADBAND, REPORT_MIN_INTERVAL_MS, REPORT_MAX_INTERVAL_MS,
+                        REPORT_SMOOTHING, REPORT_HYSTERESIS);
+ReportPolicy humidityPolicy(HUMIDITY_DEADBAND, REPORT_MIN_INTERVAL_MS, REPORT_MAX_INTERVAL_MS,
+                            REPORT_SMOOTHING, REPORT_HYSTERESIS);
 
 // Sensor state
 float temperature = NAN;
@@ -80,21 +119,22 @@ void pollDht() {
   readCount++;
   sensorReady = true;
 
-  // Check if values changed significantly (0.5 degree or 1% humidity)
-  bool tempChanged = isnan(temperature) || abs(newTemp - temperature) >= 0.5;
-  bool humidityChanged = isnan(humidity) || abs(newHumidity - humidity) >= 1.0;
+  // Report policies smooth the readings and decide what goes out
+  bool tempChanged = tempPolicy.update(newTemp, now);
+  bool humidityChanged = humidityPolicy.update(newHumidity, now);
 
-  temperature = newTemp;
-  humidity = newHumidity;
+  temperature = tempPolicy.value();
+  humidity = humidityPolicy.value();
 
-  // Update mesh state if changed
+  // Update mesh state if changed (one MSG_STATE_SET for all keys)
+  stateBatch.beginBatch();
   if (tempChanged) {
     char tempStr[8];
     dtostrf(temperature, 4, 1, tempStr);
-    swarm.setState("temp", tempStr);
+    stateBatch.set("temp", tempStr);
 
     String zoneKey = String("temp_") + SENSOR_ZONE;
-    swarm.setState(zoneKey, tempStr);
+    stateBatch.set(zoneKey, tempStr);
 
     Serial.printf("[DHT] Temperature: %s°C\n", tempStr);
   }
@@ -102,13 +142,19 @@ void pollDht() {
   if (humidityChanged) {
     char humStr[8];
     dtostrf(humidity, 4, 1, humStr);
-    swarm.setState("humidity", humStr);
+    stateBatch.set("humidity", humStr);
 
     String zoneKey = String("humidity_") + SENSOR_ZONE;
-    swarm.setState(zoneKey, humStr);
+    stateBatch.set(zoneKey, humStr);
 
     Serial.printf("[DHT] Humidity: %s%%\n", humStr);
   }
+
+  stateBatch.commit();
+
+  // Report counters ride along in the heartbeat telemetry
+  swarm.setHeartbeatData("rpt_sent", tempPolicy.sent() + humidityPolicy.sent());
+  swarm.setHeartbeatData("rpt_supp", tempPolicy.suppressed() + humidityPolicy.suppressed());
 }
 
 // ============== SETUP ==============
@@ -119,8 +165,10 @@ void setup() {
   esp_ota_mark_app_valid_cancel_rollback();
 
   swarm.begin(NODE_NAME);
+  perfStats.attach(swarm);
   swarm.enableTelemetry(true);
   swarm.enableOTAReceive(NODE_TYPE);
+  otaReceiver.begin(swarm, NODE_TYPE);  // Broadcast jobs; resumes a saved session
 
   // Enable display sleep with boot button wake
   swarm.enableDisplaySleep(DHT_DISPLAY_SLEEP_MS);
@@ -148,6 +196,9 @@ void setup() {
       }
       Serial.printf("Read count: %lu\n", readCount);
       Serial.printf("Error count: %lu\n", errorCount);
+      Serial.printf("Reports: temp %lu sent / %lu held, humidity %lu sent / %lu held\n",
+                    (unsigned long)tempPolicy.sent(), (unsigned long)tempPolicy.suppressed(),
+                    (unsigned long)humidityPolicy.sent(), (unsigned long)humidityPolicy.suppressed());
       Serial.printf("Zone: %s\n", SENSOR_ZONE);
       Serial.println();
       return true;
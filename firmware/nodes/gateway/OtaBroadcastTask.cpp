@@ -0,0 +1,363 @@
+/**
+ * @file OtaBroadcastTask.cpp
+ * @brief Broadcast OTA server worker implementation
+ */
+
+#include "OtaBroadcastTask.h"
+#include <ArduinoJson.h>
+#include <HTTPClient.h>
+#include <MD5Builder.h>
+#include <Preferences.h>
+#include <WiFi.h>
+#include <esp_ota_ops.h>
+
+#define OTA_BCAST_NVS_NAMESPACE "otab_tx"
+#define OTA_BCAST_SECTOR 4096
+
+void OtaBroadcastTask::begin(const char* serverUrl, const char* apiKey) {
+  _baseUrl = serverUrl;
+  _apiKey = apiKey ? apiKey : "";
+#if !OTA_BCAST_RELAY
+  _part = esp_ota_get_next_update_partition(NULL);
+  if (!_part) {
+    Serial.println("[OTAB] No spare OTA partition, broadcast OTA disabled");
+    return;
+  }
+#endif
+
+  xTaskCreatePinnedToCore(taskEntry, "ota_bcast", OTA_BCAST_TASK_STACK, this,
+                          OTA_BCAST_TASK_PRIORITY, &_task, OTA_BCAST_TASK_CORE);
+  Serial.printf("[OTAB] Worker started on core %d, %s%s\n", OTA_BCAST_TASK_CORE,
+                _part ? "staging in " : "relaying ranges", _part ? _part->label : "");
+}
+
+OtaChunkSource& OtaBroadcastTask::chunkSource() {
+  if (!_part) return _relay;
+  _partitionSource.begin(_part, _offer.chunkBytes);
+  return _partitionSource;
+}
+
+bool OtaBroadcastTask::takeOffer(MeshProto::OtaOffer& offer) {
+  if (!_offerReady.load(std::memory_order_acquire)) return false;
+  offer = _offer;
+  _offerReady.store(false, std::memory_order_release);
+  return true;
+}
+
+bool OtaBroadcastTask::pushProgress(uint32_t session, uint32_t nodeId, const char* state,
+                                    uint16_t got, uint16_t chunks, const char* error) {
+  OtaBcastRecord rec = {};
+  rec.type = OTAB_PROGRESS;
+  rec.session = session;
+  rec.nodeId = nodeId;
+  rec.got = got;
+  rec.chunks = chunks;
+  strncpy(rec.state, state, sizeof(rec.state) - 1);
+  if (error) strncpy(rec.error, error, sizeof(rec.error) - 1);
+  return _ring.push(rec);
+}
+
+bool OtaBroadcastTask::pushDone(uint32_t session, uint16_t completed, uint16_t failed) {
+  OtaBcastRecord rec = {};
+  rec.type = OTAB_DONE;
+  rec.session = session;
+  rec.completed = completed;
+  rec.failed = failed;
+  return _ring.push(rec);
+}
+
+void OtaBroadcastTask::taskEntry(void* arg) {
+  static_cast<OtaBroadcastTask*>(arg)->run();
+}
+
+void OtaBroadcastTask::run() {
+  resume();
+
+  for (;;) {
+    OtaBcastRecord rec;
+    while (_ring.pop(rec)) {
+      handle(rec);
+    }
+
+    if (_session.load() == 0 && WiFi.status() == WL_CONNECTED &&
+        (_lastPoll == 0 || millis() - _lastPoll >= OTA_BCAST_POLL_MS)) {
+      _lastPoll = millis();
+      poll();
+    }
+
+    if (!_part && _session.load() != 0) {
+      // Straight back for the next range while the sender is asking for chunks
+      vTaskDelay(_relay.service(OTA_BCAST_HTTP_TIMEOUT_MS) ? 1 : pdMS_TO_TICKS(OTA_BCAST_RELAY_PERIOD_MS));
+      continue;
+    }
+    vTaskDelay(pdMS_TO_TICKS(OTA_BCAST_TASK_PERIOD_MS));
+  }
+}
+
+void OtaBroadcastTask::poll() {
+  HTTPClient http;
+  http.setTimeout(OTA_BCAST_HTTP_TIMEOUT_MS);
+  http.begin(_baseUrl + "/api/v1/ota/updates/pending?mode=broadcast");
+  if (_apiKey.length() > 0) http.addHeader("X-API-Key", _apiKey);
+  _lastHttpCode = http.GET();
+  if (_lastHttpCode != 200) {
+    http.end();
+    return;
+  }
+  JsonDocument doc;
+  DeserializationError err = deserializeJson(doc, http.getString());
+  http.end();
+  if (err) return;
+
+  JsonArray jobs = doc.as<JsonArray>();
+  if (jobs.size() == 0) return;
+  JsonObject job = jobs[0];
+
+  MeshProto::OtaOffer offer;
+  offer.session = job["update_id"] | 0UL;
+  offer.role = job["node_type"] | "";
+  offer.hardware = job["hardware"] | "ESP32";
+  offer.md5 = job["md5"] | "";
+  offer.imageSize = job["size_bytes"] | 0UL;
+  offer.chunkBytes = job["part_size"] | OTA_CHUNK_BYTES;
+  offer.force = job["force"] | false;
+  const char* encoding = job["encoding"] | "raw";
+  offer.encoding = strcmp(encoding, "delta") == 0      ? MeshProto::OTA_ENC_DELTA
+                 : strcmp(encoding, "compressed") == 0 ? MeshProto::OTA_ENC_COMPRESSED
+                                                       : MeshProto::OTA_ENC_RAW;
+  offer.baseMd5 = job["base_md5"] | "";
+  offer.size = job["payload_size"] | offer.imageSize;
+  offer.chunks = MeshProto::OtaOffer::chunkCount(offer.size, offer.chunkBytes);
+  String payloadMd5 = job["payload_md5"] | offer.md5.c_str();
+  uint32_t firmwareId = job["firmware_id"] | 0UL;
+  if (!offer.session || !firmwareId) return;
+
+  String path = "/api/v1/ota/updates/" + String(offer.session);
+  if (!post(path + "/start", "")) return;  // Taken by another gateway, or gone
+  _jobs++;
+  Serial.printf("[OTAB] Job %lu: %s v%s, %lu bytes (%s, %lu byte image)\n", (unsigned long)offer.session,
+                offer.role.c_str(), (const char*)(job["version"] | "?"), (unsigned long)offer.size,
+                encoding, (unsigned long)offer.imageSize);
+
+  const char* error = nullptr;
+  if (offer.chunkBytes > OTA_CHUNK_BYTES) {
+    error = "chunk+size+too+large";
+  } else if (_part && offer.size > _part->size) {
+    error = "image+larger+than+partition";
+  } else if (offer.encoding == MeshProto::OTA_ENC_DELTA && offer.baseMd5.size() != 32) {
+    error = "delta+without+base+md5";
+  } else if (_part && !download(payloadUrl(firmwareId, offer.encoding), offer.size, payloadMd5.c_str())) {
+    error = "download+or+md5+failed";
+  }
+  if (error) {
+    Serial.printf("[OTAB] Job %lu failed: %s\n", (unsigned long)offer.session, error);
+    post(path + "/fail?error_message=" + error, "");
+    return;
+  }
+
+  _payloadMd5 = payloadMd5;
+  _firmwareId = firmwareId;
+  save(offer);
+  stage(offer);
+}
+
+String OtaBroadcastTask::payloadUrl(uint32_t firmwareId, uint8_t encoding) const {
+  const char* name = encoding == MeshProto::OTA_ENC_DELTA      ? "delta"
+                   : encoding == MeshProto::OTA_ENC_COMPRESSED ? "compressed"
+                                                               : "raw";
+  return _baseUrl + "/api/v1/firmware/" + String(firmwareId) + "/download?encoding=" + name;
+}
+
+bool OtaBroadcastTask::download(const String& url, uint32_t size, const char* md5sum) {
+  HTTPClient http;
+  http.setTimeout(OTA_BCAST_HTTP_TIMEOUT_MS);
+  http.begin(url);
+  if (_apiKey.length() > 0) http.addHeader("X-API-Key", _apiKey);
+  _lastHttpCode = http.GET();
+  if (_lastHttpCode != 200) {
+    http.end();
+    return false;
+  }
+
+  WiFiClient* stream = http.getStreamPtr();
+  MD5Builder md5;
+  md5.begin();
+  uint32_t offset = 0;
+  uint32_t erasedTo = 0;
+  unsigned long lastData = millis();
+
+  while (offset < size) {
+    size_t avail = stream->available();
+    if (avail == 0) {
+      if (!http.connected() || millis() - lastData > OTA_BCAST_HTTP_TIMEOUT_MS) break;
+      vTaskDelay(1);
+      continue;
+    }
+    size_t want = size - offset;
+    if (want > sizeof(_buf)) want = sizeof(_buf);
+    if (want > avail) want = avail;
+    size_t n = stream->readBytes(_buf, want);
+
+    // Erase one sector at a time just ahead of the writes, not the whole image up front
+    while (erasedTo < offset + n) {
+      if (esp_partition_erase_range(_part, erasedTo, OTA_BCAST_SECTOR) != ESP_OK) {
+        http.end();
+        return false;
+      }
+      erasedTo += OTA_BCAST_SECTOR;
+    }
+    if (esp_partition_write(_part, offset, _buf, n) != ESP_OK) {
+      http.end();
+      return false;
+    }
+    md5.add(_buf, n);
+    offset += n;
+    lastData = millis();
+  }
+  http.end();
+
+  md5.calculate();
+  return offset == size && md5.toString().equalsIgnoreCase(md5sum);
+}
+
+bool OtaBroadcastTask::partitionMatches(uint32_t size, const char* md5sum) {
+  MD5Builder md5;
+  md5.begin();
+  for (uint32_t offset = 0; offset < size; offset += sizeof(_buf)) {
+    size_t n = size - offset < sizeof(_buf) ? size - offset : sizeof(_buf);
+    if (esp_partition_read(_part, offset, _buf, n) != ESP_OK) return false;
+    md5.add(_buf, n);
+  }
+  md5.calculate();
+  return md5.toString().equalsIgnoreCase(md5sum);
+}
+
+void OtaBroadcastTask::stage(const MeshProto::OtaOffer& offer) {
+  if (!_part) _relay.begin(payloadUrl(_firmwareId, offer.encoding), _apiKey, offer, _payloadMd5);
+  _offer = offer;
+  _session.store(offer.session);
+  _offerReady.store(true, std::memory_order_release);
+}
+
+void OtaBroadcastTask::handle(const OtaBcastRecord& rec) {
+  String path = "/api/v1/ota/updates/" + String(rec.session);
+
+  if (rec.type == OTAB_PROGRESS) {
+    JsonDocument doc;
+    doc["current_part"] = rec.got;
+    doc["total_parts"] = rec.chunks;
+    doc["status"] = rec.state;
+    if (rec.error[0]) doc["error_message"] = rec.error;
+    String body;
+    serializeJson(doc, body);
+    post(path + "/node/" + String(rec.nodeId, HEX) + "/progress", body);
+    return;
+  }
+
+  if (!_part && _relay.failed()) {
+    post(path + "/fail?error_message=image+fetch+failed", "");
+  } else if (rec.failed == 0 && rec.completed > 0) {
+    post(path + "/complete", "");
+  } else {
+    char error[48];
+    snprintf(error, sizeof(error), "%u+of+%u+nodes+failed", rec.failed, rec.completed + rec.failed);
+    post(path + "/fail?error_message=" + error, "");
+  }
+  clearSaved();
+  if (!_part) _relay.reset();
+  _session.store(0);
+  _lastPoll = millis();
+}
+
+bool OtaBroadcastTask::post(const String& path, const String& body) {
+  if (WiFi.status() != WL_CONNECTED) {
+    _postFailures++;
+    return false;
+  }
+  HTTPClient http;
+  http.setTimeout(OTA_BCAST_HTTP_TIMEOUT_MS);
+  http.begin(_baseUrl + path);
+  http.addHeader("Content-Type", "application/json");
+  if (_apiKey.length() > 0) http.addHeader("X-API-Key", _apiKey);
+  _lastHttpCode = http.POST(body);
+  http.end();
+
+  bool ok = _lastHttpCode >= 200 && _lastHttpCode < 300;
+  if (ok) _posted++;
+  else _postFailures++;
+  return ok;
+}
+
+void OtaBroadcastTask::save(const MeshProto::OtaOffer& offer) {
+  Preferences prefs;
+  if (!prefs.begin(OTA_BCAST_NVS_NAMESPACE, false)) return;
+  prefs.putUInt("sid", offer.session);
+  prefs.putString("role", offer.role.c_str());
+  prefs.putString("hw", offer.hardware.c_str());
+  prefs.putString("md5", offer.md5.c_str());
+  prefs.putUInt("size", offer.size);
+  prefs.putUShort("cs", offer.chunkBytes);
+  prefs.putBool("f", offer.force);
+  prefs.putUChar("enc", offer.encoding);
+  prefs.putUInt("isize", offer.imageSize);
+  prefs.putString("base", offer.baseMd5.c_str());
+  prefs.putString("pmd5", _payloadMd5);
+  prefs.putUInt("fid", _firmwareId);
+  prefs.end();
+}
+
+void OtaBroadcastTask::resume() {
+  Preferences prefs;
+  if (!prefs.begin(OTA_BCAST_NVS_NAMESPACE, true)) return;
+  MeshProto::OtaOffer offer;
+  offer.session = prefs.getUInt("sid", 0);
+  offer.role = prefs.getString("role", "").c_str();
+  offer.hardware = prefs.getString("hw", "ESP32").c_str();
+  offer.md5 = prefs.getString("md5", "").c_str();
+  offer.size = prefs.getUInt("size", 0);
+  offer.chunkBytes = prefs.getUShort("cs", OTA_CHUNK_BYTES);
+  offer.chunks = MeshProto::OtaOffer::chunkCount(offer.size, offer.chunkBytes);
+  offer.force = prefs.getBool("f", false);
+  offer.encoding = prefs.getUChar("enc", MeshProto::OTA_ENC_RAW);
+  offer.imageSize = prefs.getUInt("isize", offer.size);
+  offer.baseMd5 = prefs.getString("base", "").c_str();
+  _payloadMd5 = prefs.getString("pmd5", offer.md5.c_str());
+  _firmwareId = prefs.getUInt("fid", 0);
+  prefs.end();
+  if (!offer.session) return;
+
+  if (!_part && !_firmwareId) {
+    clearSaved();  // Staged by a build without the relay; the server recovers the job
+    return;
+  }
+  if (_part && (offer.size > _part->size || !partitionMatches(offer.size, _payloadMd5.c_str()))) {
+    Serial.printf("[OTAB] Saved job %lu no longer matches %s, dropping it\n",
+                  (unsigned long)offer.session, _part->label);
+    post("/api/v1/ota/updates/" + String(offer.session) + "/fail?error_message=staged+image+lost", "");
+    clearSaved();
+    return;
+  }
+  Serial.printf("[OTAB] Resuming job %lu\n", (unsigned long)offer.session);
+  stage(offer);
+}
+
+void OtaBroadcastTask::clearSaved() {
+  Preferences prefs;
+  if (!prefs.begin(OTA_BCAST_NVS_NAMESPACE, false)) return;
+  prefs.clear();
+  prefs.end();
+}
+
+void OtaBroadcastTask::printStatus() const {
+  Serial.println("\n--- BROADCAST OTA WORKER ---");
+  Serial.printf("Core: %d  Stack free: %u\n", OTA_BCAST_TASK_CORE,
+                _task ? (unsigned)uxTaskGetStackHighWaterMark(_task) : 0);
+  Serial.printf("Job: %lu%s\n", (unsigned long)_session.load(),
+                _offerReady.load() ? " (waiting for loop)" : "");
+  Serial.printf("Ring: %u/%u (peak %u)  Drops: %lu\n", (unsigned)_ring.depth(),
+                (unsigned)_ring.capacity(), (unsigned)_ring.highWater(), (unsigned long)_ring.drops());
+  Serial.printf("Jobs: %lu  Posts: %lu ok, %lu failed  Last HTTP: %d\n", (unsigned long)_jobs,
+                (unsigned long)_posted, (unsigned long)_postFailures, _lastHttpCode);
+  if (!_part) _relay.printStatus();
+  Serial.println("----------------------------\n");
+}
@@ -0,0 +1,163 @@
+/**
+ * @file OtaBroadcastTask.h
+ * @brief Server side of broadcast OTA, on its own FreeRTOS task
+ *
+ * Polls the server for broadcast update jobs and hands them to loop(),
+ * where the OtaBroadcastSender streams them to the mesh. Per-node progress
+ * and the final result come back through a ring and are posted to the OTA
+ * endpoints from here, so HTTP never blocks the mesh loop.
+ *
+ * With OTA_BCAST_RELAY (the default) nothing is staged: an OtaRangeRelay
+ * fetches each chunk with an HTTP range request just before the sender
+ * needs it, so the gateway holds a few chunks rather than the image. With
+ * OTA_BCAST_RELAY=0 the image is downloaded into the gateway's spare OTA
+ * partition first, which keeps a session going through server outages.
+ *
+ * The job is kept in NVS. After a gateway reboot the same session is
+ * offered again (a staged partition is re-checked against its MD5 first);
+ * nodes answer with what they still miss.
+ *
+ * A job may name a compressed or delta encoding; the gateway then stages
+ * and sends that payload as is, and nodes decode it (MeshSwarmProto
+ * OtaPatch.h). The payload MD5 guards the download, the image MD5 the node.
+ *
+ * Unicast jobs stay with MeshSwarm's enableOTADistribution(): this task
+ * only asks for mode=broadcast, and MeshSwarm's poll only sees unicast.
+ */
+
+#ifndef OTA_BROADCAST_TASK_H
+#define OTA_BROADCAST_TASK_H
+
+#include <Arduino.h>
+#include <OtaChunks.h>
+#include <atomic>
+#include <esp_partition.h>
+#include "OtaRangeRelay.h"
+#include "SpscRing.h"
+
+// Fetch chunks on demand instead of staging the image in flash
+#ifndef OTA_BCAST_RELAY
+#define OTA_BCAST_RELAY 1
+#endif
+
+// Server poll period while idle
+#ifndef OTA_BCAST_POLL_MS
+#define OTA_BCAST_POLL_MS 60000
+#endif
+
+// Ring capacity in records (power of two)
+#ifndef OTA_BCAST_RING_SIZE
+#define OTA_BCAST_RING_SIZE 32
+#endif
+
+#ifndef OTA_BCAST_TASK_CORE
+#define OTA_BCAST_TASK_CORE 0
+#endif
+
+#ifndef OTA_BCAST_TASK_STACK
+#define OTA_BCAST_TASK_STACK 8192
+#endif
+
+#ifndef OTA_BCAST_TASK_PRIORITY
+#define OTA_BCAST_TASK_PRIORITY 1
+#endif
+
+#ifndef OTA_BCAST_TASK_PERIOD_MS
+#define OTA_BCAST_TASK_PERIOD_MS 50
+#endif
+
+// Worker period while a relayed session is running
+#ifndef OTA_BCAST_RELAY_PERIOD_MS
+#define OTA_BCAST_RELAY_PERIOD_MS 5
+#endif
+
+#ifndef OTA_BCAST_HTTP_TIMEOUT_MS
+#define OTA_BCAST_HTTP_TIMEOUT_MS 10000
+#endif
+
+#define OTA_BCAST_STATE_LEN 12
+
+enum OtaBcastRecordType : uint8_t {
+  OTAB_PROGRESS = 1,  // One node's state and chunk count
+  OTAB_DONE     = 2   // Session over; completed/failed are node counts
+};
+
+struct OtaBcastRecord {
+  OtaBcastRecordType type;
+  uint32_t session;
+  uint32_t nodeId;
+  uint16_t got;
+  uint16_t chunks;
+  uint16_t completed;
+  uint16_t failed;
+  char state[OTA_BCAST_STATE_LEN];
+  char error[OTA_ERROR_LEN];
+};
+
+class OtaBroadcastTask {
+public:
+  void begin(const char* serverUrl, const char* apiKey);
+
+  // ---- Mesh thread ----
+
+  /**
+   * @brief Fetch a staged image for the sender
+   * @return true once per job, with offer filled in
+   */
+  bool takeOffer(MeshProto::OtaOffer& offer);
+
+  /**
+   * @brief Where the sender reads the job's chunks from
+   */
+  OtaChunkSource& chunkSource();
+
+  bool pushProgress(uint32_t session, uint32_t nodeId, const char* state, uint16_t got, uint16_t chunks,
+                    const char* error);
+  bool pushDone(uint32_t session, uint16_t completed, uint16_t failed);
+
+  /**
+   * @brief Job id being distributed, 0 if idle
+   */
+  uint32_t session() const { return _session.load(); }
+
+  void printStatus() const;
+
+private:
+  SpscRing<OtaBcastRecord, OTA_BCAST_RING_SIZE> _ring;
+  TaskHandle_t _task = nullptr;
+  String _baseUrl;
+  String _apiKey;
+  const esp_partition_t* _part = nullptr;   // Staging mode only
+  OtaRangeRelay _relay;
+  OtaPartitionSource _partitionSource;
+
+  // Written by the worker before _offerReady is set, read by loop() after
+  MeshProto::OtaOffer _offer;
+  String _payloadMd5;              // What is sent, when it isn't the image
+  uint32_t _firmwareId = 0;
+  std::atomic<bool> _offerReady{false};
+  std::atomic<uint32_t> _session{0};
+
+  // Worker-owned
+  uint8_t _buf[1024];
+  unsigned long _lastPoll = 0;
+  uint32_t _jobs = 0;
+  uint32_t _posted = 0;
+  uint32_t _postFailures = 0;
+  int _lastHttpCode = 0;
+
+  static void taskEntry(void* arg);
+  void run();
+  void poll();
+  String payloadUrl(uint32_t firmwareId, uint8_t encoding) const;
+  bool download(const String& url, uint32_t size, const char* md5);
+  bool partitionMatches(uint32_t size, const char* md5);
+  void stage(const MeshProto::OtaOffer& offer);
+  void handle(const OtaBcastRecord& rec);
+  bool post(const String& path, const String& body);
+  void save(const MeshProto::OtaOffer& offer);
+  void resume();
+  void clearSaved();
+};
+
+#endif // OTA_BROADCAST_TASK_H
@@ -0,0 +1,169 @@
+/**
+ * @file OtaRangeRelay.cpp
+ * @brief Broadcast OTA range relay implementation
+ */
+
+#include "OtaRangeRelay.h"
+#include <WiFi.h>
+
+void OtaRangeRelay::begin(const String& url, const String& apiKey, const MeshProto::OtaOffer& offer,
+                          const String& payloadMd5) {
+  reset();
+  _url = url;
+  _apiKey = apiKey;
+  _size = offer.size;
+  _chunkBytes = offer.chunkBytes;
+  _chunks = offer.chunks;
+  _md5sum = payloadMd5;
+  _failures = 0;
+  _failed.store(offer.chunkBytes == 0 || offer.chunkBytes > OTA_CHUNK_BYTES, std::memory_order_release);
+  _http.setReuse(true);  // One connection for the whole session
+}
+
+void OtaRangeRelay::reset() {
+  for (Slot& slot : _slots) slot.state.store(SLOT_FREE, std::memory_order_release);
+  _hashedTo = 0;
+  _md5.begin();
+  _size = 0;
+  _failed.store(false, std::memory_order_release);
+  _http.end();
+}
+
+OtaRangeRelay::Slot* OtaRangeRelay::find(uint16_t index, uint8_t state) {
+  for (Slot& slot : _slots) {
+    if (slot.index == index && slot.state.load(std::memory_order_acquire) == state) return &slot;
+  }
+  return nullptr;
+}
+
+// ============== MESH THREAD ==============
+
+void OtaRangeRelay::prefetch(uint16_t index) {
+  if (find(index, SLOT_WANTED) || find(index, SLOT_READY)) return;
+  for (Slot& slot : _slots) {
+    if (slot.state.load(std::memory_order_acquire) != SLOT_FREE) continue;
+    slot.index = index;
+    slot.state.store(SLOT_WANTED, std::memory_order_release);
+    return;
+  }
+}
+
+const uint8_t* OtaRangeRelay::acquire(uint16_t index, uint16_t len) {
+  Slot* slot = find(index, SLOT_READY);
+  if (slot && slot->len == len) return slot->data;
+  prefetch(index);
+  return nullptr;
+}
+
+void OtaRangeRelay::release(uint16_t index) {
+  Slot* slot = find(index, SLOT_READY);
+  if (slot) slot->state.store(SLOT_FREE, std::memory_order_release);
+}
+
+// ============== WORKER TASK ==============
+
+bool OtaRangeRelay::service(uint32_t timeoutMs) {
+  if (_size == 0 || failed()) return false;
+  if (_failures > 0 && millis() - _failedAt < OTA_RELAY_RETRY_MS) return false;
+
+  // Lowest wanted chunk, then as many following chunks as are wanted too
+  Slot* run[OTA_RELAY_SLOTS];
+  uint8_t count = 0;
+  for (Slot& slot : _slots) {
+    if (slot.state.load(std::memory_order_acquire) != SLOT_WANTED) continue;
+    if (count == 0 || slot.index < run[0]->index) run[0] = &slot;
+    count = 1;
+  }
+  if (count == 0) return false;
+  while (count < OTA_RELAY_SLOTS) {
+    Slot* next = find(run[count - 1]->index + 1, SLOT_WANTED);
+    if (!next) break;
+    run[count++] = next;
+  }
+
+  uint32_t first = (uint32_t)run[0]->index * _chunkBytes;
+  uint32_t end = (uint32_t)(run[count - 1]->index + 1) * _chunkBytes;
+  if (end > _size) end = _size;
+  if (first >= end) {
+    _failed.store(true, std::memory_order_release);  // Sender asked past the payload
+    return false;
+  }
+
+  _http.setTimeout(timeoutMs);
+  _http.begin(_url);
+  if (_apiKey.length() > 0) _http.addHeader("X-API-Key", _apiKey);
+  _http.addHeader("Range", "bytes=" + String(first) + "-" + String(end - 1));
+  _lastHttpCode = _http.GET();
+  _requests++;
+
+  bool ok = _lastHttpCode == 206;
+  if (ok) {
+    WiFiClient* stream = _http.getStreamPtr();
+    for (uint8_t k = 0; k < count && ok; k++) {
+      Slot& slot = *run[k];
+      uint32_t offset = (uint32_t)slot.index * _chunkBytes;
+      uint16_t len = end - offset < _chunkBytes ? end - offset : _chunkBytes;
+      ok = readFully(stream, slot.data, len, timeoutMs);
+      if (!ok) break;
+      slot.len = len;
+      _bytes += len;
+
+      // The first pass fetches every chunk in order, which is enough to check the whole payload
+      if (slot.index == _hashedTo && _hashedTo < _chunks) {
+        _md5.add(slot.data, len);
+        if (++_hashedTo == _chunks) {
+          _md5.calculate();
+          if (!_md5.toString().equalsIgnoreCase(_md5sum)) {
+            Serial.println("[OTAB] Relayed payload MD5 mismatch");
+            _failed.store(true, std::memory_order_release);
+          }
+        }
+      }
+      slot.state.store(SLOT_READY, std::memory_order_release);  // Sender may use it from here
+    }
+  }
+  _http.end();  // Keeps the connection open for the next range
+
+  if (ok) {
+    _failures = 0;
+    return true;
+  }
+  _errors++;
+  if (++_failures >= OTA_RELAY_MAX_FAILURES) {
+    Serial.printf("[OTAB] Range fetch failed %u times (HTTP %d), giving up\n", _failures, _lastHttpCode);
+    _failed.store(true, std::memory_order_release);
+  }
+  _failedAt = millis();
+  return false;
+}
+
+bool OtaRangeRelay::readFully(WiFiClient* stream, uint8_t* data, uint16_t len, uint32_t timeoutMs) {
+  uint16_t got = 0;
+  unsigned long lastData = millis();
+  while (got < len) {
+    size_t avail = stream->available();
+    if (avail == 0) {
+      if (!_http.connected() || millis() - lastData > timeoutMs) return false;
+      vTaskDelay(1);
+      continue;
+    }
+    size_t want = (size_t)(len - got) < avail ? len - got : avail;
+    got += stream->readBytes(data + got, want);
+    lastData = millis();
+  }
+  return true;
+}
+
+void OtaRangeRelay::printStatus() const {
+  uint8_t wanted = 0;
+  uint8_t ready = 0;
+  for (const Slot& slot : _slots) {
+    uint8_t state = slot.state.load(std::memory_order_acquire);
+    if (state == SLOT_WANTED) wanted++;
+    else if (state == SLOT_READY) ready++;
+  }
+  Serial.printf("Relay: %u/%u slots wanted, %u ready%s\n", wanted, OTA_RELAY_SLOTS, ready,
+                failed() ? "  FAILED" : "");
+  Serial.printf("Ranges: %lu (%lu bytes), %lu failed  Checked: %u/%u chunks\n", (unsigned long)_requests,
+                (unsigned long)_bytes, (unsigned long)_errors, _hashedTo, _chunks);
+}
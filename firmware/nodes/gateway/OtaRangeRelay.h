@@ -0,0 +1,110 @@
+/**
+ * @file OtaRangeRelay.h
+ * @brief Broadcast OTA chunks fetched from the server just ahead of the sender
+ *
+ * Instead of downloading the whole image first, the relay keeps a fixed
+ * pool of OTA_RELAY_SLOTS chunk buffers. The sender (mesh loop) claims a
+ * slot for each chunk it will send soon; the OtaBroadcastTask worker fills
+ * wanted slots with HTTP range requests, one request per run of consecutive
+ * chunks, reading the body straight into the slots. Gateway memory is the
+ * pool whatever the image size, and nothing is written to flash.
+ *
+ * Backpressure is the pool itself: the worker only fetches chunks the
+ * sender has asked for, and the sender only asks as far as it has free
+ * slots. Slow receivers slow the sender (OTA_CHUNK_INTERVAL_MS grows with
+ * their reported loss), which slows the fetches.
+ *
+ * Each slot moves FREE -> WANTED (mesh) -> READY (worker) -> FREE (mesh);
+ * every transition has one writer, so the slot state is the only atomic.
+ */
+
+#ifndef OTA_RANGE_RELAY_H
+#define OTA_RANGE_RELAY_H
+
+#include <Arduino.h>
+#include <BroadcastOta.h>
+#include <HTTPClient.h>
+#include <MD5Builder.h>
+#include <atomic>
+
+// Chunk buffers in the pool (x OTA_CHUNK_BYTES)
+#ifndef OTA_RELAY_SLOTS
+#define OTA_RELAY_SLOTS OTA_PREFETCH_AHEAD
+#endif
+
+// Failed range requests in a row before the session is given up
+#ifndef OTA_RELAY_MAX_FAILURES
+#define OTA_RELAY_MAX_FAILURES 6
+#endif
+
+#ifndef OTA_RELAY_RETRY_MS
+#define OTA_RELAY_RETRY_MS 2000
+#endif
+
+class OtaRangeRelay : public OtaChunkSource {
+public:
+  // ---- Worker task ----
+
+  /**
+   * @brief Point the pool at a job's payload and empty it
+   * @param url Download URL, including any ?encoding=
+   * @param payloadMd5 Checked once the first pass has fetched every chunk
+   */
+  void begin(const String& url, const String& apiKey, const MeshProto::OtaOffer& offer,
+             const String& payloadMd5);
+
+  /**
+   * @brief Empty the pool once the sender is done with the session
+   */
+  void reset();
+
+  /**
+   * @brief Fetch the lowest wanted chunk and the wanted run after it
+   * @return true if a range was fetched
+   */
+  bool service(uint32_t timeoutMs);
+
+  // ---- Mesh thread ----
+
+  void prefetch(uint16_t index) override;
+  const uint8_t* acquire(uint16_t index, uint16_t len) override;
+  void release(uint16_t index) override;
+  bool failed() const override { return _failed.load(std::memory_order_acquire); }
+
+  void printStatus() const;
+
+private:
+  enum SlotState : uint8_t { SLOT_FREE, SLOT_WANTED, SLOT_READY };
+
+  struct Slot {
+    std::atomic<uint8_t> state{SLOT_FREE};
+    uint16_t index = 0;   // Written by the mesh thread before WANTED
+    uint16_t len = 0;
+    uint8_t data[OTA_CHUNK_BYTES];
+  };
+
+  Slot _slots[OTA_RELAY_SLOTS];
+  std::atomic<bool> _failed{false};
+
+  // Worker-owned
+  HTTPClient _http;
+  String _url;
+  String _apiKey;
+  String _md5sum;
+  MD5Builder _md5;
+  uint32_t _size = 0;              // 0 while idle
+  uint16_t _chunkBytes = OTA_CHUNK_BYTES;
+  uint16_t _chunks = 0;
+  uint16_t _hashedTo = 0;          // Chunks added to _md5, in order
+  uint8_t _failures = 0;
+  unsigned long _failedAt = 0;
+  uint32_t _requests = 0;
+  uint32_t _bytes = 0;
+  uint32_t _errors = 0;
+  int _lastHttpCode = 0;
+
+  Slot* find(uint16_t index, uint8_t state);
+  bool readFully(WiFiClient* stream, uint8_t* data, uint16_t len, uint32_t timeoutMs);
+};
+
+#endif // OTA_RANGE_RELAY_H
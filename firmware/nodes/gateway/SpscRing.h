@@ -0,0 +1,71 @@
+/**
+ * @file SpscRing.h
+ * @brief Lock-free single-producer / single-consumer ring buffer
+ *
+ * One task pushes, one task pops; no mutex is taken on either side.
+ * Capacity must be a power of two. Push fails (and counts a drop)
+ * instead of blocking when the ring is full.
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+template <typename T, size_t N>
+class SpscRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+public:
+  /**
+   * @brief Producer side: copy an item in
+   * @return false if the ring was full (item dropped)
+   */
+  bool push(const T& item) {
+    size_t head = _head.load(std::memory_order_relaxed);
+    size_t tail = _tail.load(std::memory_order_acquire);
+    if (head - tail >= N) {
+      _drops.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    _items[head & (N - 1)] = item;
+    _head.store(head + 1, std::memory_order_release);
+
+    size_t depth = head + 1 - tail;
+    if (depth > _highWater.load(std::memory_order_relaxed)) {
+      _highWater.store(depth, std::memory_order_relaxed);
+    }
+    return true;
+  }
+
+  /**
+   * @brief Consumer side: copy the oldest item out
+   * @return false if the ring was empty
+   */
+  bool pop(T& item) {
+    size_t tail = _tail.load(std::memory_order_relaxed);
+    size_t head = _head.load(std::memory_order_acquire);
+    if (tail == head) return false;
+    item = _items[tail & (N - 1)];
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t depth() const {
+    return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+  }
+  size_t capacity() const { return N; }
+  size_t highWater() const { return _highWater.load(std::memory_order_relaxed); }
+  uint32_t drops() const { return _drops.load(std::memory_order_relaxed); }
+
+private:
+  T _items[N];
+  std::atomic<size_t> _head{0};
+  std::atomic<size_t> _tail{0};
+  std::atomic<size_t> _highWater{0};
+  std::atomic<uint32_t> _drops{0};
+};
+
+#endif // SPSC_RING_H
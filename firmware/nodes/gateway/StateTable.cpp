@@ -0,0 +1,102 @@
+/**
+ * @file StateTable.cpp
+ * @brief Compact sorted state cache implementation
+ */
+
+#include "StateTable.h"
+#include <string.h>
+
+static_assert(STATE_TABLE_KEY_POOL <= 65536, "keyOffset is 16-bit");
+
+size_t StateTable::lowerBound(const char* key, bool& found) const {
+  size_t lo = 0;
+  size_t hi = _count;
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    int cmp = strcmp(keyAt(mid), key);
+    if (cmp < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  found = lo < _count && strcmp(keyAt(lo), key) == 0;
+  return lo;
+}
+
+bool StateTable::set(const char* key, const char* value) {
+  if (value[0] == '\0') return remove(key);
+
+  bool found;
+  size_t index = lowerBound(key, found);
+
+  if (found) {
+    Entry& e = _entries[index];
+    if (strncmp(e.value, value, STATE_TABLE_VALUE_LEN - 1) == 0) return false;
+    strncpy(e.value, value, STATE_TABLE_VALUE_LEN - 1);
+    e.value[STATE_TABLE_VALUE_LEN - 1] = '\0';
+    e.updated = ++_generation;
+    return true;
+  }
+
+  // New key: evict the stalest entries until it fits
+  size_t keyLen = strlen(key) + 1;
+  if (keyLen > STATE_TABLE_KEY_POOL) {
+    _rejected++;
+    return false;
+  }
+  while (_count >= STATE_TABLE_CAPACITY || _keyPoolUsed + keyLen > STATE_TABLE_KEY_POOL) {
+    size_t oldest = 0;
+    for (size_t i = 1; i < _count; i++) {
+      if (_entries[i].updated < _entries[oldest].updated) oldest = i;
+    }
+    removeAt(oldest);
+    _evicted++;
+    if (oldest < index) index--;
+  }
+
+  // Intern the key, then open a slot at the sorted position
+
+  uint16_t keyOffset = _keyPoolUsed;
+  memcpy(_keyPool + _keyPoolUsed, key, keyLen);
+  _keyPoolUsed += keyLen;
+
+  memmove(&_entries[index + 1], &_entries[index], (_count - index) * sizeof(Entry));
+  _count++;
+
+  Entry& e = _entries[index];
+  e.keyOffset = keyOffset;
+  strncpy(e.value, value, STATE_TABLE_VALUE_LEN - 1);
+  e.value[STATE_TABLE_VALUE_LEN - 1] = '\0';
+  e.updated = ++_generation;
+  return true;
+}
+
+bool StateTable::remove(const char* key) {
+  bool found;
+  size_t index = lowerBound(key, found);
+  if (!found) return false;
+  removeAt(index);
+  _generation++;
+  return true;
+}
+
+void StateTable::removeAt(size_t index) {
+  // Close the key's gap in the pool, then shift offsets past it
+  uint16_t offset = _entries[index].keyOffset;
+  size_t keyLen = strlen(_keyPool + offset) + 1;
+  memmove(_keyPool + offset, _keyPool + offset + keyLen, _keyPoolUsed - offset - keyLen);
+  _keyPoolUsed -= keyLen;
+
+  memmove(&_entries[index], &_entries[index + 1], (_count - index - 1) * sizeof(Entry));
+  _count--;
+  for (size_t i = 0; i < _count; i++) {
+    if (_entries[i].keyOffset > offset) _entries[i].keyOffset -= keyLen;
+  }
+}
+
+const char* StateTable::get(const char* key) const {
+  bool found;
+  size_t index = lowerBound(key, found);
+  return found ? _entries[index].value : nullptr;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file StateTable.h
+ * @brief Compact sorted state cache for the gateway display
+ *
+ * Replaces std::map<String, String>: keys are interned once into a fixed
+ * character pool, entries live in one contiguous array kept sorted by key,
+ * and values use fixed-capacity slots, so updates never touch the heap.
+ * Position lookups (page seeks) are O(1); key lookups are a binary search.
+ *
+ * generation() changes whenever a value is added, changed or removed,
+ * letting readers skip rebuilding their output when nothing is new.
+ *
+ * Bounded like the mesh's StateStore: an empty value removes the key (a
+ * delete or expiry upstream) and returns its pool bytes, and a new key
+ * arriving at capacity evicts the least recently updated one.
+ */
+
+#ifndef STATE_TABLE_H
+#define STATE_TABLE_H
+
+#include <Arduino.h>
+
+// Maximum number of distinct keys
+#ifndef STATE_TABLE_CAPACITY
+#define STATE_TABLE_CAPACITY 256
+#endif
+
+// Bytes reserved for all interned keys (including terminators)
+#ifndef STATE_TABLE_KEY_POOL
+#define STATE_TABLE_KEY_POOL 4096
+#endif
+
+// Value slot size (including terminator); longer values are truncated
+#ifndef STATE_TABLE_VALUE_LEN
+#define STATE_TABLE_VALUE_LEN 24
+#endif
+
+class StateTable {
+public:
+  /**
+   * @brief Insert or update a key; an empty value removes it
+   * @return true if the table changed (new key, different value or removal)
+   */
+  bool set(const char* key, const char* value);
+  bool set(const String& key, const String& value) { return set(key.c_str(), value.c_str()); }
+
+  /**
+   * @brief Remove a key and compact the key pool
+   * @return true if the key existed
+   */
+  bool remove(const char* key);
+
+  /**
+   * @brief Look up a value by key
+   * @return Value, or nullptr if the key is unknown
+   */
+  const char* get(const char* key) const;
+
+  size_t size() const { return _count; }
+  size_t capacity() const { return STATE_TABLE_CAPACITY; }
+
+  // Sorted positional access, 0 <= index < size()
+  const char* keyAt(size_t index) const { return _keyPool + _entries[index].keyOffset; }
+  const char* valueAt(size_t index) const { return _entries[index].value; }
+
+  /**
+   * @brief Change counter, bumped on every effective set() or remove()
+   */
+  uint32_t generation() const { return _generation; }
+
+  /**
+   * @brief Keys rejected because they would not fit even in an empty pool
+   */
+  uint32_t rejected() const { return _rejected; }
+
+  /**
+   * @brief Keys evicted to make room for newer ones
+   */
+  uint32_t evicted() const { return _evicted; }
+  size_t keyPoolUsed() const { return _keyPoolUsed; }
+
+private:
+  struct Entry {
+    uint16_t keyOffset;
+    uint32_t updated;   // generation() of the last change, for eviction
+    char value[STATE_TABLE_VALUE_LEN];
+  };
+
+  Entry _entries[STATE_TABLE_CAPACITY];
+  char _keyPool[STATE_TABLE_KEY_POOL];
+  size_t _count = 0;
+  size_t _keyPoolUsed = 0;
+  uint32_t _generation = 0;
+  uint32_t _rejected = 0;
+  uint32_t _evicted = 0;
+
+  /**
+   * @brief Binary search by key
+   * @param found Set true if the key exists at the returned index
+   * @return Index of the key, or where it would be inserted
+   */
+  size_t lowerBound(const char* key, bool& found) const;
+
+  void removeAt(size_t index);
+};
+
+#endif // STATE_TABLE_H
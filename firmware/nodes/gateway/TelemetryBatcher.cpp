@@ -0,0 +1,95 @@
+/**
+ * @file TelemetryBatcher.cpp
+ * @brief Bulk telemetry uplink implementation
+ */
+
+#include "TelemetryBatcher.h"
+#include <HTTPClient.h>
+#include <WiFi.h>
+
+void TelemetryBatcher::begin(const char* serverUrl, const char* apiKey,
+                             unsigned long windowMs, size_t maxBytes) {
+  _url = String(serverUrl) + "/api/v1/nodes/telemetry/batch";
+  _apiKey = apiKey ? apiKey : "";
+  _windowMs = windowMs;
+  _maxBytes = maxBytes;
+  reset();
+}
+
+void TelemetryBatcher::reset() {
+  _doc.clear();
+  _nodes = _doc["nodes"].to<JsonArray>();
+  _count = 0;
+  _windowStart = millis();
+}
+
+JsonObject TelemetryBatcher::add(const String& nodeId) {
+  // Window starts with the first entry, not when the last batch went out
+  if (_count == 0) _windowStart = millis();
+  JsonObject entry = _nodes.add<JsonObject>();
+  entry["node_id"] = nodeId;
+  _count++;
+  return entry;
+}
+
+bool TelemetryBatcher::commit() {
+  return measureJson(_doc) >= _maxBytes;
+}
+
+bool TelemetryBatcher::isDue() const {
+  return _count > 0 && millis() - _windowStart >= _windowMs;
+}
+
+bool TelemetryBatcher::flush() {
+  if (_count == 0) {
+    _windowStart = millis();
+    return true;
+  }
+
+  if (WiFi.status() != WL_CONNECTED) {
+    _failures++;
+    _lastHttpCode = 0;
+    reset();
+    return false;
+  }
+
+  String body;
+  serializeJson(_doc, body);
+
+  HTTPClient http;
+  http.setTimeout(TELEMETRY_BATCH_TIMEOUT_MS);
+  http.begin(_url);
+  http.addHeader("Content-Type", "application/json");
+  if (_apiKey.length() > 0) {
+    http.addHeader("X-API-Key", _apiKey);
+  }
+  _lastHttpCode = http.POST(body);
+  http.end();
+
+  bool ok = _lastHttpCode >= 200 && _lastHttpCode < 300;
+  if (ok) {
+    _batchesSent++;
+    _entriesSent += _count;
+    Serial.printf("[BATCH] Sent %u entries (%u bytes)\n", _count, body.length());
+  } else {
+    _failures++;
+    Serial.printf("[BATCH] Push failed: HTTP %d (%u entries)\n", _lastHttpCode, _count);
+  }
+
+  reset();
+  return ok;
+}
+
+bool TelemetryBatcher::wasRejected() const {
+  return _lastHttpCode >= 400 && _lastHttpCode < 500 && _lastHttpCode != 408 && _lastHttpCode != 429;
+}
+
+void TelemetryBatcher::printStatus() const {
+  Serial.println("\n--- TELEMETRY BATCH ---");
+  Serial.printf("Endpoint: %s\n", _url.c_str());
+  Serial.printf("Window: %lu ms  Budget: %u bytes\n", _windowMs, _maxBytes);
+  Serial.printf("Pending: %u entries\n", _count);
+  Serial.printf("Sent: %lu batches, %lu entries\n", (unsigned long)_batchesSent, (unsigned long)_entriesSent);
+  Serial.printf("Failures: %lu  Last HTTP: %d\n", (unsigned long)_failures, _lastHttpCode);
+  Serial.println("-----------------------\n");
+}
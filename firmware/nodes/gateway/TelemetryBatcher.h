@@ -0,0 +1,112 @@
+/**
+ * @file TelemetryBatcher.h
+ * @brief Buffers per-node telemetry and uplinks it as one bulk request
+ *
+ * Instead of one HTTP POST per node per interval, entries are collected
+ * for a time window (or until a byte budget is reached) and sent to
+ * POST /api/v1/nodes/telemetry/batch in a single request.
+ *
+ * The owner decides when to flush (commit() / isDue()) so it can keep
+ * the records behind a failed batch, e.g. for the offline journal.
+ */
+
+#ifndef TELEMETRY_BATCHER_H
+#define TELEMETRY_BATCHER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Flush after this long even if the byte budget is not reached
+#ifndef TELEMETRY_BATCH_WINDOW_MS
+#define TELEMETRY_BATCH_WINDOW_MS 30000
+#endif
+
+// Flush before the serialized batch would exceed this many bytes
+#ifndef TELEMETRY_BATCH_MAX_BYTES
+#define TELEMETRY_BATCH_MAX_BYTES 4096
+#endif
+
+// HTTP timeout for the bulk request
+#ifndef TELEMETRY_BATCH_TIMEOUT_MS
+#define TELEMETRY_BATCH_TIMEOUT_MS 5000
+#endif
+
+class TelemetryBatcher {
+public:
+  /**
+   * @brief Configure the server endpoint
+   * @param serverUrl Base URL (same value passed to setTelemetryServer)
+   * @param apiKey    Sent as X-API-Key when non-empty
+   */
+  void begin(const char* serverUrl, const char* apiKey,
+             unsigned long windowMs = TELEMETRY_BATCH_WINDOW_MS,
+             size_t maxBytes = TELEMETRY_BATCH_MAX_BYTES);
+
+  /**
+   * @brief Start a new entry for a node
+   * @param nodeId Mesh node ID as hex string
+   * @return Object to fill with TelemetryIn fields (name, uptime, state, ...)
+   *
+   * Call commit() once the entry is filled so the byte budget is checked.
+   */
+  JsonObject add(const String& nodeId);
+
+  /**
+   * @brief Finish the entry returned by add()
+   * @return true once the serialized batch has reached the byte budget
+   */
+  bool commit();
+
+  /**
+   * @brief Check whether the window has elapsed with entries pending
+   */
+  bool isDue() const;
+
+  /**
+   * @brief Send all pending entries now
+   * @return true if the server accepted the batch (or nothing was pending)
+   *
+   * The batch is cleared either way; on false the caller still owns
+   * whatever it needs to retry.
+   */
+  bool flush();
+
+  size_t pending() const { return _count; }
+  uint32_t batchesSent() const { return _batchesSent; }
+  uint32_t entriesSent() const { return _entriesSent; }
+  uint32_t failures() const { return _failures; }
+  int lastHttpCode() const { return _lastHttpCode; }
+
+  /**
+   * @brief Check whether the last flush was refused by the server itself
+   *
+   * A 4xx other than 408/429 means the request would fail the same way
+   * again, so the caller should drop it rather than retry.
+   */
+  bool wasRejected() const;
+
+  /**
+   * @brief Print batching stats to Serial
+   */
+  void printStatus() const;
+
+private:
+  String _url;
+  String _apiKey;
+  unsigned long _windowMs = TELEMETRY_BATCH_WINDOW_MS;
+  size_t _maxBytes = TELEMETRY_BATCH_MAX_BYTES;
+
+  JsonDocument _doc;
+  JsonArray _nodes;
+  size_t _count = 0;
+  unsigned long _windowStart = 0;
+
+  uint32_t _batchesSent = 0;
+  uint32_t _entriesSent = 0;
+  uint32_t _failures = 0;
+  int _lastHttpCode = 0;
+
+  void reset();
+};
+
+#endif // TELEMETRY_BATCHER_H
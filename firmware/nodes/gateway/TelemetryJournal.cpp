@@ -0,0 +1,163 @@
+/**
+ * @file TelemetryJournal.cpp
+ * @brief SPIFFS ring journal implementation
+ */
+
+#include "TelemetryJournal.h"
+#include <SPIFFS.h>
+#include <rom/crc.h>
+
+#define JOURNAL_MAGIC 0x4A4E4C31  // "JNL1"
+
+bool TelemetryJournal::begin() {
+  if (!SPIFFS.begin(true)) {
+    Serial.println("[JOURNAL] SPIFFS mount failed, journal disabled");
+    return false;
+  }
+
+  const size_t fileSize = (size_t)JOURNAL_CAPACITY * sizeof(Slot);
+
+  // Preallocate the ring so later writes never grow the file
+  if (!SPIFFS.exists(JOURNAL_PATH) || SPIFFS.open(JOURNAL_PATH, "r").size() != fileSize) {
+    File f = SPIFFS.open(JOURNAL_PATH, "w");
+    if (!f) {
+      Serial.println("[JOURNAL] Cannot create journal file");
+      return false;
+    }
+    Slot empty = {};
+    for (uint32_t i = 0; i < JOURNAL_CAPACITY; i++) {
+      f.write((const uint8_t*)&empty, sizeof(empty));
+    }
+    f.close();
+    SPIFFS.remove(JOURNAL_ACK_PATH);
+    Serial.printf("[JOURNAL] Created %s (%u slots, %u bytes)\n", JOURNAL_PATH,
+                  (unsigned)JOURNAL_CAPACITY, (unsigned)fileSize);
+  }
+
+  _file = SPIFFS.open(JOURNAL_PATH, "r+");
+  if (!_file) {
+    Serial.println("[JOURNAL] Cannot open journal file");
+    return false;
+  }
+
+  // Recover the write position from the newest valid slot
+  uint32_t maxSeq = 0;
+  Slot slot;
+  for (uint32_t i = 0; i < JOURNAL_CAPACITY; i++) {
+    if (readSlot(i, slot) && slot.seq > maxSeq) {
+      maxSeq = slot.seq;
+    }
+  }
+  _writeSeq = maxSeq + 1;
+
+  // Replay position, clamped to what the ring can still hold
+  _readSeq = loadAck();
+  uint32_t oldest = _writeSeq > JOURNAL_CAPACITY ? _writeSeq - JOURNAL_CAPACITY : 1;
+  if (_readSeq < oldest || _readSeq > _writeSeq) _readSeq = oldest;
+  _peekedSeq = _readSeq;
+
+  _ready = true;
+  updateDepth();
+  Serial.printf("[JOURNAL] Ready: %lu pending of %u\n", (unsigned long)depth(), (unsigned)JOURNAL_CAPACITY);
+  return true;
+}
+
+bool TelemetryJournal::append(const UplinkRecord& rec) {
+  if (!_ready) return false;
+
+  if (_writeSeq - _readSeq >= JOURNAL_CAPACITY) {
+    // Full: drop the oldest record
+    _readSeq++;
+    if (_peekedSeq < _readSeq) _peekedSeq = _readSeq;
+    _overwritten++;
+  }
+
+  Slot slot = {};
+  slot.magic = JOURNAL_MAGIC;
+  slot.seq = _writeSeq;
+  slot.rec = rec;
+  slot.crc = slotCrc(slot);
+
+  _file.seek((_writeSeq % JOURNAL_CAPACITY) * sizeof(Slot));
+  if (_file.write((const uint8_t*)&slot, sizeof(slot)) != sizeof(slot)) {
+    return false;
+  }
+  _file.flush();
+
+  _writeSeq++;
+  _appended++;
+  updateDepth();
+  return true;
+}
+
+size_t TelemetryJournal::peek(UplinkRecord* out, size_t max) {
+  if (!_ready) return 0;
+
+  size_t n = 0;
+  uint32_t seq = _readSeq;
+  Slot slot;
+  while (n < max && seq < _writeSeq) {
+    // Slots that fail CRC or were overwritten are skipped
+    if (readSlot(seq % JOURNAL_CAPACITY, slot) && slot.seq == seq) {
+      out[n++] = slot.rec;
+    }
+    seq++;
+  }
+  _peekedSeq = seq;
+  return n;
+}
+
+void TelemetryJournal::ack() {
+  if (!_ready || _peekedSeq <= _readSeq) return;
+  _readSeq = _peekedSeq;
+  saveAck();
+  updateDepth();
+}
+
+void TelemetryJournal::ack(size_t count) {
+  if (!_ready || count == 0) return;
+
+  // Walk the peeked range again, skipping the slots peek() skipped
+  uint32_t seq = _readSeq;
+  Slot slot;
+  while (count > 0 && seq < _peekedSeq) {
+    if (readSlot(seq % JOURNAL_CAPACITY, slot) && slot.seq == seq) count--;
+    seq++;
+  }
+  if (seq <= _readSeq) return;
+  _readSeq = seq;
+  saveAck();
+  updateDepth();
+}
+
+bool TelemetryJournal::readSlot(uint32_t index, Slot& slot) {
+  _file.seek(index * sizeof(Slot));
+  if (_file.read((uint8_t*)&slot, sizeof(slot)) != sizeof(slot)) return false;
+  return isValid(slot);
+}
+
+bool TelemetryJournal::isValid(const Slot& slot) const {
+  return slot.magic == JOURNAL_MAGIC && slot.seq != 0 && slot.crc == slotCrc(slot);
+}
+
+uint32_t TelemetryJournal::slotCrc(const Slot& slot) const {
+  return crc32_le(0, (const uint8_t*)&slot, offsetof(Slot, crc));
+}
+
+void TelemetryJournal::saveAck() {
+  AckMark mark = { _readSeq, ~_readSeq };
+  File f = SPIFFS.open(JOURNAL_ACK_PATH, "w");
+  if (!f) return;
+  f.write((const uint8_t*)&mark, sizeof(mark));
+  f.close();
+}
+
+uint32_t TelemetryJournal::loadAck() {
+  File f = SPIFFS.open(JOURNAL_ACK_PATH, "r");
+  if (!f) return 0;
+  AckMark mark = {};
+  size_t n = f.read((uint8_t*)&mark, sizeof(mark));
+  f.close();
+  if (n != sizeof(mark) || mark.check != ~mark.seq) return 0;
+  return mark.seq;
+}
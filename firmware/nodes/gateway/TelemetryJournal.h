@@ -0,0 +1,101 @@
+/**
+ * @file TelemetryJournal.h
+ * @brief Store-and-forward journal for uplink records in SPIFFS
+ *
+ * While the server link is down, uplink records are appended to a
+ * preallocated ring file of fixed-size slots. Each slot carries a
+ * sequence number and CRC, so a torn write after a power loss is simply
+ * ignored at the next boot. When full, the oldest records are overwritten.
+ *
+ * The replay position is kept in a small separate file and advanced only
+ * after the server has accepted a replayed batch.
+ */
+
+#ifndef TELEMETRY_JOURNAL_H
+#define TELEMETRY_JOURNAL_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <atomic>
+#include "UplinkRecord.h"
+
+// Number of slots in the ring file (~112 bytes each)
+#ifndef JOURNAL_CAPACITY
+#define JOURNAL_CAPACITY 512
+#endif
+
+#define JOURNAL_PATH     "/telem.jnl"
+#define JOURNAL_ACK_PATH "/telem.ack"
+
+class TelemetryJournal {
+public:
+  /**
+   * @brief Mount SPIFFS, create the ring file if needed, recover positions
+   * @return false if the filesystem is unavailable (journal disabled)
+   */
+  bool begin();
+
+  bool isReady() const { return _ready; }
+
+  /**
+   * @brief Append one record (overwrites the oldest when full)
+   */
+  bool append(const UplinkRecord& rec);
+
+  /**
+   * @brief Read up to max of the oldest pending records without consuming them
+   * @return Number of records copied to out
+   */
+  size_t peek(UplinkRecord* out, size_t max);
+
+  /**
+   * @brief Consume the records returned by the last peek()
+   */
+  void ack();
+
+  /**
+   * @brief Consume only the first count records returned by the last peek()
+   */
+  void ack(size_t count);
+
+  /**
+   * @brief Pending records (safe to call from any task)
+   */
+  uint32_t depth() const { return _depth.load(); }
+
+  uint32_t capacity() const { return JOURNAL_CAPACITY; }
+  uint32_t overwritten() const { return _overwritten; }
+  uint32_t appended() const { return _appended; }
+
+private:
+  struct Slot {
+    uint32_t magic;
+    uint32_t seq;
+    UplinkRecord rec;
+    uint32_t crc;
+  };
+
+  struct AckMark {
+    uint32_t seq;
+    uint32_t check;  // ~seq
+  };
+
+  File _file;
+  bool _ready = false;
+
+  uint32_t _writeSeq = 1;   // Next sequence number to write (0 = empty slot)
+  uint32_t _readSeq = 1;    // Oldest unacknowledged sequence number
+  uint32_t _peekedSeq = 1;  // One past the last record returned by peek()
+  uint32_t _overwritten = 0;
+  uint32_t _appended = 0;
+  std::atomic<uint32_t> _depth{0};
+
+  bool readSlot(uint32_t index, Slot& slot);
+  bool isValid(const Slot& slot) const;
+  uint32_t slotCrc(const Slot& slot) const;
+  void saveAck();
+  uint32_t loadAck();
+  void updateDepth() { _depth.store(_writeSeq - _readSeq); }
+};
+
+#endif // TELEMETRY_JOURNAL_H
@@ -0,0 +1,48 @@
+/**
+ * @file UplinkRecord.h
+ * @brief Fixed-size record passed from the mesh thread to the uplink worker
+ *
+ * Plain data with no pointers, so it can be copied through the ring and
+ * written to the journal as-is.
+ */
+
+#ifndef UPLINK_RECORD_H
+#define UPLINK_RECORD_H
+
+#include <stdint.h>
+#include <PerfStats.h>
+
+// Only trust clock readings after this date (Nov 2023), same gate the nodes use
+#define MIN_VALID_UNIX_TIME 1700000000UL
+
+#define UPLINK_KEY_LEN   32
+#define UPLINK_VALUE_LEN 48
+
+enum UplinkRecordType : uint8_t {
+  UPLINK_TELEMETRY = 1,  // name = node name, value = role
+  UPLINK_STATE     = 2,  // name = state key, value = state value
+  UPLINK_PERF      = 3   // perf = node's last PerfStats window
+};
+
+struct UplinkRecord {
+  UplinkRecordType type;
+  bool hasStats;         // uptime/heapFree/peerCount are valid
+  uint16_t peerCount;
+  uint32_t nodeId;
+  uint32_t uptime;
+  uint32_t heapFree;
+  uint32_t timestamp;    // Unix time when queued, 0 if NTP not synced yet
+  union {
+    struct {
+      char name[UPLINK_KEY_LEN];
+      char value[UPLINK_VALUE_LEN];
+    };
+    PerfSummary perf;
+  };
+};
+
+// Perf shares the text fields, so the journal slot size is unchanged
+static_assert(sizeof(PerfSummary) <= UPLINK_KEY_LEN + UPLINK_VALUE_LEN,
+              "PerfSummary must fit in the UplinkRecord text fields");
+
+#endif // UPLINK_RECORD_H
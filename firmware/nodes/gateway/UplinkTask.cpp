@@ -0,0 +1,323 @@
+/**
+ * @file UplinkTask.cpp
+ * @brief Gateway uplink worker implementation
+ */
+
+#include "UplinkTask.h"
+#include <HTTPClient.h>
+#include <WiFi.h>
+#include <time.h>
+
+static void copyField(char* dst, size_t size, const String& src) {
+  strncpy(dst, src.c_str(), size - 1);
+  dst[size - 1] = '\0';
+}
+
+// Records the server merges into one telemetry row
+static bool sameSample(const UplinkRecord& a, const UplinkRecord& b) {
+  return a.timestamp != 0 && a.timestamp == b.timestamp && a.nodeId == b.nodeId;
+}
+
+void UplinkTask::begin(uint32_t selfId, const char* serverUrl, const char* apiKey, const char* ntpServer,
+                       unsigned long timeSyncInterval, TelemetryBatcher* batch) {
+  _selfId = selfId;
+  _otaUrl = String(serverUrl) + "/api/v1/ota/updates/pending";
+  _apiKey = apiKey;
+  _ntpServer = ntpServer;
+  _timeSyncInterval = timeSyncInterval;
+  _batch = batch;
+
+  xTaskCreatePinnedToCore(taskEntry, "uplink", UPLINK_TASK_STACK, this,
+                          UPLINK_TASK_PRIORITY, &_task, UPLINK_TASK_CORE);
+  Serial.printf("[UPLINK] Worker started on core %d (ring %d)\n", UPLINK_TASK_CORE, UPLINK_RING_SIZE);
+}
+
+UplinkRecord UplinkTask::makeRecord(UplinkRecordType type, uint32_t nodeId,
+                                    const String& name, const String& value) const {
+  UplinkRecord rec = {};
+  rec.type = type;
+  rec.nodeId = nodeId;
+  copyField(rec.name, sizeof(rec.name), name);
+  copyField(rec.value, sizeof(rec.value), value);
+
+  // Stamp at the source so journaled samples keep their real time
+  time_t now = time(nullptr);
+  if ((unsigned long)now >= MIN_VALID_UNIX_TIME) rec.timestamp = (uint32_t)now;
+  return rec;
+}
+
+bool UplinkTask::pushTelemetry(uint32_t nodeId, const String& name, const String& role) {
+  return _ring.push(makeRecord(UPLINK_TELEMETRY, nodeId, name, role));
+}
+
+bool UplinkTask::pushTelemetry(uint32_t nodeId, const String& name, const String& role,
+                               uint32_t uptime, uint32_t heapFree, uint16_t peerCount) {
+  UplinkRecord rec = makeRecord(UPLINK_TELEMETRY, nodeId, name, role);
+  rec.hasStats = true;
+  rec.uptime = uptime;
+  rec.heapFree = heapFree;
+  rec.peerCount = peerCount;
+  return _ring.push(rec);
+}
+
+bool UplinkTask::pushState(const String& key, const String& value) {
+  return _ring.push(makeRecord(UPLINK_STATE, _selfId, key, value));
+}
+
+bool UplinkTask::pushPerf(uint32_t nodeId, const PerfSummary& perf) {
+  UplinkRecord rec = makeRecord(UPLINK_PERF, nodeId, String(), String());
+  rec.perf = perf;
+  return _ring.push(rec);
+}
+
+void UplinkTask::taskEntry(void* arg) {
+  static_cast<UplinkTask*>(arg)->run();
+}
+
+void UplinkTask::run() {
+  // Every record the mesh thread queues is journaled while the link is down
+  _journal.begin();
+
+  for (;;) {
+    UplinkRecord rec;
+    while (_ring.pop(rec)) {
+      handle(rec);
+    }
+
+    serviceTime();
+    serviceOta();
+
+    if (_batch->isDue()) {
+      flushBatch();
+    }
+    serviceReplay();
+
+    vTaskDelay(pdMS_TO_TICKS(UPLINK_TASK_PERIOD_MS));
+  }
+}
+
+void UplinkTask::handle(const UplinkRecord& rec) {
+  _recordsHandled++;
+
+  // Link down: store and forward later
+  if (_journal.isReady() && (!_linkUp.load() || WiFi.status() != WL_CONNECTED)) {
+    _linkUp.store(false);
+    _journal.append(rec);
+    return;
+  }
+
+  if (rec.type == UPLINK_STATE) {
+    // Coalesce: only the latest value per key is uplinked
+    _pendingState[rec.name] = rec.value;
+    return;
+  }
+
+  if (rec.type == UPLINK_PERF) {
+    // Held for the node's next telemetry entry (one row per sample server-side)
+    _pendingPerf[rec.nodeId] = rec.perf;
+    return;
+  }
+
+  _inBatch.push_back(rec);
+  JsonObject entry = addEntry(rec);
+
+  auto perf = _pendingPerf.find(rec.nodeId);
+  if (perf != _pendingPerf.end()) {
+    PerfStats::toJson(perf->second, entry["perf"].to<JsonObject>());
+
+    // Journaled separately with the same timestamp; the server merges them
+    UplinkRecord perfRec = rec;
+    perfRec.type = UPLINK_PERF;
+    perfRec.perf = perf->second;
+    _inBatch.push_back(perfRec);
+    _pendingPerf.erase(perf);
+  }
+
+  // State changes seen since the last push ride on the gateway's own entry
+  if (rec.nodeId == _selfId && !_pendingState.empty()) {
+    JsonObject entry = _batch->add(String(_selfId, HEX));
+    if (rec.timestamp) entry["timestamp"] = rec.timestamp;
+    JsonObject state = entry["state"].to<JsonObject>();
+    for (auto& kv : _pendingState) {
+      state[kv.first] = kv.second;
+      UplinkRecord stateRec = makeRecord(UPLINK_STATE, _selfId, kv.first, kv.second);
+      stateRec.timestamp = rec.timestamp;
+      _inBatch.push_back(stateRec);
+    }
+    _pendingState.clear();
+  }
+
+  if (_batch->commit()) {
+    flushBatch();
+  }
+}
+
+JsonObject UplinkTask::addEntry(const UplinkRecord& rec) {
+  JsonObject entry = _batch->add(String(rec.nodeId, HEX));
+  if (rec.timestamp) entry["timestamp"] = rec.timestamp;
+
+  if (rec.type == UPLINK_STATE) {
+    entry["state"][rec.name] = rec.value;
+    return entry;
+  }
+
+  if (rec.type == UPLINK_PERF) {
+    PerfStats::toJson(rec.perf, entry["perf"].to<JsonObject>());
+    return entry;
+  }
+
+  entry["name"] = rec.name;
+  if (rec.value[0] != '\0') entry["role"] = rec.value;
+  if (rec.hasStats) {
+    entry["uptime"] = rec.uptime;
+    entry["heap_free"] = rec.heapFree;
+    entry["peer_count"] = rec.peerCount;
+  }
+  return entry;
+}
+
+void UplinkTask::flushBatch() {
+  bool ok = _batch->flush();
+
+  if (!ok && _batch->wasRejected()) {
+    // The server answered, so the link is fine; a retry would be refused again
+    _rejected += _inBatch.size();
+    _linkUp.store(true);
+    _inBatch.clear();
+    return;
+  }
+
+  _linkUp.store(ok);
+  if (!ok && _journal.isReady()) {
+    for (auto& rec : _inBatch) {
+      _journal.append(rec);
+    }
+    Serial.printf("[UPLINK] Link down, journaled %u records\n", (unsigned)_inBatch.size());
+  }
+  _inBatch.clear();
+}
+
+void UplinkTask::serviceReplay() {
+  if (!_journal.isReady()) return;
+
+  if (WiFi.status() != WL_CONNECTED) {
+    _linkUp.store(false);
+    return;
+  }
+
+  if (_journal.depth() == 0) {
+    // Nothing to catch up on: let the next live batch probe the link
+    _linkUp.store(true);
+    return;
+  }
+
+  // Live batch in progress, or too soon since the last replay
+  if (_batch->pending() > 0) return;
+  if (millis() - _lastReplay < JOURNAL_REPLAY_INTERVAL_MS) return;
+  _lastReplay = millis();
+
+  size_t n = _journal.peek(_replayBuf, JOURNAL_REPLAY_BATCH);
+
+  // A sample's telemetry, perf and state records share (node, timestamp).
+  // If the window may have cut that run short, leave it for the next replay
+  // so the server gets the whole sample in one request.
+  if (n == JOURNAL_REPLAY_BATCH) {
+    size_t whole = n;
+    while (whole > 0 && sameSample(_replayBuf[whole - 1], _replayBuf[n - 1])) whole--;
+    if (whole > 0) n = whole;  // Otherwise one sample fills the window; send it as is
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    addEntry(_replayBuf[i]);
+  }
+
+  if (_batch->flush()) {
+    _journal.ack(n);
+    _replayed += n;
+    _linkUp.store(true);
+  } else if (_batch->wasRejected()) {
+    // Retrying would be refused forever and hold every later record behind it
+    _journal.ack(n);
+    _rejected += n;
+    _linkUp.store(true);
+    Serial.printf("[UPLINK] Server rejected %u replayed records, dropped\n", (unsigned)n);
+  } else {
+    _linkUp.store(false);
+  }
+}
+
+void UplinkTask::serviceTime() {
+  if (WiFi.status() != WL_CONNECTED) return;
+
+  if (!_ntpConfigured) {
+    // UTC (zero offsets) so time() returns UTC; nodes apply their own timezone
+    configTime(0, 0, _ntpServer);
+    _ntpConfigured = true;
+    Serial.printf("[UPLINK] NTP configured: %s (publishing UTC)\n", _ntpServer);
+  }
+
+  bool due = !_timeSynced.load() || millis() - _lastTimeSync > _timeSyncInterval;
+  if (!due) return;
+
+  // Blocks this task only; the mesh keeps running on the other core
+  struct tm timeinfo;
+  if (!getLocalTime(&timeinfo, 1000)) return;
+
+  time_t utcNow;
+  time(&utcNow);
+  if ((unsigned long)utcNow < MIN_VALID_UNIX_TIME) return;
+
+  _lastTimeSync = millis();
+  _timeSynced.store(true);
+  _pendingTime.store((uint32_t)utcNow);
+}
+
+void UplinkTask::serviceOta() {
+  if (WiFi.status() != WL_CONNECTED) return;
+  if (_lastOtaPoll != 0 && millis() - _lastOtaPoll < UPLINK_OTA_POLL_MS) return;
+  _lastOtaPoll = millis();
+  _otaPolls++;
+
+  HTTPClient http;
+  http.setTimeout(UPLINK_OTA_TIMEOUT_MS);
+  http.begin(_otaUrl);  // mode defaults to unicast
+  if (_apiKey.length() > 0) http.addHeader("X-API-Key", _apiKey);
+  _otaHttpCode = http.GET();
+  if (_otaHttpCode != 200) {
+    http.end();
+    return;
+  }
+
+  // Only whether the list is empty matters; MeshSwarm fetches the job itself
+  JsonDocument filter;
+  filter[0]["update_id"] = true;
+  JsonDocument doc;
+  DeserializationError err = deserializeJson(doc, http.getString(), DeserializationOption::Filter(filter));
+  http.end();
+  if (!err && doc.as<JsonArray>().size() > 0) {
+    _otaPending.store(true);
+  }
+}
+
+void UplinkTask::printStatus() const {
+  Serial.println("\n--- UPLINK WORKER ---");
+  Serial.printf("Core: %d  Stack free: %u\n", UPLINK_TASK_CORE,
+                _task ? (unsigned)uxTaskGetStackHighWaterMark(_task) : 0);
+  Serial.printf("Ring: %u/%u (peak %u)\n", (unsigned)_ring.depth(),
+                (unsigned)_ring.capacity(), (unsigned)_ring.highWater());
+  Serial.printf("Drops: %lu\n", (unsigned long)_ring.drops());
+  Serial.printf("Handled: %lu records\n", (unsigned long)_recordsHandled);
+  Serial.printf("NTP: %s\n", _timeSynced.load() ? "synced" : "waiting");
+  Serial.printf("OTA poll: %lu polls, last HTTP %d%s\n", (unsigned long)_otaPolls, _otaHttpCode,
+                _otaPending.load() ? ", job waiting" : "");
+  Serial.printf("Link: %s\n", _linkUp.load() ? "up" : "down (journaling)");
+  Serial.printf("Rejected: %lu records\n", (unsigned long)_rejected);
+  if (_journal.isReady()) {
+    Serial.printf("Journal: %lu/%lu pending, %lu replayed, %lu overwritten\n",
+                  (unsigned long)_journal.depth(), (unsigned long)_journal.capacity(),
+                  (unsigned long)_replayed, (unsigned long)_journal.overwritten());
+  } else {
+    Serial.println("Journal: unavailable");
+  }
+  Serial.println("---------------------\n");
+}
@@ -0,0 +1,178 @@
+/**
+ * @file UplinkTask.h
+ * @brief Gateway uplink worker running on its own FreeRTOS task
+ *
+ * Keeps blocking network work (HTTP telemetry, NTP) off the core that
+ * services painlessMesh. The mesh thread only pushes fixed-size records
+ * into a lock-free ring; the worker drains it into the TelemetryBatcher.
+ *
+ * While the server link is down, records go to the TelemetryJournal
+ * instead and are replayed in small, rate-limited batches once it returns.
+ *
+ * Node records are filed under the node they describe. Shared state is
+ * mesh-wide and a watcher can't tell which node wrote a key, so changes
+ * are filed under the gateway, as MeshSwarm's own push files its state.
+ *
+ * It also polls the server for unicast OTA jobs. MeshSwarm's
+ * checkForOTAUpdates() does HTTP and drives the mesh, so loop() only calls
+ * it once takeOtaPending() says a job is waiting.
+ *
+ * Anything that has to touch the mesh (publishing "time", starting OTA) is
+ * handed back to loop() through takeTime()/takeOtaPending(), since
+ * painlessMesh is not thread-safe.
+ */
+
+#ifndef UPLINK_TASK_H
+#define UPLINK_TASK_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <map>
+#include <vector>
+#include "SpscRing.h"
+#include "TelemetryBatcher.h"
+#include "TelemetryJournal.h"
+#include "UplinkRecord.h"
+
+// Ring capacity in records (power of two)
+#ifndef UPLINK_RING_SIZE
+#define UPLINK_RING_SIZE 64
+#endif
+
+// Core for the worker; loop() runs on ARDUINO_RUNNING_CORE (1)
+#ifndef UPLINK_TASK_CORE
+#define UPLINK_TASK_CORE 0
+#endif
+
+#ifndef UPLINK_TASK_STACK
+#define UPLINK_TASK_STACK 8192
+#endif
+
+#ifndef UPLINK_TASK_PRIORITY
+#define UPLINK_TASK_PRIORITY 1
+#endif
+
+// Worker idle period between ring drains
+#ifndef UPLINK_TASK_PERIOD_MS
+#define UPLINK_TASK_PERIOD_MS 20
+#endif
+
+// Journal replay: records per request and minimum gap between requests,
+// so catching up never starves live traffic
+#ifndef JOURNAL_REPLAY_BATCH
+#define JOURNAL_REPLAY_BATCH 16
+#endif
+
+#ifndef JOURNAL_REPLAY_INTERVAL_MS
+#define JOURNAL_REPLAY_INTERVAL_MS 2000
+#endif
+
+// Unicast OTA job poll period (MeshSwarm's own poll interval)
+#ifndef UPLINK_OTA_POLL_MS
+#define UPLINK_OTA_POLL_MS 60000
+#endif
+
+#ifndef UPLINK_OTA_TIMEOUT_MS
+#define UPLINK_OTA_TIMEOUT_MS 5000
+#endif
+
+class UplinkTask {
+public:
+  /**
+   * @brief Start the worker task
+   * @param selfId            Gateway node ID (pending state is attached to its entry)
+   * @param serverUrl         Server base URL, for the OTA job poll
+   * @param apiKey            Sent as X-API-Key when non-empty
+   * @param ntpServer         NTP host for time sync
+   * @param timeSyncInterval  Re-sync period in ms
+   * @param batch             Bulk telemetry uplink (required)
+   */
+  void begin(uint32_t selfId, const char* serverUrl, const char* apiKey, const char* ntpServer,
+             unsigned long timeSyncInterval, TelemetryBatcher* batch);
+
+  // ---- Producer side (mesh thread) ----
+
+  bool pushTelemetry(uint32_t nodeId, const String& name, const String& role);
+  bool pushTelemetry(uint32_t nodeId, const String& name, const String& role,
+                     uint32_t uptime, uint32_t heapFree, uint16_t peerCount);
+  bool pushState(const String& key, const String& value);
+
+  /**
+   * @brief Queue a node's perf window; it rides on that node's next telemetry entry
+   */
+  bool pushPerf(uint32_t nodeId, const PerfSummary& perf);
+
+  /**
+   * @brief Fetch a freshly synced UTC time for publishing to the mesh
+   * @return Unix time, or 0 if nothing new since the last call
+   */
+  uint32_t takeTime() { return _pendingTime.exchange(0); }
+
+  bool isTimeSynced() const { return _timeSynced.load(); }
+
+  /**
+   * @brief Whether the last OTA poll found a unicast job waiting
+   * @return true once per poll that found one
+   */
+  bool takeOtaPending() { return _otaPending.exchange(false); }
+
+  /**
+   * @brief Last known server link state (false while journaling)
+   */
+  bool isLinkUp() const { return _linkUp.load(); }
+
+  /**
+   * @brief Records waiting in the offline journal
+   */
+  uint32_t journalDepth() const { return _journal.depth(); }
+
+  /**
+   * @brief Print ring depth, drops and worker stats to Serial
+   */
+  void printStatus() const;
+
+private:
+  SpscRing<UplinkRecord, UPLINK_RING_SIZE> _ring;
+  TelemetryBatcher* _batch = nullptr;
+  TelemetryJournal _journal;
+  TaskHandle_t _task = nullptr;
+
+  uint32_t _selfId = 0;
+  String _otaUrl;
+  String _apiKey;
+  const char* _ntpServer = nullptr;
+  unsigned long _timeSyncInterval = 60000;
+
+  // Worker-owned
+  std::map<String, String> _pendingState;
+  std::map<uint32_t, PerfSummary> _pendingPerf;  // Latest window per node
+  std::vector<UplinkRecord> _inBatch;  // Records behind the live batch, journaled if it fails
+  UplinkRecord _replayBuf[JOURNAL_REPLAY_BATCH];
+  bool _ntpConfigured = false;
+  unsigned long _lastTimeSync = 0;
+  unsigned long _lastReplay = 0;
+  unsigned long _lastOtaPoll = 0;
+  uint32_t _otaPolls = 0;
+  int _otaHttpCode = 0;
+  uint32_t _recordsHandled = 0;
+  uint32_t _replayed = 0;
+  uint32_t _rejected = 0;  // Records dropped because the server refused them
+
+  std::atomic<uint32_t> _pendingTime{0};
+  std::atomic<bool> _timeSynced{false};
+  std::atomic<bool> _linkUp{true};
+  std::atomic<bool> _otaPending{false};
+
+  static void taskEntry(void* arg);
+  void run();
+  void handle(const UplinkRecord& rec);
+  JsonObject addEntry(const UplinkRecord& rec);
+  void flushBatch();
+  void serviceReplay();
+  void serviceTime();
+  void serviceOta();
+  UplinkRecord makeRecord(UplinkRecordType type, uint32_t nodeId,
+                          const String& name, const String& value) const;
+};
+
+#endif // UPLINK_TASK_H
@@ -15,6 +15,14 @@
  *   - Pushes telemetry to server for all nodes
  *   - Also pushes its own telemetry
  *   - OTA firmware distribution to mesh nodes
+ *   - Broadcast OTA: one chunk stream for every node of a type, nodes
+ *     request only the chunks they missed (OTA_BROADCAST_MODE)
+ *   - Uplink worker task on the other core: NTP, batched telemetry and
+ *     OTA polling HTTP never block the mesh loop
+ *   - Offline journal in SPIFFS: telemetry is stored while the server link
+ *     is down and replayed (rate-limited) when it returns
+ *   - Loop/heap/message counters (PerfStats) for the gateway and, pulled
+ *     with the "perf" command, its peers, uplinked with their telemetry
  *
  * Hardware:
  *   - ESP32 Dev Module
@@ -24,15 +32,25 @@
  *   - status: Show node status
  *   - peers: List connected peers
  *   - state: Show shared state
- *   - telem: Show telemetry/gateway status
+ *   - telem: Show telemetry/gateway status (plus uplink ring depth/drops, perf window)
  *   - push: Manual telemetry push
+ *   - batch: Show batched uplink status
+ *   - ota: Show broadcast OTA session and worker status (OTA_BROADCAST_MODE)
  *   - reboot: Restart node
  */
 
 #include <Arduino.h>
+#include <BroadcastOta.h>
 #include <MeshSwarm.h>
+#include <MeshTimeSync.h>
+#include <PerfStats.h>
+#include <UrgentState.h>
 #include <esp_ota_ops.h>
 #include <time.h>
+#include "OtaBroadcastTask.h"
+#include "StateTable.h"
+#include "TelemetryBatcher.h"
+#include "UplinkTask.h"
 
 // Include credentials (gitignored)
 #if __has_include("credentials.h")
@@ -58,9 +76,42 @@
 #define TELEMETRY_PUSH_INTERVAL 30000  // 30 seconds
 #endif
 
-// Time sync interval (milliseconds)
+// Telemetry goes out as one bulk POST per window instead of one POST per
+// node, sent from the uplink worker so HTTP never blocks the mesh loop.
+// MeshSwarm's relay is off; peers' telemetry comes from the "perf" pull.
+// Window/byte budget: TELEMETRY_BATCH_WINDOW_MS / TELEMETRY_BATCH_MAX_BYTES
+
+// Broadcast OTA: serve mode=broadcast jobs by streaming each chunk once to
+// all nodes of the type. Unicast jobs still go through enableOTADistribution().
+#ifndef OTA_BROADCAST_MODE
+#define OTA_BROADCAST_MODE 1
+#endif
+
+// The gateway asks every live peer for its telemetry (vitals and perf window)
+// once per TELEMETRY_PUSH_INTERVAL: TELEMETRY_PULL_BURST peers every
+// TELEMETRY_PULL_SPACING_MS, so a large mesh isn't asked all at once
+#ifndef TELEMETRY_PULL_BURST
+#define TELEMETRY_PULL_BURST 4
+#endif
+
+#ifndef TELEMETRY_PULL_SPACING_MS
+#define TELEMETRY_PULL_SPACING_MS 250
+#endif
+
+// A peer that doesn't answer in time is uplinked with its name and role only
+#ifndef TELEMETRY_PULL_TIMEOUT_MS
+#define TELEMETRY_PULL_TIMEOUT_MS 5000
+#endif
+
+// NTP refresh interval (milliseconds). Mesh clients pull time with
+// timesync requests and correct their own drift, so this can be long.
 #ifndef TIME_SYNC_INTERVAL
-#define TIME_SYNC_INTERVAL 60000  // 1 minute
+#define TIME_SYNC_INTERVAL 3600000  // 1 hour
+#endif
+
+// Also publish the legacy "time" state key for nodes without timesync
+#ifndef TIME_SYNC_PUBLISH_STATE
+#define TIME_SYNC_PUBLISH_STATE 0
 #endif
 
 // NTP settings
@@ -96,8 +147,18 @@ volatile int statePage = 0;       // Current state page
 
 // ============== GLOBALS ==============
 MeshSwarm swarm;
-unsigned long lastTimeSync = 0;
-bool ntpConfigured = false;
+UplinkTask uplink;
+
+TelemetryBatcher telemetryBatch;
+unsigned long lastBatchCollect = 0;
+bool pullSweep = false;     // Telemetry pull in progress
+uint32_t pullAfter = 0;     // Highest node id asked in this sweep
+unsigned long lastPull = 0;
+
+#if OTA_BROADCAST_MODE
+OtaBroadcastSender otaSender;
+OtaBroadcastTask otaTask;
+#endif
 
 // Screen navigation state
 volatile GatewayScreen currentScreen = SCREEN_OVERVIEW;
@@ -105,7 +166,13 @@ volatile unsigned long lastButtonPress = 0;
 volatile bool screenChanged = false;
 
 // State cache for display (since sharedState is private)
-std::map<String, String> stateCache;
+StateTable stateCache;
+
+// Formatted STATE page, rebuilt only when the page or the table changes
+char stateLines[STATE_ENTRIES_PER_PAGE][22];
+int stateLinesShown = 0;
+int stateLinesPage = -1;
+uint32_t stateLinesGeneration = 0;
 
 // Screen names for status line (21 chars max for OLED width)
 // Note: STATE screen name is generated dynamically with page number
@@ -169,6 +236,58 @@ void updateStatusLine() {
   }
 }
 
+// ============== BATCHED TELEMETRY ==============
+// Queue the gateway's own record and start a pull of every live peer. The
+// uplink worker turns the records into batch entries; state changes are
+// queued as they happen (see watchState).
+void collectBatchTelemetry() {
+  // Perf goes first so the worker attaches it to the telemetry entry below
+  if (perfStats.windows() > 0) uplink.pushPerf(swarm.getNodeId(), perfStats.last());
+  uplink.pushTelemetry(swarm.getNodeId(), NODE_NAME, swarm.isCoordinator() ? "COORD" : "NODE",
+                       millis() / 1000, ESP.getFreeHeap(), swarm.getPeerCount());
+
+  pullSweep = true;
+  pullAfter = 0;
+}
+
+// A peer's "perf" reply carries its vitals and last perf window: the same
+// fields its MSG_TELEMETRY gives MeshSwarm's relay, which can't be tapped
+void onPeerTelemetry(bool success, const String& node, JsonObject& result) {
+  for (auto& kv : swarm.getPeers()) {
+    Peer& peer = kv.second;
+    if (peer.name != node) continue;
+
+    if (!success || !result["uptime"].is<uint32_t>()) {
+      // No answer: still uplinked, so the node stays registered and online
+      uplink.pushTelemetry(kv.first, peer.name, peer.role);
+      return;
+    }
+
+    PerfSummary perf;
+    if (PerfStats::fromJson(result, perf)) uplink.pushPerf(kv.first, perf);
+    uplink.pushTelemetry(kv.first, peer.name, peer.role, result["uptime"] | 0UL,
+                         result["heap_free"] | 0UL, result["peer_count"] | 0);
+    return;
+  }
+}
+
+// Ask the next few live peers of the sweep (in id order) for their telemetry
+void pullPeerTelemetry() {
+  JsonDocument doc;
+  JsonObject args = doc.to<JsonObject>();
+  int sent = 0;
+
+  for (auto& kv : swarm.getPeers()) {
+    if (kv.first <= pullAfter || !kv.second.alive) continue;
+    if (sent >= TELEMETRY_PULL_BURST) return;
+    swarm.sendCommand(kv.second.name, PERF_COMMAND, args, onPeerTelemetry, TELEMETRY_PULL_TIMEOUT_MS);
+    perfStats.countOut(PERF_MSG_COMMAND);
+    pullAfter = kv.first;
+    sent++;
+  }
+  pullSweep = false;
+}
+
 // ============== RSSI TO QUALITY STRING ==============
 const char* rssiToQuality(int rssi) {
   if (rssi >= -50) return "Excellent";
@@ -183,11 +302,18 @@ const char* rssiToQuality(int rssi) {
 void drawOverviewScreen(Adafruit_SSD1306& disp) {
   // Lines 4-8: Gateway status (line 3 is status line with screen name)
   disp.printf("WiFi:%s\n", swarm.isWiFiConnected() ? "Connected" : "Disconnected");
-  disp.println("Server:OK  OTA:Ready");
+  // Journal depth grows while the server link is down, drains on replay
+#if OTA_BROADCAST_MODE
+  const char* otaLabel = otaSender.active() ? "Bc" : "Rdy";
+#else
+  const char* otaLabel = "Rdy";
+#endif
+  disp.printf("Srv:%s OTA:%s J:%lu\n", uplink.isLinkUp() ? "OK" : "--", otaLabel,
+              (unsigned long)uplink.journalDepth());
   disp.printf("IP:%s\n", WiFi.localIP().toString().c_str());
   unsigned long uptime = millis() / 1000;
   disp.printf("Up:%lu:%02lu:%02lu\n", uptime / 3600, (uptime / 60) % 60, uptime % 60);
-  disp.printf("Nodes:%d States:%d\n", swarm.getPeerCount() + 1, stateCache.size());
+  disp.printf("Nodes:%d States:%u\n", swarm.getPeerCount() + 1, (unsigned)stateCache.size());
 }
 
 void drawWifiScreen(Adafruit_SSD1306& disp) {
@@ -255,6 +381,31 @@ void drawNodesScreen(Adafruit_SSD1306& disp) {
   }
 }
 
+// Format the current page into stateLines (O(1) seek into the sorted table)
+void buildStateLines(int page) {
+  size_t startIdx = (size_t)page * STATE_ENTRIES_PER_PAGE;
+  stateLinesShown = 0;
+
+  for (size_t i = startIdx; i < stateCache.size() && stateLinesShown < STATE_ENTRIES_PER_PAGE; i++) {
+    // Format: key=value, ensuring value is visible
+    // Total width: 21 chars, value truncated to 10 chars
+    const char* key = stateCache.keyAt(i);
+    const char* val = stateCache.valueAt(i);
+
+    int valLen = strnlen(val, 10);
+    // Max key length: 21 - 1 (=) - valLen
+    int maxKeyLen = 20 - valLen;
+    if (maxKeyLen < 1) maxKeyLen = 1;
+
+    snprintf(stateLines[stateLinesShown], sizeof(stateLines[0]), "%.*s=%.*s",
+             maxKeyLen, key, valLen, val);
+    stateLinesShown++;
+  }
+
+  stateLinesPage = page;
+  stateLinesGeneration = stateCache.generation();
+}
+
 void drawStateScreen(Adafruit_SSD1306& disp) {
   // Lines 4-8: State entries (line 3 is status line with screen name)
   // Single column, 5 entries per page, value always visible
@@ -264,35 +415,19 @@ void drawStateScreen(Adafruit_SSD1306& disp) {
     return;
   }
 
-  int startIdx = statePage * STATE_ENTRIES_PER_PAGE;
-  int shown = 0;
-  int entryNum = 0;
-
-  for (auto& kv : stateCache) {
-    if (entryNum >= startIdx && shown < STATE_ENTRIES_PER_PAGE) {
-      // Format: key=value, ensuring value is visible
-      // Total width: 21 chars, reserve at least 6 for value (=xxxxx)
-      String key = kv.first;
-      String val = kv.second;
-
-      // Truncate value if too long (max 10 chars)
-      if (val.length() > 10) val = val.substring(0, 10);
-
-      // Calculate max key length: 21 - 1 (=) - val.length()
-      int maxKeyLen = 20 - val.length();
-      if (maxKeyLen < 1) maxKeyLen = 1;
-      if (key.length() > maxKeyLen) key = key.substring(0, maxKeyLen);
+  // Removals can shrink the table under the page being shown
+  int page = min((int)statePage, getStateTotalPages() - 1);
+  if (page != stateLinesPage || stateCache.generation() != stateLinesGeneration) {
+    buildStateLines(page);
+  }
 
-      disp.printf("%s=%s\n", key.c_str(), val.c_str());
-      shown++;
-    }
-    entryNum++;
+  for (int i = 0; i < stateLinesShown; i++) {
+    disp.println(stateLines[i]);
   }
 
   // Fill remaining lines
-  while (shown < STATE_ENTRIES_PER_PAGE) {
+  for (int i = stateLinesShown; i < STATE_ENTRIES_PER_PAGE; i++) {
     disp.println();
-    shown++;
   }
 }
 
@@ -304,6 +439,7 @@ void setup() {
 
   // Initialize mesh swarm with a name
   swarm.begin(NODE_NAME);
+  perfStats.attach(swarm);
 
   // Connect to WiFi (required for gateway)
   swarm.connectToWiFi(WIFI_SSID, WIFI_PASSWORD);
@@ -312,11 +448,33 @@ void setup() {
   swarm.setGatewayMode(true);
   swarm.setTelemetryServer(TELEMETRY_URL, TELEMETRY_KEY);
   swarm.setTelemetryInterval(TELEMETRY_PUSH_INTERVAL);
-  swarm.enableTelemetry(true);
+  // Per-node POSTs inside swarm.update() are replaced by the bulk uplink on
+  // the worker task
+  swarm.enableTelemetry(false);
+  telemetryBatch.begin(TELEMETRY_URL, TELEMETRY_KEY);
+  uplink.begin(swarm.getNodeId(), TELEMETRY_URL, TELEMETRY_KEY, NTP_SERVER, TIME_SYNC_INTERVAL,
+               &telemetryBatch);
+
+  // Answer timesync requests once NTP has set the clock
+  MeshTimeSync::serve(swarm, []() { return uplink.isTimeSynced(); });
 
   // Enable OTA distribution (gateway polls server and distributes to mesh)
   swarm.enableOTADistribution(true);
 
+#if OTA_BROADCAST_MODE
+  // Broadcast jobs: the worker stages the image, loop() starts the sender,
+  // and node progress goes back to the worker for the server
+  otaSender.begin(swarm);
+  otaSender.onProgress([](uint32_t session, uint32_t nodeId, const char* state,
+                          uint16_t got, uint16_t chunks, const char* error) {
+    otaTask.pushProgress(session, nodeId, state, got, chunks, error);
+  });
+  otaSender.onDone([](uint32_t session, uint16_t completed, uint16_t failed) {
+    otaTask.pushDone(session, completed, failed);
+  });
+  otaTask.begin(TELEMETRY_URL, TELEMETRY_KEY);
+#endif
+
   // Start HTTP server for Remote Command Protocol API
   swarm.startHTTPServer(80);
 
@@ -336,7 +494,37 @@ void setup() {
 
   // Watch all state changes to populate cache for display
   swarm.watchState("*", [](const String& key, const String& value, const String& oldValue) {
-    stateCache[key] = value;
+#if OTA_BROADCAST_MODE
+    // A button press is crossing the mesh: don't queue chunks on top of it
+    if (value.length() && UrgentState::isStamp(key)) otaSender.holdOff();
+#endif
+    stateCache.set(key, value);
+    uplink.pushState(key, value);
+  });
+
+  swarm.onSerialCommand([](const String& input) -> bool {
+    if (input == "telem") {
+      // Worker stats first, then fall through to the built-in telem output
+      uplink.printStatus();
+      perfStats.print();
+      Serial.printf("State table: %u/%u keys, pool %u/%u bytes, %lu evicted, %lu rejected\n\n",
+                    (unsigned)stateCache.size(), (unsigned)stateCache.capacity(),
+                    (unsigned)stateCache.keyPoolUsed(), (unsigned)STATE_TABLE_KEY_POOL,
+                    (unsigned long)stateCache.evicted(), (unsigned long)stateCache.rejected());
+      return false;
+    }
+    if (input == "batch") {
+      telemetryBatch.printStatus();
+      return true;
+    }
+#if OTA_BROADCAST_MODE
+    if (input == "ota") {
+      otaSender.printStatus();
+      otaTask.printStatus();
+      return true;
+    }
+#endif
+    return false;
   });
 
   // Register custom display handler for multi-screen navigation
@@ -371,12 +559,36 @@ void setup() {
 }
 
 void loop() {
-  swarm.update();
+  {
+    PerfScope scope(PERF_UPDATE);
+    swarm.update();
+  }
 
-  // Check for OTA updates (polls every OTA_POLL_INTERVAL)
-  swarm.checkForOTAUpdates();
+  // Unicast OTA: the worker polls the server; MeshSwarm only runs its own
+  // check (HTTP on this thread) once a job is actually waiting
+  if (uplink.takeOtaPending()) {
+    swarm.checkForOTAUpdates();
+  }
+
+#if OTA_BROADCAST_MODE
+  MeshProto::OtaOffer offer;
+  if (!otaSender.active() && otaTask.takeOffer(offer) &&
+      !otaSender.start(offer, otaTask.chunkSource())) {
+    otaTask.pushDone(offer.session, 0, 0);
+  }
+#endif
 
-  // Show WiFi connection status once and configure NTP
+  // Queue entries every telemetry interval; the batcher flushes on its own window
+  if (swarm.isWiFiConnected() && millis() - lastBatchCollect >= TELEMETRY_PUSH_INTERVAL) {
+    lastBatchCollect = millis();
+    collectBatchTelemetry();
+  }
+  if (pullSweep && millis() - lastPull >= TELEMETRY_PULL_SPACING_MS) {
+    lastPull = millis();
+    pullPeerTelemetry();
+  }
+
+  // Show WiFi connection status once
   static bool wifiReported = false;
   if (!wifiReported && swarm.isWiFiConnected()) {
     Serial.println();
@@ -397,46 +609,21 @@ void loop() {
     swarm.getPowerManager().wake();
 
     wifiReported = true;
-
-    // Configure NTP time sync - use UTC (zero offsets) so time() returns UTC
-    // Nodes will apply their own timezone offsets
-    configTime(0, 0, NTP_SERVER);
-    ntpConfigured = true;
-    Serial.printf("[GATEWAY] NTP configured: %s (publishing UTC)\n", NTP_SERVER);
-
-    // Wait briefly for NTP sync, then publish time immediately
-    delay(2000);
-    struct tm timeinfo;
-    if (getLocalTime(&timeinfo, 5000)) {
-      time_t utcNow;
-      time(&utcNow);
-      swarm.setState("time", String(utcNow));
-      // Show local time in serial output for convenience
-      time_t localNow = utcNow + GMT_OFFSET_SEC + DAYLIGHT_OFFSET;
-      struct tm localTime;
-      gmtime_r(&localNow, &localTime);  // Use gmtime_r since we manually applied offset
-      Serial.printf("[GATEWAY] Initial time sync: UTC %lu (local %02d:%02d:%02d)\n",
-                    utcNow, localTime.tm_hour, localTime.tm_min, localTime.tm_sec);
-      lastTimeSync = millis();
-    }
   }
 
-  // Publish time to mesh periodically
-  if (ntpConfigured && millis() - lastTimeSync > TIME_SYNC_INTERVAL) {
-    lastTimeSync = millis();
-
-    struct tm timeinfo;
-    if (getLocalTime(&timeinfo)) {
-      // Publish UTC timestamp - nodes apply their own timezone offsets
-      time_t utcNow;
-      time(&utcNow);
-      swarm.setState("time", String(utcNow));
-      // Show local time in serial output for convenience
-      time_t localNow = utcNow + GMT_OFFSET_SEC + DAYLIGHT_OFFSET;
-      struct tm localTime;
-      gmtime_r(&localNow, &localTime);  // Use gmtime_r since we manually applied offset
-      Serial.printf("[GATEWAY] Time sync: UTC %lu (local %02d:%02d:%02d)\n",
-                    utcNow, localTime.tm_hour, localTime.tm_min, localTime.tm_sec);
-    }
+  // Report NTP syncs from the uplink worker (NTP runs off the mesh thread)
+  uint32_t syncedTime = uplink.takeTime();
+  if (syncedTime) {
+    time_t utcNow = syncedTime;
+#if TIME_SYNC_PUBLISH_STATE
+    // Publish UTC timestamp - nodes apply their own timezone offsets
+    swarm.setState("time", String(utcNow));
+#endif
+    // Show local time in serial output for convenience
+    time_t localNow = utcNow + GMT_OFFSET_SEC + DAYLIGHT_OFFSET;
+    struct tm localTime;
+    gmtime_r(&localNow, &localTime);  // Use gmtime_r since we manually applied offset
+    Serial.printf("[GATEWAY] Time sync: UTC %lu (local %02d:%02d:%02d)\n",
+                  (unsigned long)utcNow, localTime.tm_hour, localTime.tm_min, localTime.tm_sec);
   }
 }
@@ -2,7 +2,8 @@
  * LED Output Node
  *
  * Watches shared LED state and controls LED accordingly.
- * Also indicates network connectivity with a second LED.
+ * Also indicates network connectivity with a second LED, and records the
+ * button -> LED latency of stamped presses (serial command "lat").
  *
  * Hardware:
  *   - ESP32 (original dual-core)
@@ -13,6 +14,9 @@
 
 #include <Arduino.h>
 #include <MeshSwarm.h>
+#include <PerfStats.h>
+#include <UrgentState.h>
+#include <BroadcastOta.h>
 #include <esp_ota_ops.h>
 
 // ============== BUILD-TIME CONFIGURATION ==============
@@ -43,6 +47,8 @@
 
 // ============== GLOBALS ==============
 MeshSwarm swarm;
+OtaBroadcastReceiver otaReceiver;
+LatencyWatch ledLatency;
 bool lastPeerState = false;
 
 // ============== SETUP ==============
@@ -53,8 +59,10 @@ void setup() {
   esp_ota_mark_app_valid_cancel_rollback();
 
   swarm.begin(NODE_NAME);
+  perfStats.attach(swarm);
   swarm.enableTelemetry(true);
   swarm.enableOTAReceive(NODE_TYPE);
+  otaReceiver.begin(swarm, NODE_TYPE);  // Broadcast jobs; resumes a saved session
 
   // Enable display sleep with boot button wake
   swarm.enableDisplaySleep(LED_DISPLAY_SLEEP_MS);
@@ -79,6 +87,20 @@ void setup() {
                   oldValue.c_str(), value.c_str(), ledOn ? "ON" : "OFF");
   });
 
+  ledLatency.begin(swarm, "led");
+
+  swarm.onSerialCommand([](const String& input) -> bool {
+    if (input == "lat") {
+      ledLatency.print();
+      return true;
+    }
+    if (input == "lat reset") {
+      ledLatency.clear();
+      return true;
+    }
+    return false;
+  });
+
   // Watch for motion state changes
   swarm.watchState("motion", [](const String& key, const String& value, const String& oldValue) {
     bool motionDetect = (value == "1" || value == "on" || value == "true");
@@ -111,6 +133,10 @@ void setup() {
     display.printf("State LED: %s\n", ledOn ? "ON" : "OFF");
     display.printf("Peer LED:  %s (%d)\n", peerCount > 0 ? "ON" : "OFF", peerCount);
     display.printf("Motion LED:  %s\n", motionSet ? "ON" : "OFF");
+    if (ledLatency.stats().count) {
+      display.printf("Press: %lums p95<%lu\n", (unsigned long)ledLatency.last(),
+                     (unsigned long)ledLatency.stats().percentileMs(95));
+    }
   });
 }
 
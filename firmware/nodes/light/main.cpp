@@ -22,6 +22,10 @@
 
 #include <Arduino.h>
 #include <MeshSwarm.h>
+#include <PerfStats.h>
+#include <BroadcastOta.h>
+#include <StateBatch.h>
+#include <ReportPolicy.h>
 #include <esp_ota_ops.h>
 
 // ============== BUILD-TIME CONFIGURATION ==============
@@ -67,8 +71,15 @@
 #define LDR_BRIGHT_THRESHOLD  3000  // Above this = bright
 #endif
 
+// Raw counts past a threshold before light_state changes band
+#ifndef LDR_STATE_HYSTERESIS
+#define LDR_STATE_HYSTERESIS  150
+#endif
+
 #define SENSOR_MODEL "LDR"
 
+#include <AdcSampler.h>
+
 #endif // LIGHT_SENSOR_LDR
 
 // ============== BH1750 CONFIGURATION ==============
@@ -81,6 +92,13 @@
 
 #define SENSOR_MODEL "BH1750"
 
+// Lux band edges for light_state, and margin past an edge to change band
+#define BH1750_DARK_LUX        10
+#define BH1750_BRIGHT_LUX      200
+#ifndef BH1750_STATE_HYSTERESIS
+#define BH1750_STATE_HYSTERESIS 3
+#endif
+
 // BH1750 commands
 #define BH1750_POWER_ON     0x01
 #define BH1750_RESET        0x07
@@ -102,12 +120,34 @@
 #define LIGHT_CHANGE_THRESHOLD  5  // Percent change to trigger update
 #endif
 
+// ============== REPORT POLICY ==============
+// Level updates: at most every LIGHT_REPORT_MIN_INTERVAL_MS, refreshed
+// every LIGHT_REPORT_MAX_INTERVAL_MS, smoothed so flicker doesn't count
+#ifndef LIGHT_REPORT_MIN_INTERVAL_MS
+#define LIGHT_REPORT_MIN_INTERVAL_MS 5000
+#endif
+
+#ifndef LIGHT_REPORT_MAX_INTERVAL_MS
+#define LIGHT_REPORT_MAX_INTERVAL_MS 300000
+#endif
+
+#ifndef LIGHT_SMOOTHING
+#define LIGHT_SMOOTHING         0.3f
+#endif
+
+#ifndef LIGHT_HYSTERESIS
+#define LIGHT_HYSTERESIS        2   // Extra change to reverse direction
+#endif
+
 // ============== GLOBALS ==============
 MeshSwarm swarm;
+OtaBroadcastReceiver otaReceiver;
+StateBatch stateBatch(swarm);  // Base + zone keys go out as one message
+ReportPolicy levelPolicy(LIGHT_CHANGE_THRESHOLD, LIGHT_REPORT_MIN_INTERVAL_MS,
+                         LIGHT_REPORT_MAX_INTERVAL_MS, LIGHT_SMOOTHING, LIGHT_HYSTERESIS);
 
 // Sensor state
 int lightLevel = 0;           // 0-100 percentage or lux value
-int lastReportedLevel = -1;   // Last value sent to mesh
 String lightState = "unknown"; // "dark", "dim", "bright"
 String lastReportedState = "";
 bool sensorReady = false;
@@ -115,6 +155,11 @@ unsigned long lastReadTime = 0;
 unsigned long readCount = 0;
 unsigned long errorCount = 0;
 
+#ifdef LIGHT_SENSOR_LDR
+AdcSampler adc;       // Oversamples the LDR in the background
+int8_t ldrSlot = -1;
+#endif
+
 // ============== BH1750 FUNCTIONS ==============
 #ifdef LIGHT_SENSOR_BH1750
 
@@ -145,6 +190,19 @@ int bh1750ReadLux() {
 #endif // LIGHT_SENSOR_BH1750
 
 // ============== LIGHT READING ==============
+// Band with hysteresis: the edges move away from the current band by
+// margin, so a reading sitting on an edge does not flip the state
+const char* classifyLight(int value, int darkEdge, int brightEdge, int margin) {
+  if (lightState == "dark") darkEdge += margin;
+  else if (lightState != "unknown") darkEdge -= margin;
+  if (lightState == "bright") brightEdge -= margin;
+  else brightEdge += margin;
+
+  if (value < darkEdge) return "dark";
+  if (value > brightEdge) return "bright";
+  return "dim";
+}
+
 void pollLight() {
   unsigned long now = millis();
 
@@ -155,8 +213,8 @@ void pollLight() {
   String newState = "unknown";
 
 #ifdef LIGHT_SENSOR_LDR
-  // Read analog value (0-4095 on ESP32)
-  int rawValue = analogRead(LDR_PIN);
+  // Filtered analog value (0-4095 on ESP32)
+  int rawValue = adc.raw(ldrSlot);
 
   // Invert if needed (some modules read high when dark)
 #if LDR_INVERTED
@@ -167,13 +225,8 @@ void pollLight() {
   newLevel = map(rawValue, 0, 4095, 0, 100);
 
   // Determine state based on thresholds
-  if (rawValue < LDR_DARK_THRESHOLD) {
-    newState = "dark";
-  } else if (rawValue > LDR_BRIGHT_THRESHOLD) {
-    newState = "bright";
-  } else {
-    newState = "dim";
-  }
+  newState = classifyLight(rawValue, LDR_DARK_THRESHOLD, LDR_BRIGHT_THRESHOLD,
+                           LDR_STATE_HYSTERESIS);
 
   sensorReady = true;
   readCount++;
@@ -190,34 +243,28 @@ void pollLight() {
   newLevel = lux;
 
   // Determine state based on lux levels
-  if (lux < 10) {
-    newState = "dark";
-  } else if (lux < 200) {
-    newState = "dim";
-  } else {
-    newState = "bright";
-  }
+  newState = classifyLight(lux, BH1750_DARK_LUX, BH1750_BRIGHT_LUX,
+                           BH1750_STATE_HYSTERESIS);
 
   sensorReady = true;
   readCount++;
 #endif
 
+  // Level goes through the report policy (smoothing, deadband, rate)
+  bool levelChanged = levelPolicy.update(newLevel, now);
+  newLevel = (int)lroundf(levelPolicy.value());
   lightLevel = newLevel;
   lightState = newState;
 
-  // Check if level changed significantly
-  bool levelChanged = (lastReportedLevel < 0) ||
-                      (abs(newLevel - lastReportedLevel) >= LIGHT_CHANGE_THRESHOLD);
   bool stateChanged = (newState != lastReportedState);
 
-  // Update mesh state if changed
+  // Update mesh state if changed (one MSG_STATE_SET for all keys)
+  stateBatch.beginBatch();
   if (levelChanged) {
-    lastReportedLevel = newLevel;
-
-    swarm.setState("light", String(newLevel));
+    stateBatch.set("light", String(newLevel));
 
     String zoneKey = String("light_") + SENSOR_ZONE;
-    swarm.setState(zoneKey, String(newLevel));
+    stateBatch.set(zoneKey, String(newLevel));
 
 #ifdef LIGHT_SENSOR_LDR
     Serial.printf("[LIGHT] Level: %d%%\n", newLevel);
@@ -229,13 +276,19 @@ void pollLight() {
   if (stateChanged) {
     lastReportedState = newState;
 
-    swarm.setState("light_state", newState);
+    stateBatch.set("light_state", newState);
 
     String zoneKey = String("light_state_") + SENSOR_ZONE;
-    swarm.setState(zoneKey, newState);
+    stateBatch.set(zoneKey, newState);
 
     Serial.printf("[LIGHT] State: %s\n", newState.c_str());
   }
+
+  stateBatch.commit();
+
+  // Report counters ride along in the heartbeat telemetry
+  swarm.setHeartbeatData("rpt_sent", levelPolicy.sent());
+  swarm.setHeartbeatData("rpt_supp", levelPolicy.suppressed());
 }
 
 // ============== SETUP ==============
@@ -246,18 +299,20 @@ void setup() {
   esp_ota_mark_app_valid_cancel_rollback();
 
   swarm.begin(NODE_NAME);
+  perfStats.attach(swarm);
   swarm.enableTelemetry(true);
   swarm.enableOTAReceive(NODE_TYPE);
+  otaReceiver.begin(swarm, NODE_TYPE);  // Broadcast jobs; resumes a saved session
 
   // Enable display sleep with boot button wake
   swarm.enableDisplaySleep(LIGHT_DISPLAY_SLEEP_MS);
   swarm.addDisplayWakeButton(BOOT_BUTTON_PIN);
 
 #ifdef LIGHT_SENSOR_LDR
-  // Configure ADC
-  analogReadResolution(12);  // 12-bit (0-4095)
-  analogSetAttenuation(ADC_11db);  // Full 0-3.3V range
+  // Configure ADC (12-bit, full 0-3.3V range, sampled in the background)
   pinMode(LDR_PIN, INPUT);
+  ldrSlot = adc.addPin(LDR_PIN);
+  adc.begin();
   Serial.printf("[LIGHT] LDR on GPIO%d\n", LDR_PIN);
 #endif
 
@@ -287,7 +342,8 @@ void setup() {
       Serial.printf("Model: %s\n", SENSOR_MODEL);
 #ifdef LIGHT_SENSOR_LDR
       Serial.printf("GPIO: %d\n", LDR_PIN);
-      Serial.printf("Raw ADC: %d\n", analogRead(LDR_PIN));
+      Serial.printf("Raw ADC: %d (%lu mV, %lu bursts)\n", adc.raw(ldrSlot),
+                    (unsigned long)adc.millivolts(ldrSlot), (unsigned long)adc.bursts());
 #endif
 #ifdef LIGHT_SENSOR_BH1750
       Serial.printf("Address: 0x%02X\n", BH1750_ADDR);
@@ -303,6 +359,8 @@ void setup() {
       }
       Serial.printf("Read count: %lu\n", readCount);
       Serial.printf("Error count: %lu\n", errorCount);
+      Serial.printf("Reports: %lu sent / %lu held\n",
+                    (unsigned long)levelPolicy.sent(), (unsigned long)levelPolicy.suppressed());
       Serial.printf("Zone: %s\n", SENSOR_ZONE);
       Serial.println();
       return true;
@@ -0,0 +1,93 @@
+/**
+ * @file SimHeap.cpp
+ * @brief Allocation tracking behind global operator new/delete
+ */
+
+#include "SimHeap.h"
+#include <new>
+#include <stdlib.h>
+
+namespace {
+
+// Placed in front of every block; 16 bytes keeps malloc's alignment
+struct Header {
+  size_t size;
+  uint32_t owner;
+  uint32_t magic;
+};
+
+const uint32_t HEADER_MAGIC = 0x53484550;  // "SHEP"
+
+// Plain arrays so the tracker itself never goes through operator new
+SimHeap::Usage* s_usage = nullptr;
+uint16_t s_nodes = 0;
+uint16_t s_current = SIM_HEAP_NONE;
+SimHeap::Usage s_none;
+
+SimHeap::Usage& slot(uint32_t node) {
+  return node < s_nodes ? s_usage[node] : s_none;
+}
+
+void* allocate(size_t size) {
+  Header* h = static_cast<Header*>(malloc(sizeof(Header) + size));
+  if (!h) throw std::bad_alloc();
+  h->size = size;
+  h->owner = s_current;
+  h->magic = HEADER_MAGIC;
+
+  SimHeap::Usage& u = slot(s_current);
+  u.live += size;
+  u.allocs++;
+  if (u.live > u.peak) u.peak = u.live;
+  return h + 1;
+}
+
+void release(void* p) {
+  if (!p) return;
+  Header* h = static_cast<Header*>(p) - 1;
+  if (h->magic != HEADER_MAGIC) abort();  // Not ours: mismatched new/delete
+  h->magic = 0;
+  slot(h->owner).live -= h->size;
+  free(h);
+}
+
+}  // namespace
+
+namespace SimHeap {
+
+void reset(uint16_t nodes) {
+  free(s_usage);
+  s_usage = static_cast<Usage*>(calloc(nodes, sizeof(Usage)));
+  s_nodes = s_usage ? nodes : 0;
+  s_current = SIM_HEAP_NONE;
+}
+
+uint16_t current() { return s_current; }
+
+const Usage& usage(uint16_t node) { return slot(node); }
+
+void resetPeak(uint16_t node) {
+  Usage& u = slot(node);
+  u.peak = u.live;
+}
+
+Scope::Scope(uint16_t node) : _previous(s_current) { s_current = node; }
+Scope::~Scope() { s_current = _previous; }
+
+}  // namespace SimHeap
+
+void* operator new(size_t size) { return allocate(size); }
+void* operator new[](size_t size) { return allocate(size); }
+void operator delete(void* p) noexcept { release(p); }
+void operator delete[](void* p) noexcept { release(p); }
+void operator delete(void* p, size_t) noexcept { release(p); }
+void operator delete[](void* p, size_t) noexcept { release(p); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  try { return allocate(size); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  try { return allocate(size); } catch (...) { return nullptr; }
+}
+void operator delete(void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { release(p); }
@@ -0,0 +1,60 @@
+/**
+ * @file SimHeap.h
+ * @brief Per-virtual-node heap accounting for the mesh simulator
+ *
+ * Global operator new/delete are replaced so every allocation is charged to
+ * the node that was running when it was made (SimHeap::Scope), and released
+ * from that node when freed, whoever frees it. Transport buffers are made
+ * outside any node scope and charged to nobody.
+ */
+
+#ifndef MESHSIM_SIM_HEAP_H
+#define MESHSIM_SIM_HEAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Heap an ESP32 has left after WiFi and painlessMesh are up
+#ifndef SIM_NODE_HEAP_BYTES
+#define SIM_NODE_HEAP_BYTES 180000
+#endif
+
+// Owner of allocations made outside any node
+#define SIM_HEAP_NONE 0xFFFF
+
+namespace SimHeap {
+
+struct Usage {
+  size_t live = 0;
+  size_t peak = 0;
+  uint32_t allocs = 0;
+};
+
+/**
+ * @brief Size the per-node table (call before any node allocates)
+ */
+void reset(uint16_t nodes);
+
+uint16_t current();
+const Usage& usage(uint16_t node);
+
+/**
+ * @brief Restart peak tracking from the current live size
+ */
+void resetPeak(uint16_t node);
+
+/**
+ * @brief Charges allocations in its lifetime to one node
+ */
+class Scope {
+public:
+  explicit Scope(uint16_t node);
+  ~Scope();
+
+private:
+  uint16_t _previous;
+};
+
+}  // namespace SimHeap
+
+#endif // MESHSIM_SIM_HEAP_H
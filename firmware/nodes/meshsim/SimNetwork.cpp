@@ -0,0 +1,371 @@
+/**
+ * @file SimNetwork.cpp
+ * @brief Simulated transport implementation
+ */
+
+#include "SimNetwork.h"
+#include "SimHeap.h"
+#include <MeshSwarm.h>
+#include <algorithm>
+
+SimNetwork* simNetwork = nullptr;
+
+SimNetwork::SimNetwork(const SimConfig& config)
+  : _config(config)
+  , _rng(config.seed)
+{
+  if (_config.fanout < 1) _config.fanout = 1;
+  if (_config.tickMs < 1) _config.tickMs = 1;
+}
+
+uint16_t SimNetwork::addNode(MeshSwarm* swarm, uint32_t nodeId, LoopFn loop) {
+  SimHeap::Scope scope(SIM_HEAP_NONE);
+  Node n;
+  n.swarm = swarm;
+  n.id = nodeId;
+  n.loop = loop;
+  // No budget: the radio itself drains the queue. FIFO gets the lanes' room in one queue
+  n.radio.begin(_config.lanes ? LANE_QUEUE_MAX : LANE_QUEUE_MAX * MeshProto::LANES, 0);
+  _nodes.push_back(n);
+  uint16_t index = (uint16_t)(_nodes.size() - 1);
+  _byId[nodeId] = index;
+  return index;
+}
+
+int SimNetwork::indexOf(uint32_t nodeId) const {
+  auto it = _byId.find(nodeId);
+  return it == _byId.end() ? -1 : it->second;
+}
+
+uint16_t SimNetwork::depth(uint16_t index) const {
+  uint16_t d = 0;
+  for (int p = _nodes[index].parent; p >= 0; p = _nodes[p].parent) d++;
+  return d;
+}
+
+uint16_t SimNetwork::maxDepth() const {
+  uint16_t deepest = 0;
+  for (uint16_t i = 0; i < _nodes.size(); i++) {
+    if (_nodes[i].online) deepest = std::max(deepest, depth(i));
+  }
+  return deepest;
+}
+
+// ---- Topology ----
+
+void SimNetwork::join(uint16_t index) {
+  Node& n = _nodes[index];
+  if (n.online) return;
+
+  // Any online node with a free station slot can take the joiner
+  std::vector<uint16_t> open;
+  for (uint16_t i = 0; i < _nodes.size(); i++) {
+    if (_nodes[i].online && _nodes[i].children.size() < _config.fanout) open.push_back(i);
+  }
+
+  n.online = true;
+  _onlineCount++;
+
+  if (open.empty()) {
+    attach(index, -1);
+    return;
+  }
+
+  uint16_t parent = open[std::uniform_int_distribution<size_t>(0, open.size() - 1)(_rng)];
+  attach(index, parent);
+
+  // Both ends of the new link run their connection handling
+  {
+    SimHeap::Scope scope(parent);
+    _nodes[parent].swarm->simConnected(n.id, false);
+  }
+  {
+    SimHeap::Scope scope(index);
+    n.swarm->simConnected(_nodes[parent].id, true);
+  }
+}
+
+void SimNetwork::leave(uint16_t index) {
+  Node& n = _nodes[index];
+  if (!n.online) return;
+
+  int parent = n.parent;
+  std::vector<uint16_t> orphans = n.children;
+  detach(index);
+  n.online = false;
+  n.session++;
+  n.radio.clear();
+  n.sending = false;
+  _onlineCount--;
+
+  // Orphaned subtrees reconnect one level up (or the first becomes root)
+  for (uint16_t child : orphans) {
+    _nodes[child].parent = -1;
+    if (parent < 0 && _root < 0) {
+      _root = child;
+      parent = child;
+      continue;
+    }
+    attach(child, parent);
+  }
+}
+
+void SimNetwork::attach(uint16_t index, int parent) {
+  Node& n = _nodes[index];
+  n.parent = parent;
+  if (parent >= 0) {
+    _nodes[parent].children.push_back(index);
+  } else {
+    _root = index;
+  }
+}
+
+void SimNetwork::detach(uint16_t index) {
+  Node& n = _nodes[index];
+  if (n.parent >= 0) {
+    std::vector<uint16_t>& siblings = _nodes[n.parent].children;
+    siblings.erase(std::remove(siblings.begin(), siblings.end(), index), siblings.end());
+  } else if (_root == index) {
+    _root = -1;
+  }
+  n.parent = -1;
+  n.children.clear();
+}
+
+// ---- Delivery ----
+
+uint64_t SimNetwork::hopDelayUs() {
+  uint64_t us = (uint64_t)_config.latencyMs * 1000;
+  if (_config.jitterMs > 0) {
+    us += std::uniform_int_distribution<uint32_t>(0, _config.jitterMs * 1000)(_rng);
+  }
+  return us;
+}
+
+void SimNetwork::enqueue(uint16_t node, uint64_t delayUs, const SimMessagePtr& msg) {
+  Delivery d;
+  d.at = _now + delayUs;
+  d.seq = _seq++;
+  d.node = node;
+  d.session = _nodes[node].session;
+  d.msg = msg;
+  _queue.push(d);
+}
+
+void SimNetwork::broadcast(uint16_t from, SimMessagePtr msg) {
+  SimHeap::Scope scope(SIM_HEAP_NONE);
+  SimTypeStats& st = _stats[msg->type];
+  st.sent++;
+  st.bytes += msg->bytes;
+  if (_config.linkBytesPerS) {
+    forward(from, -1, -1, msg);
+    return;
+  }
+
+  // Flood the tree; a lost hop cuts off everything behind it
+  struct Hop { uint16_t node; int cameFrom; uint64_t delay; };
+  std::vector<Hop> stack;
+  stack.push_back({from, -1, 0});
+
+  while (!stack.empty()) {
+    Hop h = stack.back();
+    stack.pop_back();
+
+    const Node& n = _nodes[h.node];
+    auto visit = [&](int next) {
+      if (next < 0 || next == h.cameFrom) return;
+      st.hops++;
+      st.airBytes += msg->bytes;
+      if (hopLost()) {
+        st.dropped++;
+        return;
+      }
+      uint64_t delay = h.delay + hopDelayUs();
+      enqueue((uint16_t)next, delay, msg);
+      stack.push_back({(uint16_t)next, h.node, delay});
+    };
+    visit(n.parent);
+    for (uint16_t child : n.children) visit(child);
+  }
+}
+
+void SimNetwork::sendTo(uint16_t from, uint32_t toId, SimMessagePtr msg) {
+  int to = indexOf(toId);
+  if (to < 0 || !_nodes[to].online) return;
+
+  SimHeap::Scope scope(SIM_HEAP_NONE);
+  SimTypeStats& st = _stats[msg->type];
+  st.sent++;
+  st.bytes += msg->bytes;
+  if (_config.linkBytesPerS) {
+    forward(from, -1, to, msg);
+    return;
+  }
+
+  // Tree path: both ends climb to their common ancestor
+  uint16_t hops = 0;
+  int a = from;
+  int b = to;
+  uint16_t da = depth(from);
+  uint16_t db = depth((uint16_t)to);
+  while (da > db) { a = _nodes[a].parent; da--; hops++; }
+  while (db > da) { b = _nodes[b].parent; db--; hops++; }
+  while (a != b && a >= 0 && b >= 0) {
+    a = _nodes[a].parent;
+    b = _nodes[b].parent;
+    hops += 2;
+  }
+  if (a != b) return;  // Different trees (partitioned)
+
+  uint64_t delay = 0;
+  for (uint16_t i = 0; i < hops; i++) {
+    st.hops++;
+    st.airBytes += msg->bytes;
+    if (hopLost()) {
+      st.dropped++;
+      return;
+    }
+    delay += hopDelayUs();
+  }
+  enqueue((uint16_t)to, delay, msg);
+}
+
+void SimNetwork::deliver(const Delivery& d) {
+  if (d.kind == DELIVER_SENT) {
+    sent(d);
+    return;
+  }
+
+  Node& n = _nodes[d.node];
+  if (!n.online || n.session != d.session) return;
+
+  // Queued transport: pass it on first, as painlessMesh routes before the callback
+  if (_config.linkBytesPerS && d.dest != d.node) forward(d.node, d.peer, d.dest, d.msg);
+  if (d.dest >= 0 && d.dest != d.node) return;
+
+  _stats[d.msg->type].delivered++;
+  n.received++;
+
+  SimHeap::Scope scope(d.node);
+  n.swarm->simReceive(*d.msg);
+}
+
+// ---- Queued transport ----
+
+int SimNetwork::nextHop(uint16_t node, int dest) const {
+  // Below us: the child whose subtree holds dest; otherwise up
+  for (int c = dest; c >= 0; c = _nodes[c].parent) {
+    if (_nodes[c].parent == node) return c;
+  }
+  return _nodes[node].parent;
+}
+
+void SimNetwork::forward(uint16_t node, int cameFrom, int dest, const SimMessagePtr& msg) {
+  const Node& n = _nodes[node];
+  if (dest >= 0) {
+    int next = nextHop(node, dest);
+    if (next >= 0) transmit(node, (uint16_t)next, dest, msg);
+    return;
+  }
+  if (n.parent >= 0 && n.parent != cameFrom) transmit(node, (uint16_t)n.parent, -1, msg);
+  for (uint16_t child : n.children) {
+    if (child != cameFrom) transmit(node, child, -1, msg);
+  }
+}
+
+void SimNetwork::transmit(uint16_t node, uint16_t next, int dest, const SimMessagePtr& msg) {
+  SimHeap::Scope scope(SIM_HEAP_NONE);
+  Node& n = _nodes[node];
+  uint8_t lane = _config.lanes ? msg->lane : (uint8_t)MeshProto::LANE_BULK;
+  uint16_t bytes = (uint16_t)std::min<size_t>(msg->bytes, 0xFFFF);
+  if (!n.radio.push(lane, Transmission{msg, next, dest}, bytes, (uint32_t)(_now / 1000))) {
+    _stats[msg->type].overflow++;
+    return;
+  }
+  if (!n.sending) startRadio(node);
+}
+
+void SimNetwork::startRadio(uint16_t node) {
+  Node& n = _nodes[node];
+  n.radio.pump((uint32_t)(_now / 1000), [&](Transmission& t, uint8_t lane) {
+    SimTypeStats& st = _stats[t.msg->type];
+    st.hops++;
+    st.airBytes += t.msg->bytes;
+
+    Delivery d;
+    d.at = _now + (uint64_t)t.msg->bytes * 1000000 / _config.linkBytesPerS;
+    d.seq = _seq++;
+    d.node = node;
+    d.session = n.session;
+    d.msg = t.msg;
+    d.kind = DELIVER_SENT;
+    d.peer = t.next;
+    d.dest = t.dest;
+    _queue.push(d);
+    n.sending = true;
+  }, 1);
+}
+
+void SimNetwork::sent(const Delivery& d) {
+  Node& n = _nodes[d.node];
+  if (!n.online || n.session != d.session) return;  // Left mid-send; leave() reset the radio
+  n.sending = false;
+
+  if (hopLost()) {
+    _stats[d.msg->type].dropped++;
+  } else {
+    Delivery a;
+    a.at = _now + hopDelayUs();
+    a.seq = _seq++;
+    a.node = (uint16_t)d.peer;
+    a.session = _nodes[d.peer].session;
+    a.msg = d.msg;
+    a.peer = d.node;
+    a.dest = d.dest;
+    _queue.push(a);
+  }
+  startRadio(d.node);
+}
+
+void SimNetwork::run(uint64_t untilUs, const LoopFn& afterTick) {
+  const uint64_t tickUs = (uint64_t)_config.tickMs * 1000;
+
+  while (_now < untilUs) {
+    uint64_t next = std::min(_now + tickUs, untilUs);
+    while (!_queue.empty() && _queue.top().at <= next) {
+      Delivery d = _queue.top();
+      _queue.pop();
+      if (d.at > _now) _now = d.at;
+      deliver(d);
+    }
+    _now = next;
+
+    for (uint16_t i = 0; i < _nodes.size(); i++) {
+      if (!_nodes[i].online) continue;
+      SimHeap::Scope scope(i);
+      _nodes[i].loop();
+    }
+    if (afterTick) afterTick();
+  }
+}
+
+void SimNetwork::resetStats() {
+  for (SimTypeStats& st : _stats) st = SimTypeStats();
+  for (Node& n : _nodes) {
+    n.received = 0;
+    n.radio.resetStats();
+  }
+}
+
+MeshProto::LaneStats SimNetwork::laneStats(uint8_t lane) const {
+  MeshProto::LaneStats sum;
+  for (const Node& n : _nodes) {
+    const MeshProto::LaneStats& st = n.radio.stats(lane);
+    sum.sent += st.sent;
+    sum.overflow += st.overflow;
+    sum.waitTotalMs += st.waitTotalMs;
+    sum.depthMax = std::max(sum.depthMax, st.depthMax);
+    sum.waitMaxMs = std::max(sum.waitMaxMs, st.waitMaxMs);
+  }
+  return sum;
+}
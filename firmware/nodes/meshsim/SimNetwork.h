@@ -0,0 +1,256 @@
+/**
+ * @file SimNetwork.h
+ * @brief Simulated painlessMesh transport: tree topology, latency, loss, clock
+ *
+ * Nodes form a tree the way painlessMesh does (each joiner connects to one
+ * node that still has a free station slot). A broadcast floods the tree from
+ * its sender and a unicast follows the tree path; every hop adds the
+ * configured latency plus uniform jitter and independently drops the message
+ * with the configured loss rate (a drop also cuts off the subtree behind it).
+ *
+ * With a link rate set, each node also has one radio that sends a copy at a
+ * time (bytes / rate) from a send queue, and forwards a message only once it
+ * has arrived, so traffic queues on busy hops. The queue is one FIFO, as in
+ * painlessMesh, or with lanes a MeshProto::SendLanes served by each
+ * message's lane on every hop. A full queue refuses the copy (overflow).
+ *
+ * Time is discrete: deliveries run at their exact due time, node loops run
+ * every tickMs. All randomness comes from one seeded generator, so a run is
+ * reproducible from its command line.
+ */
+
+#ifndef MESHSIM_SIM_NETWORK_H
+#define MESHSIM_SIM_NETWORK_H
+
+#include <Arduino.h>
+#include <DeltaSync.h>
+#include <Membership.h>
+#include <SendLanes.h>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class MeshSwarm;
+
+struct SimConfig {
+  uint16_t nodes = 100;
+  uint32_t seconds = 180;       // Simulated run time
+  uint32_t bootSeconds = 20;    // Nodes power up spread over this window
+  uint32_t latencyMs = 15;      // Per hop
+  uint32_t jitterMs = 10;       // Per hop, uniform 0..jitter
+  float loss = 0.0f;            // Per hop drop probability
+  uint8_t fanout = 4;           // Stations per node (painlessMesh max connections)
+  uint32_t tickMs = 10;         // Node loop period
+  uint16_t zones = 0;           // 0 = one zone per 5 nodes
+  bool deltaSync = false;       // Join with digest/delta instead of full sync
+  uint16_t probes = 20;         // Convergence probes
+  uint32_t probeIntervalMs = 5000;
+  uint16_t rejoins = 5;         // Nodes that drop out and wake again
+  uint16_t retire = 0;          // Nodes that leave for good (hardware churn)
+  uint16_t stateMaxKeys = 0;    // StateStore bound, 0 = unbounded
+  uint32_t stateTtlMs = 0;      // Expire keys of silent origins, 0 = never
+  bool adaptiveHeartbeat = false;  // Membership.h pacing, piggyback and gossip
+  uint8_t gossipPeers = GOSSIP_PEERS;
+  uint32_t linkBytesPerS = 0;   // Per node radio; 0 = no queueing, hops cost latency only
+  bool lanes = false;           // Queue by lane on every hop (SendLanes) instead of FIFO
+  uint32_t otaChunkMs = 0;      // Bulk load: one OTA chunk broadcast this often, 0 = none
+  uint32_t pressMeanMs = 300000;  // Mean time between presses per button node
+  uint32_t seed = 1;
+};
+
+enum SimMsgType : uint8_t {
+  SIM_MSG_HEARTBEAT = 1,
+  SIM_MSG_STATE_SET = 2,
+  SIM_MSG_STATE_SYNC = 3,
+  SIM_MSG_STATE_REQ = 4,
+  SIM_MSG_COMMAND = 5,
+  SIM_MSG_TELEMETRY = 6,
+  SIM_MSG_DIGEST = 7,
+  SIM_MSG_DELTA = 8,
+  SIM_MSG_OTA = 9,              // Broadcast OTA chunk (bulk load, --ota)
+  SIM_MSG_TYPES
+};
+
+struct SimEntry {
+  String key;
+  String value;
+  uint32_t version;
+  uint32_t origin;
+};
+
+/**
+ * @brief One message in flight, shared by all its recipients
+ *
+ * Carries the decoded fields instead of JSON text; bytes is the size the
+ * message would have on the wire (see SimSwarm.cpp for the formats).
+ */
+struct SimMessage {
+  uint8_t type = 0;
+  uint32_t from = 0;
+  uint32_t to = 0;              // 0 = broadcast
+  size_t bytes = 0;
+  uint8_t lane = MeshProto::LANE_STATE;   // Send class (queued by it when the network runs lanes)
+
+  String name;                  // Heartbeat: node name and role
+  String role;
+  uint8_t intervalS = 0;        // Heartbeat (adaptive): announced interval, counter, gossip
+  uint16_t seq = 0;
+  std::vector<uint8_t> gossip;
+  std::vector<SimEntry> entries;          // STATE_SET, STATE_SYNC, DELTA
+  MeshProto::StateDigest digest;          // DIGEST
+  bool full = false;                      // DIGEST: too many keys, wants a full sync
+  std::vector<uint32_t> wants;            // DELTA: keys the sender wants back
+  bool end = false;                       // DELTA: last message of the exchange
+
+  String command;               // COMMAND: name, JSON args/result
+  std::string payload;
+  uint32_t requestId = 0;
+  bool reply = false;
+  bool success = false;
+};
+
+typedef std::shared_ptr<const SimMessage> SimMessagePtr;
+
+struct SimTypeStats {
+  uint64_t sent = 0;            // Messages originated
+  uint64_t delivered = 0;       // Copies received by a node
+  uint64_t hops = 0;            // Link transmissions (airtime)
+  uint64_t bytes = 0;           // Originated bytes
+  uint64_t airBytes = 0;        // Bytes times hops
+  uint64_t dropped = 0;         // Copies lost to link loss
+  uint64_t overflow = 0;        // Copies refused by a full send queue
+};
+
+class SimNetwork {
+public:
+  typedef std::function<void()> LoopFn;
+
+  SimNetwork(const SimConfig& config);
+
+  /**
+   * @brief Register a node (not yet on the mesh)
+   * @return Node index (charge owner for SimHeap)
+   */
+  uint16_t addNode(MeshSwarm* swarm, uint32_t nodeId, LoopFn loop);
+
+  /**
+   * @brief Connect a node to the tree and fire its (and its parent's) new-connection handling
+   */
+  void join(uint16_t index);
+
+  /**
+   * @brief Take a node off the mesh; its subtree reattaches to its parent
+   */
+  void leave(uint16_t index);
+
+  bool online(uint16_t index) const { return _nodes[index].online; }
+  size_t onlineCount() const { return _onlineCount; }
+  size_t size() const { return _nodes.size(); }
+  MeshSwarm* swarm(uint16_t index) const { return _nodes[index].swarm; }
+  int indexOf(uint32_t nodeId) const;
+  uint16_t depth(uint16_t index) const;
+  uint16_t maxDepth() const;
+
+  void broadcast(uint16_t from, SimMessagePtr msg);
+  void sendTo(uint16_t from, uint32_t toId, SimMessagePtr msg);
+
+  /**
+   * @brief Advance the clock to untilUs, delivering messages and ticking online nodes
+   * @param afterTick Called after each tick, outside any node scope
+   */
+  void run(uint64_t untilUs, const LoopFn& afterTick = LoopFn());
+
+  uint64_t nowUs() const { return _now; }
+  std::mt19937& rng() { return _rng; }
+  const SimConfig& config() const { return _config; }
+
+  const SimTypeStats& stats(uint8_t type) const { return _stats[type]; }
+  void resetStats();
+
+  /**
+   * @brief Send queue stats for one lane, summed over all nodes (link rate set)
+   *
+   * FIFO queues count everything under LANE_BULK.
+   */
+  MeshProto::LaneStats laneStats(uint8_t lane) const;
+
+  /**
+   * @brief Messages received by one node since the last resetStats()
+   */
+  uint64_t received(uint16_t index) const { return _nodes[index].received; }
+
+private:
+  struct Transmission {
+    SimMessagePtr msg;
+    uint16_t next;              // Neighbour it is sent to
+    int dest;                   // Unicast destination index, -1 = broadcast
+  };
+
+  struct Node {
+    MeshSwarm* swarm;
+    uint32_t id;
+    LoopFn loop;
+    bool online = false;
+    uint32_t session = 0;       // Bumped on leave so stale deliveries are dropped
+    int parent = -1;
+    std::vector<uint16_t> children;
+    uint64_t received = 0;
+    MeshProto::SendLanes<Transmission> radio;   // Link rate set: copies waiting to go out
+    bool sending = false;
+  };
+
+  enum DeliveryKind : uint8_t {
+    DELIVER_ARRIVE,             // Message reaches node (from peer)
+    DELIVER_SENT                // node's radio finished sending to peer
+  };
+
+  struct Delivery {
+    uint64_t at;
+    uint64_t seq;
+    uint16_t node;
+    uint32_t session;
+    SimMessagePtr msg;
+    uint8_t kind = DELIVER_ARRIVE;
+    int peer = -1;
+    int dest = -1;
+
+    bool operator>(const Delivery& o) const { return at != o.at ? at > o.at : seq > o.seq; }
+  };
+
+  SimConfig _config;
+  std::mt19937 _rng;
+  std::uniform_real_distribution<float> _unit{0.0f, 1.0f};
+  std::vector<Node> _nodes;
+  std::unordered_map<uint32_t, uint16_t> _byId;
+  std::priority_queue<Delivery, std::vector<Delivery>, std::greater<Delivery>> _queue;
+  uint64_t _now = 0;
+  uint64_t _seq = 0;
+  size_t _onlineCount = 0;
+  int _root = -1;
+  SimTypeStats _stats[SIM_MSG_TYPES];
+
+  uint64_t hopDelayUs();
+  bool hopLost() { return _config.loss > 0.0f && _unit(_rng) < _config.loss; }
+  void enqueue(uint16_t node, uint64_t delayUs, const SimMessagePtr& msg);
+  void deliver(const Delivery& d);
+
+  // Link rate set: hop by hop through each node's radio
+  void forward(uint16_t node, int cameFrom, int dest, const SimMessagePtr& msg);
+  void transmit(uint16_t node, uint16_t next, int dest, const SimMessagePtr& msg);
+  void startRadio(uint16_t node);
+  void sent(const Delivery& d);
+  int nextHop(uint16_t node, int dest) const;
+  void attach(uint16_t index, int parent);
+  void detach(uint16_t index);
+};
+
+/**
+ * @brief Network whose clock millis()/micros() read (set by main)
+ */
+extern SimNetwork* simNetwork;
+
+#endif // MESHSIM_SIM_NETWORK_H
@@ -0,0 +1,251 @@
+/**
+ * @file SimNodes.cpp
+ * @brief Virtual node behaviours
+ */
+
+#include "SimNodes.h"
+#include "SimHeap.h"
+
+namespace {
+
+// Defaults from nodes/dht/main.cpp
+const unsigned long DHT_READ_INTERVAL = 5000;
+const unsigned long DHT_REPORT_MIN_MS = 15000;
+const unsigned long DHT_REPORT_MAX_MS = 300000;
+
+// Defaults from nodes/light/main.cpp (LDR build)
+const unsigned long LIGHT_READ_INTERVAL = 2000;
+const unsigned long LIGHT_REPORT_MIN_MS = 5000;
+const unsigned long LIGHT_REPORT_MAX_MS = 300000;
+const int LIGHT_DARK = 12;        // Percent equivalents of the raw thresholds
+const int LIGHT_BRIGHT = 73;
+const int LIGHT_HYSTERESIS = 4;
+
+// nodes/pir/main.cpp motion window
+const unsigned long PIR_WINDOW_MS = 10000;
+
+// Mean time between synthetic events (presses: SimConfig::pressMeanMs)
+const uint32_t PIR_MOTION_MEAN_MS = 120000;
+
+// Daily cycles are compressed so a few minutes of simulated time see movement
+const float CYCLE_MS = 600000.0f;
+
+std::vector<uint32_t> pressLatencies;
+
+String fixed1(float v) {
+  char buf[12];
+  snprintf(buf, sizeof(buf), "%.1f", v);
+  return buf;
+}
+
+}  // namespace
+
+std::vector<uint32_t>& simPressLatencies() {
+  return pressLatencies;
+}
+
+// ---- SimNode ----
+
+SimNode::SimNode(SimNetwork& net, uint32_t nodeId, const char* name, const String& zone, uint32_t seed)
+  : _net(net)
+  , _zone(zone)
+  , _rng(seed)
+  , _name(name)
+{
+  _index = net.addNode(&swarm, nodeId, [this]() {
+    swarm.update();
+    loop();
+  });
+  swarm.simBind(net, _index, nodeId);
+}
+
+void SimNode::boot() {
+  if (!_booted) {
+    SimHeap::Scope scope(_index);
+    swarm.begin(_name);
+    setup();
+    _booted = true;
+  }
+  _net.join(_index);
+}
+
+bool SimNode::chance(uint32_t meanMs) {
+  float p = (float)_net.config().tickMs / (float)meanMs;
+  return uniform(0.0f, 1.0f) < p;
+}
+
+// ---- DHT ----
+
+SimDhtNode::SimDhtNode(SimNetwork& net, uint32_t nodeId, const String& zone, uint32_t seed)
+  : SimNode(net, nodeId, "DHTNode", zone, seed)
+  , _temp(0.5f, DHT_REPORT_MIN_MS, DHT_REPORT_MAX_MS, 0.5f, 0.2f)
+  , _humidity(1.0f, DHT_REPORT_MIN_MS, DHT_REPORT_MAX_MS, 0.5f, 0.2f)
+  , _batch(swarm)
+{
+  _baseTemp = uniform(19.0f, 24.0f);
+  _baseHumidity = uniform(35.0f, 55.0f);
+}
+
+void SimDhtNode::setup() {
+  // Spread first reads like independently powered nodes
+  _lastRead = millis() - (unsigned long)uniform(0.0f, (float)DHT_READ_INTERVAL);
+}
+
+void SimDhtNode::loop() {
+  unsigned long now = millis();
+  if (now - _lastRead < DHT_READ_INTERVAL) return;
+  _lastRead = now;
+
+  float cycle = sinf(2.0f * (float)M_PI * now / CYCLE_MS);
+  float temp = _baseTemp + 1.5f * cycle + gaussian(0.15f);
+  float humidity = _baseHumidity - 4.0f * cycle + gaussian(0.5f);
+
+  bool tempChanged = _temp.update(temp, now);
+  bool humidityChanged = _humidity.update(humidity, now);
+
+  _batch.beginBatch();
+  if (tempChanged) {
+    String value = fixed1(_temp.value());
+    _batch.set("temp", value);
+    _batch.set(String("temp_") + _zone, value);
+  }
+  if (humidityChanged) {
+    String value = fixed1(_humidity.value());
+    _batch.set("humidity", value);
+    _batch.set(String("humidity_") + _zone, value);
+  }
+  _batch.commit();
+}
+
+// ---- Light ----
+
+SimLightNode::SimLightNode(SimNetwork& net, uint32_t nodeId, const String& zone, uint32_t seed)
+  : SimNode(net, nodeId, "Light", zone, seed)
+  , _level(5.0f, LIGHT_REPORT_MIN_MS, LIGHT_REPORT_MAX_MS, 0.3f, 2.0f)
+  , _batch(swarm)
+  , _state("unknown")
+{
+  _phase = uniform(0.0f, 2.0f * (float)M_PI);
+}
+
+void SimLightNode::setup() {
+  _lastRead = millis() - (unsigned long)uniform(0.0f, (float)LIGHT_READ_INTERVAL);
+}
+
+void SimLightNode::loop() {
+  unsigned long now = millis();
+  if (now - _lastRead < LIGHT_READ_INTERVAL) return;
+  _lastRead = now;
+
+  float level = 50.0f + 45.0f * sinf(_phase + 2.0f * (float)M_PI * now / CYCLE_MS) + gaussian(2.0f);
+  if (level < 0.0f) level = 0.0f;
+  if (level > 100.0f) level = 100.0f;
+
+  bool levelChanged = _level.update(level, now);
+  int shown = (int)lroundf(_level.value());
+
+  // Same hysteresis as classifyLight() in the sketch
+  int darkEdge = LIGHT_DARK;
+  int brightEdge = LIGHT_BRIGHT;
+  if (_state == "dark") darkEdge += LIGHT_HYSTERESIS;
+  else if (_state != "unknown") darkEdge -= LIGHT_HYSTERESIS;
+  if (_state == "bright") brightEdge -= LIGHT_HYSTERESIS;
+  else brightEdge += LIGHT_HYSTERESIS;
+
+  String state;
+  if (shown < darkEdge) state = "dark";
+  else if (shown > brightEdge) state = "bright";
+  else state = "dim";
+
+  _batch.beginBatch();
+  if (levelChanged) {
+    _batch.set("light", String(shown));
+    _batch.set(String("light_") + _zone, String(shown));
+  }
+  if (state != _state) {
+    _state = state;
+    _batch.set("light_state", state);
+    _batch.set(String("light_state_") + _zone, state);
+  }
+  _batch.commit();
+}
+
+// ---- PIR ----
+
+void SimPirNode::loop() {
+  unsigned long now = millis();
+
+  if (chance(PIR_MOTION_MEAN_MS)) {
+    _lastMotion = now;
+    if (!_motion) {
+      _motion = true;
+      swarm.setStates({{"motion", "1"}, {String("motion_") + _zone, "1"}});
+    }
+  }
+
+  if (_motion && now - _lastMotion >= PIR_WINDOW_MS) {
+    _motion = false;
+    swarm.setStates({{"motion", "0"}, {String("motion_") + _zone, "0"}});
+  }
+}
+
+// ---- Button ----
+
+void SimButtonNode::setup() {
+  _urgent.begin(swarm);
+}
+
+void SimButtonNode::loop() {
+  if (!chance(_net.config().pressMeanMs)) return;
+  String current = swarm.getState("led", "0");
+  _urgent.set("led", current == "1" ? "0" : "1");
+}
+
+// ---- LED ----
+
+void SimLedNode::setup() {
+  swarm.watchState("led", [this](const String& key, const String& value, const String& oldValue) {
+    _led = (value == "1" || value == "on" || value == "true");
+  });
+  swarm.watchState("motion", [this](const String& key, const String& value, const String& oldValue) {
+    _motion = (value == "1" || value == "on" || value == "true");
+  });
+  _latency.begin(swarm, "led", [](uint32_t ms) {
+    SimHeap::Scope scope(SIM_HEAP_NONE);  // The simulator's record, not the node's
+    pressLatencies.push_back(ms);
+  });
+}
+
+// ---- Watcher ----
+
+void SimWatcherNode::setup() {
+  _watchers.attach(swarm);
+  _watchers.on("*", [this](const String& key, const String& value, const String& oldValue) {
+    _changes++;
+  });
+  String zoneTemp = String("temp_") + _zone;
+  _watchers.on(zoneTemp.c_str(), [this](const String& key, const String& value, const String& oldValue) {
+    _zoneTemp = value.toFloat();
+  });
+  _watchers.on("motion_*", [](const String& key, const String& value, const String& oldValue) {});
+  _watchers.on("light_state_*", [](const String& key, const String& value, const String& oldValue) {});
+}
+
+// ---- Fleet mix ----
+
+SimNode* simCreateNode(SimNetwork& net, uint16_t i, uint32_t nodeId, const String& zone, uint32_t seed) {
+  switch (i % 20) {
+    case 0: case 1: case 2: case 3: case 4: case 5:
+      return new SimDhtNode(net, nodeId, zone, seed);
+    case 6: case 7: case 8: case 9:
+      return new SimLightNode(net, nodeId, zone, seed);
+    case 10: case 11: case 12: case 13: case 14:
+      return new SimPirNode(net, nodeId, zone, seed);
+    case 15:
+      return new SimButtonNode(net, nodeId, zone, seed);
+    case 16: case 17:
+      return new SimLedNode(net, nodeId, zone, seed);
+    default:
+      return new SimWatcherNode(net, nodeId, zone, seed);
+  }
+}
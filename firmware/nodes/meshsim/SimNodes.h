@@ -0,0 +1,165 @@
+/**
+ * @file SimNodes.h
+ * @brief Virtual node behaviours modelled on the node sketches
+ *
+ * Each class reproduces what its nodes/<type>/main.cpp puts on the mesh,
+ * with the hardware replaced by synthetic readings and random events:
+ *
+ *   dht      temp/humidity (+ _<zone>) through ReportPolicy and StateBatch, read every 5 s
+ *   light    light/light_state (+ _<zone>) through ReportPolicy and StateBatch, read every 2 s
+ *   pir      motion + motion_<zone> on the edge, cleared after a quiet window
+ *   button   toggles "led" through UrgentState (stamped, control lane)
+ *   led      watches "led" and "motion", records press latency (LatencyWatch)
+ *   watcher  StateWatchers on "*" and per-zone prefixes (displays, dashboards)
+ *
+ * The sketches themselves need the ESP32 peripherals and don't build on
+ * the host; the intervals and policies below are their defaults.
+ */
+
+#ifndef MESHSIM_SIM_NODES_H
+#define MESHSIM_SIM_NODES_H
+
+#include <Arduino.h>
+#include <MeshSwarm.h>
+#include <ReportPolicy.h>
+#include <StateBatch.h>
+#include <StateWatchers.h>
+#include <UrgentState.h>
+#include <random>
+#include <vector>
+#include "SimNetwork.h"
+
+class SimNode {
+public:
+  SimNode(SimNetwork& net, uint32_t nodeId, const char* name, const String& zone, uint32_t seed);
+  virtual ~SimNode() {}
+
+  /**
+   * @brief Power up: run setup() and join the mesh
+   */
+  void boot();
+
+  uint16_t index() const { return _index; }
+  const char* name() const { return _name; }
+  MeshSwarm& mesh() { return swarm; }
+
+protected:
+  virtual void setup() {}
+  virtual void loop() {}
+
+  float uniform(float lo, float hi) { return std::uniform_real_distribution<float>(lo, hi)(_rng); }
+  float gaussian(float sigma) { return std::normal_distribution<float>(0.0f, sigma)(_rng); }
+
+  // True on average once per meanMs, checked every tick
+  bool chance(uint32_t meanMs);
+
+  MeshSwarm swarm;
+  SimNetwork& _net;
+  String _zone;
+  std::mt19937 _rng;
+
+private:
+  const char* _name;
+  uint16_t _index;
+  bool _booted = false;
+};
+
+class SimDhtNode : public SimNode {
+public:
+  SimDhtNode(SimNetwork& net, uint32_t nodeId, const String& zone, uint32_t seed);
+
+protected:
+  void setup() override;
+  void loop() override;
+
+private:
+  ReportPolicy _temp;
+  ReportPolicy _humidity;
+  StateBatch _batch;
+  float _baseTemp;
+  float _baseHumidity;
+  unsigned long _lastRead = 0;
+};
+
+class SimLightNode : public SimNode {
+public:
+  SimLightNode(SimNetwork& net, uint32_t nodeId, const String& zone, uint32_t seed);
+
+protected:
+  void setup() override;
+  void loop() override;
+
+private:
+  ReportPolicy _level;
+  StateBatch _batch;
+  String _state;
+  float _phase;
+  unsigned long _lastRead = 0;
+};
+
+class SimPirNode : public SimNode {
+public:
+  SimPirNode(SimNetwork& net, uint32_t nodeId, const String& zone, uint32_t seed)
+    : SimNode(net, nodeId, "PIR", zone, seed) {}
+
+protected:
+  void loop() override;
+
+private:
+  bool _motion = false;
+  unsigned long _lastMotion = 0;
+};
+
+class SimButtonNode : public SimNode {
+public:
+  SimButtonNode(SimNetwork& net, uint32_t nodeId, const String& zone, uint32_t seed)
+    : SimNode(net, nodeId, "Button", zone, seed) {}
+
+protected:
+  void setup() override;
+  void loop() override;
+
+private:
+  UrgentState _urgent;
+};
+
+class SimLedNode : public SimNode {
+public:
+  SimLedNode(SimNetwork& net, uint32_t nodeId, const String& zone, uint32_t seed)
+    : SimNode(net, nodeId, "LED", zone, seed) {}
+
+protected:
+  void setup() override;
+
+private:
+  bool _led = false;
+  bool _motion = false;
+  LatencyWatch _latency;
+};
+
+class SimWatcherNode : public SimNode {
+public:
+  SimWatcherNode(SimNetwork& net, uint32_t nodeId, const String& zone, uint32_t seed)
+    : SimNode(net, nodeId, "Watcher", zone, seed) {}
+
+protected:
+  void setup() override;
+
+private:
+  StateWatchers _watchers;
+  uint32_t _changes = 0;
+  float _zoneTemp = NAN;
+};
+
+/**
+ * @brief Button -> LED delays recorded by every LED node (cleared by main)
+ */
+std::vector<uint32_t>& simPressLatencies();
+
+/**
+ * @brief Create a node of the fleet mix (dht 30%, light 20%, pir 25%,
+ * button 5%, led 10%, watcher 10%) for slot i
+ */
+SimNode* simCreateNode(SimNetwork& net, uint16_t i, uint32_t nodeId, const String& zone, uint32_t seed);
+
+#endif // MESHSIM_SIM_NODES_H
@@ -0,0 +1,61 @@
+/**
+ * @file Arduino.cpp
+ * @brief Host Arduino subset: simulator or wall clock, Serial, per-node heap figures
+ */
+
+#include <Arduino.h>
+#include <chrono>
+#include <stdarg.h>
+#include "../SimHeap.h"
+#include "../SimNetwork.h"
+
+HostSerial Serial;
+HostEsp ESP;
+
+// Wall clock when no simulation is running (bench_native)
+static uint64_t hostUs() {
+  static const auto start = std::chrono::steady_clock::now();
+  return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start).count();
+}
+
+unsigned long millis() {
+  return (unsigned long)((simNetwork ? simNetwork->nowUs() : hostUs()) / 1000);
+}
+
+unsigned long micros() {
+  return (unsigned long)(simNetwork ? simNetwork->nowUs() : hostUs());
+}
+
+void delay(unsigned long ms) {
+  (void)ms;
+}
+
+bool getLocalTime(struct tm* info, uint32_t ms) {
+  (void)ms;
+  time_t now = time(nullptr);
+  return localtime_r(&now, info) != nullptr;
+}
+
+int HostSerial::printf(const char* fmt, ...) {
+  if (!_enabled) return 0;
+  va_list args;
+  va_start(args, fmt);
+  int n = vprintf(fmt, args);
+  va_end(args);
+  return n;
+}
+
+uint32_t HostEsp::getFreeHeap() {
+  size_t live = SimHeap::usage(SimHeap::current()).live;
+  return live < SIM_NODE_HEAP_BYTES ? (uint32_t)(SIM_NODE_HEAP_BYTES - live) : 0;
+}
+
+uint32_t HostEsp::getMinFreeHeap() {
+  size_t peak = SimHeap::usage(SimHeap::current()).peak;
+  return peak < SIM_NODE_HEAP_BYTES ? (uint32_t)(SIM_NODE_HEAP_BYTES - peak) : 0;
+}
+
+uint32_t HostEsp::getMaxAllocHeap() {
+  return getFreeHeap();  // Fragmentation is not modelled
+}
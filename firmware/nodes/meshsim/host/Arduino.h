@@ -0,0 +1,135 @@
+/**
+ * @file Arduino.h
+ * @brief Host stand-in for the Arduino core subset the mesh libraries use
+ *
+ * Only on the include path of the native envs. String wraps std::string
+ * with the Arduino method names, millis()/micros() read the simulator clock
+ * (the wall clock when no simulation is running), and ESP heap figures come
+ * from the allocation tracker of the node that is currently running (SimHeap).
+ */
+
+#ifndef MESHSIM_HOST_ARDUINO_H
+#define MESHSIM_HOST_ARDUINO_H
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <time.h>
+
+#ifndef NAN
+#define NAN (__builtin_nanf(""))
+#endif
+
+using std::isnan;
+
+// ---- Time (simulated) ----
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);  // No-op: nodes never block the simulation
+inline void yield() {}
+
+// ESP32 core helper: host local time
+bool getLocalTime(struct tm* info, uint32_t ms = 5000);
+
+// ---- String ----
+
+class String {
+public:
+  String() {}
+  String(const char* s) : _s(s ? s : "") {}
+  String(const std::string& s) : _s(s) {}
+  String(char c) : _s(1, c) {}
+  String(int v) : _s(std::to_string(v)) {}
+  String(unsigned int v) : _s(std::to_string(v)) {}
+  String(long v) : _s(std::to_string(v)) {}
+  String(unsigned long v) : _s(std::to_string(v)) {}
+  String(float v, int decimals = 2) : _s(format(v, decimals)) {}
+  String(double v, int decimals = 2) : _s(format(v, decimals)) {}
+
+  const char* c_str() const { return _s.c_str(); }
+  unsigned int length() const { return (unsigned int)_s.size(); }
+  bool isEmpty() const { return _s.empty(); }
+
+  String substring(unsigned int from) const { return from < _s.size() ? _s.substr(from) : std::string(); }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from >= _s.size() || to <= from) return String();
+    return _s.substr(from, to - from);
+  }
+  bool startsWith(const String& prefix) const { return _s.compare(0, prefix._s.size(), prefix._s) == 0; }
+  bool endsWith(const String& suffix) const {
+    return _s.size() >= suffix._s.size() &&
+           _s.compare(_s.size() - suffix._s.size(), suffix._s.size(), suffix._s) == 0;
+  }
+  int indexOf(char c, unsigned int from = 0) const {
+    size_t i = _s.find(c, from);
+    return i == std::string::npos ? -1 : (int)i;
+  }
+  int indexOf(const String& s, unsigned int from = 0) const {
+    size_t i = _s.find(s._s, from);
+    return i == std::string::npos ? -1 : (int)i;
+  }
+  char charAt(unsigned int i) const { return i < _s.size() ? _s[i] : 0; }
+  char operator[](unsigned int i) const { return charAt(i); }
+  long toInt() const { return strtol(_s.c_str(), nullptr, 10); }
+  float toFloat() const { return strtof(_s.c_str(), nullptr); }
+  bool equals(const String& o) const { return _s == o._s; }
+
+  String& operator+=(const String& o) { _s += o._s; return *this; }
+  String& operator+=(const char* o) { _s += o; return *this; }
+  String& operator+=(char c) { _s += c; return *this; }
+
+  friend String operator+(const String& a, const String& b) { return a._s + b._s; }
+  friend String operator+(const String& a, const char* b) { return a._s + b; }
+  friend String operator+(const char* a, const String& b) { return a + b._s; }
+  friend bool operator==(const String& a, const String& b) { return a._s == b._s; }
+  friend bool operator==(const String& a, const char* b) { return a._s == b; }
+  friend bool operator!=(const String& a, const String& b) { return a._s != b._s; }
+  friend bool operator!=(const String& a, const char* b) { return a._s != b; }
+  friend bool operator<(const String& a, const String& b) { return a._s < b._s; }
+
+  const std::string& str() const { return _s; }
+
+private:
+  std::string _s;
+
+  static std::string format(double v, int decimals) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+    return buf;
+  }
+};
+
+// ---- Serial (stdout, muted unless the simulator enables it) ----
+
+class HostSerial {
+public:
+  void begin(unsigned long) {}
+  void setEnabled(bool enabled) { _enabled = enabled; }
+  int printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+  void print(const char* s) { if (_enabled) fputs(s, stdout); }
+  void print(const String& s) { print(s.c_str()); }
+  void println(const char* s = "") { if (_enabled) { fputs(s, stdout); fputc('\n', stdout); } }
+  void println(const String& s) { println(s.c_str()); }
+
+private:
+  bool _enabled = false;
+};
+
+extern HostSerial Serial;
+
+// ---- ESP heap figures (per virtual node) ----
+
+class HostEsp {
+public:
+  uint32_t getFreeHeap();
+  uint32_t getMinFreeHeap();
+  uint32_t getMaxAllocHeap();
+};
+
+extern HostEsp ESP;
+
+#endif // MESHSIM_HOST_ARDUINO_H
@@ -0,0 +1,179 @@
+/**
+ * @file MeshSwarm.h
+ * @brief Host MeshSwarm for the simulator: same API, simulated transport
+ *
+ * Stands in for the MeshSwarm submodule in the native env so MeshSwarmExt
+ * and the simulated node behaviours compile unchanged. Shared state follows
+ * MeshSwarm's rules: per-key (version, origin), higher version wins and
+ * the lower origin breaks ties (MeshProto::isNewer), watchers fire on every
+ * change, local or remote. Heartbeats keep the peer table and pick the
+ * coordinator (lowest alive id): every SIM_HEARTBEAT_MS, or with the
+ * network's adaptiveHeartbeat on the MeshSwarmProto/Membership.h schedule
+ * with piggy-backed liveness and gossip. On a new connection both sides broadcast
+ * their full state, or exchange digest/delta messages when the network runs
+ * with deltaSync (MeshSwarmProto/DeltaSync.h).
+ *
+ * State is kept in a MeshSwarmProto StateStore, bounded by the network's
+ * stateMaxKeys and stateTtlMs; setState(key, "") deletes. Expired,
+ * evicted and deleted keys reach watchers as an empty value.
+ *
+ * Every message carries a MeshProto::Lane (MeshSwarmProto/SendLanes.h):
+ * setState() and setStates() take one (LANE_CONTROL marks the set urgent,
+ * "u":1), commands default to LANE_CONTROL. Commands to "*" flood the mesh
+ * and are not answered. The network queues by it when
+ * it runs with lanes; MESHSWARM_LANES tells MeshSwarmExt the API is there.
+ *
+ * Display, OTA, telemetry and power features are not modelled.
+ */
+
+#ifndef MESHSIM_HOST_MESHSWARM_H
+#define MESHSIM_HOST_MESHSWARM_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <Membership.h>
+#include <SendLanes.h>
+#include <StateStore.h>
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+struct SimMessage;
+class SimNetwork;
+
+// Fixed heartbeat period; peers are marked dead after HEARTBEAT_MISSES of them
+#ifndef SIM_HEARTBEAT_MS
+#define SIM_HEARTBEAT_MS 5000
+#endif
+
+#define MESHSWARM_LANES
+
+#ifndef SIM_COMMAND_TIMEOUT_MS
+#define SIM_COMMAND_TIMEOUT_MS 5000
+#endif
+
+struct Peer {
+  uint32_t id;
+  String name;
+  String role;
+  bool alive;
+  unsigned long lastSeen;
+};
+
+typedef MeshProto::StoreEntry<String> StateEntry;
+
+/**
+ * @brief painlessMesh's synchronised clock; simulated nodes share one exactly
+ */
+class painlessMesh {
+public:
+  uint32_t getNodeTime() { return (uint32_t)micros(); }
+};
+
+typedef std::function<void(const String& key, const String& value, const String& oldValue)> StateCallback;
+typedef std::function<JsonDocument(const String& sender, JsonObject& args)> CommandHandler;
+typedef std::function<void(bool success, const String& node, JsonObject& result)> CommandCallback;
+
+class MeshSwarm {
+public:
+  /**
+   * @brief Bind to the simulated network (before begin())
+   */
+  void simBind(SimNetwork& net, uint16_t index, uint32_t nodeId);
+
+  void begin(const char* name = nullptr);
+  void update();
+
+  // ---- Peers ----
+  std::map<uint32_t, Peer>& getPeers();   // Built from the PeerTable on demand
+  int getPeerCount();
+  uint32_t getNodeId() const { return _id; }
+  bool isCoordinator();
+  String getNodeName() const { return _name; }
+
+  painlessMesh& getMesh() { return _mesh; }
+
+  // ---- Shared state ----
+  bool setState(const String& key, const String& value, uint8_t lane = MeshProto::LANE_STATE);
+  bool setStates(std::initializer_list<std::pair<String, String>> states,
+                 uint8_t lane = MeshProto::LANE_STATE);
+  String getState(const String& key, const String& defaultValue = String());
+  void watchState(const String& key, StateCallback callback);
+
+  // ---- Hooks ----
+  void onLoop(std::function<void()> fn) { _loopFns.push_back(fn); }
+  void onSerialCommand(std::function<bool(const String&)> fn) { _serialFns.push_back(fn); }
+  void setHeartbeatData(const String& key, int value) { _heartbeatData[key] = value; }
+  void enableTelemetry(bool enabled) { _telemetry = enabled; }
+
+  // ---- Remote commands ----
+  void onCommand(const String& name, CommandHandler handler) { _commands[name] = handler; }
+  bool sendCommand(const String& target, const String& command, JsonObject& args,
+                   CommandCallback callback = nullptr, unsigned long timeoutMs = 0,
+                   uint8_t lane = MeshProto::LANE_CONTROL);
+
+  // ---- Simulator access ----
+  const std::map<String, StateEntry>& simState() const { return _state.entries(); }
+  const MeshProto::StoreStats& simStoreStats() const { return _state.stats(); }
+  const MeshProto::PeerTable& simPeers() const { return _peers; }
+  void simReceive(const SimMessage& msg);
+
+  /**
+   * @brief painlessMesh new-connection callback (both ends of a new link)
+   */
+  void simConnected(uint32_t peerId, bool joiner);
+
+  /**
+   * @brief Run a serial command through the registered handlers
+   */
+  bool simSerial(const String& line);
+
+private:
+  struct PendingCommand {
+    CommandCallback callback;
+    String target;
+    unsigned long deadline;
+  };
+
+  SimNetwork* _net = nullptr;
+  painlessMesh _mesh;
+  uint16_t _index = 0;
+  uint32_t _id = 0;
+  String _name;
+  bool _telemetry = false;
+
+  MeshProto::StateStore<String> _state;
+  std::vector<std::pair<String, StateCallback>> _watchers;
+  MeshProto::PeerTable _peers;
+  MeshProto::HeartbeatPacer _pacer;
+  uint16_t _beatSeq = 0;
+  std::map<uint32_t, Peer> _peerMap;     // getPeers() view
+  uint32_t _peerMapGeneration = 0;
+  bool _peerMapBuilt = false;
+  std::map<String, int> _heartbeatData;
+  std::vector<std::function<void()>> _loopFns;
+  std::vector<std::function<bool(const String&)>> _serialFns;
+  std::map<String, CommandHandler> _commands;
+  std::map<uint32_t, PendingCommand> _pending;
+  uint32_t _nextRequest = 1;
+  unsigned long _lastPeerCheck = 0;
+
+  bool applyLocal(const String& key, const String& value, StateEntry& out);
+  bool applyRemote(const String& key, const String& value, uint32_t version, uint32_t origin);
+  void notify(const String& key, const String& value, const String& oldValue);
+  void sendHeartbeat();
+  void broadcast(const std::shared_ptr<SimMessage>& msg);
+  void heardFrom(uint32_t id);
+  void broadcastFullState();
+  void sendDigest(uint32_t to);
+  void answerDigest(const SimMessage& msg);
+  void sendDelta(uint32_t to, const std::vector<const std::pair<const String, StateEntry>*>& entries,
+                 const std::vector<uint32_t>& wants);
+  void handleCommand(const SimMessage& msg);
+  void expireCommands();
+};
+
+#endif // MESHSIM_HOST_MESHSWARM_H
@@ -0,0 +1,499 @@
+/**
+ * @file SimSwarm.cpp
+ * @brief Host MeshSwarm implementation on the simulated transport
+ *
+ * Message sizes are those of MeshSwarm's JSON encoding (field names as on
+ * the wire, no whitespace), so byte counts compare with the figures in the
+ * MeshSwarmProto README:
+ *
+ *   heartbeat  {"t":1,"name":..,"role":..,"up":..,"peers":..,"states":..,<data>...}
+ *              adaptive adds ,"hb":..,"s":..,"m":"<base64, 6 bytes per peer>"
+ *   set        {"t":2,"key":..,"value":..,"version":..,"origin":..}
+ *   set/sync   {"t":2|3,"states":[{"key":..,"value":..,"version":..,"origin":..},...]}
+ *              an urgent (control lane) set adds ,"u":1
+ *   digest     {"t":7,"n":..,"d":"<base64, 12 bytes per key>"}
+ *   delta      {"t":8,"s":[[key,value,version,origin],...],"w":"<base64>","end":1}
+ *
+ * Outgoing messages are built in the SimHeap "none" scope: once handed to
+ * painlessMesh they are its buffers, not the sender's heap.
+ */
+
+#include <MeshSwarm.h>
+#include "../SimHeap.h"
+#include "../SimNetwork.h"
+#include <ProtoUtil.h>
+#include <algorithm>
+
+namespace {
+
+size_t digits(unsigned long v) {
+  size_t n = 1;
+  while (v >= 10) { v /= 10; n++; }
+  return n;
+}
+
+size_t quoted(const String& s) { return s.length() + 2; }
+
+// {"key":"k","value":"v","version":n,"origin":n}
+size_t entryObjectBytes(const SimEntry& e) {
+  return 40 + e.key.length() + e.value.length() + digits(e.version) + digits(e.origin);
+}
+
+// ["k","v",n,n]
+size_t entryArrayBytes(const SimEntry& e) {
+  return 9 + e.key.length() + e.value.length() + digits(e.version) + digits(e.origin);
+}
+
+size_t statesBytes(const std::vector<SimEntry>& entries) {
+  size_t n = 20;  // {"t":3,"states":[]}
+  for (const SimEntry& e : entries) n += entryObjectBytes(e) + 1;
+  return n;
+}
+
+bool matches(const String& pattern, const String& key) {
+  return pattern == "*" || pattern == key;
+}
+
+}  // namespace
+
+void MeshSwarm::simBind(SimNetwork& net, uint16_t index, uint32_t nodeId) {
+  _net = &net;
+  _index = index;
+  _id = nodeId;
+}
+
+void MeshSwarm::begin(const char* name) {
+  _name = name ? name : "Node";
+
+  const SimConfig& cfg = _net->config();
+  if (cfg.adaptiveHeartbeat) {
+    _pacer.begin(millis());
+  } else {
+    _pacer.begin(millis(), SIM_HEARTBEAT_MS, SIM_HEARTBEAT_MS);
+  }
+  _state.begin(_id, cfg.stateMaxKeys ? cfg.stateMaxKeys : SIZE_MAX);
+  if (cfg.stateTtlMs) _state.expire("*", cfg.stateTtlMs);
+  _state.onDrop([this](const String& key, const String& oldValue, MeshProto::StoreDrop why) {
+    if (oldValue.length() > 0) notify(key, String(), oldValue);
+  });
+}
+
+void MeshSwarm::update() {
+  unsigned long now = millis();
+
+  if (_pacer.due(now)) sendHeartbeat();
+
+  if (now - _lastPeerCheck >= 1000) {
+    _lastPeerCheck = now;
+    _peers.expire(now);
+    _state.sweep(now);
+  }
+
+  if (!_pending.empty()) expireCommands();
+
+  for (size_t i = 0; i < _loopFns.size(); i++) _loopFns[i]();
+}
+
+// ---- Peers ----
+
+int MeshSwarm::getPeerCount() {
+  return (int)_peers.aliveCount();
+}
+
+bool MeshSwarm::isCoordinator() {
+  uint32_t lowest = _peers.lowestAlive();
+  return lowest == 0 || _id < lowest;
+}
+
+std::map<uint32_t, Peer>& MeshSwarm::getPeers() {
+  if (!_peerMapBuilt || _peerMapGeneration != _peers.generation()) {
+    _peerMap.clear();
+    for (const MeshProto::PeerRecord& r : _peers.records()) {
+      _peerMap[r.id] = Peer{r.id, _peers.name(r), _peers.role(r), r.alive, r.lastSeen};
+    }
+    _peerMapGeneration = _peers.generation();
+    _peerMapBuilt = true;
+  }
+  return _peerMap;
+}
+
+void MeshSwarm::sendHeartbeat() {
+  unsigned long now = millis();
+  _pacer.sent(now);
+  _beatSeq++;
+
+  SimHeap::Scope wire(SIM_HEAP_NONE);
+  auto msg = std::make_shared<SimMessage>();
+  msg->type = SIM_MSG_HEARTBEAT;
+  msg->from = _id;
+  msg->name = _name;
+  msg->role = isCoordinator() ? "COORD" : "PEER";
+
+  size_t bytes = 26 + quoted(msg->name) + quoted(msg->role) + digits(now / 1000) +
+                 digits(getPeerCount()) + digits(_state.size()) + 20;
+  for (auto& kv : _heartbeatData) bytes += 4 + kv.first.length() + digits(abs(kv.second)) + 1;
+
+  const SimConfig& cfg = _net->config();
+  if (cfg.adaptiveHeartbeat) {
+    msg->intervalS = (uint8_t)(_pacer.interval() / 1000);
+    msg->seq = _beatSeq;
+    bytes += 6 + digits(msg->intervalS) + 5 + digits(msg->seq);  // ,"hb":n ,"s":n
+    if (cfg.gossipPeers > 0) {
+      msg->gossip.resize(cfg.gossipPeers * MeshProto::PeerTable::GOSSIP_ITEM_BYTES);
+      size_t n = _peers.writeGossip(msg->gossip.data(), cfg.gossipPeers);
+      msg->gossip.resize(n * MeshProto::PeerTable::GOSSIP_ITEM_BYTES);
+      if (n > 0) bytes += 7 + MeshProto::base64Length(msg->gossip.size());  // ,"m":""
+    }
+  }
+  msg->bytes = bytes;
+
+  _net->broadcast(_index, msg);
+}
+
+void MeshSwarm::broadcast(const std::shared_ptr<SimMessage>& msg) {
+  _net->broadcast(_index, msg);
+  // Peers take any broadcast as a sign of life, so the next heartbeat can wait
+  if (_net->config().adaptiveHeartbeat) _pacer.spoke(millis());
+}
+
+void MeshSwarm::heardFrom(uint32_t id) {
+  _state.heard(id, millis());
+}
+
+// ---- Shared state ----
+
+bool MeshSwarm::applyLocal(const String& key, const String& value, StateEntry& out) {
+  String oldValue;
+  if (!_state.setLocal(key, value, millis(), &out, &oldValue)) return false;
+  notify(key, value, oldValue);
+  return true;
+}
+
+bool MeshSwarm::applyRemote(const String& key, const String& value, uint32_t version, uint32_t origin) {
+  String oldValue;
+  if (!_state.applyRemote(key, value, version, origin, millis(), &oldValue)) return false;
+  if (oldValue != value) notify(key, value, oldValue);
+  return true;
+}
+
+void MeshSwarm::notify(const String& key, const String& value, const String& oldValue) {
+  // Index loop: a callback may register another watcher
+  for (size_t i = 0; i < _watchers.size(); i++) {
+    if (matches(_watchers[i].first, key)) _watchers[i].second(key, value, oldValue);
+  }
+}
+
+bool MeshSwarm::setState(const String& key, const String& value, uint8_t lane) {
+  StateEntry e;
+  if (!applyLocal(key, value, e)) return false;
+
+  SimHeap::Scope wire(SIM_HEAP_NONE);
+  auto msg = std::make_shared<SimMessage>();
+  msg->type = SIM_MSG_STATE_SET;
+  msg->from = _id;
+  msg->lane = lane;
+  msg->entries.push_back({key, e.value, e.version, e.origin});
+  msg->bytes = entryObjectBytes(msg->entries[0]) + 6 + (lane == MeshProto::LANE_CONTROL ? 6 : 0);
+  broadcast(msg);
+  return true;
+}
+
+bool MeshSwarm::setStates(std::initializer_list<std::pair<String, String>> states, uint8_t lane) {
+  std::vector<SimEntry> changed;
+  for (const auto& kv : states) {
+    StateEntry e;
+    if (applyLocal(kv.first, kv.second, e)) changed.push_back({kv.first, e.value, e.version, e.origin});
+  }
+  if (changed.empty()) return false;
+
+  SimHeap::Scope wire(SIM_HEAP_NONE);
+  auto msg = std::make_shared<SimMessage>();
+  msg->type = SIM_MSG_STATE_SET;
+  msg->from = _id;
+  msg->lane = lane;
+  msg->entries.assign(changed.begin(), changed.end());
+
+  msg->bytes = msg->entries.size() == 1 ? entryObjectBytes(msg->entries[0]) + 6
+                                        : statesBytes(msg->entries);
+  if (lane == MeshProto::LANE_CONTROL) msg->bytes += 6;
+  broadcast(msg);
+  return true;
+}
+
+String MeshSwarm::getState(const String& key, const String& defaultValue) {
+  const StateEntry* e = _state.get(key, millis());
+  return e ? e->value : defaultValue;
+}
+
+void MeshSwarm::watchState(const String& key, StateCallback callback) {
+  _watchers.push_back(std::make_pair(key, callback));
+}
+
+void MeshSwarm::broadcastFullState() {
+  if (_state.size() == 0) return;
+
+  SimHeap::Scope wire(SIM_HEAP_NONE);
+  auto msg = std::make_shared<SimMessage>();
+  msg->type = SIM_MSG_STATE_SYNC;
+  msg->from = _id;
+  msg->entries.reserve(_state.size());
+  for (auto& kv : _state.entries()) {
+    msg->entries.push_back({kv.first, kv.second.value, kv.second.version, kv.second.origin});
+  }
+  msg->bytes = statesBytes(msg->entries);
+  broadcast(msg);
+}
+
+// ---- Join sync ----
+
+void MeshSwarm::simConnected(uint32_t peerId, bool joiner) {
+  if (!_net->config().deltaSync) {
+    broadcastFullState();
+    return;
+  }
+  // Delta sync: the joiner opens with its digest, the other side answers
+  if (joiner) sendDigest(peerId);
+}
+
+void MeshSwarm::sendDigest(uint32_t to) {
+  SimHeap::Scope wire(SIM_HEAP_NONE);
+  auto msg = std::make_shared<SimMessage>();
+  msg->type = SIM_MSG_DIGEST;
+  msg->from = _id;
+  msg->to = to;
+  if (_state.size() > DELTA_DIGEST_MAX_KEYS) {
+    msg->full = true;
+    msg->bytes = 16;  // {"t":7,"full":1}
+  } else {
+    msg->digest.collect(_state.entries());
+    msg->bytes = 17 + digits(_state.size()) +
+                 MeshProto::base64Length(_state.size() * MeshProto::StateDigest::ITEM_BYTES);
+  }
+  _net->sendTo(_index, to, msg);
+}
+
+void MeshSwarm::answerDigest(const SimMessage& msg) {
+  if (msg.full) {
+    broadcastFullState();
+    return;
+  }
+
+  const MeshProto::StateDigest& peer = msg.digest;
+  MeshProto::StateDigest local;
+  local.collect(_state.entries());
+
+  std::vector<const std::pair<const String, StateEntry>*> missing;
+  for (auto& kv : _state.entries()) {
+    const MeshProto::DigestItem* theirs = peer.find(MeshProto::keyHash(kv.first.c_str()));
+    if (!theirs || MeshProto::isNewer(kv.second.version, kv.second.origin, theirs->version, theirs->origin)) {
+      missing.push_back(&kv);
+    }
+  }
+
+  std::vector<uint32_t> wants;
+  for (const MeshProto::DigestItem& theirs : peer.items()) {
+    const MeshProto::DigestItem* mine = local.find(theirs.hash);
+    if (!mine || MeshProto::isNewer(theirs.version, theirs.origin, mine->version, mine->origin)) {
+      wants.push_back(theirs.hash);
+    }
+  }
+
+  sendDelta(msg.from, missing, wants);
+}
+
+void MeshSwarm::sendDelta(uint32_t to, const std::vector<const std::pair<const String, StateEntry>*>& entries,
+                          const std::vector<uint32_t>& wants) {
+  // Same split as MeshProto::DeltaWriter: entries until DELTA_MSG_MAX_BYTES
+  const size_t base = 22;  // {"t":8,"s":[],"end":1}
+  SimHeap::Scope wire(SIM_HEAP_NONE);
+  auto msg = std::make_shared<SimMessage>();
+  msg->bytes = base;
+
+  auto emit = [&](bool last) {
+    msg->type = SIM_MSG_DELTA;
+    msg->from = _id;
+    msg->to = to;
+    msg->end = last;
+    if (last && !wants.empty()) {
+      msg->wants = wants;
+      msg->bytes += 7 + MeshProto::base64Length(wants.size() * 4);
+    }
+    _net->sendTo(_index, to, msg);
+    msg = std::make_shared<SimMessage>();
+    msg->bytes = base;
+  };
+
+  for (auto* kv : entries) {
+    SimEntry e = {kv->first, kv->second.value, kv->second.version, kv->second.origin};
+    size_t add = entryArrayBytes(e) + 1;
+    if (!msg->entries.empty() && msg->bytes + add > DELTA_MSG_MAX_BYTES) emit(false);
+    msg->entries.push_back(e);
+    msg->bytes += add;
+  }
+  emit(true);
+}
+
+// ---- Receive ----
+
+void MeshSwarm::simReceive(const SimMessage& msg) {
+  if (msg.from == _id) return;
+  unsigned long now = millis();
+  bool adaptive = _net->config().adaptiveHeartbeat;
+
+  switch (msg.type) {
+    case SIM_MSG_HEARTBEAT: {
+      bool arrived = _peers.heartbeat(msg.from, msg.name.c_str(), msg.role.c_str(), msg.seq,
+                                      msg.intervalS * 1000UL, now);
+      heardFrom(msg.from);
+      if (!adaptive) break;
+      // A newcomer needs our heartbeat to list us; go back to the short interval
+      if (arrived) _pacer.unsettle();
+      _peers.readGossip(msg.gossip.data(), msg.gossip.size(), now,
+                        [this](uint32_t id) { heardFrom(id); });
+      return;
+    }
+
+    case SIM_MSG_STATE_SET:
+    case SIM_MSG_STATE_SYNC:
+      for (const SimEntry& e : msg.entries) applyRemote(e.key, e.value, e.version, e.origin);
+      break;
+
+    case SIM_MSG_DIGEST:
+      answerDigest(msg);
+      break;
+
+    case SIM_MSG_DELTA: {
+      for (const SimEntry& e : msg.entries) applyRemote(e.key, e.value, e.version, e.origin);
+      if (msg.wants.empty()) break;
+
+      std::vector<const std::pair<const String, StateEntry>*> wanted;
+      for (auto& kv : _state.entries()) {
+        if (std::binary_search(msg.wants.begin(), msg.wants.end(), MeshProto::keyHash(kv.first.c_str()))) {
+          wanted.push_back(&kv);
+        }
+      }
+      if (!wanted.empty()) sendDelta(msg.from, wanted, std::vector<uint32_t>());
+      break;
+    }
+
+    case SIM_MSG_COMMAND:
+      handleCommand(msg);
+      break;
+
+    default:
+      break;
+  }
+  if (adaptive && _peers.heard(msg.from, now)) heardFrom(msg.from);
+}
+
+// ---- Commands ----
+
+bool MeshSwarm::sendCommand(const String& target, const String& command, JsonObject& args,
+                            CommandCallback callback, unsigned long timeoutMs, uint8_t lane) {
+  // "*" floods the mesh and is not answered
+  bool everyone = target == "*";
+  uint32_t to = 0;
+  for (const MeshProto::PeerRecord& r : _peers.records()) {
+    if (everyone) break;
+    if (r.alive && target == _peers.name(r)) {
+      to = r.id;
+      break;
+    }
+  }
+  if (to == 0 && !everyone) return false;
+
+  uint32_t requestId = _nextRequest++;
+  if (callback && !everyone) {
+    PendingCommand& p = _pending[requestId];
+    p.callback = callback;
+    p.target = target;
+    p.deadline = millis() + (timeoutMs > 0 ? timeoutMs : SIM_COMMAND_TIMEOUT_MS);
+  }
+
+  SimHeap::Scope wire(SIM_HEAP_NONE);
+  auto msg = std::make_shared<SimMessage>();
+  msg->type = SIM_MSG_COMMAND;
+  msg->from = _id;
+  msg->to = to;
+  msg->lane = lane;
+  msg->command = command;
+  msg->requestId = requestId;
+  serializeJson(args, msg->payload);
+  msg->bytes = 40 + command.length() + digits(to) + digits(requestId) + msg->payload.size();
+  if (everyone) {
+    broadcast(msg);
+  } else {
+    _net->sendTo(_index, to, msg);
+  }
+  return true;
+}
+
+void MeshSwarm::handleCommand(const SimMessage& msg) {
+  if (msg.reply) {
+    auto it = _pending.find(msg.requestId);
+    if (it == _pending.end()) return;
+    CommandCallback callback = it->second.callback;
+    String target = it->second.target;
+    _pending.erase(it);
+
+    JsonDocument doc;
+    deserializeJson(doc, msg.payload);
+    JsonObject result = doc.as<JsonObject>();
+    callback(msg.success, target, result);
+    return;
+  }
+
+  JsonDocument result;
+  auto handler = _commands.find(msg.command);
+  bool found = handler != _commands.end();
+  if (found) {
+    JsonDocument argsDoc;
+    deserializeJson(argsDoc, msg.payload);
+    JsonObject args = argsDoc.as<JsonObject>();
+
+    const MeshProto::PeerRecord* peer = _peers.find(msg.from);
+    String sender = peer ? String(_peers.name(*peer)) : String((unsigned long)msg.from);
+    result = handler->second(sender, args);
+  }
+  if (msg.to == 0) return;
+
+  SimHeap::Scope wire(SIM_HEAP_NONE);
+  auto reply = std::make_shared<SimMessage>();
+  reply->type = SIM_MSG_COMMAND;
+  reply->from = _id;
+  reply->to = msg.from;
+  reply->lane = msg.lane;  // Answers travel in the lane they were asked in
+  reply->requestId = msg.requestId;
+  reply->reply = true;
+  reply->success = found;
+  if (found) serializeJson(result, reply->payload);
+  reply->bytes = 34 + digits(msg.requestId) + reply->payload.size();
+
+  _net->sendTo(_index, msg.from, reply);
+}
+
+void MeshSwarm::expireCommands() {
+  unsigned long now = millis();
+  for (auto it = _pending.begin(); it != _pending.end();) {
+    if ((long)(now - it->second.deadline) < 0) {
+      ++it;
+      continue;
+    }
+    CommandCallback callback = it->second.callback;
+    String target = it->second.target;
+    it = _pending.erase(it);
+
+    JsonDocument empty;
+    JsonObject result = empty.to<JsonObject>();
+    callback(false, target, result);
+  }
+}
+
+// ---- Serial ----
+
+bool MeshSwarm::simSerial(const String& line) {
+  for (auto& fn : _serialFns) {
+    if (fn(line)) return true;
+  }
+  return false;
+}
@@ -0,0 +1,673 @@
+/**
+ * MeshSwarm Simulator
+ *
+ * Runs 100-500 virtual nodes on the host against a simulated painlessMesh
+ * transport, with MeshSwarmExt compiled from lib/ and node behaviours
+ * modelled on the sketches (SimNodes.h). Reports message rates and bytes by
+ * type, convergence time of a state change, join sync time of nodes that
+ * drop out and come back, and per-node heap.
+ *
+ * Phases:
+ *   boot     nodes power up spread over --boot seconds and join the tree
+ *   settle   15 s for heartbeats and first reports
+ *   measure  rest of --seconds: one probe key every --probe-interval ms
+ *            from a random node, --rejoins nodes drop for 30 s and return,
+ *            --retire nodes leave for good in the first quarter
+ *
+ * Build and run:
+ *   pio run -e native
+ *   .pio/build/native/program --nodes 300 --latency 20 --loss 0.01
+ *   .pio/build/native/program --nodes 300 --sync delta --json
+ *   .pio/build/native/program --retire 20 --state-ttl 3 --max-keys 64
+ *   .pio/build/native/program --nodes 300 --heartbeat adaptive
+ *   .pio/build/native/program --link 20000 --ota 50 --press-mean 10000 --lanes
+ */
+
+#include <Arduino.h>
+#include <MeshSwarm.h>
+#include <ProtoUtil.h>
+#include <algorithm>
+#include <set>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "SimHeap.h"
+#include "SimNetwork.h"
+#include "SimNodes.h"
+
+// ============== CONFIGURATION ==============
+#define SETTLE_MS        15000     // After the boot window, before measuring
+#define REJOIN_OFFLINE_MS 30000    // Longer than the fixed-schedule peer timeout
+#define PROBE_KEY        "sim_probe"
+#define MEMBERSHIP_SAMPLE_MS 5000  // Peer table accuracy sampling
+#define OTA_CHUNK_WIRE_BYTES 740   // 512 B chunk, base64, plus the OtaChunks.h header
+
+static const char* const TYPE_NAMES[SIM_MSG_TYPES] = {
+  "?", "heartbeat", "state_set", "state_sync", "state_req", "command", "telemetry", "digest", "delta", "ota"
+};
+
+// ============== GLOBALS ==============
+static SimConfig config;
+static bool jsonOutput = false;
+static std::vector<SimNode*> nodes;
+
+struct Probe {
+  String value;
+  uint64_t startUs = 0;
+  size_t targets = 0;
+  size_t reached = 0;
+  uint64_t lastUs = 0;       // Last target reached
+  std::vector<uint8_t> pending;  // Per node: waiting for this probe
+};
+
+static std::vector<Probe> probes;
+static std::vector<uint32_t> probeLatencyMs;   // Every node of every probe
+
+struct Rejoin {
+  uint16_t node;
+  uint64_t leaveUs;
+  uint64_t joinUs;
+  bool joined = false;
+  bool synced = false;
+  uint64_t syncUs = 0;
+  size_t behind = 0;                               // Keys stale at rejoin
+  std::vector<std::pair<String, StateEntry>> target;
+};
+
+static std::vector<Rejoin> rejoins;
+static std::set<uint32_t> retiredIds;            // Node ids gone for good
+static std::map<uint32_t, uint16_t> nodeIndex;   // Node id -> index
+static uint32_t stateTtlBeats = 0;
+
+// Peer tables against who is really online, sampled during measure
+static uint64_t peersExpected = 0, peersSeen = 0, peerGhosts = 0, peerSamples = 0;
+static SimTypeStats bootStats[SIM_MSG_TYPES];
+static uint32_t otaChunks = 0;
+
+// ============== ARGUMENTS ==============
+static void usage() {
+  printf("usage: program [options]\n"
+         "  --nodes N           virtual nodes (default 100)\n"
+         "  --seconds S         simulated time (default 180)\n"
+         "  --boot S            power-up window (default 20)\n"
+         "  --latency MS        per hop latency (default 15)\n"
+         "  --jitter MS         per hop jitter, uniform (default 10)\n"
+         "  --loss P            per hop loss probability 0..1 (default 0)\n"
+         "  --fanout N          stations per node (default 4)\n"
+         "  --zones N           sensor zones (default nodes/5)\n"
+         "  --sync full|delta   join sync (default full)\n"
+         "  --probes N          convergence probes (default 20)\n"
+         "  --probe-interval MS time between probes (default 5000)\n"
+         "  --rejoins N         nodes that drop out and return (default 5)\n"
+         "  --retire N          nodes that leave and never return (default 0)\n"
+         "  --state-ttl BEATS   expire keys of origins silent this many heartbeats (default off)\n"
+         "  --max-keys N        state keys per node before LRU eviction (default unbounded)\n"
+         "  --heartbeat fixed|adaptive  heartbeat schedule (default fixed)\n"
+         "  --gossip N          peer counters per adaptive heartbeat (default 4)\n"
+         "  --link B/S          per node radio rate, queues on busy hops (default off)\n"
+         "  --lanes             queue by priority lane instead of one FIFO (needs --link)\n"
+         "  --ota MS            broadcast one OTA chunk from the root this often (default off)\n"
+         "  --press-mean MS     mean time between presses per button node (default 300000)\n"
+         "  --tick MS           node loop period (default 10)\n"
+         "  --seed N            random seed (default 1)\n"
+         "  --json              print the report as one JSON object\n"
+         "  --verbose           node Serial output to stdout\n");
+}
+
+static bool parseArgs(int argc, char** argv) {
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    const char* val = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    auto num = [&](long lo, long hi) -> long {
+      long v = val ? strtol(val, nullptr, 10) : lo;
+      i++;
+      return v < lo ? lo : (v > hi ? hi : v);
+    };
+
+    if (!strcmp(arg, "--nodes")) config.nodes = (uint16_t)num(2, 2000);
+    else if (!strcmp(arg, "--seconds")) config.seconds = (uint32_t)num(10, 86400);
+    else if (!strcmp(arg, "--boot")) config.bootSeconds = (uint32_t)num(0, 3600);
+    else if (!strcmp(arg, "--latency")) config.latencyMs = (uint32_t)num(0, 10000);
+    else if (!strcmp(arg, "--jitter")) config.jitterMs = (uint32_t)num(0, 10000);
+    else if (!strcmp(arg, "--fanout")) config.fanout = (uint8_t)num(1, 10);
+    else if (!strcmp(arg, "--zones")) config.zones = (uint16_t)num(1, 2000);
+    else if (!strcmp(arg, "--probes")) config.probes = (uint16_t)num(0, 10000);
+    else if (!strcmp(arg, "--probe-interval")) config.probeIntervalMs = (uint32_t)num(100, 600000);
+    else if (!strcmp(arg, "--rejoins")) config.rejoins = (uint16_t)num(0, 1000);
+    else if (!strcmp(arg, "--retire")) config.retire = (uint16_t)num(0, 1000);
+    else if (!strcmp(arg, "--state-ttl")) stateTtlBeats = (uint32_t)num(1, 1000);
+    else if (!strcmp(arg, "--gossip")) config.gossipPeers = (uint8_t)num(0, 64);
+    else if (!strcmp(arg, "--link")) config.linkBytesPerS = (uint32_t)num(1000, 10000000);
+    else if (!strcmp(arg, "--ota")) config.otaChunkMs = (uint32_t)num(1, 600000);
+    else if (!strcmp(arg, "--press-mean")) config.pressMeanMs = (uint32_t)num(100, 86400000);
+    else if (!strcmp(arg, "--max-keys")) config.stateMaxKeys = (uint16_t)num(1, 10000);
+    else if (!strcmp(arg, "--tick")) config.tickMs = (uint32_t)num(1, 1000);
+    else if (!strcmp(arg, "--seed")) config.seed = (uint32_t)num(0, 0x7FFFFFFF);
+    else if (!strcmp(arg, "--loss") && val) { config.loss = strtof(val, nullptr); i++; }
+    else if (!strcmp(arg, "--sync") && val) { config.deltaSync = !strcmp(val, "delta"); i++; }
+    else if (!strcmp(arg, "--heartbeat") && val) { config.adaptiveHeartbeat = !strcmp(val, "adaptive"); i++; }
+    else if (!strcmp(arg, "--lanes")) config.lanes = true;
+    else if (!strcmp(arg, "--json")) jsonOutput = true;
+    else if (!strcmp(arg, "--verbose")) Serial.setEnabled(true);
+    else {
+      usage();
+      return false;
+    }
+  }
+  if (config.loss < 0.0f) config.loss = 0.0f;
+  if (config.loss > 1.0f) config.loss = 1.0f;
+  if (config.zones == 0) config.zones = std::max(1, config.nodes / 5);
+  // A TTL counts heartbeats at the longest interval a node may announce
+  config.stateTtlMs = stateTtlBeats * (config.adaptiveHeartbeat ? HEARTBEAT_MAX_MS : SIM_HEARTBEAT_MS);
+  if (config.lanes && !config.linkBytesPerS) {
+    printf("--lanes needs --link: without a link rate nothing queues\n");
+    return false;
+  }
+  return true;
+}
+
+// ============== BULK LOAD ==============
+static void sendOtaChunk(SimNetwork& net) {
+  if (!net.online(0)) return;
+  SimHeap::Scope scope(SIM_HEAP_NONE);  // Payload is streamed, not held by the node
+  auto msg = std::make_shared<SimMessage>();
+  msg->type = SIM_MSG_OTA;
+  msg->from = nodes[0]->mesh().getNodeId();
+  msg->lane = MeshProto::LANE_BULK;
+  msg->bytes = OTA_CHUNK_WIRE_BYTES;
+  net.broadcast(0, msg);
+  otaChunks++;
+}
+
+// ============== PROBES ==============
+static void startProbe(SimNetwork& net) {
+  // A new probe supersedes the last; copies of the old value no longer count
+  std::vector<uint16_t> online;
+  for (uint16_t i = 0; i < nodes.size(); i++) {
+    if (net.online(i)) online.push_back(i);
+  }
+  if (online.size() < 2) return;
+
+  Probe p;
+  p.value = String((unsigned long)probes.size() + 1);
+  p.startUs = net.nowUs();
+  p.targets = online.size() - 1;
+  p.pending.assign(nodes.size(), 0);
+  uint16_t source = online[std::uniform_int_distribution<size_t>(0, online.size() - 1)(net.rng())];
+  for (uint16_t i : online) {
+    if (i != source) p.pending[i] = 1;
+  }
+  probes.push_back(p);
+
+  SimHeap::Scope scope(source);
+  nodes[source]->mesh().setState(PROBE_KEY, p.value);
+}
+
+static void onProbe(SimNetwork& net, uint16_t node, const String& value) {
+  if (probes.empty()) return;
+  Probe& p = probes.back();
+  if (value != p.value || !p.pending[node]) return;
+
+  SimHeap::Scope scope(SIM_HEAP_NONE);  // Runs inside the node's watcher
+  p.pending[node] = 0;
+  p.reached++;
+  p.lastUs = net.nowUs();
+  probeLatencyMs.push_back((uint32_t)((p.lastUs - p.startUs) / 1000));
+}
+
+static void dropFromProbe(uint16_t node) {
+  if (probes.empty()) return;
+  Probe& p = probes.back();
+  if (p.pending[node]) {
+    p.pending[node] = 0;
+    p.targets--;
+  }
+}
+
+// ============== REJOINS ==============
+
+// Oldest copy of each key held by every online node: what the mesh had
+// agreed on, leaving out writes still in flight
+static std::map<String, StateEntry> agreedView(SimNetwork& net, int except) {
+  std::map<String, StateEntry> oldest;
+  std::map<String, size_t> holders;
+  size_t online = 0;
+  for (uint16_t i = 0; i < nodes.size(); i++) {
+    if (!net.online(i) || i == except) continue;
+    online++;
+    for (const auto& kv : nodes[i]->mesh().simState()) {
+      holders[kv.first]++;
+      auto it = oldest.find(kv.first);
+      if (it == oldest.end() || MeshProto::isNewer(it->second.version, it->second.origin,
+                                                   kv.second.version, kv.second.origin)) {
+        oldest[kv.first] = kv.second;
+      }
+    }
+  }
+  for (auto it = oldest.begin(); it != oldest.end();) {
+    it = holders[it->first] == online ? std::next(it) : oldest.erase(it);
+  }
+  return oldest;
+}
+
+static void markRejoined(SimNetwork& net, Rejoin& r) {
+  std::map<String, StateEntry> agreed = agreedView(net, r.node);
+  const std::map<String, StateEntry>& mine = nodes[r.node]->mesh().simState();
+  for (const auto& kv : agreed) {
+    // Keys of retired nodes may expire before the rejoiner would catch up on them
+    if (kv.first == PROBE_KEY || retiredIds.count(kv.second.origin)) continue;
+    auto it = mine.find(kv.first);
+    if (it == mine.end() || MeshProto::isNewer(kv.second.version, kv.second.origin,
+                                               it->second.version, it->second.origin)) {
+      r.target.push_back(kv);
+    }
+  }
+  r.behind = r.target.size();
+}
+
+static bool caughtUp(const Rejoin& r) {
+  const std::map<String, StateEntry>& mine = nodes[r.node]->mesh().simState();
+  for (const auto& kv : r.target) {
+    // With a TTL, keys of a node that has left since may expire before arriving
+    if (config.stateTtlMs && !simNetwork->online(nodeIndex[kv.second.origin])) continue;
+    auto it = mine.find(kv.first);
+    if (it == mine.end()) return false;
+    if (MeshProto::isNewer(kv.second.version, kv.second.origin, it->second.version, it->second.origin)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// ============== MEMBERSHIP ==============
+static void sampleMembership(SimNetwork& net) {
+  for (uint16_t i = 0; i < nodes.size(); i++) {
+    if (!net.online(i)) continue;
+    const MeshProto::PeerTable& peers = nodes[i]->mesh().simPeers();
+    for (uint16_t j = 0; j < nodes.size(); j++) {
+      if (j == i || !net.online(j)) continue;
+      peersExpected++;
+      const MeshProto::PeerRecord* r = peers.find(nodes[j]->mesh().getNodeId());
+      if (r && r->alive) peersSeen++;
+    }
+    for (const MeshProto::PeerRecord& r : peers.records()) {
+      if (r.alive && !net.online(nodeIndex[r.id])) peerGhosts++;
+    }
+    peerSamples++;
+  }
+}
+
+// ============== REPORT ==============
+static uint32_t percentile(std::vector<uint32_t> v, float q) {
+  if (v.empty()) return 0;
+  std::sort(v.begin(), v.end());
+  size_t i = (size_t)(q * (v.size() - 1) + 0.5f);
+  return v[std::min(i, v.size() - 1)];
+}
+
+struct Summary {
+  double seconds;
+  SimTypeStats steady[SIM_MSG_TYPES];
+  SimTypeStats total;
+  std::vector<uint32_t> convergeMs;     // Per probe, last node reached
+  size_t probesComplete = 0;
+  double coverage = 0;                  // Reached / targets over all probes
+  std::vector<uint32_t> joinSyncMs;
+  size_t joinsSynced = 0;
+  size_t heapAvg = 0, heapMax = 0, peakMax = 0;
+  int heapMaxNode = -1;
+  size_t keysAvg = 0, keysMax = 0, peersAvg = 0;
+  double peerAccuracy = 1.0;            // Online peers listed alive, over samples
+  double ghostsAvg = 0;                 // Offline peers still listed alive, per node
+  size_t orphansAvg = 0;                // Keys per node written by retired nodes
+  uint64_t expired = 0, evicted = 0;
+  uint16_t depth = 0;
+  double rxPerNodeSec = 0;
+  MeshProto::LaneStats lanes[MeshProto::LANES];
+  uint64_t overflow = 0;                // Copies refused by full send queues
+  std::vector<uint32_t> pressMs;        // Button -> LED, every LED node
+};
+
+static Summary summarize(SimNetwork& net, uint64_t measureStartUs) {
+  Summary s;
+  s.seconds = (net.nowUs() - measureStartUs) / 1e6;
+
+  for (uint8_t t = 1; t < SIM_MSG_TYPES; t++) {
+    s.steady[t] = net.stats(t);
+    s.total.sent += s.steady[t].sent;
+    s.total.delivered += s.steady[t].delivered;
+    s.total.hops += s.steady[t].hops;
+    s.total.bytes += s.steady[t].bytes;
+    s.total.airBytes += s.steady[t].airBytes;
+    s.total.dropped += s.steady[t].dropped;
+    s.overflow += s.steady[t].overflow;
+  }
+  for (uint8_t l = 0; l < MeshProto::LANES; l++) s.lanes[l] = net.laneStats(l);
+  s.pressMs = simPressLatencies();
+
+  size_t targets = 0, reached = 0;
+  for (const Probe& p : probes) {
+    targets += p.targets;
+    reached += p.reached;
+    if (p.targets > 0 && p.reached == p.targets) {
+      s.probesComplete++;
+      s.convergeMs.push_back((uint32_t)((p.lastUs - p.startUs) / 1000));
+    }
+  }
+  s.coverage = targets > 0 ? (double)reached / targets : 1.0;
+
+  for (const Rejoin& r : rejoins) {
+    if (!r.synced) continue;
+    s.joinsSynced++;
+    s.joinSyncMs.push_back((uint32_t)((r.syncUs - r.joinUs) / 1000));
+  }
+
+  size_t online = 0, heapTotal = 0, keys = 0, orphans = 0, peers = 0;
+  uint64_t rx = 0;
+  for (uint16_t i = 0; i < nodes.size(); i++) {
+    if (!net.online(i)) continue;
+    const SimHeap::Usage& u = SimHeap::usage(i);
+    online++;
+    heapTotal += u.live;
+    if (u.live > s.heapMax) {
+      s.heapMax = u.live;
+      s.heapMaxNode = i;
+    }
+    s.peakMax = std::max(s.peakMax, u.peak);
+    const std::map<String, StateEntry>& state = nodes[i]->mesh().simState();
+    keys += state.size();
+    s.keysMax = std::max(s.keysMax, state.size());
+    for (const auto& kv : state) orphans += retiredIds.count(kv.second.origin);
+    const MeshProto::StoreStats& store = nodes[i]->mesh().simStoreStats();
+    s.expired += store.expired;
+    s.evicted += store.evicted;
+    peers += nodes[i]->mesh().getPeerCount();
+    rx += net.received(i);
+  }
+  if (online > 0) {
+    s.heapAvg = heapTotal / online;
+    s.keysAvg = keys / online;
+    s.orphansAvg = orphans / online;
+    s.peersAvg = peers / online;
+    s.rxPerNodeSec = s.seconds > 0 ? rx / (double)online / s.seconds : 0;
+  }
+  if (peersExpected > 0) s.peerAccuracy = (double)peersSeen / peersExpected;
+  if (peerSamples > 0) s.ghostsAvg = (double)peerGhosts / peerSamples;
+  s.depth = net.maxDepth();
+  return s;
+}
+
+static void printText(const Summary& s) {
+  printf("\n=== MeshSwarm simulation ===\n");
+  printf("Nodes %u, zones %u, fanout %u, tree depth %u, sync %s\n", config.nodes, config.zones,
+         config.fanout, s.depth, config.deltaSync ? "delta" : "full");
+  printf("Heartbeat %s\n", config.adaptiveHeartbeat ? "adaptive" : "fixed");
+  if (config.linkBytesPerS) {
+    printf("Link %u B/s, %s queues", (unsigned)config.linkBytesPerS, config.lanes ? "lane" : "FIFO");
+    if (config.otaChunkMs) printf(", OTA chunk every %u ms", (unsigned)config.otaChunkMs);
+    printf("\n");
+  }
+  printf("Hop latency %u ms + 0..%u ms, loss %.1f%%, seed %u\n", (unsigned)config.latencyMs,
+         (unsigned)config.jitterMs, config.loss * 100.0f, (unsigned)config.seed);
+
+  printf("\n-- Boot (first %u s) --\n", (unsigned)(config.bootSeconds + SETTLE_MS / 1000));
+  for (uint8_t t = 1; t < SIM_MSG_TYPES; t++) {
+    if (bootStats[t].sent == 0) continue;
+    printf("  %-10s %8llu msgs %10llu B sent %12llu B on air\n", TYPE_NAMES[t],
+           (unsigned long long)bootStats[t].sent, (unsigned long long)bootStats[t].bytes,
+           (unsigned long long)bootStats[t].airBytes);
+  }
+
+  printf("\n-- Steady state (%.0f s) --\n", s.seconds);
+  printf("  %-10s %9s %10s %10s %12s\n", "type", "msgs/s", "B/s sent", "hops/s", "B/s on air");
+  for (uint8_t t = 1; t < SIM_MSG_TYPES; t++) {
+    const SimTypeStats& st = s.steady[t];
+    if (st.sent == 0) continue;
+    printf("  %-10s %9.1f %10.0f %10.0f %12.0f\n", TYPE_NAMES[t], st.sent / s.seconds,
+           st.bytes / s.seconds, st.hops / s.seconds, st.airBytes / s.seconds);
+  }
+  printf("  %-10s %9.1f %10.0f %10.0f %12.0f\n", "total", s.total.sent / s.seconds,
+         s.total.bytes / s.seconds, s.total.hops / s.seconds, s.total.airBytes / s.seconds);
+  printf("  Received per node: %.1f msgs/s, dropped copies: %llu\n", s.rxPerNodeSec,
+         (unsigned long long)s.total.dropped);
+
+  printf("\n-- Convergence --\n");
+  printf("  Probes: %zu/%zu complete, %.2f%% of node copies arrived\n", s.probesComplete,
+         probes.size(), s.coverage * 100.0);
+  printf("  Per node  p50 %u ms, p95 %u ms, max %u ms\n", percentile(probeLatencyMs, 0.5f),
+         percentile(probeLatencyMs, 0.95f), percentile(probeLatencyMs, 1.0f));
+  printf("  All nodes p50 %u ms, p95 %u ms, max %u ms\n", percentile(s.convergeMs, 0.5f),
+         percentile(s.convergeMs, 0.95f), percentile(s.convergeMs, 1.0f));
+  if (!rejoins.empty()) {
+    printf("  Rejoin sync: %zu/%zu caught up, p50 %u ms, max %u ms\n", s.joinsSynced, rejoins.size(),
+           percentile(s.joinSyncMs, 0.5f), percentile(s.joinSyncMs, 1.0f));
+    for (const Rejoin& r : rejoins) {
+      printf("    node %-4u %-8s %3zu keys behind  %s", r.node, nodes[r.node]->name(), r.behind,
+             r.synced ? "" : "not synced\n");
+      if (r.synced) printf("%u ms\n", (unsigned)((r.syncUs - r.joinUs) / 1000));
+    }
+  }
+
+  printf("\n-- Button -> LED --\n");
+  printf("  %zu deliveries, p50 %u ms, p95 %u ms, max %u ms\n", s.pressMs.size(),
+         percentile(s.pressMs, 0.5f), percentile(s.pressMs, 0.95f), percentile(s.pressMs, 1.0f));
+  if (config.linkBytesPerS) {
+    printf("\n-- Send queues (all nodes%s) --\n", config.lanes ? "" : ", one FIFO counted as bulk");
+    printf("  %-10s %10s %9s %10s %10s %7s\n", "lane", "sent", "overflow", "wait avg", "wait max", "depth");
+    for (uint8_t l = 0; l < MeshProto::LANES; l++) {
+      const MeshProto::LaneStats& ls = s.lanes[l];
+      if (ls.sent == 0 && ls.overflow == 0) continue;
+      printf("  %-10s %10u %9u %7u ms %7u ms %7u\n", MeshProto::laneName(l), (unsigned)ls.sent,
+             (unsigned)ls.overflow, (unsigned)ls.waitAvgMs(), (unsigned)ls.waitMaxMs, (unsigned)ls.depthMax);
+    }
+    printf("  OTA chunks %u, copies refused by full queues %llu\n", (unsigned)otaChunks,
+           (unsigned long long)s.overflow);
+  }
+
+  printf("\n-- Memory per node (MeshSwarm + MeshSwarmExt + behaviour) --\n");
+  printf("  Live avg %zu B, max %zu B (node %d %s); peak max %zu B\n", s.heapAvg, s.heapMax,
+         s.heapMaxNode, s.heapMaxNode >= 0 ? nodes[s.heapMaxNode]->name() : "-", s.peakMax);
+  printf("  State keys avg %zu, max %zu, alive peers avg %zu\n", s.keysAvg, s.keysMax, s.peersAvg);
+  printf("  Peer tables: %.2f%% of online peers alive, %.2f offline peers listed per node\n",
+         s.peerAccuracy * 100, s.ghostsAvg);
+  if (!retiredIds.empty() || config.stateTtlMs || config.stateMaxKeys) {
+    printf("  Retired %zu nodes: %zu of their keys left per node; expired %llu, evicted %llu\n",
+           retiredIds.size(), s.orphansAvg, (unsigned long long)s.expired, (unsigned long long)s.evicted);
+  }
+}
+
+static void printJson(const Summary& s) {
+  printf("{\"nodes\":%u,\"zones\":%u,\"fanout\":%u,\"depth\":%u,\"sync\":\"%s\",\"heartbeat\":\"%s\","
+         "\"latency_ms\":%u,\"jitter_ms\":%u,\"loss\":%.4f,\"seed\":%u,\"seconds\":%.1f,"
+         "\"link_bytes_s\":%u,\"lanes\":%s,\"ota_chunk_ms\":%u,",
+         config.nodes, config.zones, config.fanout, s.depth, config.deltaSync ? "delta" : "full",
+         config.adaptiveHeartbeat ? "adaptive" : "fixed",
+         (unsigned)config.latencyMs, (unsigned)config.jitterMs, config.loss, (unsigned)config.seed,
+         s.seconds, (unsigned)config.linkBytesPerS, config.lanes ? "true" : "false",
+         (unsigned)config.otaChunkMs);
+
+  printf("\"boot\":{");
+  bool first = true;
+  for (uint8_t t = 1; t < SIM_MSG_TYPES; t++) {
+    if (bootStats[t].sent == 0) continue;
+    printf("%s\"%s\":{\"msgs\":%llu,\"bytes\":%llu,\"air_bytes\":%llu}", first ? "" : ",",
+           TYPE_NAMES[t], (unsigned long long)bootStats[t].sent,
+           (unsigned long long)bootStats[t].bytes, (unsigned long long)bootStats[t].airBytes);
+    first = false;
+  }
+  printf("},\"steady\":{");
+  first = true;
+  for (uint8_t t = 1; t < SIM_MSG_TYPES; t++) {
+    const SimTypeStats& st = s.steady[t];
+    if (st.sent == 0) continue;
+    printf("%s\"%s\":{\"msgs_s\":%.2f,\"bytes_s\":%.1f,\"hops_s\":%.1f,\"air_bytes_s\":%.1f}",
+           first ? "" : ",", TYPE_NAMES[t], st.sent / s.seconds, st.bytes / s.seconds,
+           st.hops / s.seconds, st.airBytes / s.seconds);
+    first = false;
+  }
+  printf("},\"msgs_s\":%.2f,\"bytes_s\":%.1f,\"air_bytes_s\":%.1f,\"rx_node_s\":%.2f,\"dropped\":%llu,",
+         s.total.sent / s.seconds, s.total.bytes / s.seconds, s.total.airBytes / s.seconds,
+         s.rxPerNodeSec, (unsigned long long)s.total.dropped);
+
+  printf("\"convergence\":{\"probes\":%zu,\"complete\":%zu,\"coverage\":%.4f,"
+         "\"node_p50_ms\":%u,\"node_p95_ms\":%u,\"node_max_ms\":%u,"
+         "\"all_p50_ms\":%u,\"all_p95_ms\":%u,\"all_max_ms\":%u},",
+         probes.size(), s.probesComplete, s.coverage,
+         percentile(probeLatencyMs, 0.5f), percentile(probeLatencyMs, 0.95f), percentile(probeLatencyMs, 1.0f),
+         percentile(s.convergeMs, 0.5f), percentile(s.convergeMs, 0.95f), percentile(s.convergeMs, 1.0f));
+  printf("\"rejoin\":{\"count\":%zu,\"synced\":%zu,\"p50_ms\":%u,\"max_ms\":%u},",
+         rejoins.size(), s.joinsSynced, percentile(s.joinSyncMs, 0.5f), percentile(s.joinSyncMs, 1.0f));
+  printf("\"press\":{\"count\":%zu,\"p50_ms\":%u,\"p95_ms\":%u,\"max_ms\":%u},",
+         s.pressMs.size(), percentile(s.pressMs, 0.5f), percentile(s.pressMs, 0.95f),
+         percentile(s.pressMs, 1.0f));
+  printf("\"queues\":{");
+  for (uint8_t l = 0; l < MeshProto::LANES; l++) {
+    const MeshProto::LaneStats& ls = s.lanes[l];
+    printf("%s\"%s\":{\"sent\":%u,\"overflow\":%u,\"wait_avg_ms\":%u,\"wait_max_ms\":%u,\"depth_max\":%u}",
+           l ? "," : "", MeshProto::laneName(l), (unsigned)ls.sent, (unsigned)ls.overflow,
+           (unsigned)ls.waitAvgMs(), (unsigned)ls.waitMaxMs, (unsigned)ls.depthMax);
+  }
+  printf(",\"ota_chunks\":%u,\"overflow\":%llu},", (unsigned)otaChunks, (unsigned long long)s.overflow);
+  printf("\"memory\":{\"live_avg\":%zu,\"live_max\":%zu,\"peak_max\":%zu,\"keys_avg\":%zu,\"keys_max\":%zu,"
+         "\"peers_avg\":%zu,\"peer_accuracy\":%.4f,\"peer_ghosts\":%.2f},",
+         s.heapAvg, s.heapMax, s.peakMax, s.keysAvg, s.keysMax, s.peersAvg, s.peerAccuracy, s.ghostsAvg);
+  printf("\"state\":{\"retired\":%zu,\"orphans_avg\":%zu,\"expired\":%llu,\"evicted\":%llu}}\n",
+         retiredIds.size(), s.orphansAvg, (unsigned long long)s.expired, (unsigned long long)s.evicted);
+}
+
+// ============== MAIN ==============
+int main(int argc, char** argv) {
+  if (!parseArgs(argc, argv)) return 1;
+
+  SimHeap::reset(config.nodes);
+  SimNetwork net(config);
+  simNetwork = &net;
+
+  // Unique non-zero node ids, like painlessMesh's chip-derived ones
+  std::set<uint32_t> ids;
+  while (ids.size() < config.nodes) {
+    uint32_t id = net.rng()();
+    if (id != 0) ids.insert(id);
+  }
+  std::vector<uint32_t> idList(ids.begin(), ids.end());
+  std::shuffle(idList.begin(), idList.end(), net.rng());
+
+  nodes.reserve(config.nodes);
+  for (uint16_t i = 0; i < config.nodes; i++) {
+    String zone = String("zone") + String((unsigned long)(i % config.zones) + 1);
+    SimNode* node;
+    {
+      SimHeap::Scope scope(i);
+      node = simCreateNode(net, i, idList[i], zone, net.rng()());
+    }
+    uint16_t index = node->index();
+    nodeIndex[idList[i]] = index;
+    node->mesh().watchState(PROBE_KEY, [&net, index](const String& key, const String& value,
+                                                    const String& oldValue) {
+      onProbe(net, index, value);
+    });
+    nodes.push_back(node);
+  }
+
+  // Power-up times across the boot window
+  std::vector<std::pair<uint64_t, uint16_t>> boots;
+  std::uniform_int_distribution<uint64_t> bootAt(0, (uint64_t)config.bootSeconds * 1000000);
+  for (uint16_t i = 0; i < config.nodes; i++) boots.push_back({i == 0 ? 0 : bootAt(net.rng()), i});
+  std::sort(boots.begin(), boots.end());
+
+  const uint64_t measureStartUs = (uint64_t)config.bootSeconds * 1000000 + SETTLE_MS * 1000ULL;
+  const uint64_t endUs = std::max<uint64_t>((uint64_t)config.seconds * 1000000, measureStartUs + 10000000);
+  const uint64_t measureUs = endUs - measureStartUs;
+
+  // Rejoins spread over the first half of the measure phase (so they can finish)
+  std::vector<uint16_t> order;
+  for (uint16_t i = 1; i < config.nodes; i++) order.push_back(i);
+  std::shuffle(order.begin(), order.end(), net.rng());
+  for (uint16_t r = 0; r < config.rejoins && r < order.size(); r++) {
+    Rejoin rj;
+    rj.node = order[r];
+    rj.leaveUs = measureStartUs + (measureUs / 2) * (r + 1) / (config.rejoins + 1);
+    rj.joinUs = rj.leaveUs + REJOIN_OFFLINE_MS * 1000ULL;
+    rejoins.push_back(rj);
+  }
+
+  // Retirements over the first quarter, from nodes that don't rejoin
+  std::vector<std::pair<uint64_t, uint16_t>> retires;
+  for (uint16_t r = 0; r < config.retire && config.rejoins + r < order.size(); r++) {
+    retires.push_back({measureStartUs + (measureUs / 4) * r / std::max(1, (int)config.retire),
+                       order[config.rejoins + r]});
+  }
+  size_t nextRetire = 0;
+  uint64_t nextSampleUs = measureStartUs;
+  uint64_t nextOtaUs = measureStartUs;
+
+  size_t nextBoot = 0;
+  uint64_t nextProbeUs = measureStartUs;
+  bool measuring = false;
+
+  auto afterTick = [&]() {
+    uint64_t now = net.nowUs();
+
+    while (nextBoot < boots.size() && boots[nextBoot].first <= now) {
+      nodes[boots[nextBoot].second]->boot();
+      nextBoot++;
+    }
+
+    if (!measuring && now >= measureStartUs) {
+      measuring = true;
+      for (uint8_t t = 0; t < SIM_MSG_TYPES; t++) bootStats[t] = net.stats(t);
+      net.resetStats();
+      simPressLatencies().clear();
+    }
+    if (!measuring) return;
+
+    if (config.otaChunkMs && now >= nextOtaUs) {
+      sendOtaChunk(net);
+      nextOtaUs += (uint64_t)config.otaChunkMs * 1000;
+    }
+
+    if (probes.size() < config.probes && now >= nextProbeUs &&
+        now + (uint64_t)config.probeIntervalMs * 1000 <= endUs) {
+      startProbe(net);
+      nextProbeUs += (uint64_t)config.probeIntervalMs * 1000;
+    }
+
+    if (now >= nextSampleUs) {
+      sampleMembership(net);
+      nextSampleUs += MEMBERSHIP_SAMPLE_MS * 1000ULL;
+    }
+
+    while (nextRetire < retires.size() && retires[nextRetire].first <= now) {
+      uint16_t node = retires[nextRetire].second;
+      net.leave(node);
+      dropFromProbe(node);
+      retiredIds.insert(nodes[node]->mesh().getNodeId());
+      nextRetire++;
+    }
+
+    for (Rejoin& r : rejoins) {
+      if (!r.joined && net.online(r.node) && now >= r.leaveUs && now < r.joinUs) {
+        net.leave(r.node);
+        dropFromProbe(r.node);
+      } else if (!r.joined && !net.online(r.node) && now >= r.joinUs) {
+        markRejoined(net, r);
+        r.joined = true;
+        nodes[r.node]->boot();
+      }
+      if (r.joined && !r.synced && caughtUp(r)) {
+        r.synced = true;
+        r.syncUs = now;
+      }
+    }
+  };
+
+  net.run(endUs, afterTick);
+
+  Summary s = summarize(net, measureStartUs);
+  if (jsonOutput) {
+    printJson(s);
+  } else {
+    printText(s);
+  }
+  return 0;
+}
@@ -15,11 +15,24 @@
  *     - VCC -> 3.3V (AM312) or 5V (HC-SR501)
  *     - GND -> GND
  *     - OUT -> GPIO4
+ *
+ * Motion is edge-triggered (PIR_USE_INTERRUPT): the rising edge is
+ * published on the next loop pass, and "clear" is only reported after
+ * MOTION_WINDOW_MS without activity. Between passes the loop yields
+ * instead of spinning; with PIR_LIGHT_SLEEP the idle time becomes
+ * automatic light sleep, woken by the PIR pin.
  */
 
 #include <Arduino.h>
 #include <MeshSwarm.h>
+#include <PerfStats.h>
+#include <BroadcastOta.h>
+#include <FastBoot.h>
 #include <esp_ota_ops.h>
+#include <esp_idf_version.h>
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
 
 // ============== BUILD-TIME CONFIGURATION ==============
 // These can be overridden in platformio.ini build_flags
@@ -63,8 +76,26 @@
 #define MOTION_WINDOW_MS  10000     // 10 second evaluation window
 #endif
 
+// Edge interrupt: report motion at once, window only the "clear" (0 = poll)
+#ifndef PIR_USE_INTERRUPT
+#define PIR_USE_INTERRUPT 1
+#endif
+
+// Loop yield between passes in interrupt mode
+#ifndef PIR_IDLE_MS
+#define PIR_IDLE_MS       10
+#endif
+
+// Let the CPU light-sleep while idle (battery leaf nodes). Needs power
+// management in the SDK build; skipped while this node is coordinator
+#ifndef PIR_LIGHT_SLEEP
+#define PIR_LIGHT_SLEEP   0
+#endif
+
 // ============== GLOBALS ==============
+FastBoot fastBoot;
 MeshSwarm swarm;
+OtaBroadcastReceiver otaReceiver;
 
 // PIR state - time window approach
 bool pirReady = false;
@@ -74,7 +105,108 @@ unsigned long lastWindowCheck = 0;    // Last window evaluation time
 unsigned long motionCount = 0;
 unsigned long bootTime = 0;
 
+#if PIR_USE_INTERRUPT
+// Written by the ISR
+volatile bool pirEdge = false;            // Rising edge since last pass
+volatile unsigned long pirEdgeTime = 0;   // millis() of that edge
+
+unsigned long lastMotionTime = 0;         // Last edge or HIGH level seen
+bool lightSleepActive = false;
+
+void IRAM_ATTR onPirEdge() {
+  pirEdge = true;
+  pirEdgeTime = millis();
+}
+#endif
+
 // ============== PIR HANDLING ==============
+void publishMotion(bool motion) {
+  lastReportedMotion = motion;
+
+  String zoneKey = String("motion_") + MOTION_ZONE;
+  swarm.setStates({{"motion", motion ? "1" : "0"}, {zoneKey, motion ? "1" : "0"}});
+
+  if (motion) {
+    motionCount++;
+    Serial.printf("[PIR] Motion DETECTED (#%lu)\n", motionCount);
+  } else {
+    Serial.println("[PIR] Motion cleared");
+  }
+}
+
+#if PIR_USE_INTERRUPT
+
+void pollPir() {
+  if (!pirReady) return;
+
+  unsigned long now = millis();
+
+  // The ISR catches short pulses; the level covers edges lost in light
+  // sleep and sensors that hold OUT high while retriggered
+  if (pirEdge) {
+    pirEdge = false;
+    lastMotionTime = pirEdgeTime;
+    motionDetectedInWindow = true;
+  }
+  if (digitalRead(PIR_PIN) == HIGH) {
+    lastMotionTime = now;
+    motionDetectedInWindow = true;
+  }
+
+  if (motionDetectedInWindow && !lastReportedMotion) {
+    // Transition: no motion → motion, published immediately
+    publishMotion(true);
+  }
+  else if (lastReportedMotion && now - lastMotionTime >= MOTION_WINDOW_MS) {
+    // Transition: motion → no motion after a quiet window
+    publishMotion(false);
+    motionDetectedInWindow = false;
+  }
+  lastWindowCheck = now;
+}
+
+// Enable automatic light sleep while this node is not coordinator
+// (and not taking a broadcast OTA, which wants every chunk on its first pass)
+void updateSleepPolicy() {
+#if PIR_LIGHT_SLEEP && defined(CONFIG_PM_ENABLE) && defined(CONFIG_FREERTOS_USE_TICKLESS_IDLE)
+  bool allowed = pirReady && !swarm.isCoordinator() && !otaReceiver.active();
+  if (allowed == lightSleepActive) return;
+
+#if ESP_IDF_VERSION_MAJOR >= 5
+  esp_pm_config_t cfg;
+#elif CONFIG_IDF_TARGET_ESP32S3
+  esp_pm_config_esp32s3_t cfg;
+#else
+  esp_pm_config_esp32_t cfg;
+#endif
+  cfg.max_freq_mhz = getCpuFrequencyMhz();
+  cfg.min_freq_mhz = 80;
+  cfg.light_sleep_enable = allowed;
+  if (esp_pm_configure(&cfg) == ESP_OK) {
+    lightSleepActive = allowed;
+    Serial.printf("[PIR] Light sleep %s\n", allowed ? "enabled" : "disabled (coordinator/OTA)");
+  }
+#endif
+}
+
+// Yield until the next pass; the PIR pin ends a light sleep early
+void pirIdle() {
+  if (pirEdge) return;
+
+#if PIR_LIGHT_SLEEP
+  if (lightSleepActive) {
+    // Wake on the level opposite to the current one, so a held HIGH
+    // output doesn't keep the chip awake
+    bool high = digitalRead(PIR_PIN) == HIGH;
+    gpio_wakeup_enable((gpio_num_t)PIR_PIN, high ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+  }
+#endif
+
+  delay(PIR_IDLE_MS);
+}
+
+#else
+
 void pollPir() {
   if (!pirReady) return;
 
@@ -91,22 +223,11 @@ void pollPir() {
 
     if (motionDetectedInWindow && !lastReportedMotion) {
       // Transition: no motion → motion
-      lastReportedMotion = true;
-      motionCount++;
-
-      String zoneKey = String("motion_") + MOTION_ZONE;
-      swarm.setStates({{"motion", "1"}, {zoneKey, "1"}});
-
-      Serial.printf("[PIR] Motion DETECTED (#%lu)\n", motionCount);
+      publishMotion(true);
     }
     else if (!motionDetectedInWindow && lastReportedMotion) {
       // Transition: motion → no motion
-      lastReportedMotion = false;
-
-      String zoneKey = String("motion_") + MOTION_ZONE;
-      swarm.setStates({{"motion", "0"}, {zoneKey, "0"}});
-
-      Serial.println("[PIR] Motion cleared");
+      publishMotion(false);
     }
 
     // Reset window
@@ -114,17 +235,24 @@ void pollPir() {
   }
 }
 
+#endif // PIR_USE_INTERRUPT
+
 // ============== SETUP ==============
 void setup() {
+  fastBoot.begin();
   Serial.begin(115200);
 
   // Mark OTA partition as valid (enables automatic rollback on boot failure)
   esp_ota_mark_app_valid_cancel_rollback();
 
   swarm.begin(NODE_NAME);
+  perfStats.attach(swarm);
   swarm.enableTelemetry(true);
   swarm.enableOTAReceive(NODE_TYPE);
+  otaReceiver.begin(swarm, NODE_TYPE);  // Broadcast jobs; resumes a saved session
   bootTime = millis();
+  fastBoot.mark("mesh");
+  fastBoot.attach(swarm);
 
   // Enable display sleep with boot button wake
   swarm.enableDisplaySleep(PIR_DISPLAY_SLEEP_MS);
@@ -136,17 +264,35 @@ void setup() {
   Serial.printf("[PIR] GPIO: %d\n", PIR_PIN);
   Serial.printf("[PIR] Zone: %s\n", MOTION_ZONE);
   Serial.printf("[PIR] Window: %dms\n", MOTION_WINDOW_MS);
+#if PIR_USE_INTERRUPT
+  Serial.println("[PIR] Mode: edge interrupt");
+#else
+  Serial.println("[PIR] Mode: polled window");
+#endif
 
-  // PIR warmup
-  Serial.printf("[PIR] Warming up (%d seconds)...\n", WARMUP_SEC);
-  for (int i = WARMUP_SEC; i > 0; i--) {
-    Serial.printf("%d ", i);
-    if (i % 10 == 0 && i != WARMUP_SEC) Serial.println();
-    delay(1000);
+  // PIR warmup. The sensor keeps its own supply through a software, panic
+  // or watchdog reset, so it is already settled on a warm boot; a brownout
+  // may have taken it down with the ESP32
+  if (fastBoot.isWarmBoot() && !fastBoot.wasBrownout()) {
+    Serial.printf("[PIR] Warm boot (%s), skipping warmup\n", fastBoot.resetReason());
+  } else {
+    Serial.printf("[PIR] Warming up (%d seconds)...\n", WARMUP_SEC);
+    for (int i = WARMUP_SEC; i > 0; i--) {
+      Serial.printf("%d ", i);
+      if (i % 10 == 0 && i != WARMUP_SEC) Serial.println();
+      delay(1000);
+    }
+    Serial.println();
   }
-  Serial.println();
+  fastBoot.mark("warmup");
   pirReady = true;
   lastWindowCheck = millis();  // Start first window now
+#if PIR_USE_INTERRUPT
+  attachInterrupt(digitalPinToInterrupt(PIR_PIN), onPirEdge, RISING);
+#if PIR_LIGHT_SLEEP
+  esp_sleep_enable_gpio_wakeup();
+#endif
+#endif
   Serial.println("[PIR] Ready!");
   Serial.println();
 
@@ -154,6 +300,7 @@ void setup() {
   String zoneKey = String("motion_") + MOTION_ZONE;
   swarm.setStates({{"motion", "0"}, {zoneKey, "0"}});
   Serial.println("[PIR] Initial state: no motion");
+  fastBoot.markOnce("first_state");
 
   // Register PIR polling in loop
   swarm.onLoop(pollPir);
@@ -173,6 +320,9 @@ void setup() {
       Serial.printf("Event count: %lu\n", motionCount);
       Serial.printf("Last check: %lu sec ago\n", secSinceCheck);
       Serial.printf("Window: %dms\n", MOTION_WINDOW_MS);
+#if PIR_USE_INTERRUPT
+      Serial.printf("Mode: interrupt, light sleep %s\n", lightSleepActive ? "on" : "off");
+#endif
       Serial.printf("Zone: %s\n", MOTION_ZONE);
       Serial.printf("Raw pin: %s\n", digitalRead(PIR_PIN) ? "HIGH" : "LOW");
       Serial.println();
@@ -209,4 +359,8 @@ void setup() {
 // ============== MAIN LOOP ==============
 void loop() {
   swarm.update();
+#if PIR_USE_INTERRUPT
+  updateSleepPolicy();
+  pirIdle();
+#endif
 }
@@ -25,7 +25,14 @@
 
 #include <Arduino.h>
 #include <MeshSwarm.h>
+#include <PerfStats.h>
+#include <BroadcastOta.h>
 #include <TFT_eSPI.h>
+#include <Widget.h>
+#include <DisplayPipeline.h>
+#include <StateCache.h>
+#include <PeerView.h>
+#include <FastBoot.h>
 #include <esp_ota_ops.h>
 
 // ============== BUILD-TIME CONFIGURATION ==============
@@ -51,6 +58,14 @@
 #define NODE_BUTTON_HEIGHT 50
 #define NODE_BUTTON_MARGIN 5
 #define NODES_PER_PAGE 5
+#define STATE_ROWS 8
+#define STATE_ROW_HEIGHT 20
+#define NO_STATE_HEIGHT 45
+
+// Off-screen tile for widget repaints: fits every widget but the view panels
+// (tallest is a node button, 45 px). 240x48 = 23 KB, plus two 11.5 KB DMA buffers.
+#define UI_TILE_HEIGHT 48
+#define UI_DMA_BUFFER_PIXELS (TFT_WIDTH * 24)
 
 // Colors (RGB565)
 #define COLOR_BG 0x0000        // Black
@@ -62,8 +77,13 @@
 #define COLOR_DETAIL_BG 0x18E3 // Dark gray
 
 // ============== GLOBALS ==============
+FastBoot fastBoot;
 MeshSwarm swarm;
+OtaBroadcastReceiver otaReceiver;
 TFT_eSPI tft = TFT_eSPI();
+DisplayPipeline pipeline;
+TFT_eSprite uiTile = TFT_eSprite(&tft);
+bool uiTiled = false;  // Tile allocated; otherwise widgets draw straight to the panel
 
 // UI State
 enum ViewMode {
@@ -75,25 +95,29 @@ ViewMode currentView = VIEW_NODE_LIST;
 uint32_t selectedNodeId = 0;
 String selectedNodeName = "";
 
-// State cache for detail view
-struct StateItem {
-  String key;
-  String value;
-  uint32_t origin;
-};
-std::vector<StateItem> stateCache;
+// State cache for detail view (hashed, slots are stable until cleared)
+StateCache stateCache;
+
+// Alive peers in id order, for paging the node list
+PeerView peerView;
+uint8_t listPage = 0;
+
+void updateStateCache() {
+  stateCache.clear();
+
+  // Use state watcher approach - we'll collect all state we see
+  // For now, just note that state is tracked via watchers
+  // In a future enhancement, we could expose getSharedState() in MeshSwarm
+}
 
 // Touch handling
 unsigned long lastTouchTime = 0;
 #define TOUCH_DEBOUNCE 250
 
-// Display refresh
+// Polling of unbound data (uptime, peer list)
 unsigned long lastDisplayUpdate = 0;
 #define DISPLAY_UPDATE_INTERVAL 1000
 
-// Track state changes for refresh
-bool stateChanged = false;
-
 // ============== TOUCH HANDLING ==============
 
 struct TouchPoint {
@@ -107,6 +131,7 @@ TouchPoint getTouch() {
   tp.valid = false;
   
   uint16_t touchX = 0, touchY = 0;
+  pipeline.finish();  // Touch controller shares the SPI bus with the panel
   bool pressed = tft.getTouch(&touchX, &touchY, TOUCH_THRESHOLD);
   
   if (pressed) {
@@ -122,209 +147,410 @@ TouchPoint getTouch() {
   return tp;
 }
 
-// ============== DISPLAY RENDERING ==============
+// ============== WIDGETS ==============
+// Each widget caches what it last drew; refresh() compares against the
+// mesh and returns true only when the pixels would change.
 
-void drawHeader() {
-  tft.fillRect(0, 0, TFT_WIDTH, HEADER_HEIGHT, COLOR_HEADER);
-  tft.setTextColor(COLOR_TEXT, COLOR_HEADER);
-  tft.setTextSize(1);
-  
-  // Title
-  tft.setCursor(5, 5);
-  tft.print("MeshSwarm Remote");
-  
-  // Network info
-  int peers = swarm.getPeerCount();
-  unsigned long uptime = millis() / 1000;
-  tft.setCursor(5, 17);
-  tft.printf("Peers:%d Up:%02d:%02d", peers, uptime/60, uptime%60);
-}
+void showNodeList();
+void showNodeDetail(uint32_t nodeId, const String& nodeName);
 
-void drawNodeList() {
-  // Clear main area
-  tft.fillRect(0, HEADER_HEIGHT, TFT_WIDTH, TFT_HEIGHT - HEADER_HEIGHT, COLOR_BG);
-  
-  // Get list of peers - Peer is in global namespace, not MeshSwarm::
-  std::map<uint32_t, Peer>& peers = swarm.getPeers();
-  
-  if (peers.empty()) {
-    tft.setTextColor(COLOR_TEXT, COLOR_BG);
-    tft.setTextSize(2);
-    tft.setCursor(20, 120);
-    tft.print("No nodes found");
-    tft.setTextSize(1);
-    tft.setCursor(20, 145);
-    tft.print("Waiting for mesh...");
-    return;
+// Filled background for a view's main area
+class PanelWidget : public Widget {
+public:
+  PanelWidget(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+    : Widget(x, y, w, h), _color(color) {}
+
+  void draw(TFT_eSPI& g) override {
+    g.fillRect(_x, _y, _w, _h, _color);
   }
-  
-  // Draw node buttons
-  int yPos = HEADER_HEIGHT + NODE_BUTTON_MARGIN;
-  int nodeIndex = 0;
-  
-  for (auto& kv : peers) {
-    if (!kv.second.alive) continue;
-    if (nodeIndex >= NODES_PER_PAGE) break;
-    
-    uint32_t nodeId = kv.first;
-    String nodeName = kv.second.name;
-    String nodeRole = kv.second.role;
-    
-    // Draw button
+
+private:
+  uint16_t _color;
+};
+
+// Header bar with title (static)
+class HeaderWidget : public Widget {
+public:
+  HeaderWidget() : Widget(0, 0, TFT_WIDTH, HEADER_HEIGHT) {}
+
+  void draw(TFT_eSPI& g) override {
+    g.fillRect(_x, _y, _w, _h, COLOR_HEADER);
+    g.setTextColor(COLOR_TEXT, COLOR_HEADER);
+    g.setTextSize(1);
+    g.setCursor(_x + 5, _y + 5);
+    g.print("MeshSwarm Remote");
+  }
+};
+
+// Network info line inside the header
+class StatusWidget : public Widget {
+public:
+  StatusWidget() : Widget(5, 17, TFT_WIDTH - 10, 8), _peers(-1), _uptime(0) {}
+
+  bool refresh() override {
+    int peers = swarm.getPeerCount();
+    unsigned long uptime = millis() / 1000;
+    if (peers == _peers && uptime == _uptime) return false;
+    _peers = peers;
+    _uptime = uptime;
+    return true;
+  }
+
+  void draw(TFT_eSPI& g) override {
+    g.fillRect(_x, _y, _w, _h, COLOR_HEADER);
+    g.setTextColor(COLOR_TEXT, COLOR_HEADER);
+    g.setTextSize(1);
+    g.setCursor(_x, _y);
+    g.printf("Peers:%d Up:%02lu:%02lu", _peers, _uptime / 60, _uptime % 60);
+  }
+
+private:
+  int _peers;
+  unsigned long _uptime;
+};
+
+// "No nodes found" placeholder, shown while no peer is alive
+class EmptyListWidget : public Widget {
+public:
+  EmptyListWidget() : Widget(20, 120, 200, 35), _empty(true) {}
+
+  bool refresh() override {
+    bool empty = peerView.empty();
+    if (empty == _empty) return false;
+    _empty = empty;
+    return true;
+  }
+
+  void draw(TFT_eSPI& g) override {
+    g.fillRect(_x, _y, _w, _h, COLOR_BG);
+    if (!_empty) return;
+    g.setTextColor(COLOR_TEXT, COLOR_BG);
+    g.setTextSize(2);
+    g.setCursor(_x, _y);
+    g.print("No nodes found");
+    g.setTextSize(1);
+    g.setCursor(_x, _y + 25);
+    g.print("Waiting for mesh...");
+  }
+
+private:
+  bool _empty;
+};
+
+// One node button slot in the list (shows peer page * NODES_PER_PAGE + slot)
+class NodeButtonWidget : public Widget {
+public:
+  explicit NodeButtonWidget(uint8_t slot)
+    : Widget(NODE_BUTTON_MARGIN,
+             HEADER_HEIGHT + NODE_BUTTON_MARGIN + slot * NODE_BUTTON_HEIGHT,
+             TFT_WIDTH - 2 * NODE_BUTTON_MARGIN,
+             NODE_BUTTON_HEIGHT - NODE_BUTTON_MARGIN)
+    , _slot(slot), _present(false), _nodeId(0), _index(-1), _generation(0) {}
+
+  bool refresh() override {
+    int index = listPage * NODES_PER_PAGE + _slot;
+    if (index == _index && peerView.generation() == _generation) return false;
+    _index = index;
+    _generation = peerView.generation();
+
+    bool present = (size_t)index < peerView.size();
+    if (!present && !_present) return false;
+    _present = present;
+    if (present) {
+      const PeerView::Entry& peer = peerView.at(index);
+      const char* name = peerView.name(peer);
+      const char* role = peerView.role(peer);
+      if (peer.id == _nodeId && _name == name && _role == role) return false;
+      _nodeId = peer.id;
+      _name = name;
+      _role = role;
+    } else {
+      _nodeId = 0;
+    }
+    return true;
+  }
+
+  void draw(TFT_eSPI& g) override {
+    if (!_present) {
+      g.fillRect(_x, _y, _w, _h, COLOR_BG);
+      return;
+    }
     uint16_t btnColor = COLOR_NODE_BTN;
-    tft.fillRoundRect(NODE_BUTTON_MARGIN, yPos, 
-                      TFT_WIDTH - 2*NODE_BUTTON_MARGIN, 
-                      NODE_BUTTON_HEIGHT - NODE_BUTTON_MARGIN,
-                      5, btnColor);
-    
-    // Draw text
-    tft.setTextColor(COLOR_BG, btnColor);
-    tft.setTextSize(2);
-    tft.setCursor(NODE_BUTTON_MARGIN + 10, yPos + 8);
-    tft.print(nodeName);
-    
-    tft.setTextSize(1);
-    tft.setCursor(NODE_BUTTON_MARGIN + 10, yPos + 30);
-    tft.printf("Role: %s", nodeRole.c_str());
-    
-    yPos += NODE_BUTTON_HEIGHT;
-    nodeIndex++;
+    // Corners outside the rounding, so the widget stays opaque
+    g.fillRect(_x, _y, _w, 5, COLOR_BG);
+    g.fillRect(_x, _y + _h - 5, _w, 5, COLOR_BG);
+    g.fillRoundRect(_x, _y, _w, _h, 5, btnColor);
+
+    g.setTextColor(COLOR_BG, btnColor);
+    g.setTextSize(2);
+    g.setCursor(_x + 10, _y + 8);
+    g.print(_name);
+
+    g.setTextSize(1);
+    g.setCursor(_x + 10, _y + 30);
+    g.printf("Role: %s", _role.c_str());
   }
-}
 
-void updateStateCache() {
-  stateCache.clear();
-  
-  // Use state watcher approach - we'll collect all state we see
-  // For now, just note that state is tracked via watchers
-  // In a future enhancement, we could expose getSharedState() in MeshSwarm
-}
+  bool onTouch(int16_t x, int16_t y) override {
+    if (!_present) return false;
+    showNodeDetail(_nodeId, _name);
+    return true;
+  }
 
-void drawNodeDetail() {
-  // Clear main area
-  tft.fillRect(0, HEADER_HEIGHT, TFT_WIDTH, TFT_HEIGHT - HEADER_HEIGHT - FOOTER_HEIGHT, COLOR_DETAIL_BG);
-  
-  // Node title
-  tft.setTextColor(COLOR_TEXT, COLOR_DETAIL_BG);
-  tft.setTextSize(2);
-  tft.setCursor(10, HEADER_HEIGHT + 10);
-  tft.print(selectedNodeName);
-  
-  int yPos = HEADER_HEIGHT + 40;
-  
-  tft.setTextSize(1);
-  tft.setCursor(10, yPos);
-  
-  if (stateCache.empty()) {
-    tft.print("No state data");
-    tft.setCursor(10, yPos + 20);
-    tft.print("State updates will");
-    tft.setCursor(10, yPos + 35);
-    tft.print("appear here...");
-  } else {
-    int shown = 0;
-    const int maxEntries = 8;
-    
-    for (auto& item : stateCache) {
-      if (shown >= maxEntries) break;
-      
-      tft.setCursor(10, yPos);
-      tft.setTextColor(COLOR_NODE_ACTIVE, COLOR_DETAIL_BG);
-      tft.print(item.key);
-      tft.print(": ");
-      tft.setTextColor(COLOR_TEXT, COLOR_DETAIL_BG);
-      tft.print(item.value);
-      
-      yPos += 20;
-      shown++;
+private:
+  uint8_t _slot;
+  bool _present;
+  uint32_t _nodeId;
+  int _index;
+  uint32_t _generation;
+  String _name;
+  String _role;
+};
+
+// Page indicator and prev/next in the list footer (blank with one page)
+class PagerWidget : public Widget {
+public:
+  PagerWidget() : Widget(0, TFT_HEIGHT - FOOTER_HEIGHT, TFT_WIDTH, FOOTER_HEIGHT), _page(0), _pages(1) {}
+
+  bool refresh() override {
+    uint8_t pages = peerView.pageCount(NODES_PER_PAGE);
+    if (listPage >= pages) listPage = pages - 1;
+    if (pages == _pages && listPage == _page) return false;
+    _pages = pages;
+    _page = listPage;
+    return true;
+  }
+
+  void draw(TFT_eSPI& g) override {
+    g.fillRect(_x, _y, _w, _h, COLOR_BG);
+    if (_pages <= 1) return;
+    g.setTextColor(COLOR_TEXT, COLOR_BG);
+    g.setTextSize(2);
+    g.setCursor(_x + 10, _y + 12);
+    g.print("<");
+    g.setCursor(_x + _w - 22, _y + 12);
+    g.print(">");
+    g.setCursor(_x + _w / 2 - 24, _y + 12);
+    g.printf("%u/%u", (unsigned)(_page + 1), (unsigned)_pages);
+  }
+
+  bool onTouch(int16_t x, int16_t y) override;
+
+private:
+  uint8_t _page;
+  uint8_t _pages;
+};
+
+// Selected node's name at the top of the detail view
+class DetailTitleWidget : public Widget {
+public:
+  DetailTitleWidget() : Widget(10, HEADER_HEIGHT + 10, TFT_WIDTH - 20, 16) {}
+
+  void draw(TFT_eSPI& g) override {
+    g.fillRect(_x, _y, _w, _h, COLOR_DETAIL_BG);
+    g.setTextColor(COLOR_TEXT, COLOR_DETAIL_BG);
+    g.setTextSize(2);
+    g.setCursor(_x, _y);
+    g.print(selectedNodeName);
+  }
+};
+
+// "No state data" placeholder, painted before the state rows it overlaps
+class NoStateWidget : public Widget {
+public:
+  NoStateWidget() : Widget(10, HEADER_HEIGHT + 40, TFT_WIDTH - 20, NO_STATE_HEIGHT), _empty(true) {}
+
+  bool refresh() override {
+    bool empty = stateCache.empty();
+    if (empty == _empty) return false;
+    _empty = empty;
+    return true;
+  }
+
+  void draw(TFT_eSPI& g) override {
+    g.fillRect(_x, _y, _w, _h, COLOR_DETAIL_BG);
+    if (!_empty) return;
+    g.setTextColor(COLOR_TEXT, COLOR_DETAIL_BG);
+    g.setTextSize(1);
+    g.setCursor(_x, _y);
+    g.print("No state data");
+    g.setCursor(_x, _y + 20);
+    g.print("State updates will");
+    g.setCursor(_x, _y + 35);
+    g.print("appear here...");
+  }
+
+private:
+  bool _empty;
+};
+
+// One key/value row of the detail view (shows stateCache[slot])
+class StateRowWidget : public Widget {
+public:
+  explicit StateRowWidget(uint8_t slot)
+    : Widget(10, HEADER_HEIGHT + 40 + slot * STATE_ROW_HEIGHT, TFT_WIDTH - 20, 8)
+    , _slot(slot), _present(false), _changes(0) {}
+
+  bool refresh() override {
+    // The slot's change counter says whether it changed; no string compares
+    bool present = stateCache.used(_slot);
+    uint16_t changes = present ? stateCache.at(_slot).changes : 0;
+    if (present == _present && changes == _changes) return false;
+    _present = present;
+    _changes = changes;
+    return true;
+  }
+
+  void draw(TFT_eSPI& g) override {
+    if (!_present) {
+      // A removed key clears its row, except under the "No state data" text
+      // once the cache is empty (that widget paints first)
+      if (!underPlaceholder()) g.fillRect(_x, _y, _w, _h, COLOR_DETAIL_BG);
+      return;
     }
+    const StateCache::Item& item = stateCache.at(_slot);
+    g.fillRect(_x, _y, _w, _h, COLOR_DETAIL_BG);
+    g.setTextSize(1);
+    g.setCursor(_x, _y);
+    g.setTextColor(COLOR_NODE_ACTIVE, COLOR_DETAIL_BG);
+    g.print(item.key);
+    g.print(": ");
+    g.setTextColor(COLOR_TEXT, COLOR_DETAIL_BG);
+    g.print(item.value);
   }
-  
-  // Draw footer (back button)
-  tft.fillRect(0, TFT_HEIGHT - FOOTER_HEIGHT, TFT_WIDTH, FOOTER_HEIGHT, COLOR_FOOTER);
-  tft.setTextColor(COLOR_TEXT, COLOR_FOOTER);
-  tft.setTextSize(2);
-  tft.setCursor(TFT_WIDTH/2 - 30, TFT_HEIGHT - FOOTER_HEIGHT + 12);
-  tft.print("< BACK");
-}
 
-void updateDisplay() {
-  drawHeader();
-  
-  switch (currentView) {
-    case VIEW_NODE_LIST:
-      drawNodeList();
-      break;
-    case VIEW_NODE_DETAIL:
-      drawNodeDetail();
-      break;
+  bool isOpaque() const override { return _present || !underPlaceholder(); }
+
+  /**
+   * Forget the drawn state (the cache was cleared)
+   */
+  void reset() { _present = false; _changes = 0; }
+
+private:
+  uint8_t _slot;
+  bool _present;
+  uint16_t _changes;
+
+  bool underPlaceholder() const {
+    return stateCache.empty() && _slot * STATE_ROW_HEIGHT < NO_STATE_HEIGHT;
+  }
+};
+
+// Footer back button
+class BackButtonWidget : public Widget {
+public:
+  BackButtonWidget() : Widget(0, TFT_HEIGHT - FOOTER_HEIGHT, TFT_WIDTH, FOOTER_HEIGHT) {}
+
+  void draw(TFT_eSPI& g) override {
+    g.fillRect(_x, _y, _w, _h, COLOR_FOOTER);
+    g.setTextColor(COLOR_TEXT, COLOR_FOOTER);
+    g.setTextSize(2);
+    g.setCursor(_x + _w / 2 - 30, _y + 12);
+    g.print("< BACK");
   }
+
+  bool onTouch(int16_t x, int16_t y) override {
+    showNodeList();
+    Serial.println("[TOUCH] Back to node list");
+    return true;
+  }
+};
+
+WidgetTree ui;
+FrameScheduler frames;
+
+HeaderWidget headerWidget;
+StatusWidget statusWidget;
+PanelWidget listPanel(0, HEADER_HEIGHT, TFT_WIDTH, TFT_HEIGHT - HEADER_HEIGHT, COLOR_BG);
+EmptyListWidget emptyListWidget;
+NodeButtonWidget nodeButtons[NODES_PER_PAGE] = {
+  NodeButtonWidget(0), NodeButtonWidget(1), NodeButtonWidget(2),
+  NodeButtonWidget(3), NodeButtonWidget(4)
+};
+PanelWidget detailPanel(0, HEADER_HEIGHT, TFT_WIDTH, TFT_HEIGHT - HEADER_HEIGHT - FOOTER_HEIGHT, COLOR_DETAIL_BG);
+DetailTitleWidget detailTitle;
+NoStateWidget noStateWidget;
+StateRowWidget stateRows[STATE_ROWS] = {
+  StateRowWidget(0), StateRowWidget(1), StateRowWidget(2), StateRowWidget(3),
+  StateRowWidget(4), StateRowWidget(5), StateRowWidget(6), StateRowWidget(7)
+};
+BackButtonWidget backButton;
+PagerWidget pager;
+
+bool PagerWidget::onTouch(int16_t x, int16_t y) {
+  if (_pages <= 1) return false;
+  if (x < TFT_WIDTH / 3 && listPage > 0) {
+    listPage--;
+  } else if (x > TFT_WIDTH * 2 / 3 && listPage + 1 < _pages) {
+    listPage++;
+  } else {
+    return true;
+  }
+  // Page change: each button looks up its peer by position, O(1)
+  for (auto& button : nodeButtons) {
+    button.markStale();
+  }
+  markStale();
+  frames.request();
+  return true;
 }
 
-// ============== TOUCH EVENT HANDLERS ==============
+// ============== VIEWS ==============
 
-void handleTouchNodeList(int16_t x, int16_t y) {
-  // Check if touch is in node button area
-  if (y < HEADER_HEIGHT || y > TFT_HEIGHT) return;
-  
-  // Calculate which node was touched
-  int nodeIndex = (y - HEADER_HEIGHT - NODE_BUTTON_MARGIN) / NODE_BUTTON_HEIGHT;
-  
-  if (nodeIndex < 0 || nodeIndex >= NODES_PER_PAGE) return;
-  
-  // Find the corresponding peer
-  std::map<uint32_t, Peer>& peers = swarm.getPeers();
-  int currentIndex = 0;
-  
-  for (auto& kv : peers) {
-    if (!kv.second.alive) continue;
-    
-    if (currentIndex == nodeIndex) {
-      // Switch to detail view
-      selectedNodeId = kv.first;
-      selectedNodeName = kv.second.name;
-      currentView = VIEW_NODE_DETAIL;
-      updateStateCache();
-      updateDisplay();
-      
-      Serial.printf("[TOUCH] Selected node: %s (ID: %08X)\n", 
-                    selectedNodeName.c_str(), selectedNodeId);
-      break;
-    }
-    currentIndex++;
+void showNodeList() {
+  currentView = VIEW_NODE_LIST;
+  selectedNodeId = 0;
+  selectedNodeName = "";
+
+  ui.clear();
+  ui.add(&headerWidget);
+  ui.add(&statusWidget);
+  ui.add(&listPanel);
+  ui.add(&emptyListWidget);
+  for (auto& button : nodeButtons) {
+    ui.add(&button);
   }
+  ui.add(&pager);
+  frames.request();
 }
 
-void handleTouchNodeDetail(int16_t x, int16_t y) {
-  // Check if back button was pressed
-  if (y >= TFT_HEIGHT - FOOTER_HEIGHT && y <= TFT_HEIGHT) {
-    currentView = VIEW_NODE_LIST;
-    selectedNodeId = 0;
-    selectedNodeName = "";
-    updateDisplay();
-    Serial.println("[TOUCH] Back to node list");
+void showNodeDetail(uint32_t nodeId, const String& nodeName) {
+  currentView = VIEW_NODE_DETAIL;
+  selectedNodeId = nodeId;
+  selectedNodeName = nodeName;
+  updateStateCache();
+
+  ui.clear();
+  ui.add(&headerWidget);
+  ui.add(&statusWidget);
+  ui.add(&detailPanel);
+  ui.add(&detailTitle);
+  ui.add(&noStateWidget);
+  for (auto& row : stateRows) {
+    row.reset();
+    ui.add(&row);
   }
+  ui.add(&backButton);
+  frames.request();
+
+  Serial.printf("[TOUCH] Selected node: %s (ID: %08X)\n",
+                selectedNodeName.c_str(), selectedNodeId);
 }
 
+// ============== TOUCH EVENT HANDLERS ==============
+
 void handleTouch() {
   unsigned long now = millis();
   if (now - lastTouchTime < TOUCH_DEBOUNCE) return;
-  
+
   TouchPoint tp = getTouch();
   if (!tp.valid) return;
-  
+
   lastTouchTime = now;
-  
+
   Serial.printf("[TOUCH] x=%d, y=%d\n", tp.x, tp.y);
-  
-  switch (currentView) {
-    case VIEW_NODE_LIST:
-      handleTouchNodeList(tp.x, tp.y);
-      break;
-    case VIEW_NODE_DETAIL:
-      handleTouchNodeDetail(tp.x, tp.y);
-      break;
-  }
+
+  ui.touch(tp.x, tp.y);
 }
 
 // ============== STATE TRACKING ==============
@@ -332,32 +558,24 @@ void handleTouch() {
 void onStateChange(const String& key, const String& value, const String& oldValue) {
   Serial.printf("[STATE] %s: %s -> %s\n", key.c_str(), oldValue.c_str(), value.c_str());
   
-  // Update state cache
-  bool found = false;
-  for (auto& item : stateCache) {
-    if (item.key == key) {
-      item.value = value;
-      found = true;
-      break;
-    }
-  }
-  
-  if (!found) {
-    StateItem item;
-    item.key = key;
-    item.value = value;
-    item.origin = 0; // We don't have access to origin through this callback
-    stateCache.push_back(item);
+  // Update state cache (origin is not available through this callback);
+  // an empty value is a deleted or expired key
+  uint16_t slot = value.length() == 0 ? stateCache.remove(key) : stateCache.set(key, value);
+
+  // Coalesced: only the row showing this slot refreshes, on the next frame
+  if (currentView == VIEW_NODE_DETAIL && slot < STATE_ROWS) {
+    stateRows[slot].markStale();
+    noStateWidget.markStale();
+    frames.request();
   }
-  
-  stateChanged = true;
 }
 
 // ============== SETUP ==============
 
 void setup() {
+  fastBoot.begin();
   Serial.begin(115200);
-  delay(100);
+  if (!fastBoot.isWarmBoot()) delay(100);
   
   Serial.println("\n========================================");
   Serial.println("  MeshSwarm Remote Control Node");
@@ -376,7 +594,14 @@ void setup() {
   uint16_t calData[5] = {275, 3620, 264, 3532, 2};
   tft.setTouch(calData);
   
+  // DMA pipeline and widget tile, allocated once; without them widgets draw direct
+  pipeline.begin(tft, UI_DMA_BUFFER_PIXELS);
+  uiTile.setColorDepth(16);
+  uiTiled = uiTile.createSprite(TFT_WIDTH, UI_TILE_HEIGHT) != nullptr;
+  if (!uiTiled) Serial.println("[INIT] Widget tile allocation failed, drawing direct");
+
   Serial.println("[INIT] Display initialized");
+  fastBoot.mark("display");
   
   // Show splash screen
   tft.setTextColor(COLOR_TEXT, COLOR_BG);
@@ -392,19 +617,23 @@ void setup() {
   
   // Initialize MeshSwarm (disable OLED display support)
   swarm.begin(NODE_NAME);
+  perfStats.attach(swarm);
   swarm.enableTelemetry(true);
   swarm.enableOTAReceive(NODE_TYPE);
+  otaReceiver.begin(swarm, NODE_TYPE);  // Broadcast jobs; resumes a saved session
   
   Serial.println("[INIT] MeshSwarm initialized");
+  fastBoot.mark("mesh");
+  fastBoot.attach(swarm);
   Serial.println("[MODE] Remote Control - Touch Dashboard");
   
   // Watch all state changes for updates
   swarm.watchState("*", onStateChange);
   
-  delay(2000);
-  
-  // Initial display
-  updateDisplay();
+  // Initial display; the list fills in from the loop as peers are found
+  peerView.refresh(swarm);
+  showNodeList();
+  fastBoot.mark("ready");
 }
 
 // ============== MAIN LOOP ==============
@@ -415,11 +644,23 @@ void loop() {
   // Handle touch input
   handleTouch();
   
-  // Periodic display refresh
+  // Poll uptime and the peer list; widgets repaint only if they changed
   unsigned long now = millis();
-  if (now - lastDisplayUpdate >= DISPLAY_UPDATE_INTERVAL || stateChanged) {
-    updateDisplay();
+  if (now - lastDisplayUpdate >= DISPLAY_UPDATE_INTERVAL) {
     lastDisplayUpdate = now;
-    stateChanged = false;
+    peerView.refresh(swarm);
+    ui.markAllStale();
+    frames.request();
+  }
+
+  // At most one partial repaint per frame
+  if (frames.due()) {
+    PerfScope scope(PERF_FRAME);
+    if (uiTiled) {
+      ui.render(tft, uiTile, pipeline);  // Returns while the last widget is still being sent
+    } else {
+      ui.render(tft);
+    }
+    frames.done();
   }
 }
\ No newline at end of file
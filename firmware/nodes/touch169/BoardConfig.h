@@ -113,7 +113,7 @@ namespace Timing {
     constexpr int16_t SWIPE_MAX_CROSS    = 40;   // Max perpendicular movement for swipe
 
     // Battery monitoring
-    constexpr unsigned long VOLTAGE_READ_INTERVAL = 2000;  // Read voltage every 2 seconds
+    constexpr unsigned long VOLTAGE_READ_INTERVAL = 1000;  // Filtered reading, cheap to take
     constexpr float VOLTAGE_FULL_THRESHOLD    = 4.15f;  // Consider full above this
     constexpr float VOLTAGE_TREND_THRESHOLD   = 0.02f;  // Min voltage change to detect trend
 
@@ -124,6 +124,13 @@ namespace Timing {
 
     // Display sleep
     constexpr unsigned long DISPLAY_SLEEP_TIMEOUT_MS = 30000;  // 30 seconds to sleep
+
+    // Main loop task periods (see core/Scheduler.h)
+    constexpr unsigned long RENDER_INTERVAL_MS = 33;  // ~30 fps target
+    constexpr unsigned long IMU_READ_INTERVAL  = 50;  // FIFO drain (buffers 32 samples at 125 Hz)
+    constexpr unsigned long INPUT_POLL_INTERVAL = 5;  // Touch (no I2C unless INT fired) and boot button
+    constexpr unsigned long POWER_POLL_INTERVAL = 20; // Power button long press
+    constexpr unsigned long SETTINGS_POLL_INTERVAL = 250; // Debounced settings commit check
 }
 
 // ============== LEGACY MACROS (for gradual migration) ==============
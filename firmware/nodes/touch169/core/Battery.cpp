@@ -5,12 +5,13 @@
 
 #include "Battery.h"
 
-void Battery::begin() {
-    // Initialize ADC pin (ESP32 does this automatically, but explicit is clearer)
-    pinMode(BAT_ADC_PIN, INPUT);
-
-    // Take initial reading
-    _lastVoltage = readRawVoltage();
+void Battery::begin(AdcSampler& adc) {
+    _adc = &adc;
+    _adcSlot = adc.addPin(BAT_ADC_PIN);
+    if (_adcSlot < 0) {
+        Serial.println("[Battery] ADC sampler unavailable, using analogRead");
+        pinMode(BAT_ADC_PIN, INPUT);
+    }
 }
 
 void Battery::update() {
@@ -31,8 +32,12 @@ void Battery::update() {
 }
 
 float Battery::readRawVoltage() {
-    int adcValue = analogRead(BAT_ADC_PIN);
-    float voltage = (float)adcValue * (BAT_VREF / 4095.0);
+    float voltage;
+    if (_adcSlot >= 0) {
+        voltage = _adc->millivolts(_adcSlot) / 1000.0f;  // Calibrated pin voltage
+    } else {
+        voltage = (float)analogRead(BAT_ADC_PIN) * (BAT_VREF / 4095.0);
+    }
     float actualVoltage = voltage * ((BAT_R1 + BAT_R2) / BAT_R2);
     return actualVoltage;
 }
@@ -51,12 +56,10 @@ int Battery::getPercent() const {
 }
 
 void Battery::updateState() {
-    // Calculate trend from voltage history
-    // Compare average of older samples vs newer samples
-    float older = (_voltageHistory[(_historyIndex + 0) % HISTORY_SIZE] +
-                   _voltageHistory[(_historyIndex + 1) % HISTORY_SIZE]) / 2.0f;
-    float newer = (_voltageHistory[(_historyIndex + 3) % HISTORY_SIZE] +
-                   _voltageHistory[(_historyIndex + 4) % HISTORY_SIZE]) / 2.0f;
+    // Calculate trend across the history window
+    // Samples are already filtered, so oldest vs newest is stable enough
+    float older = _voltageHistory[_historyIndex % HISTORY_SIZE];
+    float newer = _voltageHistory[(_historyIndex + HISTORY_SIZE - 1) % HISTORY_SIZE];
     float trend = newer - older;
 
     // Determine charging state
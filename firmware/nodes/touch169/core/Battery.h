@@ -4,12 +4,17 @@
  *
  * Handles voltage reading via ADC and voltage divider,
  * charging state detection through voltage trend analysis.
+ *
+ * The pin is sampled in the background by the shared AdcSampler
+ * (oversampled, calibrated and filtered), so update() only reads the
+ * latest value and the trend is not swamped by single-read ADC noise.
  */
 
 #ifndef BATTERY_H
 #define BATTERY_H
 
 #include <Arduino.h>
+#include <AdcSampler.h>
 #include "../BoardConfig.h"
 
 // Charging states
@@ -31,8 +36,11 @@ class Battery {
 public:
     /**
      * @brief Initialize battery monitoring
+     * @param adc Shared sampler; registers BAT_ADC_PIN, so call before adc.begin()
+     *
+     * The first voltage is taken on the first update() once the sampler runs.
      */
-    void begin();
+    void begin(AdcSampler& adc);
 
     /**
      * @brief Update battery readings (call from loop)
@@ -83,6 +91,9 @@ public:
 private:
     static constexpr int HISTORY_SIZE = 5;
 
+    AdcSampler* _adc = nullptr;
+    int8_t _adcSlot = -1;
+
     float _voltageHistory[HISTORY_SIZE] = {0};
     int _historyIndex = 0;
     int _sampleCount = 0;
@@ -0,0 +1,122 @@
+/**
+ * @file Scheduler.cpp
+ * @brief Cooperative main-loop scheduler implementation
+ */
+
+#include "Scheduler.h"
+#include <esp_idf_version.h>
+#include <esp_pm.h>
+
+int8_t Scheduler::add(const char* name, uint32_t periodMs, TaskFunction fn, uint32_t deadlineMs) {
+    if (_count >= SCHED_MAX_TASKS || fn == nullptr) return -1;
+
+    SchedTask& t = _tasks[_count];
+    t.name = name;
+    t.fn = fn;
+    t.periodMs = periodMs;
+    t.deadlineMs = deadlineMs != 0 ? deadlineMs : periodMs;
+    t.nextRun = millis();
+    t.runs = 0;
+    t.overruns = 0;
+    t.maxLateMs = 0;
+    t.maxRunUs = 0;
+    return (int8_t)_count++;
+}
+
+void Scheduler::setPeriod(int8_t id, uint32_t periodMs) {
+    if (id < 0 || id >= _count) return;
+    _tasks[id].periodMs = periodMs;
+}
+
+void Scheduler::begin() {
+    _windowStart = millis();
+
+#if SCHED_LIGHT_SLEEP && defined(CONFIG_PM_ENABLE)
+#if ESP_IDF_VERSION_MAJOR >= 5
+    esp_pm_config_t cfg;
+#else
+    esp_pm_config_esp32s3_t cfg;
+#endif
+    cfg.max_freq_mhz = getCpuFrequencyMhz();
+    cfg.min_freq_mhz = SCHED_MIN_FREQ_MHZ;
+#ifdef CONFIG_FREERTOS_USE_TICKLESS_IDLE
+    // WiFi keeps its own PM lock while the radio must stay awake, so the
+    // mesh connection is not dropped by the chip sleeping between tasks
+    cfg.light_sleep_enable = true;
+#else
+    cfg.light_sleep_enable = false;
+#endif
+    esp_err_t err = esp_pm_configure(&cfg);
+    _lightSleep = (err == ESP_OK) && cfg.light_sleep_enable;
+    Serial.printf("[SCHED] Power management: %s (%d-%d MHz)\n",
+                  err != ESP_OK ? "unavailable" : (_lightSleep ? "light sleep" : "DFS only"),
+                  (int)cfg.min_freq_mhz, (int)cfg.max_freq_mhz);
+#else
+    Serial.println("[SCHED] Power management not enabled in SDK, idling with vTaskDelay");
+#endif
+}
+
+void Scheduler::run() {
+    for (uint8_t i = 0; i < _count; i++) {
+        uint32_t now = millis();
+        if ((int32_t)(now - _tasks[i].nextRun) >= 0) {
+            runTask(_tasks[i], now);
+        }
+    }
+    idle(millis());
+}
+
+void Scheduler::runTask(SchedTask& t, uint32_t now) {
+    uint32_t late = now - t.nextRun;
+    uint32_t start = micros();
+    t.fn();
+    uint32_t elapsed = micros() - start;
+
+    t.runs++;
+    if (late > t.maxLateMs) t.maxLateMs = late;
+    if (elapsed > t.maxRunUs) t.maxRunUs = elapsed;
+    if (t.periodMs != 0 && (late > t.deadlineMs || elapsed > t.periodMs * 1000)) {
+        t.overruns++;
+    }
+
+    // Stay on the original phase unless a whole period was missed
+    t.nextRun += t.periodMs;
+    if ((int32_t)(millis() - t.nextRun) >= 0) {
+        t.nextRun = millis() + t.periodMs;
+    }
+}
+
+void Scheduler::idle(uint32_t now) {
+    uint32_t wait = SCHED_MAX_IDLE_MS;
+    for (uint8_t i = 0; i < _count; i++) {
+        if (_tasks[i].periodMs == 0) continue;  // Runs on every pass anyway
+        int32_t until = (int32_t)(_tasks[i].nextRun - now);
+        if (until <= 0) {
+            wait = 0;
+            break;
+        }
+        if ((uint32_t)until < wait) wait = (uint32_t)until;
+    }
+
+    if (wait > 0) {
+        uint32_t start = micros();
+        vTaskDelay(pdMS_TO_TICKS(wait));
+        _idleUs += micros() - start;
+    }
+
+    uint32_t windowMs = millis() - _windowStart;
+    if (windowMs >= 1000) {
+        uint32_t percent = _idleUs / (windowMs * 10);
+        _idlePercent = (uint8_t)(percent > 100 ? 100 : percent);
+        _idleUs = 0;
+        _windowStart = millis();
+    }
+}
+
+uint32_t Scheduler::totalOverruns() const {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < _count; i++) {
+        total += _tasks[i].overruns;
+    }
+    return total;
+}
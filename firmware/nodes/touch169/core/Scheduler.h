@@ -0,0 +1,127 @@
+/**
+ * @file Scheduler.h
+ * @brief Cooperative main-loop scheduler with idle sleep
+ *
+ * Each subsystem is registered as a task with its own period. run() calls
+ * the tasks that are due and then idles until the next deadline instead
+ * of spinning, so the CPU spends the gaps in the FreeRTOS idle task where
+ * automatic light sleep (or at least frequency scaling) can kick in.
+ *
+ * A task counts an overrun when it starts more than its deadline after
+ * its release time, or when one run takes longer than its period. Late
+ * tasks are re-phased rather than run back to back to catch up.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+
+// Maximum registered tasks
+#ifndef SCHED_MAX_TASKS
+#define SCHED_MAX_TASKS 10
+#endif
+
+// Longest single idle wait, so nothing polled outside the scheduler starves
+#ifndef SCHED_MAX_IDLE_MS
+#define SCHED_MAX_IDLE_MS 20
+#endif
+
+// Ask ESP-IDF power management for automatic light sleep when idle
+// (needs CONFIG_PM_ENABLE and tickless idle in the SDK build; without
+// tickless idle only frequency scaling is enabled)
+#ifndef SCHED_LIGHT_SLEEP
+#define SCHED_LIGHT_SLEEP 1
+#endif
+
+// Lowest CPU frequency power management may drop to while idle
+#ifndef SCHED_MIN_FREQ_MHZ
+#define SCHED_MIN_FREQ_MHZ 80
+#endif
+
+typedef void (*TaskFunction)();
+
+/**
+ * @struct SchedTask
+ * @brief One scheduled task and its timing statistics
+ */
+struct SchedTask {
+    const char* name;
+    TaskFunction fn;
+    uint32_t periodMs;
+    uint32_t deadlineMs;    // Allowed start latency before it counts as an overrun
+    uint32_t nextRun;       // millis() of the next release
+    uint32_t runs;
+    uint32_t overruns;
+    uint32_t maxLateMs;     // Worst start latency seen
+    uint32_t maxRunUs;      // Worst single run time seen
+};
+
+/**
+ * @class Scheduler
+ * @brief Runs periodic tasks and sleeps between deadlines
+ */
+class Scheduler {
+public:
+    /**
+     * @brief Register a task
+     * @param name Short label (shown on the debug screen)
+     * @param periodMs Run interval (0 = every pass, does not shorten idle)
+     * @param fn Task body
+     * @param deadlineMs Allowed start latency (0 = one period)
+     * @return Task id, or -1 if the table is full
+     */
+    int8_t add(const char* name, uint32_t periodMs, TaskFunction fn, uint32_t deadlineMs = 0);
+
+    /**
+     * @brief Change a task's period (takes effect from its next run)
+     */
+    void setPeriod(int8_t id, uint32_t periodMs);
+
+    /**
+     * @brief Configure power management for idle sleep
+     *
+     * Call once from setup(), after WiFi/mesh is up.
+     */
+    void begin();
+
+    /**
+     * @brief Run due tasks, then idle until the next deadline
+     *
+     * Call from loop().
+     */
+    void run();
+
+    uint8_t taskCount() const { return _count; }
+    const SchedTask& task(uint8_t index) const { return _tasks[index]; }
+
+    /**
+     * @brief Share of the last second spent idle (0-100)
+     */
+    uint8_t idlePercent() const { return _idlePercent; }
+
+    /**
+     * @brief True if automatic light sleep was accepted by the SDK
+     */
+    bool lightSleepEnabled() const { return _lightSleep; }
+
+    /**
+     * @brief Total overruns across all tasks
+     */
+    uint32_t totalOverruns() const;
+
+private:
+    void runTask(SchedTask& t, uint32_t now);
+    void idle(uint32_t now);
+
+    SchedTask _tasks[SCHED_MAX_TASKS];
+    uint8_t _count = 0;
+    bool _lightSleep = false;
+
+    // Idle accounting over a one second window
+    uint32_t _windowStart = 0;
+    uint32_t _idleUs = 0;
+    uint8_t _idlePercent = 0;
+};
+
+#endif // SCHEDULER_H
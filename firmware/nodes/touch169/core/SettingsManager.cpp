@@ -1,7 +1,7 @@
 /**
  * SettingsManager - Persistent settings for touch169
  *
- * Implementation of settings persistence via Preferences.
+ * Implementation of the write-back settings cache over Preferences.
  */
 
 #include "SettingsManager.h"
@@ -9,6 +9,11 @@
 SettingsManager::SettingsManager()
   : _initialized(false)
   , _bootCount(0)
+  , _count(0)
+  , _dirty(false)
+  , _lastChange(0)
+  , _commits(0)
+  , _listenerCount(0)
 {
 }
 
@@ -22,35 +27,138 @@ void SettingsManager::begin() {
   _bootCount = _prefs.getInt(SettingKey::BOOT_COUNT, 0) + 1;
   _prefs.putInt(SettingKey::BOOT_COUNT, _bootCount);
 
-  Serial.printf("[SETTINGS] Initialized, boot count: %d\n", _bootCount);
+  // Load the known keys once; getters are served from RAM from here on
+  load(SettingKey::BRIGHTNESS, false);
+  load(SettingKey::SLEEP_TIMEOUT, false);
+  load(SettingKey::CLOCK_FORMAT, false);
+  load(SettingKey::TZ_OFFSET, false);
+  load(SettingKey::TEMP_UNIT, true);
+  load(SettingKey::TIMEZONE, true);
+
+  Serial.printf("[SETTINGS] Initialized, boot count: %d, %d keys cached\n", _bootCount, _count);
 }
 
 void SettingsManager::end() {
   if (!_initialized) return;
+  flush();
   _prefs.end();
   _initialized = false;
 }
 
+void SettingsManager::update() {
+  if (_dirty && millis() - _lastChange >= SETTINGS_COMMIT_DELAY_MS) {
+    flush();
+  }
+}
+
+void SettingsManager::flush() {
+  if (!_initialized || !_dirty) return;
+
+  int written = 0;
+  for (uint8_t i = 0; i < _count; i++) {
+    Entry& e = _cache[i];
+    if (!e.dirty) continue;
+    if (e.isString) {
+      _prefs.putString(e.key, e.strValue);
+    } else {
+      _prefs.putInt(e.key, e.intValue);
+    }
+    e.dirty = false;
+    written++;
+  }
+  _dirty = false;
+  _commits++;
+  Serial.printf("[SETTINGS] Committed %d key(s)\n", written);
+}
+
+bool SettingsManager::onChange(SettingChangeCallback callback) {
+  if (callback == nullptr || _listenerCount >= SETTINGS_MAX_LISTENERS) return false;
+  _listeners[_listenerCount++] = callback;
+  return true;
+}
+
+// ============== Cache ==============
+
+SettingsManager::Entry* SettingsManager::find(const char* key) {
+  for (uint8_t i = 0; i < _count; i++) {
+    if (strncmp(_cache[i].key, key, KEY_LEN) == 0) return &_cache[i];
+  }
+  return nullptr;
+}
+
+SettingsManager::Entry* SettingsManager::load(const char* key, bool isString) {
+  Entry* e = find(key);
+  if (e != nullptr) return (e->isString == isString) ? e : nullptr;
+  if (_count >= SETTINGS_CACHE_SIZE || strlen(key) >= KEY_LEN) return nullptr;
+
+  e = &_cache[_count++];
+  strncpy(e->key, key, KEY_LEN - 1);
+  e->key[KEY_LEN - 1] = '\0';
+  e->isString = isString;
+  e->present = _prefs.isKey(key);
+  e->dirty = false;
+  e->intValue = 0;
+  e->strValue = "";
+  if (e->present) {
+    if (isString) {
+      e->strValue = _prefs.getString(key, "");
+    } else {
+      e->intValue = _prefs.getInt(key, 0);
+    }
+  }
+  return e;
+}
+
+void SettingsManager::changed(Entry& entry) {
+  entry.present = true;
+  entry.dirty = true;
+  _dirty = true;
+  _lastChange = millis();
+  for (uint8_t i = 0; i < _listenerCount; i++) {
+    _listeners[i](entry.key);
+  }
+}
+
 // ============== Generic Get/Set ==============
 
+// Keys that don't fit the cache fall back to direct NVS access
+
 int SettingsManager::getInt(const char* key, int defaultVal) {
   if (!_initialized) return defaultVal;
-  return _prefs.getInt(key, defaultVal);
+  Entry* e = load(key, false);
+  if (e == nullptr) return _prefs.getInt(key, defaultVal);
+  return e->present ? e->intValue : defaultVal;
 }
 
 void SettingsManager::setInt(const char* key, int value) {
   if (!_initialized) return;
-  _prefs.putInt(key, value);
+  Entry* e = load(key, false);
+  if (e == nullptr) {
+    _prefs.putInt(key, value);
+    return;
+  }
+  if (e->present && e->intValue == value) return;
+  e->intValue = value;
+  changed(*e);
 }
 
 String SettingsManager::getString(const char* key, const String& defaultVal) {
   if (!_initialized) return defaultVal;
-  return _prefs.getString(key, defaultVal);
+  Entry* e = load(key, true);
+  if (e == nullptr) return _prefs.getString(key, defaultVal);
+  return e->present ? e->strValue : defaultVal;
 }
 
 void SettingsManager::setString(const char* key, const String& value) {
   if (!_initialized) return;
-  _prefs.putString(key, value);
+  Entry* e = load(key, true);
+  if (e == nullptr) {
+    _prefs.putString(key, value);
+    return;
+  }
+  if (e->present && e->strValue == value) return;
+  e->strValue = value;
+  changed(*e);
 }
 
 // ============== Convenience Methods ==============
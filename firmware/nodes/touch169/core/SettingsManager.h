@@ -4,6 +4,13 @@
  * Centralizes all Preferences-based persistent storage.
  * Extracted from main.cpp as part of Phase R6 refactoring.
  *
+ * Settings are cached in RAM: begin() loads the known keys once, other
+ * keys are loaded on first use. Getters never touch NVS. Setters update
+ * the cache, mark the key dirty and notify change listeners; update()
+ * commits dirty keys once no setter has run for SETTINGS_COMMIT_DELAY_MS,
+ * so dragging a slider costs one flash write instead of one per step.
+ * Call flush() before power off or deep sleep.
+ *
  * Usage:
  *   SettingsManager settings;
  *   settings.begin();  // Load from flash
@@ -23,6 +30,24 @@
 #include <Arduino.h>
 #include <Preferences.h>
 
+// Cached keys (known keys plus any generic ones used)
+#ifndef SETTINGS_CACHE_SIZE
+#define SETTINGS_CACHE_SIZE 12
+#endif
+
+// Quiet time after the last change before dirty keys are committed
+#ifndef SETTINGS_COMMIT_DELAY_MS
+#define SETTINGS_COMMIT_DELAY_MS 1500
+#endif
+
+// Change callbacks registered with onChange()
+#ifndef SETTINGS_MAX_LISTENERS
+#define SETTINGS_MAX_LISTENERS 4
+#endif
+
+// Called with the SettingKey of a value that changed (not yet committed)
+typedef void (*SettingChangeCallback)(const char* key);
+
 // Keys for persistent settings
 namespace SettingKey {
   constexpr const char* BOOT_COUNT     = "bootCount";
@@ -48,8 +73,9 @@ namespace SettingDefault {
  * SettingsManager class - manages persistent settings via Preferences
  *
  * Responsibilities:
- * - Load/save settings from flash
+ * - Load settings from flash once, commit changes in the background
  * - Provide typed accessors with defaults
+ * - Notify listeners when a value changes
  * - Track boot count for diagnostics
  * - Centralize all persistent storage
  */
@@ -65,9 +91,35 @@ public:
 
   /**
    * Close preferences (optional, called automatically on ESP32)
+   * Commits pending changes first.
    */
   void end();
 
+  /**
+   * Commit dirty keys once the debounce delay has passed
+   * Call periodically (scheduler task).
+   */
+  void update();
+
+  /**
+   * Commit dirty keys now (power off, deep sleep)
+   */
+  void flush();
+
+  /**
+   * True if changes are waiting to be committed
+   */
+  bool isDirty() const { return _dirty; }
+
+  /**
+   * Register a change listener
+   * @return false if SETTINGS_MAX_LISTENERS are already registered
+   */
+  bool onChange(SettingChangeCallback callback);
+
+  // Stats
+  uint32_t commitCount() const { return _commits; }
+
   // ============== Generic Get/Set ==============
 
   /**
@@ -166,10 +218,35 @@ public:
   int getBootCount();
 
 private:
+  // NVS keys are at most 15 characters
+  static constexpr size_t KEY_LEN = 16;
+
+  struct Entry {
+    char key[KEY_LEN];
+    bool isString;
+    bool present;     // Stored in NVS (or set since boot)
+    bool dirty;
+    int intValue;
+    String strValue;
+  };
+
+  Entry* find(const char* key);
+  Entry* load(const char* key, bool isString);
+  void changed(Entry& entry);
+
   Preferences _prefs;
   bool _initialized;
   int _bootCount;
 
+  Entry _cache[SETTINGS_CACHE_SIZE];
+  uint8_t _count;
+  bool _dirty;
+  unsigned long _lastChange;
+  uint32_t _commits;
+
+  SettingChangeCallback _listeners[SETTINGS_MAX_LISTENERS];
+  uint8_t _listenerCount;
+
   static constexpr const char* NAMESPACE = "touch169";
 };
 
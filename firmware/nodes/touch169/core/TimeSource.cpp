@@ -7,14 +7,23 @@
 #include <string.h>
 
 void TimeSource::setMeshTime(unsigned long unixTime) {
-    _meshTimeBase = unixTime;
-    _meshTimeMillis = millis();
+    _clock.reset((uint64_t)unixTime * 1000, millis());
     _hasMeshTime = true;
+    setSystemTime((uint64_t)unixTime * 1000);
+}
+
+void TimeSource::applySyncSample(uint64_t unixMs, uint32_t atMillis, uint32_t rttMs) {
+    _clock.sample(unixMs, atMillis);
+    _lastRtt = rttMs;
+    _hasMeshTime = true;
+    setSystemTime(_clock.nowMs());
+}
 
+void TimeSource::setSystemTime(uint64_t unixMs) {
     // Also set the system time so getLocalTime() works
     struct timeval tv;
-    tv.tv_sec = unixTime;
-    tv.tv_usec = 0;
+    tv.tv_sec = unixMs / 1000;
+    tv.tv_usec = (unixMs % 1000) * 1000;
     settimeofday(&tv, NULL);
 }
 
@@ -35,9 +44,8 @@ bool TimeSource::getTime(struct tm* timeinfo) {
 bool TimeSource::getMeshTime(struct tm* timeinfo) {
     if (!_hasMeshTime) return false;
 
-    // Calculate current time based on mesh time + elapsed millis
-    unsigned long elapsed = (millis() - _meshTimeMillis) / 1000;
-    time_t currentTime = _meshTimeBase + elapsed + _gmtOffset + _daylightOffset;
+    // Drift-corrected mesh time, interpolated from the last sync
+    time_t currentTime = (time_t)_clock.now() + _gmtOffset + _daylightOffset;
 
     // Convert to struct tm
     struct tm* t = localtime(&currentTime);
@@ -3,7 +3,9 @@
  * @brief Time management with mesh sync support
  *
  * Handles time synchronization from mesh network and provides
- * consistent time access with timezone support.
+ * consistent time access with timezone support. Mesh time is kept in a
+ * DriftClock, so it interpolates between RTT-compensated syncs with the
+ * local crystal's drift corrected.
  */
 
 #ifndef TIMESOURCE_H
@@ -12,6 +14,7 @@
 #include <Arduino.h>
 #include <time.h>
 #include <sys/time.h>
+#include <DriftClock.h>
 #include "../BoardConfig.h"
 
 /**
@@ -31,6 +34,26 @@ public:
      */
     void setMeshTime(unsigned long unixTime);
 
+    /**
+     * @brief Apply an RTT-compensated sync sample
+     * @param unixMs Unix time in milliseconds at atMillis
+     * @param atMillis millis() reading the sample refers to
+     * @param rttMs Round trip of the exchange (for diagnostics)
+     *
+     * Updates the drift estimate and the system time.
+     */
+    void applySyncSample(uint64_t unixMs, uint32_t atMillis, uint32_t rttMs);
+
+    /**
+     * @brief Estimated local clock drift in ppm (positive = local runs slow)
+     */
+    float getDriftPpm() const { return _clock.driftPpm(); }
+
+    /**
+     * @brief Round trip of the last sync in milliseconds
+     */
+    uint32_t getLastRtt() const { return _lastRtt; }
+
     /**
      * @brief Check if mesh time has been received
      * @return true if mesh time is available
@@ -61,7 +84,7 @@ public:
      * @brief Get timezone offset in seconds
      * @return Total offset (GMT + daylight)
      */
-    long getTimezoneOffset() const { return GMT_OFFSET_SEC + DAYLIGHT_OFFSET; }
+    long getTimezoneOffset() const { return _gmtOffset + _daylightOffset; }
 
     /**
      * @brief Set timezone offset
@@ -71,14 +94,15 @@ public:
     void setTimezone(long gmtOffset, long daylightOffset);
 
 private:
-    unsigned long _meshTimeBase = 0;    // Unix timestamp when sync received
-    unsigned long _meshTimeMillis = 0;  // millis() when sync received
+    DriftClock _clock;                  // Mesh time base + drift estimate
+    uint32_t _lastRtt = 0;
     bool _hasMeshTime = false;
     bool _timeValid = false;
     long _gmtOffset = GMT_OFFSET_SEC;
     long _daylightOffset = DAYLIGHT_OFFSET;
 
     bool getMeshTime(struct tm* timeinfo);
+    void setSystemTime(uint64_t unixMs);
 };
 
 #endif // TIMESOURCE_H
@@ -11,67 +11,158 @@ GestureDetector::GestureDetector(int16_t minSwipeDistance, int16_t maxCrossDista
   , _startY(0)
   , _endX(0)
   , _endY(0)
+  , _lastX(0)
+  , _lastY(0)
+  , _startTime(0)
+  , _endTime(0)
   , _active(false)
+  , _moved(false)
+  , _longPressed(false)
+  , _fling(false)
+  , _velocityX(0)
+  , _velocityY(0)
   , _gesture(Gesture::None)
+  , _historyCount(0)
+  , _historyNext(0)
   , _minSwipeDistance(minSwipeDistance)
   , _maxCrossDistance(maxCrossDistance)
 {
 }
 
-void GestureDetector::onTouchStart(int16_t x, int16_t y) {
+void GestureDetector::onTouchStart(int16_t x, int16_t y, uint32_t t) {
+  reset();
   _startX = x;
   _startY = y;
   _endX = x;
   _endY = y;
+  _startTime = t;
   _active = true;
-  _gesture = Gesture::None;
+  addPoint(x, y, t);
+}
+
+void GestureDetector::onTouchMove(int16_t x, int16_t y, uint32_t t) {
+  if (!_active) return;
+  addPoint(x, y, t);
 }
 
-void GestureDetector::onTouchEnd(int16_t x, int16_t y) {
+void GestureDetector::onTouchEnd(int16_t x, int16_t y, uint32_t t) {
   if (!_active) return;
 
+  addPoint(x, y, t);
   _endX = x;
   _endY = y;
+  _endTime = t;
   _active = false;
 
   classifyGesture();
 }
 
+bool GestureDetector::checkLongPress(uint32_t now) {
+  if (!_active || _moved || _longPressed) return false;
+  if (now - _startTime < GESTURE_LONG_PRESS_MS) return false;
+
+  _longPressed = true;
+  _gesture = Gesture::LongPress;
+  return true;
+}
+
 void GestureDetector::reset() {
   _startX = 0;
   _startY = 0;
   _endX = 0;
   _endY = 0;
+  _lastX = 0;
+  _lastY = 0;
+  _startTime = 0;
+  _endTime = 0;
   _active = false;
+  _moved = false;
+  _longPressed = false;
+  _fling = false;
+  _velocityX = 0;
+  _velocityY = 0;
+  _historyCount = 0;
+  _historyNext = 0;
   _gesture = Gesture::None;
 }
 
+void GestureDetector::addPoint(int16_t x, int16_t y, uint32_t t) {
+  _lastX = x;
+  _lastY = y;
+  if (abs(x - _startX) > GESTURE_TAP_SLOP || abs(y - _startY) > GESTURE_TAP_SLOP) {
+    _moved = true;
+  }
+
+  _history[_historyNext] = Point{x, y, t};
+  _historyNext = (_historyNext + 1) % HISTORY;
+  if (_historyCount < HISTORY) _historyCount++;
+}
+
+void GestureDetector::computeVelocity() {
+  _velocityX = 0;
+  _velocityY = 0;
+  if (_historyCount < 2) return;
+
+  // Newest sample, and the oldest one still inside the window
+  const Point& last = _history[(_historyNext + HISTORY - 1) % HISTORY];
+  const Point* first = &last;
+  for (uint8_t i = 2; i <= _historyCount; i++) {
+    const Point& p = _history[(_historyNext + HISTORY - i) % HISTORY];
+    if (last.t - p.t > GESTURE_VELOCITY_WINDOW_MS) break;
+    first = &p;
+  }
+
+  int32_t dt = (int32_t)(last.t - first->t);
+  if (dt <= 0) return;
+  _velocityX = (int16_t)constrain((int32_t)(last.x - first->x) * 1000 / dt, -32000, 32000);
+  _velocityY = (int16_t)constrain((int32_t)(last.y - first->y) * 1000 / dt, -32000, 32000);
+}
+
 void GestureDetector::classifyGesture() {
+  computeVelocity();
+  _fling = false;
+
+  // Already reported while held; the release just ends it
+  if (_longPressed) {
+    _gesture = Gesture::LongPress;
+    return;
+  }
+
   int16_t deltaX = _endX - _startX;
   int16_t deltaY = _endY - _startY;
 
-  // Check for vertical swipe (up or down)
-  if (abs(deltaY) >= _minSwipeDistance && abs(deltaX) < _maxCrossDistance) {
-    if (deltaY > 0) {
-      _gesture = Gesture::SwipeDown;
-    } else {
-      _gesture = Gesture::SwipeUp;
-    }
-    return;
+  // Judge along the dominant axis
+  bool vertical = abs(deltaY) >= abs(deltaX);
+  int16_t along = vertical ? abs(deltaY) : abs(deltaX);
+  int16_t cross = vertical ? abs(deltaX) : abs(deltaY);
+  int16_t delta = vertical ? deltaY : deltaX;
+  int16_t velocity = vertical ? _velocityY : _velocityX;
+
+  uint32_t duration = _endTime - _startTime;
+  if (duration == 0) duration = 1;
+  int32_t averageSpeed = (int32_t)along * 1000 / (int32_t)duration;
+
+  bool swipe = along >= _minSwipeDistance && cross < _maxCrossDistance &&
+               averageSpeed >= GESTURE_SWIPE_MIN_SPEED;
+
+  // Short flick: fast at release, moving the same way as the whole gesture
+  if (!swipe && along >= GESTURE_FLING_MIN_DISTANCE && cross * 2 <= along &&
+      abs(velocity) >= GESTURE_FLING_VELOCITY && (velocity > 0) == (delta > 0)) {
+    swipe = true;
+    _fling = true;
   }
 
-  // Check for horizontal swipe (left or right)
-  if (abs(deltaX) >= _minSwipeDistance && abs(deltaY) < _maxCrossDistance) {
-    if (deltaX > 0) {
-      _gesture = Gesture::SwipeRight;
+  if (swipe) {
+    if (vertical) {
+      _gesture = deltaY > 0 ? Gesture::SwipeDown : Gesture::SwipeUp;
     } else {
-      _gesture = Gesture::SwipeLeft;
+      _gesture = deltaX > 0 ? Gesture::SwipeRight : Gesture::SwipeLeft;
     }
     return;
   }
 
-  // Not a swipe - classify as tap
-  _gesture = Gesture::Tap;
+  // Not a swipe - a tap if it stayed in place, otherwise a drag
+  _gesture = _moved ? Gesture::Drag : Gesture::Tap;
 }
 
 const char* GestureDetector::getGestureName(Gesture gesture) {
@@ -82,6 +173,8 @@ const char* GestureDetector::getGestureName(Gesture gesture) {
     case Gesture::SwipeDown:  return "SwipeDown";
     case Gesture::SwipeLeft:  return "SwipeLeft";
     case Gesture::SwipeRight: return "SwipeRight";
+    case Gesture::LongPress:  return "LongPress";
+    case Gesture::Drag:       return "Drag";
     default:                  return "Unknown";
   }
 }
@@ -1,7 +1,14 @@
 /**
  * GestureDetector - Touch gesture detection for touch169
  *
- * Detects swipe gestures (up, down, left, right) and taps from touch input.
+ * Detects swipe gestures (up, down, left, right), taps, long presses and
+ * drags from the stream of touch samples. Start and end points decide the
+ * direction; the timestamps decide speed:
+ * - A short, fast flick (release velocity >= GESTURE_FLING_VELOCITY) is a
+ *   swipe even below the swipe distance.
+ * - A slow drag (average speed < GESTURE_SWIPE_MIN_SPEED) is a Drag, not a
+ *   swipe, so sliding a finger around doesn't navigate.
+ * - Moving more than GESTURE_TAP_SLOP never counts as a tap.
  * Extracted from main.cpp as part of Phase R5 refactoring.
  *
  * Usage:
@@ -9,11 +16,13 @@
  *   // or with custom thresholds:
  *   GestureDetector gesture(60, 30);  // minSwipe=60, maxCross=30
  *
- *   // On touch start:
- *   gesture.onTouchStart(x, y);
+ *   // On touch start / each sample while down:
+ *   gesture.onTouchStart(x, y, t);
+ *   gesture.onTouchMove(x, y, t);
+ *   if (gesture.checkLongPress(millis())) { ... }   // Fires once while held
  *
  *   // On touch end:
- *   gesture.onTouchEnd(x, y);
+ *   gesture.onTouchEnd(x, y, t);
  *   Gesture g = gesture.getGesture();
  *   if (g == Gesture::SwipeDown) { ... }
  *   if (g == Gesture::Tap) {
@@ -30,6 +39,36 @@
 
 #include <Arduino.h>
 
+// Movement (pixels) beyond which a touch is no longer a tap or long press
+#ifndef GESTURE_TAP_SLOP
+#define GESTURE_TAP_SLOP 12
+#endif
+
+// Hold time for a long press
+#ifndef GESTURE_LONG_PRESS_MS
+#define GESTURE_LONG_PRESS_MS 600
+#endif
+
+// Release velocity (px/s) that makes a short movement a swipe
+#ifndef GESTURE_FLING_VELOCITY
+#define GESTURE_FLING_VELOCITY 500
+#endif
+
+// Shortest flick accepted as a swipe (pixels)
+#ifndef GESTURE_FLING_MIN_DISTANCE
+#define GESTURE_FLING_MIN_DISTANCE 20
+#endif
+
+// Below this average speed (px/s) a long movement is a drag, not a swipe
+#ifndef GESTURE_SWIPE_MIN_SPEED
+#define GESTURE_SWIPE_MIN_SPEED 120
+#endif
+
+// Release velocity is measured over the samples in this window
+#ifndef GESTURE_VELOCITY_WINDOW_MS
+#define GESTURE_VELOCITY_WINDOW_MS 60
+#endif
+
 // Gesture types
 enum class Gesture {
   None,        // No gesture detected yet
@@ -37,16 +76,19 @@ enum class Gesture {
   SwipeUp,     // Swipe upward
   SwipeDown,   // Swipe downward
   SwipeLeft,   // Swipe left
-  SwipeRight   // Swipe right
+  SwipeRight,  // Swipe right
+  LongPress,   // Held in place (reported by checkLongPress while down)
+  Drag         // Moved, but too slowly or too crookedly to be a swipe
 };
 
 /**
  * GestureDetector class - detects swipe and tap gestures
  *
  * Responsibilities:
- * - Track touch start and end positions
- * - Classify gesture based on movement distance and direction
+ * - Track touch start, end and recent positions with timestamps
+ * - Classify gesture based on movement distance, direction and speed
  * - Provide tap coordinates when gesture is a tap
+ * - Report drag offset while a drag is in progress
  */
 class GestureDetector {
 public:
@@ -61,15 +103,32 @@ public:
    * Call when touch begins
    * @param x Touch X coordinate
    * @param y Touch Y coordinate
+   * @param t Sample time in millis()
    */
-  void onTouchStart(int16_t x, int16_t y);
+  void onTouchStart(int16_t x, int16_t y, uint32_t t = millis());
+
+  /**
+   * Call for each sample while the touch is down
+   * @param x Touch X coordinate
+   * @param y Touch Y coordinate
+   * @param t Sample time in millis()
+   */
+  void onTouchMove(int16_t x, int16_t y, uint32_t t = millis());
 
   /**
    * Call when touch ends - triggers gesture detection
    * @param x Final touch X coordinate
    * @param y Final touch Y coordinate
+   * @param t Release time in millis()
    */
-  void onTouchEnd(int16_t x, int16_t y);
+  void onTouchEnd(int16_t x, int16_t y, uint32_t t = millis());
+
+  /**
+   * Check for a long press while the touch is held
+   * @param now Current millis()
+   * @return true once, when the hold first qualifies
+   */
+  bool checkLongPress(uint32_t now);
 
   /**
    * Reset state for next gesture
@@ -99,24 +158,66 @@ public:
    */
   bool isActive() const { return _active; }
 
+  /**
+   * Check if the active touch has moved beyond the tap slop
+   */
+  bool isDragging() const { return _active && _moved; }
+
+  /**
+   * Offset of the latest sample from the touch start
+   */
+  int16_t getDragDX() const { return _lastX - _startX; }
+  int16_t getDragDY() const { return _lastY - _startY; }
+
+  /**
+   * Release velocity in px/s (valid after onTouchEnd)
+   */
+  int16_t getVelocityX() const { return _velocityX; }
+  int16_t getVelocityY() const { return _velocityY; }
+
+  /**
+   * True if the last swipe was recognized from speed rather than distance
+   */
+  bool isFling() const { return _fling; }
+
   /**
    * Get human-readable gesture name
    */
   static const char* getGestureName(Gesture gesture);
 
 private:
+  static const uint8_t HISTORY = 8;
+  struct Point { int16_t x, y; uint32_t t; };
+
   int16_t _startX;
   int16_t _startY;
   int16_t _endX;
   int16_t _endY;
+  int16_t _lastX;
+  int16_t _lastY;
+  uint32_t _startTime;
+  uint32_t _endTime;
   bool _active;
+  bool _moved;        // Left the tap slop at some point
+  bool _longPressed;
+  bool _fling;
+  int16_t _velocityX;
+  int16_t _velocityY;
   Gesture _gesture;
 
+  // Most recent samples, for the release velocity
+  Point _history[HISTORY];
+  uint8_t _historyCount;
+  uint8_t _historyNext;
+
   // Thresholds
   int16_t _minSwipeDistance;
   int16_t _maxCrossDistance;
 
-  // Classify gesture based on start/end positions
+  void addPoint(int16_t x, int16_t y, uint32_t t);
+  void computeVelocity();
+
+  // Classify gesture based on start/end positions and speed
   void classifyGesture();
 };
 
@@ -6,9 +6,35 @@
 #include "IMU.h"
 #include "../BoardConfig.h"
 
+#if IMU_INT_PIN >= 0
+#include <driver/gpio.h>
+#include <esp_sleep.h>
+#endif
+
+// Accel/gyro ODR period (125 Hz), used to back-date FIFO samples
+static const uint32_t SAMPLE_PERIOD_MS = 8;
+
+// Drain at least this often even without a watermark interrupt, so the
+// cached values never go stale if an edge is missed
+static const unsigned long MAX_DRAIN_INTERVAL_MS = 250;
+
+// STATUS1 register: wake-on-motion event
+static const uint8_t STATUS1_WOM = 0x04;
+
+volatile uint32_t IMU::s_irqCount = 0;
+
 IMU::IMU()
   : _available(false)
   , _hasNewData(false)
+  , _wakeOnMotion(false)
+  , _motionWake(false)
+  , _seenIrqs(0)
+  , _lastDrain(0)
+  , _head(0)
+  , _tail(0)
+  , _samplesRead(0)
+  , _batches(0)
+  , _dropped(0)
   , _temperature(0.0f)
   , _accel{0.0f, 0.0f, 0.0f}
   , _gyro{0.0f, 0.0f, 0.0f}
@@ -33,7 +59,32 @@ bool IMU::begin(TwoWire& wire, int sda, int scl) {
 
   Serial.printf("[IMU] QMI8658 found, chip ID: 0x%02X\n", _qmi.getChipID());
 
-  // Configure accelerometer: 4G range, 100Hz output rate, low-pass filter
+  if (!configureSampling()) {
+    Serial.println("[IMU] FIFO configuration failed");
+    _available = false;
+    return false;
+  }
+
+#if IMU_INT_PIN >= 0
+  pinMode(IMU_INT_PIN, INPUT_PULLUP);
+  _seenIrqs = s_irqCount;
+  attachInterrupt(digitalPinToInterrupt(IMU_INT_PIN), onInterrupt, RISING);
+  Serial.printf("[IMU] FIFO watermark %d, interrupt on GPIO%d\n", IMU_FIFO_WATERMARK, IMU_INT_PIN);
+#else
+  Serial.printf("[IMU] FIFO watermark %d, polling\n", IMU_FIFO_WATERMARK);
+#endif
+
+  _available = true;
+  Serial.println("[IMU] QMI8658 initialized successfully");
+
+  // Do initial reading
+  drainFifo();
+
+  return true;
+}
+
+bool IMU::configureSampling() {
+  // Configure accelerometer: 4G range, 125Hz output rate, low-pass filter
   _qmi.configAccelerometer(
     SensorQMI8658::ACC_RANGE_4G,
     SensorQMI8658::ACC_ODR_125Hz,
@@ -47,42 +98,134 @@ bool IMU::begin(TwoWire& wire, int sda, int scl) {
     SensorQMI8658::LPF_MODE_0
   );
 
+  // Stream mode keeps the newest 32 samples; the watermark raises INT2
+  int rc = _qmi.configFIFO(
+    SensorQMI8658::FIFO_MODE_STREAM,
+    SensorQMI8658::FIFO_SAMPLES_32,
+    IMU_INT_PIN >= 0 ? SensorQMI8658::INTERRUPT_PIN_2 : SensorQMI8658::INTERRUPT_PIN_DISABLE,
+    IMU_FIFO_WATERMARK
+  );
+
   // Enable both sensors
   _qmi.enableAccelerometer();
   _qmi.enableGyroscope();
 
-  _available = true;
-  Serial.println("[IMU] QMI8658 initialized successfully");
-
-  // Do initial reading
-  update();
+  return rc >= 0;
+}
 
-  return true;
+void IRAM_ATTR IMU::onInterrupt() {
+  s_irqCount++;
 }
 
 void IMU::update() {
-  if (!_available) {
-    _hasNewData = false;
+  _hasNewData = false;
+  if (!_available) return;
+
+  if (_wakeOnMotion) {
+#if IMU_INT_PIN >= 0
+    uint32_t irqs = s_irqCount;
+    if (irqs == _seenIrqs) return;
+    _seenIrqs = irqs;
+#endif
+    if (_qmi.getIrqStatus() & STATUS1_WOM) {
+      _motionWake = true;
+    }
     return;
   }
 
-  // Check if new data is ready
-  if (_qmi.getDataReady()) {
-    // Read temperature
-    _temperature = _qmi.getTemperature_C();
+#if IMU_INT_PIN >= 0
+  uint32_t irqs = s_irqCount;
+  if (irqs == _seenIrqs && millis() - _lastDrain < MAX_DRAIN_INTERVAL_MS) {
+    return;  // Watermark not reached yet, stay off the bus
+  }
+  _seenIrqs = irqs;
+#endif
+
+  drainFifo();
+}
+
+void IMU::drainFifo() {
+  IMUdata acc[IMU_FIFO_WATERMARK * 2];
+  IMUdata gyr[IMU_FIFO_WATERMARK * 2];
+
+  uint16_t count = _qmi.readFromFifo(acc, IMU_FIFO_WATERMARK * 2, gyr, IMU_FIFO_WATERMARK * 2);
+  _lastDrain = millis();
+  if (count == 0) return;
+
+  // The FIFO holds no timestamps: the newest sample is "now", older ones
+  // one ODR period apart
+  uint32_t now = _lastDrain;
+  for (uint16_t i = 0; i < count; i++) {
+    IMUSample s;
+    s.accel = IMUVector{acc[i].x, acc[i].y, acc[i].z};
+    s.gyro = IMUVector{gyr[i].x, gyr[i].y, gyr[i].z};
+    s.t = now - (uint32_t)(count - 1 - i) * SAMPLE_PERIOD_MS;
+    push(s);
+  }
+
+  _accel = IMUVector{acc[count - 1].x, acc[count - 1].y, acc[count - 1].z};
+  _gyro = IMUVector{gyr[count - 1].x, gyr[count - 1].y, gyr[count - 1].z};
+  _temperature = _qmi.getTemperature_C();
 
-    // Read accelerometer
-    _qmi.getAccelerometer(_accel.x, _accel.y, _accel.z);
+  _samplesRead += count;
+  _batches++;
+  _hasNewData = true;
+}
+
+void IMU::push(const IMUSample& sample) {
+  if ((uint8_t)(_head - _tail) >= IMU_RING_SIZE) {
+    _tail++;  // Full: drop the oldest
+    _dropped++;
+  }
+  _ring[_head % IMU_RING_SIZE] = sample;
+  _head++;
+}
 
-    // Read gyroscope
-    _qmi.getGyroscope(_gyro.x, _gyro.y, _gyro.z);
+bool IMU::popSample(IMUSample& sample) {
+  if (_head == _tail) return false;
+  sample = _ring[_tail % IMU_RING_SIZE];
+  _tail++;
+  return true;
+}
 
-    _hasNewData = true;
+void IMU::setWakeOnMotion(bool enable) {
+  if (!_available || enable == _wakeOnMotion) return;
+
+  if (enable) {
+    // Accelerometer alone in low-power mode, event on INT2
+    _qmi.configWakeOnMotion(
+      IMU_WOM_THRESHOLD_MG,
+      SensorQMI8658::ACC_ODR_LOWPOWER_128Hz,
+      SensorQMI8658::INTERRUPT_PIN_2
+    );
+#if IMU_INT_PIN >= 0
+    // Let the motion edge end a light sleep too
+    gpio_wakeup_enable((gpio_num_t)IMU_INT_PIN, GPIO_INTR_HIGH_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+    _seenIrqs = s_irqCount;
+#endif
+    _motionWake = false;
+    _wakeOnMotion = true;
+    Serial.printf("[IMU] Wake-on-motion armed (%d mg)\n", IMU_WOM_THRESHOLD_MG);
   } else {
-    _hasNewData = false;
+#if IMU_INT_PIN >= 0
+    gpio_wakeup_disable((gpio_num_t)IMU_INT_PIN);
+#endif
+    // Reset clears the WoM engine; then restore normal FIFO sampling
+    _qmi.reset();
+    configureSampling();
+    _head = _tail = 0;
+    _wakeOnMotion = false;
+    Serial.println("[IMU] Wake-on-motion off, FIFO sampling resumed");
   }
 }
 
+bool IMU::consumeMotionWake() {
+  bool wake = _motionWake;
+  _motionWake = false;
+  return wake;
+}
+
 uint8_t IMU::getChipID() const {
   if (!_available) return 0;
   // Cast away const - getChipID doesn't modify state but isn't marked const in library
@@ -7,6 +7,19 @@
  *
  * I2C Address: 0x6B
  * Uses shared I2C bus (SDA=GPIO11, SCL=GPIO10)
+ *
+ * Samples are collected by the chip's hardware FIFO (stream mode, 32
+ * samples deep, watermark IMU_FIFO_WATERMARK) and burst-read in one I2C
+ * transaction per batch into a ring buffer, so nothing is lost when the
+ * loop is slow and the bus shared with the touch controller is not
+ * polled every sample period. With IMU_INT_PIN wired, update() only
+ * touches the bus after the watermark interrupt.
+ *
+ * While the display sleeps the chip can be switched to its wake-on-motion
+ * engine (accelerometer in low-power mode, gyro off). A motion event is
+ * signalled on the interrupt pin, which is also armed as a light-sleep
+ * wakeup source; without a pin the status register is read at the
+ * update() rate instead.
  */
 
 #ifndef IMU_H
@@ -19,6 +32,27 @@
 // QMI8658 I2C address on Waveshare board
 #define IMU_I2C_ADDR 0x6B
 
+// GPIO wired to the QMI8658 INT2 output (FIFO watermark / wake-on-motion).
+// Not routed on every board revision: -1 = poll the FIFO and status register
+#ifndef IMU_INT_PIN
+#define IMU_INT_PIN -1
+#endif
+
+// FIFO samples per watermark interrupt (the FIFO holds 32)
+#ifndef IMU_FIFO_WATERMARK
+#define IMU_FIFO_WATERMARK 16
+#endif
+
+// Samples kept for consumers between pops (power of two)
+#ifndef IMU_RING_SIZE
+#define IMU_RING_SIZE 64
+#endif
+
+// Wake-on-motion threshold in mg
+#ifndef IMU_WOM_THRESHOLD_MG
+#define IMU_WOM_THRESHOLD_MG 200
+#endif
+
 /**
  * @brief 3-axis vector for accelerometer/gyroscope data
  */
@@ -28,6 +62,15 @@ struct IMUVector {
   float z;
 };
 
+/**
+ * @brief One FIFO sample with its estimated capture time
+ */
+struct IMUSample {
+  IMUVector accel;
+  IMUVector gyro;
+  uint32_t t;   // millis(), back-dated from the batch read by the ODR
+};
+
 /**
  * @brief QMI8658 IMU wrapper class
  *
@@ -59,11 +102,44 @@ public:
   /**
    * @brief Update sensor readings (call periodically)
    *
-   * Checks if new data is ready and updates cached values.
-   * Call this in the main loop or before reading values.
+   * Drains the FIFO into the ring buffer and updates the cached values
+   * with the newest sample. With IMU_INT_PIN wired, returns without bus
+   * traffic until the watermark interrupt fires. In wake-on-motion mode,
+   * checks for the motion event instead.
    */
   void update();
 
+  /**
+   * @brief Take the oldest buffered sample
+   * @return false if the ring is empty
+   */
+  bool popSample(IMUSample& sample);
+
+  /**
+   * @brief Number of buffered samples
+   */
+  uint8_t available() const { return (uint8_t)(_head - _tail); }
+
+  /**
+   * @brief Switch between normal sampling and wake-on-motion
+   * @param enable true = low-power motion detection (FIFO stops)
+   *
+   * Idempotent; call with the display's sleep state.
+   */
+  void setWakeOnMotion(bool enable);
+
+  bool isWakeOnMotion() const { return _wakeOnMotion; }
+
+  /**
+   * @brief Check for a wake-on-motion event (clears it)
+   */
+  bool consumeMotionWake();
+
+  // Stats
+  uint32_t samplesRead() const { return _samplesRead; }
+  uint32_t batchesRead() const { return _batches; }
+  uint32_t droppedSamples() const { return _dropped; }
+
   /**
    * @brief Get board/chip temperature
    * @return Temperature in Celsius
@@ -95,9 +171,28 @@ public:
   bool hasNewData() const { return _hasNewData; }
 
 private:
+  static void IRAM_ATTR onInterrupt();
+  bool configureSampling();
+  void drainFifo();
+  void push(const IMUSample& sample);
+
+  // Written by the ISR
+  static volatile uint32_t s_irqCount;
+
   SensorQMI8658 _qmi;
   bool _available;
   bool _hasNewData;
+  bool _wakeOnMotion;
+  bool _motionWake;
+  uint32_t _seenIrqs;
+  unsigned long _lastDrain;
+
+  IMUSample _ring[IMU_RING_SIZE];
+  uint8_t _head;
+  uint8_t _tail;
+  uint32_t _samplesRead;
+  uint32_t _batches;
+  uint32_t _dropped;
 
   // Cached sensor values
   float _temperature;
@@ -4,15 +4,25 @@
 
 #include "TouchInput.h"
 
+volatile uint32_t TouchInput::s_irqCount = 0;
+volatile uint32_t TouchInput::s_irqTime = 0;
+
 TouchInput::TouchInput()
   : _initialized(false)
   , _touched(false)
   , _x(-1)
   , _y(-1)
+  , _intPin(-1)
+  , _seenIrqs(0)
+  , _lastSampleTime(0)
+  , _head(0)
+  , _tail(0)
+  , _reads(0)
+  , _dropped(0)
 {
 }
 
-bool TouchInput::begin(TwoWire& wire, int sda, int scl, uint8_t addr) {
+bool TouchInput::begin(TwoWire& wire, int sda, int scl, uint8_t addr, int intPin) {
   if (!_touch.begin(wire, addr, sda, scl)) {
     Serial.println("[TOUCH] CST816T not found");
     return false;
@@ -20,20 +30,82 @@ bool TouchInput::begin(TwoWire& wire, int sda, int scl, uint8_t addr) {
 
   Serial.printf("[TOUCH] Initialized: %s\n", _touch.getModelName());
   _initialized = true;
+
+  _intPin = intPin;
+  if (_intPin >= 0) {
+    pinMode(_intPin, INPUT_PULLUP);
+    _seenIrqs = s_irqCount;
+    attachInterrupt(digitalPinToInterrupt(_intPin), onInterrupt, FALLING);
+    Serial.printf("[TOUCH] Interrupt on GPIO%d\n", _intPin);
+  } else {
+    Serial.println("[TOUCH] No interrupt pin, polling");
+  }
   return true;
 }
 
+void IRAM_ATTR TouchInput::onInterrupt() {
+  s_irqCount++;
+  s_irqTime = millis();
+}
+
 bool TouchInput::read() {
   if (!_initialized) {
     _touched = false;
     return false;
   }
 
-  uint8_t points = _touch.getPoint(&_x, &_y, 1);
+  int16_t x, y;
+  uint8_t points = _touch.getPoint(&x, &y, 1);
+  _reads++;
   _touched = (points > 0);
+  if (_touched) {
+    _x = x;  // Keep the last position across the release
+    _y = y;
+  }
   return _touched;
 }
 
+uint8_t TouchInput::service() {
+  if (!_initialized) return 0;
+
+  uint32_t now = millis();
+  uint32_t sampleTime = now;
+
+  if (_intPin >= 0) {
+    uint32_t irqs = s_irqCount;
+    if (irqs != _seenIrqs) {
+      _seenIrqs = irqs;
+      sampleTime = s_irqTime;
+    } else if (!_touched || now - _lastSampleTime < TOUCH_RELEASE_MS) {
+      return 0;  // Nothing new, and not waiting on a release
+    }
+  }
+
+  bool wasTouched = _touched;
+  read();
+  if (!_touched && !wasTouched) return 0;  // Idle poll (or stray pulse)
+
+  _lastSampleTime = now;
+  push(TouchSample{_x, _y, sampleTime, _touched});
+  return 1;
+}
+
+void TouchInput::push(const TouchSample& sample) {
+  if ((uint8_t)(_head - _tail) >= TOUCH_RING_SIZE) {
+    _tail++;  // Full: drop the oldest
+    _dropped++;
+  }
+  _ring[_head % TOUCH_RING_SIZE] = sample;
+  _head++;
+}
+
+bool TouchInput::popSample(TouchSample& sample) {
+  if (_head == _tail) return false;
+  sample = _ring[_tail % TOUCH_RING_SIZE];
+  _tail++;
+  return true;
+}
+
 const char* TouchInput::getModelName() {
   if (!_initialized) return "Not initialized";
   return _touch.getModelName();
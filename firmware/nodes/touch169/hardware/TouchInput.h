@@ -4,6 +4,17 @@
  * Provides a clean interface to the touch hardware, abstracting
  * the SensorLib TouchClassCST816 driver.
  *
+ * The CST816T pulls its INT line low for every report while a finger is
+ * down (about every 10 ms). With TOUCH_INT_PIN wired, the ISR only counts
+ * pulses and records their time; service() reads the controller over I2C
+ * only after a pulse, so the shared bus stays quiet while nobody touches
+ * the screen. Each read becomes a timestamped sample in a small ring
+ * buffer, which InputManager feeds to GestureDetector.
+ *
+ * Release is detected by a read that returns no points. If INT stays
+ * quiet for TOUCH_RELEASE_MS while touched, one confirming read is made.
+ * With TOUCH_INT_PIN < 0, service() reads on every call (polling).
+ *
  * Extracted from main.cpp as part of Phase R10 refactoring.
  *
  * Usage:
@@ -11,9 +22,10 @@
  *   touch.begin(Wire, TOUCH_SDA, TOUCH_SCL);
  *
  *   // In loop:
- *   if (touch.read()) {
- *     int16_t x = touch.getX();
- *     int16_t y = touch.getY();
+ *   touch.service();
+ *   TouchSample s;
+ *   while (touch.popSample(s)) {
+ *     // s.x, s.y, s.t (millis), s.down
  *   }
  */
 
@@ -25,6 +37,33 @@
 #include "touch/TouchClassCST816.h"
 #include "../BoardConfig.h"
 
+// Touch controller interrupt (TP_INT in the Waveshare pin config), -1 = poll
+#ifndef TOUCH_INT_PIN
+#define TOUCH_INT_PIN 14
+#endif
+
+// Samples buffered between services (power of two)
+#ifndef TOUCH_RING_SIZE
+#define TOUCH_RING_SIZE 16
+#endif
+static_assert((TOUCH_RING_SIZE & (TOUCH_RING_SIZE - 1)) == 0 && TOUCH_RING_SIZE <= 128,
+              "TOUCH_RING_SIZE must be a power of two up to 128");
+
+// INT silence while touched before a read confirms the release
+#ifndef TOUCH_RELEASE_MS
+#define TOUCH_RELEASE_MS 40
+#endif
+
+/**
+ * One controller report
+ */
+struct TouchSample {
+  int16_t x;
+  int16_t y;
+  uint32_t t;    // millis() of the interrupt (or of the read when polling)
+  bool down;     // false = finger lifted (x/y hold the last position)
+};
+
 class TouchInput {
 public:
   TouchInput();
@@ -35,16 +74,40 @@ public:
    * @param sda I2C data pin
    * @param scl I2C clock pin
    * @param addr I2C address (default 0x15 for CST816T)
+   * @param intPin Controller INT pin (-1 = poll on every service())
    * @return true if initialization succeeded
    */
-  bool begin(TwoWire& wire, int sda = TOUCH_SDA, int scl = TOUCH_SCL, uint8_t addr = 0x15);
+  bool begin(TwoWire& wire, int sda = TOUCH_SDA, int scl = TOUCH_SCL, uint8_t addr = 0x15,
+             int intPin = TOUCH_INT_PIN);
 
   /**
-   * Read touch state
+   * Read touch state now (always talks to the controller)
    * @return true if screen is being touched
    */
   bool read();
 
+  /**
+   * Read the controller if it signalled new data, queueing a sample
+   * Call from the main loop; cheap when nothing is touching the screen
+   * @return Number of samples queued (0 or 1)
+   */
+  uint8_t service();
+
+  /**
+   * Take the oldest queued sample
+   * @return false if the ring is empty
+   */
+  bool popSample(TouchSample& sample);
+
+  /**
+   * True if reads are driven by the INT line
+   */
+  bool usesInterrupt() const { return _intPin >= 0; }
+
+  // Stats
+  uint32_t readCount() const { return _reads; }
+  uint32_t droppedSamples() const { return _dropped; }
+
   /**
    * Check if touch controller is initialized
    */
@@ -71,11 +134,28 @@ public:
   const char* getModelName();
 
 private:
+  static void IRAM_ATTR onInterrupt();
+  void push(const TouchSample& sample);
+
+  // Written by the ISR (one controller per board)
+  static volatile uint32_t s_irqCount;
+  static volatile uint32_t s_irqTime;
+
   TouchClassCST816 _touch;
   bool _initialized;
   bool _touched;
   int16_t _x;
   int16_t _y;
+
+  int _intPin;
+  uint32_t _seenIrqs;       // s_irqCount at the last service
+  uint32_t _lastSampleTime;
+
+  TouchSample _ring[TOUCH_RING_SIZE];
+  uint8_t _head;            // Next write
+  uint8_t _tail;            // Next read
+  uint32_t _reads;
+  uint32_t _dropped;
 };
 
 #endif // TOUCH_INPUT_H
@@ -35,6 +35,11 @@
 
 #include <MeshSwarm.h>
 #include <TFT_eSPI.h>
+#include <ClockHand.h>
+#include <GlyphAtlas.h>
+#include <FastBoot.h>
+#include <PerfStats.h>
+#include <BroadcastOta.h>
 #include <time.h>
 #include <sys/time.h>
 #include <Wire.h>
@@ -48,6 +53,7 @@
 #include "core/TimeSource.h"
 #include "core/Navigator.h"
 #include "core/SettingsManager.h"
+#include "core/Scheduler.h"
 
 // Hardware layer
 #include "hardware/GestureDetector.h"
@@ -64,9 +70,12 @@
 #include "ui/screens/DebugScreen.h"
 
 // ============== GLOBALS ==============
+FastBoot fastBoot;
 MeshSwarm swarm;
+OtaBroadcastReceiver otaReceiver;
 TFT_eSPI tft = TFT_eSPI();
 SettingsManager settings;
+AdcSampler adc;
 Battery battery;
 TimeSource timeSource;
 Navigator navigator;
@@ -77,27 +86,32 @@ PowerManager power;
 TouchInput touchInput;
 InputManager input(touchInput, gesture);
 IMU imu;
+Scheduler scheduler;
 
 // Touch state (used by processTouchZones)
 int16_t touchX = -1;
 int16_t touchY = -1;
 
 // Previous sensor values for efficient redraw
-String prevTemp = "";
-String prevHumid = "";
-String prevLight = "";
-String prevMotion = "";
-String prevLed = "";
+MeshReading prevTemp;
+MeshReading prevHumid;
+MeshReading prevLight;
+MeshReading prevMotion;
+MeshReading prevLed;
+bool cornersDirty = true;  // Redraw every corner regardless of the previous values
 
 // Time tracking
 int lastSec = -1;
 int lastMin = -1;
 int lastHour = -1;
 
-// Previous hand positions for efficient redraw
-float prevSecAngle = -999;
-float prevMinAngle = -999;
-float prevHourAngle = -999;
+// Clock hands (each keeps its on-screen spans, so a move erases only what changed)
+ClockHand hourHand(CENTER_X, CENTER_Y, HOUR_HAND_LEN, 5, COLOR_HOUR);
+ClockHand minHand(CENTER_X, CENTER_Y, MIN_HAND_LEN, 3, COLOR_MINUTE);
+ClockHand secHand(CENTER_X, CENTER_Y, SEC_HAND_LEN, 1, COLOR_SECOND);
+
+// Digital time digits, rasterized once at boot and pushed as one window
+GlyphAtlas timeDigits;
 
 // Battery indicator state (for redraw optimization)
 bool batteryIndicatorDirty = true;
@@ -111,12 +125,11 @@ bool firstDraw = true;
 
 // ============== FUNCTION DECLARATIONS ==============
 void drawClockFace();
-void drawHand(float angle, int length, uint16_t color, int width);
-void eraseHand(float angle, int length, int width);
 void updateClock();
 void updateCorners();
 void drawCornerLabels();
 void onPowerOff();            // Power off callback for PowerManager
+void onSettingChanged(const char* key);  // Pushes cached settings to their owners
 void drawBatteryIndicator();  // Uses Battery class
 
 // Input callbacks
@@ -137,10 +150,14 @@ void processTouchZones();
 void setup() {
   // CRITICAL: Initialize power management FIRST to latch power on battery
   power.begin();
+  fastBoot.begin();
 
+  // Give a serial monitor time to attach on a cold start only; after an
+  // OTA restart or crash nobody is waiting on the USB port
   Serial.begin(115200);
-  delay(1000);
+  if (!fastBoot.isWarmBoot()) delay(1000);
   Serial.println("\n[TOUCH169] Starting...");
+  fastBoot.mark("serial");
 
   // Initialize backlight
   pinMode(TFT_BL, OUTPUT);
@@ -155,7 +172,12 @@ void setup() {
   tft.setRotation(0);  // Portrait mode
   tft.fillScreen(COLOR_BG);
 
+  if (!timeDigits.begin(2, COLOR_TEXT, COLOR_BG)) {
+    Serial.println("[TOUCH169] Glyph atlas allocation failed, using text drawing");
+  }
+
   Serial.println("[TOUCH169] Display initialized");
+  fastBoot.mark("display");
 
   // Initialize touch controller
   if (touchInput.begin(Wire)) {
@@ -178,15 +200,25 @@ void setup() {
   swarm.begin(NODE_NAME);
   swarm.enableTelemetry(true);
   swarm.enableOTAReceive(NODE_TYPE);
+  otaReceiver.begin(swarm, NODE_TYPE);  // Broadcast jobs; resumes a saved session
   Serial.println("[TOUCH169] MeshSwarm initialized");
+  fastBoot.mark("mesh");
+
+  // Loop timing, message and heap counters (debug screen, "perf" command)
+  perfStats.attach(swarm);
+
+  // Gateway back after a warm boot: sync time now instead of on the retry timer
+  fastBoot.attach(swarm);
+  fastBoot.onRejoin([](uint32_t peerId) { meshState.requestTimeSync(); });
 
   // Initialize mesh state adapter (registers watchers for sensor data)
   meshState.setTimeSource(&timeSource);
   meshState.begin();
   Serial.println("[TOUCH169] MeshState adapter initialized");
 
-  // Initialize battery monitoring
-  battery.begin();
+  // Initialize battery monitoring (registers its pin with the ADC sampler)
+  battery.begin(adc);
+  adc.begin();
   Serial.println("[TOUCH169] Battery monitoring initialized");
 
   // Initialize IMU (QMI8658)
@@ -196,14 +228,21 @@ void setup() {
     Serial.println("[TOUCH169] IMU not found (continuing without it)");
   }
 
+  fastBoot.mark("sensors");
+
   // Register screen renderers
-  display.registerScreen(new DebugScreen(battery, swarm, imu, meshState));
+  display.registerScreen(new DebugScreen(battery, swarm, imu, meshState, scheduler));
   Serial.println("[TOUCH169] DebugScreen registered");
 
   // Initialize display manager with fallback callbacks for non-migrated screens
   display.setFallbackRenderer(fallbackRender);
   display.setFallbackTouchHandler(fallbackTouchHandler);
   display.begin();
+
+  // Apply stored settings, then follow changes from the settings screens
+  onSettingChanged(SettingKey::SLEEP_TIMEOUT);
+  onSettingChanged(SettingKey::TZ_OFFSET);
+  settings.onChange(onSettingChanged);
   Serial.println("[TOUCH169] DisplayManager initialized");
 
   // Set power off callback to show message before power down
@@ -219,35 +258,54 @@ void setup() {
   input.begin();
   Serial.println("[TOUCH169] InputManager initialized");
 
-  // Clear startup message and draw clock
-  delay(500);
+  // Main loop tasks, in the order they run when several are due
+  scheduler.add("msh", 0, []() {
+    PerfScope scope(PERF_UPDATE);
+    swarm.update();
+  });
+  scheduler.add("inp", Timing::INPUT_POLL_INTERVAL, []() { input.update(); });
+  scheduler.add("pwr", Timing::POWER_POLL_INTERVAL, []() { power.update(); });
+  scheduler.add("imu", Timing::IMU_READ_INTERVAL, []() {
+    imu.setWakeOnMotion(display.isAsleep());  // Raise to wake
+    imu.update();
+    if (imu.consumeMotionWake()) display.wake();
+  });
+  scheduler.add("bat", VOLTAGE_READ_INTERVAL, []() { battery.update(); });
+  scheduler.add("drw", Timing::RENDER_INTERVAL_MS, []() {
+    PerfScope scope(PERF_FRAME);
+    display.checkSleepTimeout();
+    display.render();  // DisplayManager checks if asleep
+  });
+  scheduler.add("cfg", Timing::SETTINGS_POLL_INTERVAL, []() { settings.update(); });
+  scheduler.begin();
+  Serial.println("[TOUCH169] Scheduler initialized");
+
+  // Clear startup message and draw clock (leave it readable on a cold start)
+  if (!fastBoot.isWarmBoot()) delay(500);
   tft.fillScreen(COLOR_BG);
   drawClockFace();
   drawCornerLabels();
 
+  fastBoot.mark("ready");
   Serial.println("[TOUCH169] Ready");
 }
 
 // ============== MAIN LOOP ==============
 void loop() {
-  swarm.update();
-  power.update();    // Check power button (long press = power off)
-  battery.update();  // Update battery monitoring
-  imu.update();      // Update IMU readings
-  input.update();    // Handle touch and boot button
-
-  // Check for sleep timeout
-  display.checkSleepTimeout();
-
-  // Render current screen (DisplayManager checks if asleep)
-  display.render();
+  // Runs due tasks, then idles until the next deadline. The mesh runs on
+  // every pass, so it is serviced at least every SCHED_MAX_IDLE_MS.
+  scheduler.run();
 }
 
 // ============== POWER MANAGEMENT ==============
 
 // Power off callback - shows message and turns off backlight
 void onPowerOff() {
-  // Show power off message
+  // Don't lose a change still waiting for its debounced commit
+  settings.flush();
+
+  // Show power off message (after any DMA transfer has finished)
+  display.flush();
   tft.fillScreen(COLOR_BG);
   tft.setTextColor(COLOR_TEXT);
   tft.setTextSize(2);
@@ -259,6 +317,19 @@ void onPowerOff() {
   digitalWrite(TFT_BL, LOW);
 }
 
+// ============== SETTINGS ==============
+
+// Settings listener - values come from the RAM cache, no NVS read
+void onSettingChanged(const char* key) {
+  if (strcmp(key, SettingKey::SLEEP_TIMEOUT) == 0) {
+    display.setSleepTimeout(settings.getSleepTimeout() * 1000UL);
+  } else if (strcmp(key, SettingKey::TZ_OFFSET) == 0) {
+    // Build-time GMT_OFFSET_SEC until an offset has been saved
+    timeSource.setTimezone(settings.getInt(SettingKey::TZ_OFFSET, GMT_OFFSET_SEC / 3600) * 3600L,
+                           DAYLIGHT_OFFSET);
+  }
+}
+
 // ============== BATTERY FUNCTIONS ==============
 
 void drawBatteryIndicator() {
@@ -318,11 +389,9 @@ void drawClockFace() {
 
   // Draw hour ticks
   for (int i = 0; i < 12; i++) {
-    float angle = i * 30 * PI / 180;
-    int x1 = CENTER_X + cos(angle - PI/2) * (CLOCK_RADIUS - 10);
-    int y1 = CENTER_Y + sin(angle - PI/2) * (CLOCK_RADIUS - 10);
-    int x2 = CENTER_X + cos(angle - PI/2) * (CLOCK_RADIUS - 3);
-    int y2 = CENTER_Y + sin(angle - PI/2) * (CLOCK_RADIUS - 3);
+    int x1, y1, x2, y2;
+    FixedTrig::dialPoint(CENTER_X, CENTER_Y, CLOCK_RADIUS - 10, FixedTrig::fromHours(i), &x1, &y1);
+    FixedTrig::dialPoint(CENTER_X, CENTER_Y, CLOCK_RADIUS - 3, FixedTrig::fromHours(i), &x2, &y2);
 
     // Thicker ticks at 12, 3, 6, 9
     if (i % 3 == 0) {
@@ -338,26 +407,6 @@ void drawClockFace() {
   tft.fillCircle(CENTER_X, CENTER_Y, 6, COLOR_HOUR);
 }
 
-void drawHand(float angle, int length, uint16_t color, int width) {
-  float rad = (angle - 90) * PI / 180;
-  int x = CENTER_X + cos(rad) * length;
-  int y = CENTER_Y + sin(rad) * length;
-
-  if (width > 1) {
-    // Draw thick line for hour/minute hands
-    for (int w = -width/2; w <= width/2; w++) {
-      tft.drawLine(CENTER_X + w, CENTER_Y, x + w, y, color);
-      tft.drawLine(CENTER_X, CENTER_Y + w, x, y + w, color);
-    }
-  } else {
-    tft.drawLine(CENTER_X, CENTER_Y, x, y, color);
-  }
-}
-
-void eraseHand(float angle, int length, int width) {
-  drawHand(angle, length, COLOR_BG, width + 2);
-}
-
 void updateClock() {
   struct tm timeinfo;
 
@@ -370,16 +419,12 @@ void updateClock() {
     lastSec = -1;
     lastMin = -1;
     lastHour = -1;
-    prevSecAngle = -999;
-    prevMinAngle = -999;
-    prevHourAngle = -999;
+    hourHand.reset();
+    minHand.reset();
+    secHand.reset();
     firstDraw = true;
-    // Reset corner prev values to force redraw with current sensor data
-    prevTemp = "";
-    prevHumid = "";
-    prevLight = "";
-    prevMotion = "";
-    prevLed = "";
+    // Force corner redraw with current sensor data
+    cornersDirty = true;
   }
 
   // Try to get time from TimeSource
@@ -411,6 +456,9 @@ void updateClock() {
     lastSec = -1;
     lastMin = -1;
     lastHour = -1;
+    hourHand.reset();
+    minHand.reset();
+    secHand.reset();
     firstDraw = true;
   }
 
@@ -421,26 +469,20 @@ void updateClock() {
   // Only update if time changed
   if (sec == lastSec) return;
 
-  // Calculate angles
-  float secAngle = sec * 6;  // 360/60 = 6 degrees per second
-  float minAngle = min * 6 + sec * 0.1;  // Smooth minute hand
-  float hourAngle = hour * 30 + min * 0.5;  // 360/12 = 30 degrees per hour
+  // Move hands (half-degree steps: smooth minute and hour hands)
+  secHand.moveTo(FixedTrig::fromSeconds(sec));
+  minHand.moveTo(FixedTrig::fromMinutes(min, sec));
+  hourHand.moveTo(FixedTrig::fromHours(hour, min));
 
-  // Erase old hands (in reverse order: second, minute, hour)
-  if (prevSecAngle != -999) {
-    eraseHand(prevSecAngle, SEC_HAND_LEN, 1);
-  }
-  if (prevMinAngle != -999 && (min != lastMin || lastMin == -1)) {
-    eraseHand(prevMinAngle, MIN_HAND_LEN, 3);
-  }
-  if (prevHourAngle != -999 && (hour != lastHour || min != lastMin || lastHour == -1)) {
-    eraseHand(prevHourAngle, HOUR_HAND_LEN, 5);
-  }
+  // Erase only pixels the hands have left (second, minute, hour)
+  secHand.erase(tft, COLOR_BG);
+  minHand.erase(tft, COLOR_BG);
+  hourHand.erase(tft, COLOR_BG);
 
-  // Draw new hands (hour, minute, second)
-  drawHand(hourAngle, HOUR_HAND_LEN, COLOR_HOUR, 5);
-  drawHand(minAngle, MIN_HAND_LEN, COLOR_MINUTE, 3);
-  drawHand(secAngle, SEC_HAND_LEN, COLOR_SECOND, 1);
+  // Draw hands (hour, minute, second) - also repairs overlaps erased above
+  hourHand.draw(tft, COLOR_BG);
+  minHand.draw(tft, COLOR_BG);
+  secHand.draw(tft, COLOR_BG);
 
   // Redraw center dot
   tft.fillCircle(CENTER_X, CENTER_Y, 6, COLOR_SECOND);
@@ -451,11 +493,6 @@ void updateClock() {
     firstDraw = false;
   }
 
-  // Store previous angles
-  prevSecAngle = secAngle;
-  prevMinAngle = minAngle;
-  prevHourAngle = hourAngle;
-
   // Update date display at top center (once per minute)
   // Two lines: day of week on top, month + day below
   if (min != lastMin || lastMin == -1) {
@@ -480,12 +517,10 @@ void updateClock() {
 
   // Digital time at bottom center
   if (lastSec != sec) {
-    // Clear digital time area (between corner labels)
-    tft.fillRect(70, SCREEN_HEIGHT - 28, 100, 20, COLOR_BG);
-    tft.setTextSize(2);
-    tft.setTextColor(COLOR_TEXT, COLOR_BG);
-    tft.setCursor(72, SCREEN_HEIGHT - 26);
-    tft.printf("%02d:%02d:%02d", timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
+    // One 96x16 window write; the atlas cells carry their own background
+    char timeBuf[12];
+    snprintf(timeBuf, sizeof(timeBuf), "%02d:%02d:%02d", timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
+    timeDigits.draw(tft, 72, SCREEN_HEIGHT - 26, timeBuf);
   }
 
   lastSec = sec;
@@ -523,54 +558,49 @@ void drawCornerLabels() {
 }
 
 void updateCorners() {
-  // Get current values from mesh state adapter
-  String meshHumid = meshState.getHumidity();
-  String meshTemp = meshState.getTemperature();
-  String meshLight = meshState.getLightLevel();
-  String meshMotion = meshState.getMotionRaw();
-  String meshLed = meshState.getLedRaw();
+  // Readings are parsed once on arrival; nothing here allocates
+  const MeshReading& meshHumid = meshState.getHumidity();
+  const MeshReading& meshTemp = meshState.getTemperature();
+  const MeshReading& meshLight = meshState.getLightLevel();
+  const MeshReading& meshMotion = meshState.getMotion();
+  const MeshReading& meshLed = meshState.getLed();
+  bool redraw = cornersDirty;
+  cornersDirty = false;
+  char text[12];
 
   // Top-left: Humidity
-  if (meshHumid != prevHumid) {
+  if (redraw || !meshHumid.sameAs(prevHumid)) {
     prevHumid = meshHumid;
     tft.fillRect(CORNER_MARGIN, CORNER_MARGIN + 12, 50, 16, COLOR_BG);
     tft.setTextSize(2);
     tft.setTextColor(COLOR_HUMID, COLOR_BG);
     tft.setCursor(CORNER_MARGIN, CORNER_MARGIN + 12);
-    if (meshHumid != "--") {
-      tft.printf("%s%%", meshHumid.c_str());
-    } else {
-      tft.print("--");
-    }
+    tft.print(meshHumid.format(text, sizeof(text), "%.0f%%"));
   }
 
   // Top-right: Temperature
-  if (meshTemp != prevTemp) {
+  if (redraw || !meshTemp.sameAs(prevTemp)) {
     prevTemp = meshTemp;
     tft.fillRect(SCREEN_WIDTH - CORNER_MARGIN - 55, CORNER_MARGIN + 12, 55, 16, COLOR_BG);
     tft.setTextSize(2);
     tft.setTextColor(COLOR_TEMP, COLOR_BG);
     tft.setCursor(SCREEN_WIDTH - CORNER_MARGIN - 55, CORNER_MARGIN + 12);
-    if (meshTemp != "--") {
-      tft.printf("%sC", meshTemp.c_str());
-    } else {
-      tft.print("--");
-    }
+    tft.print(meshTemp.format(text, sizeof(text), "%.1fC"));
   }
 
   // Bottom-left: Light level
-  if (meshLight != prevLight) {
+  if (redraw || !meshLight.sameAs(prevLight)) {
     prevLight = meshLight;
     tft.fillRect(CORNER_MARGIN, SCREEN_HEIGHT - CORNER_MARGIN - 26, 55, 16, COLOR_BG);
     tft.setTextSize(2);
     tft.setTextColor(COLOR_LIGHT, COLOR_BG);
     tft.setCursor(CORNER_MARGIN, SCREEN_HEIGHT - CORNER_MARGIN - 26);
-    if (meshLight != "--") {
-      int lightVal = meshLight.toInt();
+    if (meshLight.valid) {
+      int lightVal = meshLight.asInt();
       if (lightVal >= 1000) {
         tft.printf("%dk", lightVal / 1000);
       } else {
-        tft.print(meshLight.c_str());
+        tft.printf("%d", lightVal);
       }
     } else {
       tft.print("--");
@@ -578,9 +608,9 @@ void updateCorners() {
   }
 
   // Bottom-right: Motion indicator
-  if (meshMotion != prevMotion) {
+  if (redraw || !meshMotion.sameAs(prevMotion)) {
     prevMotion = meshMotion;
-    bool motion = (meshMotion == "1");
+    bool motion = meshMotion.asBool();
     tft.fillCircle(SCREEN_WIDTH - CORNER_MARGIN - 8, SCREEN_HEIGHT - CORNER_MARGIN - 14, 5,
                    motion ? COLOR_MOTION : COLOR_BG);
     if (!motion) {
@@ -589,9 +619,9 @@ void updateCorners() {
   }
 
   // Bottom-right: LED indicator
-  if (meshLed != prevLed) {
+  if (redraw || !meshLed.sameAs(prevLed)) {
     prevLed = meshLed;
-    bool ledOn = (meshLed == "1" || meshLed == "on" || meshLed == "true");
+    bool ledOn = meshLed.asBool();
     tft.fillCircle(SCREEN_WIDTH - CORNER_MARGIN - 8, SCREEN_HEIGHT - CORNER_MARGIN - 2, 5,
                    ledOn ? COLOR_LED : COLOR_BG);
     if (!ledOn) {
@@ -4,6 +4,10 @@
  * Decouples UI components from MeshSwarm implementation.
  * Enables testing with MockMeshState without live mesh.
  *
+ * Values are parsed once when the state message arrives and kept as
+ * MeshReading, so screens compare and draw numbers instead of converting
+ * Strings every frame.
+ *
  * Extracted from main.cpp as part of Phase R7 refactoring.
  */
 
@@ -11,9 +15,39 @@
 #define IMESH_STATE_H
 
 #include <Arduino.h>
+#include <math.h>
+
+/**
+ * One sensor value as last received from the mesh
+ */
+struct MeshReading {
+  float value = 0;          // Parsed number; 1/0 for motion and LED
+  uint32_t updatedMs = 0;   // millis() of the last update, 0 if never
+  bool valid = false;       // false until a parseable value arrives
+
+  int asInt() const { return (int)lroundf(value); }
+  bool asBool() const { return valid && value != 0; }
+
+  /**
+   * Same value for display purposes (timestamps ignored)
+   */
+  bool sameAs(const MeshReading& other) const {
+    return valid == other.valid && (!valid || value == other.value);
+  }
+
+  /**
+   * snprintf the value with fmt, or "--" if not valid
+   * @return buf
+   */
+  const char* format(char* buf, size_t len, const char* fmt) const {
+    if (valid) snprintf(buf, len, fmt, value);
+    else snprintf(buf, len, "--");
+    return buf;
+  }
+};
 
 // Callback type for state changes (function pointer to avoid heap allocation)
-typedef void (*StateChangeCallback)(const String& value);
+typedef void (*StateChangeCallback)(const MeshReading& value);
 
 /**
  * IMeshState interface - abstract access to mesh sensor data
@@ -29,42 +63,42 @@ public:
   virtual ~IMeshState() = default;
 
   // ============== Sensor Values ==============
-  // Returns "--" if no data available
+  // Readings are not valid until data has been received
 
   /**
-   * Get temperature value from mesh
+   * Get temperature in C
    */
-  virtual String getTemperature() const = 0;
+  virtual const MeshReading& getTemperature() const = 0;
 
   /**
-   * Get humidity value from mesh
+   * Get relative humidity in %
    */
-  virtual String getHumidity() const = 0;
+  virtual const MeshReading& getHumidity() const = 0;
 
   /**
-   * Get light level from mesh
+   * Get light level
    */
-  virtual String getLightLevel() const = 0;
+  virtual const MeshReading& getLightLevel() const = 0;
 
   /**
-   * Get motion detection state
+   * Get motion reading (1 = motion)
    */
-  virtual bool getMotionDetected() const = 0;
+  virtual const MeshReading& getMotion() const = 0;
 
   /**
-   * Get raw motion value string (for debug display)
+   * Get LED reading (1 = on)
    */
-  virtual String getMotionRaw() const = 0;
+  virtual const MeshReading& getLed() const = 0;
 
   /**
-   * Get LED state
+   * Get motion detection state
    */
-  virtual bool getLedState() const = 0;
+  virtual bool getMotionDetected() const { return getMotion().asBool(); }
 
   /**
-   * Get raw LED value string (for debug display)
+   * Get LED state
    */
-  virtual String getLedRaw() const = 0;
+  virtual bool getLedState() const { return getLed().asBool(); }
 
   /**
    * Check if any sensor data has been received
@@ -83,7 +117,7 @@ public:
   /**
    * Register callback for state changes on a specific key
    * @param key State key to watch ("temp", "humid", "light", "motion", "led")
-   * @param cb Callback function (receives new value)
+   * @param cb Callback function (receives the parsed reading)
    */
   virtual void onStateChange(const char* key, StateChangeCallback cb) = 0;
 
@@ -6,6 +6,7 @@
 
 #include "MeshSwarmAdapter.h"
 #include "../core/TimeSource.h"
+#include <PerfStats.h>
 #include <cstring>
 
 // Static instance pointer for lambda callbacks
@@ -13,20 +14,22 @@
 // so we use a static pointer that the lambdas can access)
 static MeshSwarmAdapter* s_instance = nullptr;
 
+const char* const MeshSwarmAdapter::KEY_NAMES[KEY_COUNT] = { "temp", "humid", "light", "motion", "led" };
+
 MeshSwarmAdapter::MeshSwarmAdapter(MeshSwarm& swarm)
   : _swarm(swarm)
   , _timeSource(nullptr)
-  , _temp("--")
-  , _humidity("--")
-  , _light("--")
-  , _motion("0")
-  , _led("0")
+  , _baseKeys(0)
   , _hasSensorData(false)
   , _callbackCount(0)
 {
+  // Motion and LED read as off until told otherwise
+  _readings[KEY_MOTION].valid = true;
+  _readings[KEY_LED].valid = true;
+
   // Initialize callback slots
   for (int i = 0; i < MAX_STATE_CALLBACKS; i++) {
-    _callbacks[i].key = nullptr;
+    _callbacks[i].key = KEY_COUNT;
     _callbacks[i].cb = nullptr;
   }
 }
@@ -39,73 +42,71 @@ void MeshSwarmAdapter::begin() {
   // Store instance pointer for static lambda access
   s_instance = this;
 
-  // Watch temperature
   _swarm.watchState("temp", [](const String& key, const String& value, const String& oldValue) {
-    if (s_instance) {
-      s_instance->_temp = value;
-      s_instance->_hasSensorData = true;
-      s_instance->notifyCallbacks("temp", value);
-      Serial.printf("[MESHSTATE] Temperature: %s C\n", value.c_str());
-    }
+    if (s_instance) s_instance->update(KEY_TEMP, value, false);
   });
 
-  // Watch humidity
   _swarm.watchState("humid", [](const String& key, const String& value, const String& oldValue) {
-    if (s_instance) {
-      s_instance->_humidity = value;
-      s_instance->_hasSensorData = true;
-      s_instance->notifyCallbacks("humid", value);
-      Serial.printf("[MESHSTATE] Humidity: %s %%\n", value.c_str());
-    }
+    if (s_instance) s_instance->update(KEY_HUMID, value, false);
   });
 
-  // Watch light level
   _swarm.watchState("light", [](const String& key, const String& value, const String& oldValue) {
-    if (s_instance) {
-      s_instance->_light = value;
-      s_instance->_hasSensorData = true;
-      s_instance->notifyCallbacks("light", value);
-      Serial.printf("[MESHSTATE] Light: %s\n", value.c_str());
-    }
+    if (s_instance) s_instance->update(KEY_LIGHT, value, false);
   });
 
-  // Watch motion
   _swarm.watchState("motion", [](const String& key, const String& value, const String& oldValue) {
-    if (s_instance) {
-      s_instance->_motion = value;
-      s_instance->notifyCallbacks("motion", value);
-      Serial.printf("[MESHSTATE] Motion: %s\n", value.c_str());
-    }
+    if (s_instance) s_instance->update(KEY_MOTION, value, false);
   });
 
-  // Watch LED state
   _swarm.watchState("led", [](const String& key, const String& value, const String& oldValue) {
-    if (s_instance) {
-      s_instance->_led = value;
-      s_instance->notifyCallbacks("led", value);
-      Serial.printf("[MESHSTATE] LED: %s\n", value.c_str());
-    }
+    if (s_instance) s_instance->update(KEY_LED, value, false);
   });
 
-  // Watch time sync from gateway
+  // RTT-compensated time sync with the gateway
+  if (_timeSource) {
+    _timeClient.begin(_swarm, [](uint64_t unixMs, uint32_t atMillis, uint32_t rttMs) {
+      if (s_instance && s_instance->_timeSource) {
+        s_instance->_timeSource->applySyncSample(unixMs, atMillis, rttMs);
+        MESHSTATE_LOG(MESHSTATE_LOG_INFO, "[MESHSTATE] Time synced: %lu (rtt %lu ms, drift %.1f ppm)\n",
+                      (unsigned long)(unixMs / 1000), (unsigned long)rttMs,
+                      s_instance->_timeSource->getDriftPpm());
+      }
+    });
+  }
+
+  // Legacy "time" state from gateways without timesync (ignored once synced)
   _swarm.watchState("time", [](const String& key, const String& value, const String& oldValue) {
-    if (s_instance && s_instance->_timeSource) {
+    if (s_instance && s_instance->_timeSource && !s_instance->_timeClient.synced()) {
       unsigned long unixTime = value.toInt();
       if (unixTime > 1700000000) {
         s_instance->_timeSource->setMeshTime(unixTime);
-        Serial.printf("[MESHSTATE] Time synced: %lu\n", unixTime);
+        MESHSTATE_LOG(MESHSTATE_LOG_INFO, "[MESHSTATE] Time synced (state): %lu\n", unixTime);
       }
     }
   });
 
-  // Wildcard watcher for zone-specific fallback keys
-  _swarm.watchState("*", [](const String& key, const String& value, const String& oldValue) {
-    if (s_instance) {
-      s_instance->handleZoneFallback(key, value);
-    }
+  // Zone-specific fallback keys (temp_zone1, temp_kitchen, etc.)
+  // Temperature/humidity/light only apply while there is no base key value
+  _zoneWatchers.on("temp_*", [](const String& key, const String& value, const String& oldValue) {
+    if (s_instance) s_instance->update(KEY_TEMP, value, true);
+  });
+
+  _zoneWatchers.on("humidity_*", [](const String& key, const String& value, const String& oldValue) {
+    if (s_instance) s_instance->update(KEY_HUMID, value, true);
   });
 
-  Serial.println("[MESHSTATE] Watchers registered");
+  _zoneWatchers.on("light_*", [](const String& key, const String& value, const String& oldValue) {
+    if (s_instance) s_instance->update(KEY_LIGHT, value, true);
+  });
+
+  // Motion from zone - always update (motion is event-based)
+  _zoneWatchers.on("motion_*", [](const String& key, const String& value, const String& oldValue) {
+    if (s_instance) s_instance->update(KEY_MOTION, value, true);
+  });
+
+  _zoneWatchers.attach(_swarm);
+
+  MESHSTATE_LOG(MESHSTATE_LOG_INFO, "[MESHSTATE] Watchers registered\n");
 }
 
 int MeshSwarmAdapter::getNodeCount() const {
@@ -113,10 +114,14 @@ int MeshSwarmAdapter::getNodeCount() const {
 }
 
 void MeshSwarmAdapter::onStateChange(const char* key, StateChangeCallback cb) {
-  if (_callbackCount < MAX_STATE_CALLBACKS && cb != nullptr) {
-    _callbacks[_callbackCount].key = key;
-    _callbacks[_callbackCount].cb = cb;
-    _callbackCount++;
+  if (_callbackCount >= MAX_STATE_CALLBACKS || cb == nullptr) return;
+  for (uint8_t k = 0; k < KEY_COUNT; k++) {
+    if (strcmp(KEY_NAMES[k], key) == 0) {
+      _callbacks[_callbackCount].key = (SensorKey)k;
+      _callbacks[_callbackCount].cb = cb;
+      _callbackCount++;
+      return;
+    }
   }
 }
 
@@ -128,45 +133,36 @@ void MeshSwarmAdapter::setState(const char* key, const String& value) {
   _swarm.setState(key, value);
 }
 
-void MeshSwarmAdapter::notifyCallbacks(const char* key, const String& value) {
-  for (int i = 0; i < _callbackCount; i++) {
-    if (_callbacks[i].key != nullptr && strcmp(_callbacks[i].key, key) == 0) {
-      if (_callbacks[i].cb != nullptr) {
-        _callbacks[i].cb(value);
-      }
-    }
-  }
-}
-
-void MeshSwarmAdapter::handleZoneFallback(const String& key, const String& value) {
-  // Temperature from zone (temp_zone1, temp_kitchen, etc.) - only if no base temp
-  if (key.startsWith("temp_") && _temp == "--") {
-    _temp = value;
-    _hasSensorData = true;
-    notifyCallbacks("temp", value);
-    Serial.printf("[MESHSTATE] Temperature (zone fallback): %s = %s C\n", key.c_str(), value.c_str());
-  }
-
-  // Humidity from zone - only if no base humidity
-  if (key.startsWith("humidity_") && _humidity == "--") {
-    _humidity = value;
-    _hasSensorData = true;
-    notifyCallbacks("humid", value);
-    Serial.printf("[MESHSTATE] Humidity (zone fallback): %s = %s %%\n", key.c_str(), value.c_str());
+void MeshSwarmAdapter::update(SensorKey key, const String& value, bool zoneKey) {
+  uint8_t bit = 1 << key;
+  bool isSwitch = key == KEY_MOTION || key == KEY_LED;
+  if (zoneKey && !isSwitch && (_baseKeys & bit)) return;
+  if (!zoneKey) _baseKeys |= bit;
+
+  MeshReading& reading = _readings[key];
+  if (isSwitch) {
+    reading.value = (value == "1" || value == "on" || value == "true") ? 1 : 0;
+    reading.valid = true;
+  } else {
+    const char* text = value.c_str();
+    char* end = nullptr;
+    float parsed = strtof(text, &end);
+    reading.valid = end != text;
+    reading.value = reading.valid ? parsed : 0;
+    if (reading.valid) _hasSensorData = true;
   }
+  reading.updatedMs = millis();
 
-  // Light from zone - only if no base light
-  if (key.startsWith("light_") && _light == "--") {
-    _light = value;
-    _hasSensorData = true;
-    notifyCallbacks("light", value);
-    Serial.printf("[MESHSTATE] Light (zone fallback): %s = %s\n", key.c_str(), value.c_str());
-  }
+  MESHSTATE_LOG(MESHSTATE_LOG_DEBUG, "[MESHSTATE] %s%s: %s\n", KEY_NAMES[key], zoneKey ? " (zone)" : "",
+                value.c_str());
+  notifyCallbacks(key, reading);
+}
 
-  // Motion from zone - always update (motion is event-based)
-  if (key.startsWith("motion_")) {
-    _motion = value;
-    notifyCallbacks("motion", value);
-    Serial.printf("[MESHSTATE] Motion (zone): %s = %s\n", key.c_str(), value.c_str());
+void MeshSwarmAdapter::notifyCallbacks(SensorKey key, const MeshReading& reading) {
+  PerfScope scope(PERF_WATCHERS);
+  for (int i = 0; i < _callbackCount; i++) {
+    if (_callbacks[i].key == key && _callbacks[i].cb != nullptr) {
+      _callbacks[i].cb(reading);
+    }
   }
 }
@@ -12,7 +12,8 @@
  *   meshState.begin();  // Register watchers after swarm.begin()
  *
  *   // Read sensor values
- *   String temp = meshState.getTemperature();
+ *   const MeshReading& temp = meshState.getTemperature();
+ *   if (temp.valid) tft.printf("%.1fC", temp.value);
  *
  *   // Control actuators
  *   meshState.setLedState(true);
@@ -23,6 +24,18 @@
 
 #include "IMeshState.h"
 #include <MeshSwarm.h>
+#include <StateWatchers.h>
+#include <MeshTimeSync.h>
+
+// Serial logging: 0 = off, 1 = setup and time sync, 2 = every value received
+#define MESHSTATE_LOG_INFO  1
+#define MESHSTATE_LOG_DEBUG 2
+#ifndef MESHSTATE_LOG_LEVEL
+#define MESHSTATE_LOG_LEVEL MESHSTATE_LOG_INFO
+#endif
+
+#define MESHSTATE_LOG(level, ...) \
+  do { if (MESHSTATE_LOG_LEVEL >= (level)) Serial.printf(__VA_ARGS__); } while (0)
 
 // Forward declaration for TimeSource integration
 class TimeSource;
@@ -32,10 +45,10 @@ class TimeSource;
  *
  * Responsibilities:
  * - Register watchers on MeshSwarm for sensor keys
- * - Cache sensor values for efficient polling
+ * - Parse sensor values once on arrival and cache them for polling
  * - Support zone-specific fallback keys (temp_zone1, etc.)
  * - Notify registered callbacks on state changes
- * - Sync time to TimeSource when "time" key received
+ * - Sync time to TimeSource via RTT-compensated timesync exchanges
  */
 class MeshSwarmAdapter : public IMeshState {
 public:
@@ -57,13 +70,18 @@ public:
    */
   void setTimeSource(TimeSource* ts);
 
+  /**
+   * Start a time sync burst now (e.g. the gateway is back after a warm boot)
+   */
+  void requestTimeSync() { _timeClient.requestNow(); }
+
   // ============== IMeshState Implementation ==============
 
-  String getTemperature() const override { return _temp; }
-  String getHumidity() const override { return _humidity; }
-  String getLightLevel() const override { return _light; }
-  bool getMotionDetected() const override { return _motion == "1"; }
-  bool getLedState() const override { return _led == "1"; }
+  const MeshReading& getTemperature() const override { return _readings[KEY_TEMP]; }
+  const MeshReading& getHumidity() const override { return _readings[KEY_HUMID]; }
+  const MeshReading& getLightLevel() const override { return _readings[KEY_LIGHT]; }
+  const MeshReading& getMotion() const override { return _readings[KEY_MOTION]; }
+  const MeshReading& getLed() const override { return _readings[KEY_LED]; }
   bool hasSensorData() const override { return _hasSensorData; }
 
   int getNodeCount() const override;
@@ -73,55 +91,50 @@ public:
   void setLedState(bool on) override;
   void setState(const char* key, const String& value) override;
 
-  // ============== Raw Value Access (for debug screens) ==============
-
-  /**
-   * Get raw motion value string
-   */
-  String getMotionRaw() const override { return _motion; }
-
-  /**
-   * Get raw LED value string
-   */
-  String getLedRaw() const override { return _led; }
-
 private:
+  friend struct AdapterBench;  // nodes/bench times notifyCallbacks()
+
   static const int MAX_STATE_CALLBACKS = 8;
 
+  enum SensorKey : uint8_t { KEY_TEMP, KEY_HUMID, KEY_LIGHT, KEY_MOTION, KEY_LED, KEY_COUNT };
+  static const char* const KEY_NAMES[KEY_COUNT];
+
   // Callback slot - associates a key with a callback function
   struct StateCallbackSlot {
-    const char* key;           // State key to match
+    SensorKey key;             // Resolved once at registration
     StateChangeCallback cb;    // Callback function pointer
   };
 
   MeshSwarm& _swarm;
   TimeSource* _timeSource;
 
-  // Cached sensor values
-  String _temp;
-  String _humidity;
-  String _light;
-  String _motion;
-  String _led;
+  // Cached sensor values, parsed on arrival
+  MeshReading _readings[KEY_COUNT];
+  uint8_t _baseKeys;           // Bit per key once its base key (not a zone key) has a value
   bool _hasSensorData;
 
   // Static callback array (no heap allocation)
   StateCallbackSlot _callbacks[MAX_STATE_CALLBACKS];
   int _callbackCount;
 
+  // Prefix watchers for zone-specific fallback keys
+  StateWatchers _zoneWatchers;
+
+  // Time sync client (active when a TimeSource is set)
+  MeshTimeClient _timeClient;
+
   /**
-   * Fire all callbacks registered for a specific key
-   * @param key State key that changed
-   * @param value New value
+   * Parse a received value into its reading and notify
+   * @param zoneKey Value came from a zone key (temp_kitchen, ...)
    */
-  void notifyCallbacks(const char* key, const String& value);
+  void update(SensorKey key, const String& value, bool zoneKey);
 
   /**
-   * Handle zone-specific fallback keys
-   * @param key Full key (e.g., "temp_zone1")
-   * @param value Value received
+   * Fire all callbacks registered for a specific key
+   * @param key State key that changed
+   * @param reading New reading
    */
-  void handleZoneFallback(const String& key, const String& value);
+  void notifyCallbacks(SensorKey key, const MeshReading& reading);
 };
 
 #endif // MESH_SWARM_ADAPTER_H
@@ -0,0 +1,120 @@
+/**
+ * Compositor - Dirty-region compositing over pooled sprite tiles
+ *
+ * Implementation of tile pool management and change detection.
+ */
+
+#include "Compositor.h"
+
+Compositor::Compositor(TFT_eSPI& tft)
+  : _tft(tft)
+  , _pipeline(nullptr)
+  , _ready(false)
+  , _openId(-1)
+  , _openTile(0)
+  , _nextTile(0)
+  , _regionsDrawn(0)
+  , _regionsPushed(0)
+  , _bytesPushed(0)
+{
+  for (int i = 0; i < COMPOSITOR_TILES; i++) {
+    _tiles[i] = nullptr;
+  }
+  invalidate();
+}
+
+bool Compositor::begin() {
+  if (_ready) return true;
+
+  for (int i = 0; i < COMPOSITOR_TILES; i++) {
+    _tiles[i] = new TFT_eSprite(&_tft);
+    _tiles[i]->setColorDepth(16);
+    if (_tiles[i]->createSprite(COMPOSITOR_TILE_W, COMPOSITOR_TILE_H) == nullptr) {
+      Serial.printf("[DISPLAY] Compositor: tile %d allocation failed, drawing direct\n", i);
+      for (int j = 0; j <= i; j++) {
+        _tiles[j]->deleteSprite();
+        delete _tiles[j];
+        _tiles[j] = nullptr;
+      }
+      return false;
+    }
+  }
+
+  _ready = true;
+  Serial.printf("[DISPLAY] Compositor: %d tiles of %dx%d (%u bytes)\n",
+                COMPOSITOR_TILES, COMPOSITOR_TILE_W, COMPOSITOR_TILE_H,
+                (unsigned)(COMPOSITOR_TILES * COMPOSITOR_TILE_W * COMPOSITOR_TILE_H * 2));
+  return true;
+}
+
+void Compositor::invalidate() {
+  for (int i = 0; i < COMPOSITOR_MAX_REGIONS; i++) {
+    _regions[i].valid = false;
+  }
+}
+
+TFT_eSPI* Compositor::beginRegion(uint8_t id, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t bg) {
+  if (!_ready || _openId >= 0 || id >= COMPOSITOR_MAX_REGIONS) return nullptr;
+
+  if (w > COMPOSITOR_TILE_W) w = COMPOSITOR_TILE_W;
+  if (h > COMPOSITOR_TILE_H) h = COMPOSITOR_TILE_H;
+
+  Region& r = _regions[id];
+  if (!r.valid || r.x != x || r.y != y || r.w != w || r.h != h) {
+    r.x = x;
+    r.y = y;
+    r.w = w;
+    r.h = h;
+    r.valid = false;
+  }
+
+  _openId = id;
+  _openTile = _nextTile;
+  _nextTile = (_nextTile + 1) % COMPOSITOR_TILES;
+
+  TFT_eSprite* tile = _tiles[_openTile];
+  tile->fillRect(0, 0, w, h, bg);
+  return tile;
+}
+
+bool Compositor::endRegion() {
+  if (_openId < 0) return false;
+
+  Region& r = _regions[_openId];
+  TFT_eSprite* tile = _tiles[_openTile];
+  _openId = -1;
+  _regionsDrawn++;
+
+  uint32_t hash = hashTile(*tile, r.w, r.h);
+  if (r.valid && r.hash == hash) return false;
+
+  if (_pipeline != nullptr) {
+    _pipeline->pushRect(r.x, r.y, r.w, r.h, (const uint16_t*)tile->getPointer(), COMPOSITOR_TILE_W);
+  } else {
+    tile->pushSprite(r.x, r.y, 0, 0, r.w, r.h);
+  }
+  r.hash = hash;
+  r.valid = true;
+  _regionsPushed++;
+  _bytesPushed += (uint32_t)r.w * r.h * 2;
+  return true;
+}
+
+TFT_eSPI& Compositor::getTft() {
+  if (_pipeline != nullptr) _pipeline->finish();
+  return _tft;
+}
+
+uint32_t Compositor::hashTile(const TFT_eSprite& tile, int16_t w, int16_t h) const {
+  // FNV-1a over the region's pixels, one 16-bit pixel per step
+  const uint16_t* pixels = (const uint16_t*)const_cast<TFT_eSprite&>(tile).getPointer();
+  uint32_t hash = 2166136261u;
+  for (int16_t row = 0; row < h; row++) {
+    const uint16_t* p = pixels + (size_t)row * COMPOSITOR_TILE_W;
+    for (int16_t col = 0; col < w; col++) {
+      hash ^= p[col];
+      hash *= 16777619u;
+    }
+  }
+  return hash;
+}
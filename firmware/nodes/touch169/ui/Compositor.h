@@ -0,0 +1,127 @@
+/**
+ * Compositor - Dirty-region compositing over pooled sprite tiles
+ *
+ * Screens declare regions by id, draw each one into an off-screen
+ * TFT_eSprite tile, and the compositor pushes the tile to the panel only
+ * if its pixels differ from what was pushed for that region last time.
+ * Regions are drawn complete before they reach the panel, so clearing and
+ * redrawing no longer flickers, and unchanged regions cost no SPI traffic.
+ *
+ * With a DisplayPipeline attached, changed regions are copied into its DMA
+ * buffers and sent while the next region is drawn. Without one they are
+ * pushed with blocking pushSprite().
+ *
+ * All tile memory is allocated once in begin(); frames never allocate.
+ * If the allocation fails the compositor stays disabled and DisplayManager
+ * falls back to rendering straight to the TFT.
+ *
+ * Usage (inside ScreenRenderer::compose):
+ *   TFT_eSPI* g = comp.beginRegion(REGION_BATTERY, 10, 45, 220, 60, Colors::BG);
+ *   if (g) {
+ *     g->setCursor(0, 0);       // Region-local coordinates
+ *     g->print("Battery:");
+ *     comp.endRegion();         // Pushed only if the pixels changed
+ *   }
+ */
+
+#ifndef COMPOSITOR_H
+#define COMPOSITOR_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include <DisplayPipeline.h>
+
+// Tile size: the largest region a screen may declare
+#ifndef COMPOSITOR_TILE_W
+#define COMPOSITOR_TILE_W 240
+#endif
+
+#ifndef COMPOSITOR_TILE_H
+#define COMPOSITOR_TILE_H 80
+#endif
+
+// Tiles in the pool (16-bit color: 38.4 KB each at 240x80). One is enough
+// with the DMA pipeline, which copies each region out before sending it.
+#ifndef COMPOSITOR_TILES
+#define COMPOSITOR_TILES 1
+#endif
+
+// Region ids tracked for change detection
+#ifndef COMPOSITOR_MAX_REGIONS
+#define COMPOSITOR_MAX_REGIONS 16
+#endif
+
+class Compositor {
+public:
+  explicit Compositor(TFT_eSPI& tft);
+
+  /**
+   * Allocate the tile pool (call once at boot)
+   * @return true if compositing is available
+   */
+  bool begin();
+
+  bool isReady() const { return _ready; }
+
+  /**
+   * Send regions through a DMA pipeline (nullptr = blocking pushSprite)
+   */
+  void setPipeline(DisplayPipeline* pipeline) { _pipeline = pipeline; }
+
+  /**
+   * Forget pushed content so the next frame pushes every region
+   * Call after anything draws to the panel directly (screen change, wake)
+   */
+  void invalidate();
+
+  /**
+   * Start drawing a region
+   * @param id Stable region id (0 .. COMPOSITOR_MAX_REGIONS-1) within the screen
+   * @param x,y,w,h Panel rectangle; w/h are clamped to the tile size
+   * @param bg Fill color for the tile
+   * @return Canvas in region-local coordinates, or nullptr if unavailable
+   */
+  TFT_eSPI* beginRegion(uint8_t id, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t bg);
+
+  /**
+   * Finish the open region, pushing it if its content changed
+   * @return true if the region was pushed to the panel
+   */
+  bool endRegion();
+
+  /**
+   * Get the TFT for direct drawing (waits for any DMA transfer first)
+   */
+  TFT_eSPI& getTft();
+
+  // Stats
+  uint32_t regionsDrawn() const { return _regionsDrawn; }
+  uint32_t regionsPushed() const { return _regionsPushed; }
+  uint32_t bytesPushed() const { return _bytesPushed; }
+
+private:
+  struct Region {
+    int16_t x, y, w, h;
+    uint32_t hash;
+    bool valid;
+  };
+
+  TFT_eSPI& _tft;
+  DisplayPipeline* _pipeline;
+  TFT_eSprite* _tiles[COMPOSITOR_TILES];
+  Region _regions[COMPOSITOR_MAX_REGIONS];
+  bool _ready;
+
+  // Open region
+  int _openId;
+  uint8_t _openTile;
+  uint8_t _nextTile;
+
+  uint32_t _regionsDrawn;
+  uint32_t _regionsPushed;
+  uint32_t _bytesPushed;
+
+  uint32_t hashTile(const TFT_eSprite& tile, int16_t w, int16_t h) const;
+};
+
+#endif // COMPOSITOR_H
@@ -10,6 +10,7 @@ DisplayManager::DisplayManager(TFT_eSPI& tft, Navigator& nav, int backlightPin)
   : _tft(tft)
   , _nav(nav)
   , _backlightPin(backlightPin)
+  , _compositor(tft)
   , _screenCount(0)
   , _asleep(false)
   , _lastActivityTime(0)
@@ -27,6 +28,11 @@ DisplayManager::DisplayManager(TFT_eSPI& tft, Navigator& nav, int backlightPin)
 void DisplayManager::begin() {
   _lastActivityTime = millis();
   _lastScreen = _nav.current();
+  // Tile pool and DMA buffers are allocated once, here
+  _compositor.begin();
+  if (_pipeline.begin(_tft)) {
+    _compositor.setPipeline(&_pipeline);
+  }
   Serial.println("[DISPLAY] DisplayManager initialized");
 }
 
@@ -59,11 +65,20 @@ void DisplayManager::render() {
     bool forceRedraw = _nav.hasChanged();
     if (forceRedraw) {
       _nav.clearChanged();
+      _compositor.invalidate();
+    }
+    if (_compositor.isReady()) {
+      // Transfers may still be running when this returns
+      renderer->compose(_compositor, forceRedraw);
+    } else {
+      renderer->render(_tft, forceRedraw);
     }
-    renderer->render(_tft, forceRedraw);
   } else if (_fallbackRenderer != nullptr) {
-    // Use fallback for screens not yet migrated
+    // Use fallback for screens not yet migrated (draws direct, so the
+    // next composited frame must push every region)
+    _pipeline.finish();
     _fallbackRenderer(current, _tft, _nav);
+    _compositor.invalidate();
   }
 }
 
@@ -91,6 +106,7 @@ void DisplayManager::sleep() {
   if (_asleep) return;
 
   _asleep = true;
+  _pipeline.finish();
   Serial.println("[DISPLAY] Going to sleep...");
 
   // Turn off backlight
@@ -127,6 +143,11 @@ void DisplayManager::setSleepTimeout(unsigned long timeoutMs) {
   _sleepTimeoutMs = timeoutMs;
 }
 
+TFT_eSPI& DisplayManager::getTft() {
+  _pipeline.finish();
+  return _tft;
+}
+
 ScreenRenderer* DisplayManager::findRenderer(Screen screen) {
   for (int i = 0; i < _screenCount; i++) {
     if (_screens[i] != nullptr && _screens[i]->getScreen() == screen) {
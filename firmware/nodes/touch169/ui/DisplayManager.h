@@ -2,7 +2,8 @@
  * DisplayManager - Screen routing and display management
  *
  * Routes rendering to the appropriate ScreenRenderer based on current screen.
- * Manages display sleep/wake and screen transitions.
+ * Manages display sleep/wake and screen transitions. Registered screens
+ * render through a Compositor so only changed regions reach the panel.
  *
  * Extracted from main.cpp as part of Phase R8 refactoring.
  *
@@ -23,6 +24,8 @@
 #include <TFT_eSPI.h>
 #include "../core/Navigator.h"
 #include "ScreenRenderer.h"
+#include "Compositor.h"
+#include <DisplayPipeline.h>
 #include "../BoardConfig.h"
 
 /**
@@ -33,6 +36,7 @@
  * - Manage display sleep/wake
  * - Track activity for sleep timeout
  * - Handle screen transitions
+ * - Own the compositor tile pool and DMA pipeline
  */
 class DisplayManager {
 public:
@@ -104,8 +108,19 @@ public:
 
   /**
    * Get TFT instance for direct access when needed
+   * Waits for any DMA transfer in flight first
    */
-  TFT_eSPI& getTft() { return _tft; }
+  TFT_eSPI& getTft();
+
+  /**
+   * Wait for DMA transfers before drawing to the TFT outside render()
+   */
+  void flush() { _pipeline.finish(); }
+
+  /**
+   * Get the compositor (for stats on the debug screen)
+   */
+  Compositor& getCompositor() { return _compositor; }
 
   /**
    * Set callback for rendering screens not in registry
@@ -126,6 +141,8 @@ private:
   TFT_eSPI& _tft;
   Navigator& _nav;
   int _backlightPin;
+  Compositor _compositor;
+  DisplayPipeline _pipeline;
 
   ScreenRenderer* _screens[MAX_SCREENS];
   int _screenCount;
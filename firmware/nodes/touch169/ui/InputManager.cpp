@@ -14,6 +14,7 @@ InputManager::InputManager(TouchInput& touch, GestureDetector& gesture)
   , _bootShortPending(false)
   , _touchActive(false)
   , _wasTouched(false)
+  , _ignoreUntilRelease(false)
   , _touchX(-1)
   , _touchY(-1)
   , _lastTouchTime(0)
@@ -24,6 +25,8 @@ InputManager::InputManager(TouchInput& touch, GestureDetector& gesture)
   , _bootDebounceMs(BOOT_BTN_DEBOUNCE_MS)
   , _tapCallback(nullptr)
   , _swipeCallback(nullptr)
+  , _longPressCallback(nullptr)
+  , _dragCallback(nullptr)
   , _bootShortCallback(nullptr)
   , _bootLongCallback(nullptr)
   , _touchCallback(nullptr)
@@ -42,79 +45,118 @@ void InputManager::update() {
 }
 
 void InputManager::handleTouch() {
-  bool touched = _touch.read();
-  unsigned long now = millis();
+  _touch.service();
 
-  if (touched) {
-    _touchX = _touch.getX();
-    _touchY = _touch.getY();
+  TouchSample sample;
+  while (_touch.popSample(sample)) {
+    handleSample(sample);
+  }
 
-    // Notify on any touch (for wake/activity)
-    if (_touchCallback) {
-      _touchCallback();
+  // Long press fires while the finger is still down
+  if (_wasTouched && !_ignoreUntilRelease && _gesture.checkLongPress(millis())) {
+    Serial.printf("[INPUT] Long press at x=%d, y=%d\n", _gesture.getTapX(), _gesture.getTapY());
+    if (_longPressCallback) {
+      _longPressCallback(_gesture.getTapX(), _gesture.getTapY());
     }
+  }
+}
 
-    // Track touch start for gesture detection
-    if (!_wasTouched) {
-      _gesture.onTouchStart(_touchX, _touchY);
-      Serial.printf("[INPUT] Touch start x=%d, y=%d\n", _touchX, _touchY);
-    }
+void InputManager::handleSample(const TouchSample& sample) {
+  if (!sample.down) {
+    if (_wasTouched) handleRelease(sample.t);
+    return;
+  }
+
+  _touchX = sample.x;
+  _touchY = sample.y;
 
-    // Debounce check
-    if (now - _lastTouchTime < _debounceMs) return;
-    _lastTouchTime = now;
+  // Notify on any touch (for wake/activity)
+  if (_touchCallback) {
+    _touchCallback();
+  }
+  if (_ignoreUntilRelease) {
+    _wasTouched = true;
+    return;
+  }
 
-    // Cooldown check (after screen transitions)
-    if (isInCooldown()) {
-      Serial.printf("[INPUT] Touch ignored (cooldown) x=%d, y=%d\n", _touchX, _touchY);
-      return;
+  // Track touch start for gesture detection
+  if (!_wasTouched) {
+    _wasTouched = true;
+    _gesture.onTouchStart(_touchX, _touchY, sample.t);
+    Serial.printf("[INPUT] Touch start x=%d, y=%d\n", _touchX, _touchY);
+  } else {
+    _gesture.onTouchMove(_touchX, _touchY, sample.t);
+    if (_gesture.isDragging() && _dragCallback) {
+      _dragCallback(_touchX, _touchY, _gesture.getDragDX(), _gesture.getDragDY());
     }
+  }
 
-    _touchActive = true;
-
-  } else if (_wasTouched) {
-    // Touch released - detect gesture
-    _gesture.onTouchEnd(_touchX, _touchY);
-    _touchActive = false;
-
-    Gesture gestureType = _gesture.getGesture();
-
-    switch (gestureType) {
-      case Gesture::SwipeUp:
-      case Gesture::SwipeDown:
-      case Gesture::SwipeLeft:
-      case Gesture::SwipeRight:
-        if (_swipeCallback) {
-          SwipeDirection dir;
-          switch (gestureType) {
-            case Gesture::SwipeUp:    dir = SwipeDirection::Up; break;
-            case Gesture::SwipeDown:  dir = SwipeDirection::Down; break;
-            case Gesture::SwipeLeft:  dir = SwipeDirection::Left; break;
-            case Gesture::SwipeRight: dir = SwipeDirection::Right; break;
-            default: dir = SwipeDirection::None; break;
-          }
-          Serial.printf("[INPUT] Swipe detected: %d\n", (int)dir);
-          _swipeCallback(dir);
-        }
-        break;
-
-      case Gesture::Tap:
-        if (_tapCallback) {
-          int16_t tapX = _gesture.getTapX();
-          int16_t tapY = _gesture.getTapY();
-          Serial.printf("[INPUT] Tap detected at x=%d, y=%d\n", tapX, tapY);
-          _tapCallback(tapX, tapY);
+  // Debounce check
+  unsigned long now = millis();
+  if (now - _lastTouchTime < _debounceMs) return;
+  _lastTouchTime = now;
+
+  // Cooldown check (after screen transitions)
+  if (isInCooldown()) {
+    Serial.printf("[INPUT] Touch ignored (cooldown) x=%d, y=%d\n", _touchX, _touchY);
+    return;
+  }
+
+  _touchActive = true;
+}
+
+void InputManager::handleRelease(uint32_t t) {
+  _wasTouched = false;
+  _touchActive = false;
+
+  if (_ignoreUntilRelease) {
+    _ignoreUntilRelease = false;
+    return;
+  }
+
+  // Touch released - detect gesture
+  _gesture.onTouchEnd(_touchX, _touchY, t);
+  Gesture gestureType = _gesture.getGesture();
+
+  switch (gestureType) {
+    case Gesture::SwipeUp:
+    case Gesture::SwipeDown:
+    case Gesture::SwipeLeft:
+    case Gesture::SwipeRight:
+      if (_swipeCallback) {
+        SwipeDirection dir;
+        switch (gestureType) {
+          case Gesture::SwipeUp:    dir = SwipeDirection::Up; break;
+          case Gesture::SwipeDown:  dir = SwipeDirection::Down; break;
+          case Gesture::SwipeLeft:  dir = SwipeDirection::Left; break;
+          case Gesture::SwipeRight: dir = SwipeDirection::Right; break;
+          default: dir = SwipeDirection::None; break;
         }
-        break;
+        Serial.printf("[INPUT] Swipe detected: %d%s (v=%d,%d px/s)\n", (int)dir,
+                      _gesture.isFling() ? " fling" : "",
+                      _gesture.getVelocityX(), _gesture.getVelocityY());
+        _swipeCallback(dir);
+      }
+      break;
+
+    case Gesture::Tap:
+      if (_tapCallback) {
+        int16_t tapX = _gesture.getTapX();
+        int16_t tapY = _gesture.getTapY();
+        Serial.printf("[INPUT] Tap detected at x=%d, y=%d\n", tapX, tapY);
+        _tapCallback(tapX, tapY);
+      }
+      break;
 
-      default:
-        break;
-    }
+    case Gesture::Drag:
+      Serial.printf("[INPUT] Drag ended dx=%d, dy=%d\n", _gesture.getDragDX(), _gesture.getDragDY());
+      break;
 
-    _gesture.reset();
+    default:
+      break;  // LongPress was reported while held
   }
 
-  _wasTouched = touched;
+  _gesture.reset();
 }
 
 void InputManager::handleBootButton() {
@@ -171,6 +213,7 @@ void InputManager::startCooldown() {
 
 void InputManager::cancelTouch() {
   _gesture.reset();
-  _wasTouched = false;
   _touchActive = false;
+  // The rest of this touch (up to its release) produces no gesture
+  _ignoreUntilRelease = _wasTouched || _touch.isTouched();
 }
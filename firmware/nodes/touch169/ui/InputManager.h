@@ -3,6 +3,8 @@
  *
  * Combines touch input, gesture detection, and boot button handling
  * into a single manager. Fires callbacks for different input events.
+ * Touch samples come from TouchInput's interrupt-fed ring buffer, so
+ * update() costs no I2C traffic while the screen is not being touched.
  *
  * Extracted from main.cpp as part of Phase R10 refactoring.
  *
@@ -10,6 +12,8 @@
  *   InputManager input(touchInput, gesture);
  *   input.onTap([](int16_t x, int16_t y) { ... });
  *   input.onSwipe([](SwipeDirection dir) { ... });
+ *   input.onLongPress([](int16_t x, int16_t y) { ... });
+ *   input.onDrag([](int16_t x, int16_t y, int16_t dx, int16_t dy) { ... });
  *   input.onBootShortPress([]() { ... });
  *   input.onBootLongPress([]() { ... });
  *   input.begin();
@@ -39,6 +43,7 @@ enum class SwipeDirection {
 typedef void (*TapCallback)(int16_t x, int16_t y);
 typedef void (*SwipeCallback)(SwipeDirection dir);
 typedef void (*ButtonCallback)();
+typedef void (*DragCallback)(int16_t x, int16_t y, int16_t dx, int16_t dy);
 
 class InputManager {
 public:
@@ -66,9 +71,15 @@ public:
   /** Called on tap gesture with coordinates */
   void onTap(TapCallback cb) { _tapCallback = cb; }
 
-  /** Called on swipe gesture with direction */
+  /** Called on swipe gesture with direction (including fast short flicks) */
   void onSwipe(SwipeCallback cb) { _swipeCallback = cb; }
 
+  /** Called once while a touch is held in place for GESTURE_LONG_PRESS_MS */
+  void onLongPress(TapCallback cb) { _longPressCallback = cb; }
+
+  /** Called for each sample of a drag in progress, with offset from the start */
+  void onDrag(DragCallback cb) { _dragCallback = cb; }
+
   /** Called on boot button short press */
   void onBootShortPress(ButtonCallback cb) { _bootShortCallback = cb; }
 
@@ -114,6 +125,8 @@ public:
 
 private:
   void handleTouch();
+  void handleSample(const TouchSample& sample);
+  void handleRelease(uint32_t t);
   void handleBootButton();
 
   TouchInput& _touch;
@@ -129,6 +142,7 @@ private:
   // Touch state
   bool _touchActive;
   bool _wasTouched;
+  bool _ignoreUntilRelease;  // Set by cancelTouch()
   int16_t _touchX;
   int16_t _touchY;
   unsigned long _lastTouchTime;
@@ -143,6 +157,8 @@ private:
   // Callbacks
   TapCallback _tapCallback;
   SwipeCallback _swipeCallback;
+  TapCallback _longPressCallback;
+  DragCallback _dragCallback;
   ButtonCallback _bootShortCallback;
   ButtonCallback _bootLongCallback;
   ButtonCallback _touchCallback;
@@ -21,6 +21,7 @@
 #include <Arduino.h>
 #include <TFT_eSPI.h>
 #include "../core/Navigator.h"
+#include "Compositor.h"
 
 /**
  * ScreenRenderer abstract base class
@@ -41,6 +42,14 @@ public:
    */
   virtual void render(TFT_eSPI& tft, bool forceRedraw) = 0;
 
+  /**
+   * Render the screen through the compositor
+   * Override to draw into dirty regions; the default draws directly
+   * @param comp Compositor (always ready when this is called)
+   * @param forceRedraw If true, redraw everything regardless of change detection
+   */
+  virtual void compose(Compositor& comp, bool forceRedraw) { render(comp.getTft(), forceRedraw); }
+
   /**
    * Handle touch event on this screen
    * @param x Touch X coordinate
@@ -5,12 +5,22 @@
 
 #include "DebugScreen.h"
 #include "../../BoardConfig.h"
+#include <PerfStats.h>
 
-DebugScreen::DebugScreen(Battery& battery, MeshSwarm& swarm, IMU& imu, IMeshState& meshState)
+const DebugScreen::SectionRect DebugScreen::SECTIONS[REGION_COUNT] = {
+  { 10,  45, 220, 60 },  // Battery
+  { 10, 110, 220, 72 },  // Mesh and loop timing
+  { 10, 184, 220, 30 },  // IMU
+  { 10, 216, 220, 62 },  // Mesh sensors
+};
+
+DebugScreen::DebugScreen(Battery& battery, MeshSwarm& swarm, IMU& imu, IMeshState& meshState,
+                         const Scheduler& scheduler)
   : _battery(battery)
   , _swarm(swarm)
   , _imu(imu)
   , _meshState(meshState)
+  , _scheduler(scheduler)
   , _needsRedraw(true)
   , _lastUpdate(0)
 {
@@ -21,7 +31,7 @@ void DebugScreen::onEnter() {
   _lastUpdate = 0;  // Force immediate update
 }
 
-void DebugScreen::render(TFT_eSPI& tft, bool forceRedraw) {
+bool DebugScreen::beginFrame(TFT_eSPI& tft, bool forceRedraw) {
   if (forceRedraw || _needsRedraw) {
     drawHeader(tft);
     _needsRedraw = false;
@@ -29,13 +39,34 @@ void DebugScreen::render(TFT_eSPI& tft, bool forceRedraw) {
   }
 
   // Throttle updates to every 500ms
-  if (millis() - _lastUpdate < UPDATE_INTERVAL_MS) return;
+  if (millis() - _lastUpdate < UPDATE_INTERVAL_MS) return false;
   _lastUpdate = millis();
+  return true;
+}
 
-  drawBatterySection(tft);
-  drawMeshSection(tft);
-  drawIMUSection(tft);
-  drawSensorSection(tft);
+void DebugScreen::render(TFT_eSPI& tft, bool forceRedraw) {
+  if (!beginFrame(tft, forceRedraw)) return;
+
+  for (uint8_t i = 0; i < REGION_COUNT; i++) {
+    // Direct drawing: clear the section first, then draw at panel coordinates
+    tft.fillRect(SECTIONS[i].x, SECTIONS[i].y, SECTIONS[i].w, SECTIONS[i].h, Colors::BG);
+    drawSection(i, tft, SECTIONS[i].x, SECTIONS[i].y);
+  }
+}
+
+void DebugScreen::compose(Compositor& comp, bool forceRedraw) {
+  if (forceRedraw || _needsRedraw) {
+    comp.invalidate();  // Header clears the panel under every region
+  }
+  if (!beginFrame(comp.getTft(), forceRedraw)) return;
+
+  for (uint8_t i = 0; i < REGION_COUNT; i++) {
+    const SectionRect& r = SECTIONS[i];
+    TFT_eSPI* g = comp.beginRegion(i, r.x, r.y, r.w, r.h, Colors::BG);
+    if (g == nullptr) continue;
+    drawSection(i, *g, 0, 0);
+    comp.endRegion();
+  }
 }
 
 bool DebugScreen::handleTouch(int16_t x, int16_t y, Navigator& nav) {
@@ -43,6 +74,15 @@ bool DebugScreen::handleTouch(int16_t x, int16_t y, Navigator& nav) {
   return false;
 }
 
+void DebugScreen::drawSection(uint8_t region, TFT_eSPI& g, int16_t dx, int16_t dy) {
+  switch (region) {
+    case REGION_BATTERY: drawBatterySection(g, dx, dy); break;
+    case REGION_MESH:    drawMeshSection(g, dx, dy); break;
+    case REGION_IMU:     drawIMUSection(g, dx, dy); break;
+    case REGION_SENSORS: drawSensorSection(g, dx, dy); break;
+  }
+}
+
 void DebugScreen::drawHeader(TFT_eSPI& tft) {
   tft.fillScreen(Colors::BG);
   tft.setTextColor(Colors::TEXT);
@@ -53,42 +93,41 @@ void DebugScreen::drawHeader(TFT_eSPI& tft) {
   tft.drawLine(10, 35, 230, 35, Colors::TICK);
 }
 
-void DebugScreen::drawBatterySection(TFT_eSPI& tft) {
+void DebugScreen::drawBatterySection(TFT_eSPI& g, int16_t dx, int16_t dy) {
   float voltage = _battery.getVoltage();
   int percent = _battery.getPercent();
   ChargingState state = _battery.getState();
 
-  tft.setTextSize(2);
+  g.setTextSize(2);
 
   // Battery header
-  tft.fillRect(10, 45, 220, 55, Colors::BG);
-  tft.setTextColor(Colors::HUMID);
-  tft.setCursor(10, 45);
-  tft.print("Battery:");
+  g.setTextColor(Colors::HUMID);
+  g.setCursor(dx, dy);
+  g.print("Battery:");
 
   // Voltage and percentage
-  tft.setTextColor(Colors::TEXT);
-  tft.setCursor(10, 65);
-  tft.printf("%.2fV  %d%%", voltage, percent);
+  g.setTextColor(Colors::TEXT);
+  g.setCursor(dx, dy + 20);
+  g.printf("%.2fV  %d%%", voltage, percent);
 
   // Charging state
-  tft.setCursor(120, 65);
+  g.setCursor(dx + 110, dy + 20);
   switch (state) {
     case ChargingState::Charging:
-      tft.setTextColor(Colors::HUMID);
-      tft.print("[CHARGING]");
+      g.setTextColor(Colors::HUMID);
+      g.print("[CHARGING]");
       break;
     case ChargingState::Full:
-      tft.setTextColor(Colors::HUMID);
-      tft.print("[FULL]");
+      g.setTextColor(Colors::HUMID);
+      g.print("[FULL]");
       break;
     case ChargingState::Discharging:
-      tft.setTextColor(Colors::TEXT);
-      tft.print("[ON BAT]");
+      g.setTextColor(Colors::TEXT);
+      g.print("[ON BAT]");
       break;
     default:
-      tft.setTextColor(Colors::TICK);
-      tft.print("[...]");
+      g.setTextColor(Colors::TICK);
+      g.print("[...]");
       break;
   }
 
@@ -96,67 +135,89 @@ void DebugScreen::drawBatterySection(TFT_eSPI& tft) {
   int barWidth = (percent * 180) / 100;
   uint16_t barColor = (state == ChargingState::Charging || state == ChargingState::Full)
                       ? Colors::HUMID : (percent > 20 ? Colors::TEXT : Colors::SECOND);
-  tft.drawRect(10, 90, 184, 12, Colors::TICK);
-  tft.fillRect(12, 92, 180, 8, Colors::BG);  // Clear old bar
-  tft.fillRect(12, 92, barWidth, 8, barColor);
-  tft.fillRect(194, 94, 4, 4, Colors::TICK);  // Battery nub
+  g.drawRect(dx, dy + 45, 184, 12, Colors::TICK);
+  g.fillRect(dx + 2, dy + 47, barWidth, 8, barColor);
+  g.fillRect(dx + 184, dy + 49, 4, 4, Colors::TICK);  // Battery nub
 }
 
-void DebugScreen::drawMeshSection(TFT_eSPI& tft) {
-  tft.fillRect(10, 110, 220, 50, Colors::BG);
-  tft.setTextColor(Colors::TEMP);
-  tft.setTextSize(2);
-  tft.setCursor(10, 110);
-  tft.print("Mesh:");
+void DebugScreen::drawMeshSection(TFT_eSPI& g, int16_t dx, int16_t dy) {
+  g.setTextColor(Colors::TEMP);
+  g.setTextSize(2);
+  g.setCursor(dx, dy);
+  g.print("Mesh:");
+
+  g.setTextColor(Colors::TEXT);
+  g.setTextSize(1);
+  g.setCursor(dx, dy + 17);
+  g.printf("ID:%u Peers:%d %s", _swarm.getNodeId(), _swarm.getPeerCount(),
+           _swarm.isCoordinator() ? "COORD" : "");
+  g.setCursor(dx, dy + 28);
+  g.printf("Uptime: %lus  Idle: %u%%%s", millis() / 1000,
+           (unsigned)_scheduler.idlePercent(), _scheduler.lightSleepEnabled() ? " LS" : "");
+
+  // Only tasks that have missed a deadline, to fit one line
+  g.setCursor(dx, dy + 39);
+  g.print("Overruns:");
+  if (_scheduler.totalOverruns() == 0) {
+    g.print(" none");
+  }
+  for (uint8_t i = 0; i < _scheduler.taskCount(); i++) {
+    const SchedTask& t = _scheduler.task(i);
+    if (t.overruns == 0) continue;
+    g.printf(" %s:%lu", t.name, (unsigned long)t.overruns);
+  }
 
-  tft.setTextColor(Colors::TEXT);
-  tft.setTextSize(1);
-  tft.setCursor(10, 128);
-  tft.printf("ID:%u Peers:%d %s", _swarm.getNodeId(), _swarm.getPeerCount(),
-             _swarm.isCoordinator() ? "COORD" : "");
-  tft.setCursor(10, 143);
-  tft.printf("Uptime: %lus", millis() / 1000);
+  // Last closed perf window (max values in ms)
+  const PerfSummary& p = perfStats.last();
+  g.setCursor(dx, dy + 50);
+  g.printf("Loop:%.1f/%.1f Upd:%.1f Frm:%.1f", p.loopAvgUs / 1000.0f, p.loopMaxUs / 1000.0f,
+           p.timerMaxUs[PERF_UPDATE] / 1000.0f, p.timerMaxUs[PERF_FRAME] / 1000.0f);
+  g.setCursor(dx, dy + 61);
+  g.printf("Heap min:%luK blk:%luK Msg:%u/%u",
+           (unsigned long)(p.heapMin / 1024), (unsigned long)(p.heapMaxBlock / 1024),
+           p.msgIn[PERF_MSG_STATE] + p.msgIn[PERF_MSG_COMMAND],
+           p.msgOut[PERF_MSG_STATE] + p.msgOut[PERF_MSG_COMMAND]);
 }
 
-void DebugScreen::drawIMUSection(TFT_eSPI& tft) {
-  tft.setTextSize(2);
-  tft.fillRect(10, 160, 220, 45, Colors::BG);
-  tft.setTextColor(Colors::MOTION);
-  tft.setCursor(10, 160);
-  tft.print("IMU:");
+void DebugScreen::drawIMUSection(TFT_eSPI& g, int16_t dx, int16_t dy) {
+  g.setTextSize(2);
+  g.setTextColor(Colors::MOTION);
+  g.setCursor(dx, dy);
+  g.print("IMU:");
 
-  tft.setTextSize(1);
-  tft.setTextColor(Colors::TEXT);
+  g.setTextSize(1);
+  g.setTextColor(Colors::TEXT);
 
+  // Beside the header, to leave room for loop timing above
   if (_imu.isAvailable()) {
     IMUVector accel = _imu.getAccel();
-    tft.setCursor(10, 178);
-    tft.printf("Temp: %.1f C", _imu.getTemperature());
-    tft.setCursor(10, 193);
-    tft.printf("Accel: %.2f %.2f %.2f", accel.x, accel.y, accel.z);
+    g.setCursor(dx + 55, dy + 4);
+    g.printf("%.1fC  %.2f %.2f %.2f", _imu.getTemperature(), accel.x, accel.y, accel.z);
   } else {
-    tft.setCursor(10, 178);
-    tft.print("Not available");
+    g.setCursor(dx + 55, dy + 4);
+    g.print("Not available");
   }
 }
 
-void DebugScreen::drawSensorSection(TFT_eSPI& tft) {
-  tft.setTextSize(2);
-  tft.fillRect(10, 210, 220, 70, Colors::BG);
-  tft.setTextColor(Colors::LIGHT);
-  tft.setCursor(10, 210);
-  tft.print("Mesh Sensors:");
-
-  tft.setTextSize(1);
-  tft.setTextColor(Colors::TEXT);
-  tft.setCursor(10, 228);
-  tft.printf("Temp: %s C  Humid: %s%%",
-             _meshState.getTemperature().c_str(),
-             _meshState.getHumidity().c_str());
-  tft.setCursor(10, 243);
-  tft.printf("Light: %s", _meshState.getLightLevel().c_str());
-  tft.setCursor(10, 258);
-  tft.printf("Motion: %s  LED: %s",
-             _meshState.getMotionRaw().c_str(),
-             _meshState.getLedRaw().c_str());
+void DebugScreen::drawSensorSection(TFT_eSPI& g, int16_t dx, int16_t dy) {
+  g.setTextSize(2);
+  g.setTextColor(Colors::LIGHT);
+  g.setCursor(dx, dy);
+  g.print("Mesh Sensors:");
+
+  g.setTextSize(1);
+  g.setTextColor(Colors::TEXT);
+  g.setCursor(dx, dy + 18);
+  char temp[12];
+  char humid[12];
+  char light[12];
+  g.printf("Temp: %s C  Humid: %s%%",
+           _meshState.getTemperature().format(temp, sizeof(temp), "%.1f"),
+           _meshState.getHumidity().format(humid, sizeof(humid), "%.0f"));
+  g.setCursor(dx, dy + 33);
+  g.printf("Light: %s", _meshState.getLightLevel().format(light, sizeof(light), "%.0f"));
+  g.setCursor(dx, dy + 48);
+  g.printf("Motion: %d  LED: %d",
+           _meshState.getMotionDetected() ? 1 : 0,
+           _meshState.getLedState() ? 1 : 0);
 }
@@ -5,6 +5,8 @@
  * Displays diagnostic information:
  * - Battery voltage, percentage, charging state
  * - Mesh network info (node ID, peers, role)
+ * - Main loop scheduler (idle share, per-task overruns)
+ * - Loop/update/frame timing, heap low-water, message counts (PerfStats)
  * - IMU data (temperature, accelerometer)
  * - Mesh sensor values (temp, humidity, light, motion, LED)
  *
@@ -16,6 +18,7 @@
 
 #include "../ScreenRenderer.h"
 #include "../../core/Battery.h"
+#include "../../core/Scheduler.h"
 #include "../../hardware/IMU.h"
 #include "../../mesh/IMeshState.h"
 #include <MeshSwarm.h>
@@ -34,11 +37,14 @@ public:
    * @param swarm Reference to MeshSwarm instance
    * @param imu Reference to IMU instance
    * @param meshState Reference to IMeshState instance
+   * @param scheduler Main loop scheduler (for timing stats)
    */
-  DebugScreen(Battery& battery, MeshSwarm& swarm, IMU& imu, IMeshState& meshState);
+  DebugScreen(Battery& battery, MeshSwarm& swarm, IMU& imu, IMeshState& meshState,
+              const Scheduler& scheduler);
 
   // ScreenRenderer interface
   void render(TFT_eSPI& tft, bool forceRedraw) override;
+  void compose(Compositor& comp, bool forceRedraw) override;
   bool handleTouch(int16_t x, int16_t y, Navigator& nav) override;
   Screen getScreen() const override { return Screen::Debug; }
   void onEnter() override;
@@ -46,16 +52,30 @@ public:
   void clearRedraw() override { _needsRedraw = false; }
 
 private:
+  // Section rectangles (panel coordinates); each is one compositor region
+  enum Region : uint8_t { REGION_BATTERY, REGION_MESH, REGION_IMU, REGION_SENSORS, REGION_COUNT };
+  struct SectionRect { int16_t x, y, w, h; };
+  static const SectionRect SECTIONS[REGION_COUNT];
+
+  /**
+   * Check the update throttle (and header redraw)
+   * @return true if the sections should be redrawn this frame
+   */
+  bool beginFrame(TFT_eSPI& tft, bool forceRedraw);
+  void drawSection(uint8_t region, TFT_eSPI& g, int16_t dx, int16_t dy);
+
+  // Section drawing in section-local coordinates offset by (dx, dy)
   void drawHeader(TFT_eSPI& tft);
-  void drawBatterySection(TFT_eSPI& tft);
-  void drawMeshSection(TFT_eSPI& tft);
-  void drawIMUSection(TFT_eSPI& tft);
-  void drawSensorSection(TFT_eSPI& tft);
+  void drawBatterySection(TFT_eSPI& g, int16_t dx, int16_t dy);
+  void drawMeshSection(TFT_eSPI& g, int16_t dx, int16_t dy);
+  void drawIMUSection(TFT_eSPI& g, int16_t dx, int16_t dy);
+  void drawSensorSection(TFT_eSPI& g, int16_t dx, int16_t dy);
 
   Battery& _battery;
   MeshSwarm& _swarm;
   IMU& _imu;
   IMeshState& _meshState;
+  const Scheduler& _scheduler;
 
   bool _needsRedraw;
   unsigned long _lastUpdate;
@@ -11,6 +11,8 @@
 
 #include <Arduino.h>
 #include <MeshSwarm.h>
+#include <PerfStats.h>
+#include <BroadcastOta.h>
 #include <esp_ota_ops.h>
 
 // ============== BUILD-TIME CONFIGURATION ==============
@@ -28,6 +30,7 @@
 
 // ============== GLOBALS ==============
 MeshSwarm swarm;
+OtaBroadcastReceiver otaReceiver;
 
 // ============== SETUP ==============
 void setup() {
@@ -37,8 +40,10 @@ void setup() {
   esp_ota_mark_app_valid_cancel_rollback();
 
   swarm.begin(NODE_NAME);
+  perfStats.attach(swarm);
   swarm.enableTelemetry(true);
   swarm.enableOTAReceive(NODE_TYPE);
+  otaReceiver.begin(swarm, NODE_TYPE);  // Broadcast jobs; resumes a saved session
 
   // Enable display sleep with boot button wake
   swarm.enableDisplaySleep(WATCHER_DISPLAY_SLEEP_MS);
@@ -0,0 +1,266 @@
+"""Compressed and delta firmware images for broadcast OTA.
+
+Each chunk of an encoded image is a segment that rebuilds one range of the
+image on its own, so nodes can decode chunks in whatever order the mesh
+delivers them. The format and the node-side decoder are in
+firmware/lib/MeshSwarmProto/OtaPatch.h; CHUNK_BYTES and WINDOW must match
+OTA_CHUNK_BYTES and OTA_PATCH_WINDOW there.
+
+    segment = varint(offset) varint(length) op... [zero padding to CHUNK_BYTES]
+    op byte = kk LLLLLL  (literal / backref / base copy / run, L=0: varint length)
+"""
+
+CHUNK_BYTES = 512
+WINDOW = 4096
+
+OP_LITERAL = 0
+OP_BACKREF = 1
+OP_BASE = 2
+OP_RUN = 3
+
+ENCODING_RAW = "raw"
+ENCODING_COMPRESSED = "compressed"
+ENCODING_DELTA = "delta"
+
+_MIN_MATCH = 4
+_BASE_KEY = 8      # Bytes hashed per base index entry
+_BASE_STRIDE = 4   # Base positions indexed; others are found by extending backwards
+_MAX_LITERAL = 63  # Literal runs never take a varint length
+
+
+class CodecError(ValueError):
+    pass
+
+
+def _varint(n: int) -> bytes:
+    out = bytearray()
+    while True:
+        b = n & 0x7F
+        n >>= 7
+        if n:
+            out.append(b | 0x80)
+        else:
+            out.append(b)
+            return bytes(out)
+
+
+def _zigzag(n: int) -> int:
+    return n * 2 if n >= 0 else -n * 2 - 1
+
+
+def _op(kind: int, length: int) -> bytes:
+    if length < 64:
+        return bytes([kind << 6 | length])
+    return bytes([kind << 6]) + _varint(length)
+
+
+def _match_len(a: bytes, i: int, b: bytes, j: int, limit: int) -> int:
+    """Length of the common run of a[i:] and b[j:], capped at limit."""
+    n = 0
+    while n + 64 <= limit and a[i + n:i + n + 64] == b[j + n:j + n + 64]:
+        n += 64
+    while n < limit and a[i + n] == b[j + n]:
+        n += 1
+    return n
+
+
+def _literal_cost(count: int) -> int:
+    return count + (count + _MAX_LITERAL - 1) // _MAX_LITERAL
+
+
+def _index_base(base: bytes) -> dict[bytes, int]:
+    index: dict[bytes, int] = {}
+    for q in range(0, len(base) - _BASE_KEY + 1, _BASE_STRIDE):
+        index.setdefault(base[q:q + _BASE_KEY], q)
+    return index
+
+
+def encode(image: bytes, base: bytes | None = None, chunk_bytes: int = CHUNK_BYTES) -> bytes:
+    """Encode image into chunk-sized segments, copying from base where it matches.
+
+    Without a base the result is compressed only. Every chunk but the last
+    is exactly chunk_bytes, so chunk i of the result is what the gateway
+    broadcasts as chunk i.
+    """
+    if not image:
+        raise CodecError("empty image")
+    base_index = _index_base(base) if base else {}
+    recent: dict[bytes, int] = {}  # 4-byte key -> last image position
+    n = len(image)
+    last_delta = 0  # base source - output offset of the previous base copy
+    chunks: list[bytes] = []
+    p = 0
+
+    def remember(start: int, end: int) -> None:
+        # Long base copies only keep their tail; backrefs can't reach further anyway
+        for k in range(max(start, end - WINDOW // 16), min(end, n - _MIN_MATCH + 1)):
+            recent[image[k:k + _MIN_MATCH]] = k
+
+    while p < n:
+        seg_start = p
+        head = _varint(p)
+        budget = chunk_bytes - len(head) - len(_varint(n))
+        if budget < 8:
+            raise CodecError(f"chunk size {chunk_bytes} too small")
+        ops = bytearray()
+        literals = bytearray()
+
+        def flush_literals() -> None:
+            for k in range(0, len(literals), _MAX_LITERAL):
+                run = literals[k:k + _MAX_LITERAL]
+                ops.extend(_op(OP_LITERAL, len(run)))
+                ops.extend(run)
+            literals.clear()
+
+        while p < n:
+            limit = n - p
+            best = None  # (gain, kind, length, arg, back)
+
+            # Run of one byte (erased flash, zeroed tables)
+            if limit >= _MIN_MATCH and image[p:p + _MIN_MATCH] == image[p:p + 1] * _MIN_MATCH:
+                length = _MIN_MATCH
+                while length < limit and image[p + length] == image[p]:
+                    length += 1
+                cost = len(_op(OP_RUN, length)) + 1
+                best = (length - cost, OP_RUN, length, image[p], 0)
+
+            if base:
+                # Same displacement as the last copy first: most of a rebuilt image just shifted
+                candidates = []
+                src = p + last_delta
+                if 0 <= src < len(base):
+                    candidates.append(src)
+                q = base_index.get(image[p:p + _BASE_KEY])
+                if q is not None:
+                    candidates.append(q)
+                for src in candidates:
+                    length = _match_len(image, p, base, src, min(limit, len(base) - src))
+                    if length < _MIN_MATCH:
+                        continue
+                    # Take back bytes already queued as literals
+                    back = 0
+                    while (back < len(literals) and src - back > 0 and
+                           base[src - back - 1] == literals[len(literals) - back - 1]):
+                        back += 1
+                    cost = len(_op(OP_BASE, length + back)) + len(_varint(_zigzag(src - p)))
+                    gain = length + back - cost
+                    if gain > 0 and (best is None or gain > best[0]):
+                        best = (gain, OP_BASE, length, src, back)
+
+            c = recent.get(image[p:p + _MIN_MATCH])
+            if c is not None and c >= seg_start and p - c <= WINDOW:
+                length = _match_len(image, p, image, c, limit)
+                cost = len(_op(OP_BACKREF, length)) + len(_varint(p - c))
+                if length >= _MIN_MATCH and (best is None or length - cost > best[0]):
+                    best = (length - cost, OP_BACKREF, length, p - c, 0)
+
+            if best is None or best[0] <= 0:
+                if len(ops) + _literal_cost(len(literals) + 1) > budget:
+                    break
+                literals.append(image[p])
+                remember(p, p + 1)
+                p += 1
+                continue
+
+            _, kind, length, arg, back = best
+            if kind == OP_BASE:
+                del literals[len(literals) - back:]
+                length += back
+                arg -= back
+            start = p - back
+            if kind == OP_RUN:
+                op = _op(OP_RUN, length) + bytes([arg])
+            elif kind == OP_BACKREF:
+                op = _op(OP_BACKREF, length) + _varint(arg)
+            else:
+                op = _op(OP_BASE, length) + _varint(_zigzag(arg - start))
+            if len(ops) + _literal_cost(len(literals)) + len(op) > budget:
+                if kind == OP_BASE and back:
+                    literals.extend(image[start:p])  # Put them back; this segment is full
+                break
+            flush_literals()
+            ops.extend(op)
+            if kind == OP_BASE:
+                last_delta = arg - start
+            p = start + length
+            remember(start, p)
+
+        flush_literals()
+        segment = head + _varint(p - seg_start) + ops
+        if p - seg_start == 0 or len(segment) > chunk_bytes:
+            raise CodecError("segment overflow")
+        if p < n:
+            segment += bytes(chunk_bytes - len(segment))
+        chunks.append(bytes(segment))
+
+    return b"".join(chunks)
+
+
+def decode(blob: bytes, image_size: int, base: bytes | None = None,
+           chunk_bytes: int = CHUNK_BYTES) -> bytes:
+    """Rebuild the image from an encoded blob, as a node would."""
+    out = bytearray(image_size)
+    covered = 0
+    for c in range(0, len(blob), chunk_bytes):
+        seg = blob[c:c + chunk_bytes]
+        pos = 0
+
+        def varint() -> int:
+            nonlocal pos
+            value, shift = 0, 0
+            while True:
+                if pos >= len(seg):
+                    raise CodecError(f"truncated segment at chunk {c // chunk_bytes}")
+                b = seg[pos]
+                pos += 1
+                value |= (b & 0x7F) << shift
+                shift += 7
+                if not b & 0x80:
+                    return value
+
+        offset = varint()
+        length = varint()
+        if length == 0 or offset + length > image_size:
+            raise CodecError(f"segment outside image at chunk {c // chunk_bytes}")
+        w = offset
+        end = offset + length
+        while w < end:
+            op = seg[pos]
+            pos += 1
+            kind, count = op >> 6, op & 0x3F
+            if count == 0:
+                count = varint()
+            if count == 0 or w + count > end:
+                raise CodecError(f"bad op length at chunk {c // chunk_bytes}")
+            if kind == OP_LITERAL:
+                out[w:w + count] = seg[pos:pos + count]
+                pos += count
+            elif kind == OP_BACKREF:
+                dist = varint()
+                if dist == 0 or dist > w - offset or dist > WINDOW:
+                    raise CodecError(f"bad backref at chunk {c // chunk_bytes}")
+                for k in range(count):
+                    out[w + k] = out[w + k - dist]
+            elif kind == OP_BASE:
+                zz = varint()
+                src = w + (-(zz >> 1) - 1 if zz & 1 else zz >> 1)
+                if base is None or src < 0 or src + count > len(base):
+                    raise CodecError(f"bad base copy at chunk {c // chunk_bytes}")
+                out[w:w + count] = base[src:src + count]
+            else:
+                out[w:w + count] = bytes([seg[pos]]) * count
+                pos += 1
+            w += count
+        covered += length
+    if covered != image_size:
+        raise CodecError("segments do not cover the image")
+    return bytes(out)
+
+
+def encode_checked(image: bytes, base: bytes | None = None,
+                   chunk_bytes: int = CHUNK_BYTES) -> bytes | None:
+    """Encode and decode back; None if the result isn't smaller than the image."""
+    blob = encode(image, base, chunk_bytes)
+    if decode(blob, len(image), base, chunk_bytes) != image:
+        raise CodecError("round trip mismatch")
+    return blob if len(blob) < len(image) else None
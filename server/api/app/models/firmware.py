@@ -1,5 +1,5 @@
 from datetime import datetime
-from sqlalchemy import String, Boolean, Integer, Text, LargeBinary, DateTime
+from sqlalchemy import String, Boolean, Integer, Text, LargeBinary, DateTime, ForeignKey
 from sqlalchemy.orm import Mapped, mapped_column
 
 from ..database import Base
@@ -18,4 +18,12 @@ class Firmware(Base):
     binary_data: Mapped[bytes] = mapped_column(LargeBinary, nullable=False)
     release_notes: Mapped[str | None] = mapped_column(Text, nullable=True)
     is_stable: Mapped[bool] = mapped_column(Boolean, default=False)
+    # Broadcast OTA payloads (app/firmware_codec.py), NULL when not smaller than the image
+    compressed_data: Mapped[bytes | None] = mapped_column(LargeBinary, nullable=True)
+    compressed_size: Mapped[int | None] = mapped_column(Integer, nullable=True)
+    compressed_md5: Mapped[str | None] = mapped_column(String(32), nullable=True)
+    delta_base_id: Mapped[int | None] = mapped_column(Integer, ForeignKey("firmware.id", ondelete="SET NULL"), nullable=True)
+    delta_data: Mapped[bytes | None] = mapped_column(LargeBinary, nullable=True)
+    delta_size: Mapped[int | None] = mapped_column(Integer, nullable=True)
+    delta_md5: Mapped[str | None] = mapped_column(String(32), nullable=True)
     created_at: Mapped[datetime] = mapped_column(DateTime(timezone=True), default=datetime.utcnow)
@@ -1,5 +1,6 @@
 from datetime import datetime
 from sqlalchemy import String, Integer, DateTime, Text
+from sqlalchemy.dialects.postgresql import ARRAY, JSONB
 from sqlalchemy.orm import Mapped, mapped_column
 
 from ..database import Base
@@ -14,6 +15,16 @@ class Telemetry(Base):
     uptime_sec: Mapped[int | None] = mapped_column(Integer, nullable=True)
     peer_count: Mapped[int | None] = mapped_column(Integer, nullable=True)
     role: Mapped[str | None] = mapped_column(String(10), nullable=True)
+    # Node PerfStats window
+    loop_avg_us: Mapped[int | None] = mapped_column(Integer, nullable=True)
+    loop_max_us: Mapped[int | None] = mapped_column(Integer, nullable=True)
+    update_max_us: Mapped[int | None] = mapped_column(Integer, nullable=True)
+    watcher_max_us: Mapped[int | None] = mapped_column(Integer, nullable=True)
+    frame_max_us: Mapped[int | None] = mapped_column(Integer, nullable=True)
+    heap_min: Mapped[int | None] = mapped_column(Integer, nullable=True)
+    heap_max_block: Mapped[int | None] = mapped_column(Integer, nullable=True)
+    loop_hist: Mapped[list[int] | None] = mapped_column(ARRAY(Integer), nullable=True)
+    msg_counts: Mapped[dict | None] = mapped_column(JSONB, nullable=True)
 
 
 class CurrentState(Base):
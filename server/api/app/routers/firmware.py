@@ -1,9 +1,11 @@
 import hashlib
 from fastapi import APIRouter, Depends, HTTPException, UploadFile, File, Form, Header
+from fastapi.concurrency import run_in_threadpool
 from fastapi.responses import Response
 from sqlalchemy import select, func
 from sqlalchemy.ext.asyncio import AsyncSession
 
+from .. import firmware_codec
 from ..database import get_db
 from ..models import Firmware
 from ..schemas import FirmwareOut, FirmwareList
@@ -11,6 +13,39 @@ from ..schemas import FirmwareOut, FirmwareList
 router = APIRouter(prefix="/api/v1/firmware", tags=["firmware"])
 
 
+async def _delta_base(db: AsyncSession, firmware: Firmware) -> Firmware | None:
+    """Image nodes most likely run: the newest stable release, else the previous upload."""
+    query = (
+        select(Firmware)
+        .where(
+            Firmware.node_type == firmware.node_type,
+            Firmware.hardware == firmware.hardware,
+            Firmware.id != firmware.id,
+        )
+        .order_by(Firmware.is_stable.desc(), Firmware.created_at.desc())
+        .limit(1)
+    )
+    return (await db.execute(query)).scalar_one_or_none()
+
+
+async def _encode_payloads(firmware: Firmware, base: Firmware | None) -> None:
+    """Build the compressed and delta broadcast payloads; each stays NULL unless smaller."""
+    compressed = await run_in_threadpool(firmware_codec.encode_checked, firmware.binary_data)
+    firmware.compressed_data = compressed
+    firmware.compressed_size = len(compressed) if compressed else None
+    firmware.compressed_md5 = hashlib.md5(compressed).hexdigest() if compressed else None
+
+    delta = None
+    if base:
+        delta = await run_in_threadpool(firmware_codec.encode_checked, firmware.binary_data, base.binary_data)
+    if delta and compressed and len(delta) >= len(compressed):
+        delta = None
+    firmware.delta_base_id = base.id if delta else None
+    firmware.delta_data = delta
+    firmware.delta_size = len(delta) if delta else None
+    firmware.delta_md5 = hashlib.md5(delta).hexdigest() if delta else None
+
+
 @router.post("/upload", response_model=FirmwareOut)
 async def upload_firmware(
     file: UploadFile = File(...),
@@ -55,6 +90,7 @@ async def upload_firmware(
         release_notes=release_notes,
         is_stable=is_stable,
     )
+    await _encode_payloads(firmware, await _delta_base(db, firmware))
 
     db.add(firmware)
     await db.commit()
@@ -68,6 +104,9 @@ async def upload_firmware(
         filename=firmware.filename,
         size_bytes=firmware.size_bytes,
         md5_hash=firmware.md5_hash,
+        compressed_size=firmware.compressed_size,
+        delta_base_id=firmware.delta_base_id,
+        delta_size=firmware.delta_size,
         release_notes=firmware.release_notes,
         is_stable=firmware.is_stable,
         created_at=firmware.created_at,
@@ -104,6 +143,9 @@ async def list_firmware(
                 filename=fw.filename,
                 size_bytes=fw.size_bytes,
                 md5_hash=fw.md5_hash,
+                compressed_size=fw.compressed_size,
+                delta_base_id=fw.delta_base_id,
+                delta_size=fw.delta_size,
                 release_notes=fw.release_notes,
                 is_stable=fw.is_stable,
                 created_at=fw.created_at,
@@ -131,6 +173,52 @@ async def get_firmware(firmware_id: int, db: AsyncSession = Depends(get_db)):
         filename=firmware.filename,
         size_bytes=firmware.size_bytes,
         md5_hash=firmware.md5_hash,
+        compressed_size=firmware.compressed_size,
+        delta_base_id=firmware.delta_base_id,
+        delta_size=firmware.delta_size,
+        release_notes=firmware.release_notes,
+        is_stable=firmware.is_stable,
+        created_at=firmware.created_at,
+    )
+
+
+@router.post("/{firmware_id}/delta", response_model=FirmwareOut)
+async def rebuild_delta(
+    firmware_id: int,
+    base_id: int,
+    db: AsyncSession = Depends(get_db),
+):
+    """Rebuild the delta payload against another image, e.g. the version a fleet actually runs."""
+    result = await db.execute(select(Firmware).where(Firmware.id == firmware_id))
+    firmware = result.scalar_one_or_none()
+    if not firmware:
+        raise HTTPException(status_code=404, detail="Firmware not found")
+
+    result = await db.execute(select(Firmware).where(Firmware.id == base_id))
+    base = result.scalar_one_or_none()
+    if not base or base.id == firmware.id:
+        raise HTTPException(status_code=404, detail="Base firmware not found")
+    if (base.node_type, base.hardware) != (firmware.node_type, firmware.hardware):
+        raise HTTPException(status_code=400, detail="Base firmware is for another node type or hardware")
+
+    await _encode_payloads(firmware, base)
+    await db.commit()
+    await db.refresh(firmware)
+
+    if firmware.delta_base_id != base.id:
+        raise HTTPException(status_code=422, detail="Delta is not smaller than the compressed image")
+
+    return FirmwareOut(
+        id=firmware.id,
+        node_type=firmware.node_type,
+        version=firmware.version,
+        hardware=firmware.hardware,
+        filename=firmware.filename,
+        size_bytes=firmware.size_bytes,
+        md5_hash=firmware.md5_hash,
+        compressed_size=firmware.compressed_size,
+        delta_base_id=firmware.delta_base_id,
+        delta_size=firmware.delta_size,
         release_notes=firmware.release_notes,
         is_stable=firmware.is_stable,
         created_at=firmware.created_at,
@@ -140,18 +228,30 @@ async def get_firmware(firmware_id: int, db: AsyncSession = Depends(get_db)):
 @router.get("/{firmware_id}/download")
 async def download_firmware(
     firmware_id: int,
+    encoding: str = firmware_codec.ENCODING_RAW,
     range: str | None = Header(None),
     db: AsyncSession = Depends(get_db),
 ):
-    """Download firmware binary file. Supports Range header for partial downloads."""
+    """Download firmware binary file. Supports Range header for partial downloads.
+
+    encoding=compressed or delta returns the broadcast payload instead of the
+    image; X-MD5 is then the payload's MD5.
+    """
     result = await db.execute(select(Firmware).where(Firmware.id == firmware_id))
     firmware = result.scalar_one_or_none()
 
     if not firmware:
         raise HTTPException(status_code=404, detail="Firmware not found")
 
-    binary_data = firmware.binary_data
-    total_size = firmware.size_bytes
+    if encoding == firmware_codec.ENCODING_RAW:
+        binary_data, md5_hash = firmware.binary_data, firmware.md5_hash
+    elif encoding == firmware_codec.ENCODING_COMPRESSED and firmware.compressed_data:
+        binary_data, md5_hash = firmware.compressed_data, firmware.compressed_md5
+    elif encoding == firmware_codec.ENCODING_DELTA and firmware.delta_data and firmware.delta_base_id:
+        binary_data, md5_hash = firmware.delta_data, firmware.delta_md5
+    else:
+        raise HTTPException(status_code=404, detail=f"No {encoding} payload for this firmware")
+    total_size = len(binary_data)
 
     # Handle Range header for partial content requests
     if range and range.startswith("bytes="):
@@ -186,7 +286,7 @@ async def download_firmware(
             "Content-Disposition": f'attachment; filename="{firmware.filename}"',
             "Content-Length": str(total_size),
             "Accept-Ranges": "bytes",
-            "X-MD5": firmware.md5_hash,
+            "X-MD5": md5_hash,
         },
     )
 
@@ -231,6 +331,9 @@ async def mark_firmware_stable(
         filename=firmware.filename,
         size_bytes=firmware.size_bytes,
         md5_hash=firmware.md5_hash,
+        compressed_size=firmware.compressed_size,
+        delta_base_id=firmware.delta_base_id,
+        delta_size=firmware.delta_size,
         release_notes=firmware.release_notes,
         is_stable=firmware.is_stable,
         created_at=firmware.created_at,
@@ -5,6 +5,7 @@ from sqlalchemy import select
 from sqlalchemy.ext.asyncio import AsyncSession
 from sqlalchemy.orm import selectinload
 
+from .. import firmware_codec
 from ..database import get_db
 from ..models import Firmware, OTAUpdate, OTANodeStatus
 from ..schemas import (
@@ -15,6 +16,19 @@ from ..schemas import (
 router = APIRouter(prefix="/api/v1/ota", tags=["ota"])
 
 OTA_PART_SIZE = 1024  # Bytes per chunk for painlessMesh OTA
+OTA_BROADCAST_PART_SIZE = firmware_codec.CHUNK_BYTES  # Bytes per chunk for broadcast OTA (OTA_CHUNK_BYTES)
+
+
+def _broadcast_payload(update: OTAUpdate, firmware: Firmware, base: Firmware | None) -> tuple[str, bytes, str]:
+    """Encoding, payload and payload MD5 the gateway downloads for a job.
+
+    Falls back to the raw image if the payload is gone (e.g. the delta base was deleted).
+    """
+    if update.encoding == firmware_codec.ENCODING_COMPRESSED and firmware.compressed_data:
+        return update.encoding, firmware.compressed_data, firmware.compressed_md5
+    if update.encoding == firmware_codec.ENCODING_DELTA and firmware.delta_data and base:
+        return update.encoding, firmware.delta_data, firmware.delta_md5
+    return firmware_codec.ENCODING_RAW, firmware.binary_data, firmware.md5_hash
 
 
 @router.post("/updates", response_model=OTAUpdateOut)
@@ -29,12 +43,27 @@ async def create_update(
     if not firmware:
         raise HTTPException(status_code=404, detail="Firmware not found")
 
+    # Nodes decode compressed and delta payloads only on the broadcast path
+    encoding = update.encoding
+    if update.mode != "broadcast":
+        if encoding not in (None, firmware_codec.ENCODING_RAW):
+            raise HTTPException(status_code=400, detail="Compressed and delta images need mode=broadcast")
+        encoding = firmware_codec.ENCODING_RAW
+    elif encoding is None:
+        encoding = firmware_codec.ENCODING_COMPRESSED if firmware.compressed_data else firmware_codec.ENCODING_RAW
+    elif encoding == firmware_codec.ENCODING_COMPRESSED and not firmware.compressed_data:
+        raise HTTPException(status_code=400, detail="Firmware has no compressed payload")
+    elif encoding == firmware_codec.ENCODING_DELTA and not (firmware.delta_data and firmware.delta_base_id):
+        raise HTTPException(status_code=400, detail="Firmware has no delta payload")
+
     # Create update job
     ota_update = OTAUpdate(
         firmware_id=update.firmware_id,
         target_node_id=update.target_node_id,
         target_node_type=update.target_node_type or firmware.node_type,
         force_update=update.force_update,
+        mode=update.mode,
+        encoding=encoding,
     )
 
     db.add(ota_update)
@@ -48,6 +77,8 @@ async def create_update(
         target_node_type=ota_update.target_node_type,
         status=ota_update.status,
         force_update=ota_update.force_update,
+        mode=ota_update.mode,
+        encoding=ota_update.encoding,
         created_at=ota_update.created_at,
         started_at=ota_update.started_at,
         completed_at=ota_update.completed_at,
@@ -75,6 +106,8 @@ async def list_updates(
             target_node_type=u.target_node_type,
             status=u.status,
             force_update=u.force_update,
+            mode=u.mode,
+            encoding=u.encoding,
             created_at=u.created_at,
             started_at=u.started_at,
             completed_at=u.completed_at,
@@ -84,18 +117,30 @@ async def list_updates(
 
 
 @router.get("/updates/pending", response_model=list[OTAPendingUpdate])
-async def get_pending_updates(db: AsyncSession = Depends(get_db)):
-    """Gateway polls this endpoint for pending updates."""
+async def get_pending_updates(
+    mode: str = "unicast",
+    db: AsyncSession = Depends(get_db),
+):
+    """Gateway polls this endpoint for pending updates.
+
+    Only jobs of the requested mode are listed, so a gateway that only does
+    unicast never picks up a broadcast job.
+    """
     result = await db.execute(
         select(OTAUpdate, Firmware)
         .join(Firmware)
-        .where(OTAUpdate.status == "pending")
+        .where(OTAUpdate.status == "pending", OTAUpdate.mode == mode)
         .order_by(OTAUpdate.created_at)
     )
 
+    part_size = OTA_BROADCAST_PART_SIZE if mode == "broadcast" else OTA_PART_SIZE
     updates = []
     for update, firmware in result.all():
-        num_parts = math.ceil(firmware.size_bytes / OTA_PART_SIZE)
+        base = None
+        if update.encoding == firmware_codec.ENCODING_DELTA and firmware.delta_base_id:
+            base = await db.get(Firmware, firmware.delta_base_id)
+        encoding, payload, payload_md5 = _broadcast_payload(update, firmware, base)
+        num_parts = math.ceil(len(payload) / part_size)
         updates.append(
             OTAPendingUpdate(
                 update_id=update.id,
@@ -108,6 +153,12 @@ async def get_pending_updates(db: AsyncSession = Depends(get_db)):
                 size_bytes=firmware.size_bytes,
                 target_node_id=update.target_node_id,
                 force=update.force_update,
+                mode=update.mode,
+                part_size=part_size,
+                encoding=encoding,
+                payload_size=len(payload),
+                payload_md5=payload_md5,
+                base_md5=base.md5_hash if base and encoding == firmware_codec.ENCODING_DELTA else None,
             )
         )
 
@@ -134,6 +185,8 @@ async def get_update_status(update_id: int, db: AsyncSession = Depends(get_db)):
         version=update.firmware.version,
         status=update.status,
         force_update=update.force_update,
+        mode=update.mode,
+        encoding=update.encoding,
         created_at=update.created_at,
         started_at=update.started_at,
         completed_at=update.completed_at,
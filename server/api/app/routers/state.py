@@ -1,13 +1,26 @@
-from fastapi import APIRouter, Depends, HTTPException
+import asyncio
+import json
+
+from fastapi import APIRouter, Depends, HTTPException, Query, Request
+from fastapi.responses import StreamingResponse
 from sqlalchemy import select
 from sqlalchemy.ext.asyncio import AsyncSession
 
-from ..database import get_db
+from ..config import settings
+from ..database import get_db, async_session
 from ..models import Node, CurrentState
 from ..schemas import StateOut
+from ..state_feed import state_feed
 
 router = APIRouter(prefix="/api/v1", tags=["state"])
 
+# Client reconnect delay after the stream drops
+STREAM_RETRY_MS = 3000
+
+
+def _sse(seq: int, event: str, data) -> str:
+    return f"id: {state_feed.epoch}-{seq}\nevent: {event}\ndata: {json.dumps(data)}\n\n"
+
 
 @router.get("/state", response_model=list[StateOut])
 async def get_all_state(db: AsyncSession = Depends(get_db)):
@@ -19,6 +32,61 @@ async def get_all_state(db: AsyncSession = Depends(get_db)):
     return [StateOut.model_validate(s) for s in states]
 
 
+@router.get("/state/stream")
+async def stream_state(
+    request: Request,
+    since: str | None = Query(default=None, description="Resume cursor; the Last-Event-ID header takes precedence"),
+):
+    """
+    Server-sent change feed of current state.
+
+    A new client gets one `snapshot` event (every key, as GET /state), then a
+    `changes` event for each ingest that changed keys. Every event id is a
+    cursor: a client reconnecting with it (EventSource sends Last-Event-ID
+    itself) gets only the batches it missed, or a new snapshot if the cursor
+    is too old or from before a restart. Changes carry the per-key version,
+    so a change already in the snapshot can be told apart and skipped.
+    """
+    cursor = request.headers.get("last-event-id") or since
+
+    # Subscribe before reading the backlog, with no await in between, so no batch falls in a gap
+    queue = state_feed.subscribe()
+    backlog = state_feed.since(cursor)
+    start = state_feed.cursor
+
+    async def events():
+        try:
+            yield f"retry: {STREAM_RETRY_MS}\n\n"
+            if backlog is None:
+                async with async_session() as db:
+                    result = await db.execute(
+                        select(CurrentState).order_by(CurrentState.node_id, CurrentState.key)
+                    )
+                    rows = [StateOut.model_validate(s).model_dump(mode="json") for s in result.scalars().all()]
+                yield f"id: {start}\nevent: snapshot\ndata: {json.dumps(rows)}\n\n"
+            else:
+                for seq, event, data in backlog:
+                    yield _sse(seq, event, data)
+
+            while True:
+                try:
+                    entry = await asyncio.wait_for(queue.get(), settings.state_feed_keepalive_seconds)
+                except asyncio.TimeoutError:
+                    yield ": keepalive\n\n"
+                    continue
+                if entry is None:
+                    break  # Fell behind; the client reconnects and resumes
+                yield _sse(*entry)
+        finally:
+            state_feed.unsubscribe(queue)
+
+    return StreamingResponse(
+        events(),
+        media_type="text/event-stream",
+        headers={"Cache-Control": "no-cache", "X-Accel-Buffering": "no"},
+    )
+
+
 @router.get("/nodes/{node_id}/state", response_model=list[StateOut])
 async def get_node_state(node_id: str, db: AsyncSession = Depends(get_db)):
     """Get current state for a specific node."""
@@ -1,32 +1,46 @@
 from datetime import datetime, timedelta
 from fastapi import APIRouter, Depends, Query
-from sqlalchemy import select
+from sqlalchemy import func, select, insert
+from sqlalchemy.dialects.postgresql import insert as pg_insert
 from sqlalchemy.ext.asyncio import AsyncSession
 
+from ..config import settings
 from ..database import get_db
 from ..models import Node, Telemetry, CurrentState, StateHistory
-from ..schemas import TelemetryIn, TelemetryOut
+from ..schemas import TelemetryIn, TelemetryBatchIn, TelemetryBatchItem, TelemetryOut
+from ..state_feed import state_feed
 
 router = APIRouter(prefix="/api/v1/nodes", tags=["telemetry"])
 
+# Rows per multi-row INSERT (asyncpg caps a statement at 32767 bind parameters)
+STATE_UPSERT_CHUNK = 1000
+TELEMETRY_UPSERT_CHUNK = 500
 
-@router.post("/{node_id}/telemetry")
-async def push_telemetry(node_id: str, data: TelemetryIn, db: AsyncSession = Depends(get_db)):
-    """
-    Push telemetry data from a node.
-    Auto-registers the node if it doesn't exist.
-    """
-    print(f"[TELEMETRY] node_id={node_id} payload={data.model_dump()}")
-    now = datetime.utcnow()
+# Telemetry columns merged on a repeated (time, node_id) sample
+TELEMETRY_FIELDS = (
+    "heap_free", "uptime_sec", "peer_count", "role",
+    "loop_avg_us", "loop_max_us", "update_max_us", "watcher_max_us", "frame_max_us",
+    "heap_min", "heap_max_block", "loop_hist", "msg_counts",
+)
 
-    # Get or create node
-    result = await db.execute(select(Node).where(Node.id == node_id))
-    node = result.scalar_one_or_none()
 
+def _ingest_telemetry(
+    db: AsyncSession, node: Node | None, node_id: str, data: TelemetryIn, now: datetime, live: bool = True
+) -> tuple[Node, dict | None]:
+    """
+    Apply one node's telemetry to the session (node upsert) and build its
+    telemetry row. Shared by the single-node and batch endpoints; the row goes
+    through _upsert_telemetry, state through _upsert_state, and the caller
+    commits.
+
+    `now` is the sample time. Samples that are not `live` (journal replays)
+    are recorded in telemetry but do not refresh last_seen/is_online.
+    """
     if node:
-        # Update existing node
-        node.last_seen = now
-        node.is_online = True
+        if live:
+            # Update existing node
+            node.last_seen = now
+            node.is_online = True
         if data.name:
             node.name = data.name
         if data.firmware:
@@ -42,12 +56,17 @@ async def push_telemetry(node_id: str, data: TelemetryIn, db: AsyncSession = Dep
             role=data.role or "NODE",
             first_seen=now,
             last_seen=now,
-            is_online=True,
+            is_online=live,
         )
         db.add(node)
 
-    # Store telemetry
-    telemetry = Telemetry(
+    # State-only entries (e.g. replayed state changes) carry no telemetry row
+    fields = (data.name, data.uptime, data.heap_free, data.peer_count, data.role, data.firmware, data.perf)
+    if all(f is None for f in fields):
+        return node, None
+
+    row = dict.fromkeys(TELEMETRY_FIELDS)
+    row.update(
         time=now,
         node_id=node_id,
         heap_free=data.heap_free,
@@ -55,63 +74,166 @@ async def push_telemetry(node_id: str, data: TelemetryIn, db: AsyncSession = Dep
         peer_count=data.peer_count,
         role=data.role,
     )
-    db.add(telemetry)
+    if data.perf:
+        perf = data.perf
+        row.update(
+            loop_avg_us=perf.loop_avg_us,
+            loop_max_us=perf.loop_max_us,
+            update_max_us=perf.update_max_us,
+            watcher_max_us=perf.watcher_max_us,
+            frame_max_us=perf.frame_max_us,
+            heap_min=perf.heap_min,
+            heap_max_block=perf.heap_max_block,
+            loop_hist=perf.loop_hist,
+        )
+        if perf.msg_in is not None or perf.msg_out is not None:
+            row["msg_counts"] = {"in": perf.msg_in or {}, "out": perf.msg_out or {}}
+    return node, row
 
-    # Update state if provided
-    if data.state:
-        for key, value in data.state.items():
-            # Check if state exists
-            state_result = await db.execute(
-                select(CurrentState).where(
-                    CurrentState.node_id == node_id,
-                    CurrentState.key == key
-                )
-            )
-            current_state = state_result.scalar_one_or_none()
-
-            if current_state:
-                # Only update if value changed
-                if current_state.value != value:
-                    old_version = current_state.version
-                    current_state.value = value
-                    current_state.version = old_version + 1
-                    current_state.updated_at = now
-
-                    # Record in history
-                    history = StateHistory(
-                        time=now,
-                        node_id=node_id,
-                        key=key,
-                        value=value,
-                        version=current_state.version,
-                    )
-                    db.add(history)
-            else:
-                # Create new state entry
-                new_state = CurrentState(
-                    node_id=node_id,
-                    key=key,
-                    value=value,
-                    version=1,
-                    updated_at=now,
-                )
-                db.add(new_state)
-
-                # Record in history
-                history = StateHistory(
-                    time=now,
-                    node_id=node_id,
-                    key=key,
-                    value=value,
-                    version=1,
-                )
-                db.add(history)
 
+async def _upsert_telemetry(db: AsyncSession, rows: list[dict]) -> None:
+    """
+    Idempotent telemetry insert. A sample seen again for the same
+    (time, node_id), e.g. a journal replay the server already committed
+    before the gateway's request timed out, or a sample whose perf record
+    arrived in a later replay batch, merges into the stored row: fields it
+    carries overwrite, fields it lacks keep their stored value.
+    """
+    for i in range(0, len(rows), TELEMETRY_UPSERT_CHUNK):
+        stmt = pg_insert(Telemetry).values(rows[i:i + TELEMETRY_UPSERT_CHUNK])
+        stmt = stmt.on_conflict_do_update(
+            index_elements=[Telemetry.time, Telemetry.node_id],
+            set_={f: func.coalesce(stmt.excluded[f], getattr(Telemetry, f)) for f in TELEMETRY_FIELDS},
+        )
+        await db.execute(stmt)
+
+
+async def _upsert_state(db: AsyncSession, states: dict[tuple[str, str], tuple[str, datetime]]) -> list:
+    """
+    Set-based state ingest for any number of nodes.
+
+    `states` maps (node_id, key) to (value, sample time). One INSERT ... ON
+    CONFLICT DO UPDATE per chunk writes new and changed keys (unchanged values,
+    and samples older than the stored one, are filtered by the conflict WHERE
+    clause, so their version is not bumped);
+    RETURNING yields exactly the rows that changed, which become one bulk
+    state_history insert. Returns the changed rows, for the state feed once
+    the caller has committed.
+    """
+    if not states:
+        return []
+
+    rows = [
+        {"node_id": node_id, "key": key, "value": value, "version": 1, "updated_at": when}
+        for (node_id, key), (value, when) in states.items()
+    ]
+
+    changed = []
+    for i in range(0, len(rows), STATE_UPSERT_CHUNK):
+        stmt = pg_insert(CurrentState).values(rows[i:i + STATE_UPSERT_CHUNK])
+        stmt = stmt.on_conflict_do_update(
+            index_elements=[CurrentState.node_id, CurrentState.key],
+            set_={
+                "value": stmt.excluded.value,
+                "version": CurrentState.version + 1,
+                "updated_at": stmt.excluded.updated_at,
+            },
+            where=CurrentState.value.is_distinct_from(stmt.excluded.value)
+            & (CurrentState.updated_at <= stmt.excluded.updated_at),
+        ).returning(
+            CurrentState.node_id, CurrentState.key, CurrentState.value,
+            CurrentState.version, CurrentState.updated_at,
+        )
+        result = await db.execute(stmt)
+        changed.extend(result.all())
+
+    history = [
+        {"time": r.updated_at, "node_id": r.node_id, "key": r.key, "value": r.value, "version": r.version}
+        for r in changed
+    ]
+    for i in range(0, len(history), STATE_UPSERT_CHUNK):
+        await db.execute(insert(StateHistory).values(history[i:i + STATE_UPSERT_CHUNK]))
+
+    return changed
+
+
+@router.post("/{node_id}/telemetry")
+async def push_telemetry(node_id: str, data: TelemetryIn, db: AsyncSession = Depends(get_db)):
+    """
+    Push telemetry data from a node.
+    Auto-registers the node if it doesn't exist.
+    """
+    print(f"[TELEMETRY] node_id={node_id} payload={data.model_dump()}")
+    now = datetime.utcnow()
+
+    result = await db.execute(select(Node).where(Node.id == node_id))
+    node = result.scalar_one_or_none()
+
+    _, row = _ingest_telemetry(db, node, node_id, data, now)
+    if row:
+        await _upsert_telemetry(db, [row])
+    changed = []
+    if data.state:
+        changed = await _upsert_state(db, {(node_id, k): (v, now) for k, v in data.state.items()})
     await db.commit()
+    state_feed.publish(changed)
 
     return {"status": "ok", "node_id": node_id, "timestamp": now.isoformat()}
 
 
+@router.post("/telemetry/batch")
+async def push_telemetry_batch(batch: TelemetryBatchIn, db: AsyncSession = Depends(get_db)):
+    """
+    Push telemetry for many nodes in one request (gateway batching mode).
+    Applied in a single transaction; auto-registers unknown nodes.
+    """
+    now = datetime.utcnow()
+    node_ids = [item.node_id for item in batch.nodes]
+    print(f"[TELEMETRY] batch count={len(node_ids)} nodes={node_ids}")
+
+    # Fetch all referenced nodes in one query
+    result = await db.execute(select(Node).where(Node.id.in_(node_ids)))
+    nodes = {node.id: node for node in result.scalars().all()}
+
+    # Telemetry PK is (time, node_id): merge duplicate entries for the same
+    # node and sample time (fields and state keys from earlier entries are
+    # kept unless overwritten; replayed journals split a sample's perf and
+    # state into entries of their own). Entries without a timestamp are
+    # stamped with `now`.
+    samples: dict[tuple[str, datetime], TelemetryBatchItem] = {}
+    for item in batch.nodes:
+        when = now
+        if item.timestamp:
+            when = min(datetime.utcfromtimestamp(item.timestamp), now)
+        prev = samples.get((item.node_id, when))
+        if prev:
+            state = {**(prev.state or {}), **(item.state or {})} or None
+            merged = {**prev.model_dump(exclude_none=True), **item.model_dump(exclude_none=True)}
+            item = TelemetryBatchItem(**{**merged, "state": state})
+        samples[(item.node_id, when)] = item
+
+    # Replayed samples older than the offline threshold don't mark nodes online
+    live_since = now - timedelta(seconds=settings.offline_threshold_seconds)
+
+    rows = []
+    states: dict[tuple[str, str], tuple[str, datetime]] = {}
+    for (node_id, when), item in sorted(samples.items(), key=lambda kv: kv[0][1]):
+        nodes[node_id], row = _ingest_telemetry(db, nodes.get(node_id), node_id, item, when, when >= live_since)
+        if row:
+            rows.append(row)
+        if item.state:
+            # Sorted by time, so the newest sample of each key wins
+            for key, value in item.state.items():
+                states[(node_id, key)] = (value, when)
+
+    await _upsert_telemetry(db, rows)
+    changed = await _upsert_state(db, states)
+    await db.commit()
+    state_feed.publish(changed)
+
+    return {"status": "ok", "count": len(samples), "timestamp": now.isoformat()}
+
+
 @router.get("/{node_id}/history", response_model=list[TelemetryOut])
 async def get_node_history(
     node_id: str,
@@ -1,10 +1,10 @@
 from .node import NodeOut, NodeUpdate
-from .telemetry import TelemetryIn, TelemetryOut, StateOut
+from .telemetry import TelemetryIn, TelemetryBatchItem, TelemetryBatchIn, TelemetryOut, StateOut
 from .firmware import FirmwareOut, FirmwareList, FirmwareCreate
 from .ota import OTAUpdateCreate, OTAUpdateOut, OTANodeStatusOut, OTAUpdateStatus, OTAPendingUpdate, OTAProgressReport
 
 __all__ = [
-    "NodeOut", "NodeUpdate", "TelemetryIn", "TelemetryOut", "StateOut",
+    "NodeOut", "NodeUpdate", "TelemetryIn", "TelemetryBatchItem", "TelemetryBatchIn", "TelemetryOut", "StateOut",
     "FirmwareOut", "FirmwareList", "FirmwareCreate",
     "OTAUpdateCreate", "OTAUpdateOut", "OTANodeStatusOut", "OTAUpdateStatus", "OTAPendingUpdate", "OTAProgressReport"
 ]
@@ -21,6 +21,9 @@ class FirmwareOut(FirmwareBase):
     filename: str
     size_bytes: int
     md5_hash: str
+    compressed_size: int | None = None  # Broadcast payload sizes, when smaller than the image
+    delta_base_id: int | None = None
+    delta_size: int | None = None
     created_at: datetime
 
     class Config:
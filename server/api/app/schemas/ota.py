@@ -1,4 +1,5 @@
 from datetime import datetime
+from typing import Literal
 from pydantic import BaseModel
 
 
@@ -8,6 +9,8 @@ class OTAUpdateCreate(BaseModel):
     target_node_id: str | None = None  # NULL = all nodes of type
     target_node_type: str | None = None  # Defaults to firmware's node_type
     force_update: bool = False
+    mode: Literal["unicast", "broadcast"] = "unicast"  # broadcast = one chunk stream for all nodes of type
+    encoding: Literal["raw", "compressed", "delta"] | None = None  # broadcast only; default compressed if smaller
 
 
 class OTAUpdateOut(BaseModel):
@@ -18,6 +21,8 @@ class OTAUpdateOut(BaseModel):
     target_node_type: str | None = None
     status: str
     force_update: bool
+    mode: str = "unicast"
+    encoding: str = "raw"
     created_at: datetime
     started_at: datetime | None = None
     completed_at: datetime | None = None
@@ -48,6 +53,8 @@ class OTAUpdateStatus(BaseModel):
     version: str
     status: str
     force_update: bool
+    mode: str = "unicast"
+    encoding: str = "raw"
     created_at: datetime
     started_at: datetime | None = None
     completed_at: datetime | None = None
@@ -61,11 +68,17 @@ class OTAPendingUpdate(BaseModel):
     node_type: str
     version: str
     hardware: str
-    md5: str
+    md5: str  # Image MD5, checked by the node
     num_parts: int
-    size_bytes: int
+    size_bytes: int  # Image bytes
     target_node_id: str | None = None
     force: bool
+    mode: str = "unicast"
+    part_size: int  # Bytes per part in num_parts
+    encoding: str = "raw"  # Download with ?encoding=; num_parts counts the payload
+    payload_size: int  # Bytes to download and send
+    payload_md5: str
+    base_md5: str | None = None  # Image a delta applies to
 
 
 class OTAProgressReport(BaseModel):
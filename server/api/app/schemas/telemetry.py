@@ -2,6 +2,22 @@ from datetime import datetime
 from pydantic import BaseModel
 
 
+class PerfIn(BaseModel):
+    """One PerfStats window from a node (all durations in microseconds)."""
+    win_ms: int | None = None
+    loops: int | None = None
+    loop_avg_us: int | None = None
+    loop_max_us: int | None = None
+    update_max_us: int | None = None
+    watcher_max_us: int | None = None
+    frame_max_us: int | None = None
+    heap_min: int | None = None
+    heap_max_block: int | None = None
+    loop_hist: list[int] | None = None
+    msg_in: dict[str, int] | None = None
+    msg_out: dict[str, int] | None = None
+
+
 class TelemetryIn(BaseModel):
     name: str | None = None
     uptime: int | None = None
@@ -10,6 +26,16 @@ class TelemetryIn(BaseModel):
     role: str | None = None
     firmware: str | None = None
     state: dict[str, str] | None = None
+    perf: PerfIn | None = None
+
+
+class TelemetryBatchItem(TelemetryIn):
+    node_id: str
+    timestamp: int | None = None  # Unix time of the sample (journal replay); None = now
+
+
+class TelemetryBatchIn(BaseModel):
+    nodes: list[TelemetryBatchItem]
 
 
 class TelemetryOut(BaseModel):
@@ -19,6 +45,15 @@ class TelemetryOut(BaseModel):
     uptime_sec: int | None = None
     peer_count: int | None = None
     role: str | None = None
+    loop_avg_us: int | None = None
+    loop_max_us: int | None = None
+    update_max_us: int | None = None
+    watcher_max_us: int | None = None
+    frame_max_us: int | None = None
+    heap_min: int | None = None
+    heap_max_block: int | None = None
+    loop_hist: list[int] | None = None
+    msg_counts: dict | None = None
 
     class Config:
         from_attributes = True
@@ -0,0 +1,105 @@
+"""In-process change feed of CurrentState for the state stream.
+
+The telemetry ingest path publishes the rows its upsert changed, after
+commit. Every publish is one batch with a feed-wide sequence number, kept in
+a bounded log so a reconnecting client can resume from the last batch it saw
+instead of reloading everything.
+
+A cursor is "<epoch>-<seq>". The epoch changes when the API restarts (the log
+is in memory), so a cursor from a previous process, or one older than the log,
+can't be resumed; the client then gets a fresh snapshot.
+
+The feed lives in one process. Run the API as a single worker, or every
+worker would only see its own ingests.
+"""
+
+import asyncio
+import secrets
+from collections import deque
+from datetime import datetime
+
+from .config import settings
+
+EVENT_CHANGES = "changes"
+
+
+class StateFeed:
+    def __init__(self, backlog: int = settings.state_feed_backlog, queue_size: int = settings.state_feed_queue):
+        self.epoch = secrets.token_hex(4)
+        self._seq = 0
+        self._log: deque[tuple[int, str, object]] = deque(maxlen=backlog)
+        self._queue_size = queue_size
+        self._subscribers: set[asyncio.Queue] = set()
+
+    @property
+    def cursor(self) -> str:
+        return f"{self.epoch}-{self._seq}"
+
+    def _append(self, event: str, data: object) -> None:
+        self._seq += 1
+        entry = (self._seq, event, data)
+        self._log.append(entry)
+        for queue in list(self._subscribers):
+            if queue.qsize() < self._queue_size:
+                queue.put_nowait(entry)
+            else:
+                # Too slow to keep up: end its stream (the spare slot takes the
+                # marker), and it resumes from its cursor
+                self._subscribers.discard(queue)
+                queue.put_nowait(None)
+
+    def publish(self, rows) -> None:
+        """Publish changed CurrentState rows (node_id, key, value, version, updated_at)."""
+        if not rows:
+            return
+        self._append(EVENT_CHANGES, [
+            {
+                "node_id": r.node_id,
+                "key": r.key,
+                "value": r.value,
+                "version": r.version,
+                "updated_at": _iso(r.updated_at),
+            }
+            for r in rows
+        ])
+
+    def since(self, cursor: str | None) -> list[tuple[int, str, object]] | None:
+        """
+        Batches after cursor, or None if it can't be resumed (missing, other
+        epoch, or older than the log) and the client needs a snapshot.
+        """
+        if not cursor:
+            return None
+        epoch, _, seq = cursor.partition("-")
+        if epoch != self.epoch or not seq.isdigit():
+            return None
+        seq = int(seq)
+        if seq > self._seq:
+            return None
+        oldest = self._log[0][0] if self._log else self._seq + 1
+        if seq < oldest - 1:
+            return None
+        return [entry for entry in self._log if entry[0] > seq]
+
+    def subscribe(self) -> asyncio.Queue:
+        """
+        Queue of (seq, event, data) published from now on; None in it means
+        the subscriber fell behind and was dropped.
+        """
+        queue: asyncio.Queue = asyncio.Queue(maxsize=self._queue_size + 1)
+        self._subscribers.add(queue)
+        return queue
+
+    def unsubscribe(self, queue: asyncio.Queue) -> None:
+        self._subscribers.discard(queue)
+
+    @property
+    def subscribers(self) -> int:
+        return len(self._subscribers)
+
+
+def _iso(when: datetime | None) -> str | None:
+    return when.isoformat() if when else None
+
+
+state_feed = StateFeed()
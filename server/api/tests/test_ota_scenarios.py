@@ -5,6 +5,9 @@ Tests typical OTA update scenarios:
 1. Golden path: one firmware, one node
 2. Multiple nodes: two nodes update successfully
 3. Partial failure: one node succeeds, one fails
+4. Cancel a pending update
+5. Broadcast: job only visible to broadcast polls, progress for many nodes
+6. Delta broadcast: payload built at upload, advertised with its base MD5
 
 Usage:
     cd server/api
@@ -16,6 +19,7 @@ Or run directly:
 """
 
 import asyncio
+import hashlib
 import httpx
 import sys
 
@@ -45,10 +49,12 @@ async def cleanup_test_data(client: httpx.AsyncClient):
                 pass  # May fail if in progress
 
 
-async def upload_test_firmware(client: httpx.AsyncClient, node_type: str, version: str) -> int:
+async def upload_test_firmware(
+    client: httpx.AsyncClient, node_type: str, version: str, binary: bytes = None
+) -> int:
     """Upload a test firmware binary."""
     # Create fake firmware content
-    fake_binary = f"FAKE_FIRMWARE_{node_type}_{version}".encode() * 100  # ~2KB
+    fake_binary = binary or f"FAKE_FIRMWARE_{node_type}_{version}".encode() * 100  # ~2KB
 
     files = {"file": (f"{node_type}_{version}.bin", fake_binary, "application/octet-stream")}
     data = {
@@ -65,11 +71,18 @@ async def upload_test_firmware(client: httpx.AsyncClient, node_type: str, versio
     return firmware["id"]
 
 
-async def create_update_job(client: httpx.AsyncClient, firmware_id: int, target_node_id: str = None) -> int:
+async def create_update_job(
+    client: httpx.AsyncClient, firmware_id: int, target_node_id: str = None, mode: str = None,
+    encoding: str = None,
+) -> int:
     """Create an OTA update job."""
     payload = {"firmware_id": firmware_id}
     if target_node_id:
         payload["target_node_id"] = target_node_id
+    if mode:
+        payload["mode"] = mode
+    if encoding:
+        payload["encoding"] = encoding
 
     resp = await client.post(f"{BASE_URL}/api/v1/ota/updates", json=payload)
     assert resp.status_code == 200, f"Create update failed: {resp.text}"
@@ -80,13 +93,14 @@ async def create_update_job(client: httpx.AsyncClient, firmware_id: int, target_
     return update["id"]
 
 
-async def simulate_gateway_poll(client: httpx.AsyncClient) -> list:
+async def simulate_gateway_poll(client: httpx.AsyncClient, mode: str = None) -> list:
     """Simulate gateway polling for pending updates."""
-    resp = await client.get(f"{BASE_URL}/api/v1/ota/updates/pending")
+    params = {"mode": mode} if mode else None
+    resp = await client.get(f"{BASE_URL}/api/v1/ota/updates/pending", params=params)
     assert resp.status_code == 200, f"Poll failed: {resp.text}"
 
     updates = resp.json()
-    print(f"  ✓ Gateway polled: {len(updates)} pending update(s)")
+    print(f"  ✓ Gateway polled ({mode or 'unicast'}): {len(updates)} pending update(s)")
     return updates
 
 
@@ -375,6 +389,125 @@ async def test_scenario_4_cancel_pending():
         return True
 
 
+async def test_scenario_5_broadcast():
+    """
+    Scenario 5: Broadcast update to several nodes of one type.
+
+    The job is hidden from unicast polls, and the gateway reports each
+    node's chunk count as it comes back in the nodes' gap reports.
+    """
+    print("\n" + "=" * 60)
+    print("SCENARIO 5: Broadcast Update")
+    print("=" * 60)
+
+    async with httpx.AsyncClient(timeout=30.0) as client:
+        await cleanup_test_data(client)
+
+        print("\n[Step 1] Upload firmware and create broadcast update")
+        firmware_id = await upload_test_firmware(client, "pir", "1.1.0")
+        update_id = await create_update_job(client, firmware_id, mode="broadcast")
+
+        print("\n[Step 2] Only broadcast polls see the job")
+        pending = await simulate_gateway_poll(client)
+        assert len(pending) == 0, "Unicast poll should not list broadcast jobs"
+        pending = await simulate_gateway_poll(client, mode="broadcast")
+        assert len(pending) == 1
+        assert pending[0]["mode"] == "broadcast"
+        assert pending[0]["part_size"] == 512
+        total_parts = pending[0]["num_parts"]
+        print(f"  ✓ {total_parts} parts of {pending[0]['part_size']} bytes")
+
+        await simulate_gateway_start(client, update_id)
+
+        print("\n[Step 3] Nodes report received chunks")
+        nodes = ["a1b2c3d4", "a1b2c3d5", "a1b2c3d6"]
+        for node_id in nodes:
+            resp = await client.post(
+                f"{BASE_URL}/api/v1/ota/updates/{update_id}/node/{node_id}/progress",
+                json={"current_part": total_parts // 2, "total_parts": total_parts, "status": "downloading"},
+            )
+            assert resp.status_code == 200
+        for node_id in nodes:
+            resp = await client.post(
+                f"{BASE_URL}/api/v1/ota/updates/{update_id}/node/{node_id}/progress",
+                json={"current_part": total_parts, "total_parts": total_parts, "status": "completed"},
+            )
+            assert resp.status_code == 200
+        print(f"  ✓ {len(nodes)} nodes completed")
+
+        await complete_update(client, update_id)
+
+        status = await get_update_status(client, update_id)
+        assert status["mode"] == "broadcast"
+        assert status["status"] == "completed"
+        assert len(status["nodes"]) == len(nodes)
+        assert all(n["status"] == "completed" for n in status["nodes"])
+
+        print("\n✓ SCENARIO 5 PASSED")
+        return True
+
+
+async def test_scenario_6_delta_broadcast():
+    """
+    Scenario 6: Broadcast a delta against the previous upload.
+
+    Upload builds the delta, the pending job advertises the payload and the
+    base it applies to, and the download returns exactly that payload.
+    """
+    print("\n" + "=" * 60)
+    print("SCENARIO 6: Delta Broadcast")
+    print("=" * 60)
+
+    async with httpx.AsyncClient(timeout=60.0) as client:
+        await cleanup_test_data(client)
+
+        # Incompressible base, and a new version that changes a few hundred bytes
+        base = b"".join(hashlib.sha256(i.to_bytes(4, "little")).digest() for i in range(1024))
+        image = base[:10000] + b"NEW CODE" * 40 + base[10000:20000] + base[20400:]
+
+        print("\n[Step 1] Upload two versions")
+        base_id = await upload_test_firmware(client, "pir", "1.0.0", base)
+        firmware_id = await upload_test_firmware(client, "pir", "1.1.0", image)
+        resp = await client.get(f"{BASE_URL}/api/v1/firmware/{firmware_id}")
+        firmware = resp.json()
+        assert firmware["delta_base_id"] == base_id
+        assert firmware["delta_size"] < firmware["size_bytes"] // 10
+        print(f"  ✓ Delta {firmware['delta_size']} bytes for a {firmware['size_bytes']} byte image")
+
+        print("\n[Step 2] Delta needs broadcast mode")
+        resp = await client.post(f"{BASE_URL}/api/v1/ota/updates",
+                                 json={"firmware_id": firmware_id, "encoding": "delta"})
+        assert resp.status_code == 400
+        print("  ✓ Unicast delta job rejected")
+
+        update_id = await create_update_job(client, firmware_id, mode="broadcast", encoding="delta")
+        pending = await simulate_gateway_poll(client, mode="broadcast")
+        assert len(pending) == 1
+        job = pending[0]
+        assert job["encoding"] == "delta"
+        assert job["base_md5"] == hashlib.md5(base).hexdigest()
+        assert job["md5"] == hashlib.md5(image).hexdigest()
+        assert job["size_bytes"] == len(image)
+        assert job["payload_size"] == firmware["delta_size"]
+        assert job["num_parts"] == -(-job["payload_size"] // job["part_size"])
+
+        print("\n[Step 3] Gateway downloads the payload")
+        resp = await client.get(f"{BASE_URL}/api/v1/firmware/{firmware_id}/download",
+                                params={"encoding": "delta"})
+        assert resp.status_code == 200
+        assert len(resp.content) == job["payload_size"]
+        assert hashlib.md5(resp.content).hexdigest() == job["payload_md5"] == resp.headers["X-MD5"]
+        print(f"  ✓ {len(resp.content)} byte payload, MD5 matches")
+
+        await simulate_gateway_start(client, update_id)
+        await complete_update(client, update_id)
+        status = await get_update_status(client, update_id)
+        assert status["encoding"] == "delta"
+
+        print("\n✓ SCENARIO 6 PASSED")
+        return True
+
+
 async def run_all_scenarios():
     """Run all test scenarios."""
     print("\n" + "=" * 60)
@@ -402,6 +535,8 @@ async def run_all_scenarios():
         results.append(("Scenario 2: Multiple Nodes", await test_scenario_2_multiple_nodes()))
         results.append(("Scenario 3: Partial Failure", await test_scenario_3_partial_failure()))
         results.append(("Scenario 4: Cancel Pending", await test_scenario_4_cancel_pending()))
+        results.append(("Scenario 5: Broadcast", await test_scenario_5_broadcast()))
+        results.append(("Scenario 6: Delta Broadcast", await test_scenario_6_delta_broadcast()))
     except Exception as e:
         print(f"\n✗ Test failed with error: {e}")
         import traceback
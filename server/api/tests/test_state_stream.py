@@ -0,0 +1,220 @@
+"""
+State Stream Test Harness
+
+Tests the state change feed (GET /api/v1/state/stream):
+1. Snapshot, then live changes from telemetry ingest
+2. Resume: a reconnect with Last-Event-ID gets only what it missed
+3. An unknown cursor falls back to a snapshot
+
+Usage:
+    cd server/api
+    pip install httpx pytest pytest-asyncio
+    pytest tests/test_state_stream.py -v
+
+Or run directly:
+    python tests/test_state_stream.py
+"""
+
+import asyncio
+import json
+import sys
+import time
+
+import httpx
+
+# Windows console encoding fix
+if sys.platform == "win32":
+    sys.stdout.reconfigure(encoding='utf-8', errors='replace')
+
+BASE_URL = "http://localhost:8000"
+STREAM_URL = f"{BASE_URL}/api/v1/state/stream"
+TEST_NODE = "5eed5eed"
+TEST_KEY = "stream_test"
+EVENT_TIMEOUT = 10.0
+
+
+async def push_state(client: httpx.AsyncClient, value: str):
+    """Push one state key for the test node, as a gateway would."""
+    resp = await client.post(f"{BASE_URL}/api/v1/nodes/{TEST_NODE}/telemetry", json={"state": {TEST_KEY: value}})
+    assert resp.status_code == 200, f"Telemetry push failed: {resp.text}"
+
+
+async def sse_events(resp: httpx.Response):
+    """Yield (id, event, data) for each server-sent event on a streaming response."""
+    event_id, event, data = None, None, []
+    async for line in resp.aiter_lines():
+        if line == "":
+            if data:
+                yield event_id, event, json.loads("\n".join(data))
+            event, data = None, []
+        elif line.startswith("id: "):
+            event_id = line[4:]
+        elif line.startswith("event: "):
+            event = line[7:]
+        elif line.startswith("data: "):
+            data.append(line[6:])
+
+
+async def next_event(events, want: str = None):
+    """Next event (of type want), or fail after EVENT_TIMEOUT."""
+    async def find():
+        async for event_id, event, data in events:
+            if want is None or event == want:
+                return event_id, event, data
+    return await asyncio.wait_for(find(), EVENT_TIMEOUT)
+
+
+def stream_row(rows: list) -> dict | None:
+    return next((r for r in rows if r["node_id"] == TEST_NODE and r["key"] == TEST_KEY), None)
+
+
+async def test_scenario_1_snapshot_then_changes():
+    """
+    Scenario 1: A new stream gets a snapshot, then each ingested change.
+    """
+    print("\n" + "=" * 60)
+    print("SCENARIO 1: Snapshot Then Changes")
+    print("=" * 60)
+
+    async with httpx.AsyncClient(timeout=30.0) as client:
+        print("\n[Step 1] Push a value, open the stream")
+        await push_state(client, f"a{time.time()}")
+
+        async with client.stream("GET", STREAM_URL) as resp:
+            assert resp.status_code == 200
+            assert resp.headers["content-type"].startswith("text/event-stream")
+            events = sse_events(resp)
+
+            _, event, rows = await next_event(events)
+            assert event == "snapshot", f"Expected a snapshot first, got {event}"
+            held = stream_row(rows)
+            assert held, "Snapshot is missing the pushed key"
+            print(f"  ✓ Snapshot of {len(rows)} keys, {TEST_KEY} at version {held['version']}")
+
+            print("\n[Step 2] Push a change, expect it on the stream")
+            value = f"b{time.time()}"
+            await push_state(client, value)
+            while True:
+                _, _, rows = await next_event(events, "changes")
+                row = stream_row(rows)
+                if row:
+                    break
+            assert row["value"] == value
+            assert row["version"] == held["version"] + 1
+            print(f"  ✓ Change arrived at version {row['version']}")
+
+    print("\n✓ SCENARIO 1 PASSED")
+    return True
+
+
+async def test_scenario_2_resume():
+    """
+    Scenario 2: Reconnecting with Last-Event-ID replays only the missed change.
+    """
+    print("\n" + "=" * 60)
+    print("SCENARIO 2: Resume From Cursor")
+    print("=" * 60)
+
+    async with httpx.AsyncClient(timeout=30.0) as client:
+        print("\n[Step 1] Open the stream, remember the snapshot cursor, disconnect")
+        async with client.stream("GET", STREAM_URL) as resp:
+            cursor, event, _ = await next_event(sse_events(resp))
+            assert event == "snapshot"
+        print(f"  ✓ Cursor {cursor}")
+
+        print("\n[Step 2] Change the key while disconnected")
+        value = f"c{time.time()}"
+        await push_state(client, value)
+
+        print("\n[Step 3] Reconnect with Last-Event-ID")
+        async with client.stream("GET", STREAM_URL, headers={"Last-Event-ID": cursor}) as resp:
+            events = sse_events(resp)
+            while True:
+                _, event, rows = await next_event(events)
+                assert event == "changes", f"Resume should not send a {event}"
+                row = stream_row(rows)
+                if row:
+                    break
+            assert row["value"] == value
+            print(f"  ✓ Missed change replayed (version {row['version']}), no snapshot")
+
+    print("\n✓ SCENARIO 2 PASSED")
+    return True
+
+
+async def test_scenario_3_unknown_cursor():
+    """
+    Scenario 3: A cursor from another process (or too old) gets a snapshot.
+    """
+    print("\n" + "=" * 60)
+    print("SCENARIO 3: Unknown Cursor")
+    print("=" * 60)
+
+    async with httpx.AsyncClient(timeout=30.0) as client:
+        await push_state(client, f"d{time.time()}")
+        async with client.stream("GET", STREAM_URL, params={"since": "00000000-1"}) as resp:
+            _, event, rows = await next_event(sse_events(resp))
+            assert event == "snapshot"
+            assert stream_row(rows), "Snapshot is missing the pushed key"
+        print("  ✓ Fell back to a snapshot")
+
+    print("\n✓ SCENARIO 3 PASSED")
+    return True
+
+
+async def run_all_scenarios():
+    """Run all test scenarios."""
+    print("\n" + "=" * 60)
+    print("STATE STREAM TEST HARNESS")
+    print("=" * 60)
+    print(f"Target: {BASE_URL}")
+
+    # Check server is running
+    async with httpx.AsyncClient(timeout=5.0) as client:
+        try:
+            resp = await client.get(f"{BASE_URL}/health")
+            if resp.status_code != 200:
+                print(f"\n✗ Server health check failed: {resp.status_code}")
+                return False
+            print("✓ Server is healthy")
+        except httpx.ConnectError:
+            print(f"\n✗ Cannot connect to server at {BASE_URL}")
+            print("  Make sure the server is running: docker-compose up")
+            return False
+
+    results = []
+
+    try:
+        results.append(("Scenario 1: Snapshot Then Changes", await test_scenario_1_snapshot_then_changes()))
+        results.append(("Scenario 2: Resume From Cursor", await test_scenario_2_resume()))
+        results.append(("Scenario 3: Unknown Cursor", await test_scenario_3_unknown_cursor()))
+    except Exception as e:
+        print(f"\n✗ Test failed with error: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+    # Summary
+    print("\n" + "=" * 60)
+    print("TEST SUMMARY")
+    print("=" * 60)
+
+    all_passed = True
+    for name, passed in results:
+        status = "✓ PASS" if passed else "✗ FAIL"
+        print(f"  {status}: {name}")
+        if not passed:
+            all_passed = False
+
+    print("=" * 60)
+    if all_passed:
+        print("ALL TESTS PASSED")
+    else:
+        print("SOME TESTS FAILED")
+
+    return all_passed
+
+
+if __name__ == "__main__":
+    success = asyncio.run(run_all_scenarios())
+    sys.exit(0 if success else 1)
@@ -4,11 +4,24 @@ import StateTable from './components/StateTable';
 import TabNavigation from './components/TabNavigation';
 import ManagerLayout from './components/manager/ManagerLayout';
 import { ToastProvider } from './components/common/Toast';
-import { fetchNodes, fetchState } from './api/mesh';
+import { fetchNodes, fetchState, subscribeState } from './api/mesh';
 
-const REFRESH_INTERVAL = 5000; // 5 seconds
+const REFRESH_INTERVAL = 30000; // Node list; state is pushed by the stream
 
-function Header({ lastUpdate, refreshing, onRefresh }) {
+const stateId = (row) => `${row.node_id}/${row.key}`;
+
+// Apply changed rows to the state list; a row no newer than the one held is skipped
+function mergeState(state, rows) {
+  const byId = new Map(state.map((row) => [stateId(row), row]));
+  for (const row of rows) {
+    const held = byId.get(stateId(row));
+    if (!held || row.version > held.version) byId.set(stateId(row), row);
+  }
+  return [...byId.values()].sort((a, b) =>
+    a.node_id === b.node_id ? a.key.localeCompare(b.key) : a.node_id.localeCompare(b.node_id));
+}
+
+function Header({ lastUpdate, live, refreshing, onRefresh }) {
   return (
     <header className="bg-gray-800 border-b border-gray-700">
       <div className="max-w-7xl mx-auto px-4 py-4">
@@ -27,6 +40,8 @@ function Header({ lastUpdate, refreshing, onRefresh }) {
           </div>
           <div className="flex items-center gap-4">
             <span className="text-sm text-gray-500">
+              <span className={`inline-block w-2 h-2 rounded-full mr-2 ${live ? 'bg-green-500' : 'bg-gray-600'}`}
+                    title={live ? 'Live state stream' : 'State stream reconnecting'}></span>
               {lastUpdate ? `Updated ${new Date(lastUpdate).toLocaleTimeString()}` : 'Loading...'}
             </span>
             <button
@@ -53,21 +68,24 @@ function AppContent() {
   const [nodes, setNodes] = useState([]);
   const [state, setState] = useState([]);
   const [loading, setLoading] = useState(true);
+  const [stateLoading, setStateLoading] = useState(true);
+  const [live, setLive] = useState(false);
   const [error, setError] = useState(null);
   const [lastUpdate, setLastUpdate] = useState(null);
   const [refreshing, setRefreshing] = useState(false);
 
+  // Nodes are polled; a manual refresh also reloads state in full
   const loadData = useCallback(async (showRefreshing = false) => {
     if (showRefreshing) setRefreshing(true);
 
     try {
       const [nodesData, stateData] = await Promise.all([
         fetchNodes(),
-        fetchState(),
+        showRefreshing ? fetchState() : null,
       ]);
 
       setNodes(nodesData);
-      setState(stateData);
+      if (stateData) setState(stateData);
       setError(null);
       setLastUpdate(new Date().toISOString());
     } catch (err) {
@@ -84,6 +102,22 @@ function AppContent() {
     loadData();
   }, [loadData]);
 
+  // State changes are pushed: one snapshot, then deltas
+  useEffect(() => {
+    return subscribeState({
+      onSnapshot: (rows) => {
+        setState(rows);
+        setStateLoading(false);
+        setLastUpdate(new Date().toISOString());
+      },
+      onChanges: (rows) => {
+        setState((current) => mergeState(current, rows));
+        setLastUpdate(new Date().toISOString());
+      },
+      onStatus: setLive,
+    });
+  }, []);
+
   // Auto-refresh (only on dashboard tab)
   useEffect(() => {
     if (activeTab !== 'dashboard') return;
@@ -98,6 +132,7 @@ function AppContent() {
     <div className="min-h-screen bg-gray-900">
       <Header
         lastUpdate={lastUpdate}
+        live={live}
         refreshing={refreshing}
         onRefresh={handleRefresh}
       />
@@ -129,7 +164,7 @@ function AppContent() {
 
             <StateTable
               state={state}
-              loading={loading}
+              loading={stateLoading}
               error={null}
             />
           </>
@@ -143,7 +178,9 @@ function AppContent() {
 
       <footer className="border-t border-gray-800 mt-auto">
         <div className="max-w-7xl mx-auto px-4 py-4 text-center text-sm text-gray-600">
-          IoT Mesh Dashboard - {activeTab === 'dashboard' ? `Refreshes every ${REFRESH_INTERVAL / 1000} seconds` : 'Manager Mode'}
+          IoT Mesh Dashboard - {activeTab === 'dashboard'
+            ? `State is live; nodes refresh every ${REFRESH_INTERVAL / 1000} seconds`
+            : 'Manager Mode'}
         </div>
       </footer>
     </div>
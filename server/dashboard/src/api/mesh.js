@@ -18,6 +18,23 @@ export async function fetchState() {
   return response.json();
 }
 
+/**
+ * Subscribe to the state change feed (GET /state/stream, server-sent events).
+ *
+ * onSnapshot(rows) gets the full state on first connect, and again if a
+ * reconnect can't resume; onChanges(rows) gets each batch of changed keys.
+ * EventSource reconnects by itself and resumes from the last event id.
+ * Returns a function that closes the stream.
+ */
+export function subscribeState({ onSnapshot, onChanges, onStatus }) {
+  const source = new EventSource(`${API_BASE}/state/stream`);
+  source.addEventListener('snapshot', (e) => onSnapshot(JSON.parse(e.data)));
+  source.addEventListener('changes', (e) => onChanges(JSON.parse(e.data)));
+  source.onopen = () => onStatus?.(true);
+  source.onerror = () => onStatus?.(false);
+  return () => source.close();
+}
+
 export async function fetchNodeHistory(nodeId, hours = 24) {
   const response = await fetch(`${API_BASE}/nodes/${nodeId}/history?hours=${hours}`);
   if (!response.ok) throw new Error('Failed to fetch history');
@@ -1,6 +1,6 @@
 const API_BASE = '/api/v1';
 
-export async function createOTAUpdate(firmwareId, forceUpdate = false, targetNodeId = null) {
+export async function createOTAUpdate(firmwareId, forceUpdate = false, targetNodeId = null, mode = 'unicast', encoding = null) {
   const response = await fetch(`${API_BASE}/ota/updates`, {
     method: 'POST',
     headers: { 'Content-Type': 'application/json' },
@@ -8,6 +8,8 @@ export async function createOTAUpdate(firmwareId, forceUpdate = false, targetNod
       firmware_id: firmwareId,
       force_update: forceUpdate,
       target_node_id: targetNodeId,
+      mode,
+      encoding,
     }),
   });
   if (!response.ok) {
@@ -102,7 +102,16 @@ function FirmwarePanel() {
                     </td>
                     <td className="py-3">{fw.version}</td>
                     <td className="py-3">{fw.hardware}</td>
-                    <td className="py-3">{formatFileSize(fw.size_bytes)}</td>
+                    <td className="py-3">
+                      {formatFileSize(fw.size_bytes)}
+                      {(fw.compressed_size || fw.delta_size) && (
+                        <div className="text-xs text-gray-500">
+                          {fw.compressed_size && `lz ${formatFileSize(fw.compressed_size)}`}
+                          {fw.compressed_size && fw.delta_size && ' · '}
+                          {fw.delta_size && `Δ ${formatFileSize(fw.delta_size)}`}
+                        </div>
+                      )}
+                    </td>
                     <td className="py-3">
                       <button
                         onClick={() => handleToggleStable(fw)}
@@ -170,6 +170,8 @@ function OTACreateForm({ firmware, onSuccess }) {
   const [selectedType, setSelectedType] = useState('');
   const [selectedFirmware, setSelectedFirmware] = useState('');
   const [forceUpdate, setForceUpdate] = useState(false);
+  const [broadcast, setBroadcast] = useState(false);
+  const [encoding, setEncoding] = useState('');
   const [creating, setCreating] = useState(false);
   const toast = useToast();
 
@@ -180,6 +182,7 @@ function OTACreateForm({ firmware, onSuccess }) {
   const filteredFirmware = selectedType
     ? firmware.filter(fw => fw.node_type === selectedType)
     : [];
+  const chosen = firmware.find(fw => fw.id === parseInt(selectedFirmware));
 
   const handleSubmit = async (e) => {
     e.preventDefault();
@@ -191,13 +194,16 @@ function OTACreateForm({ firmware, onSuccess }) {
 
     setCreating(true);
     try {
-      await createOTAUpdate(parseInt(selectedFirmware), forceUpdate);
+      await createOTAUpdate(parseInt(selectedFirmware), forceUpdate, null,
+                            broadcast ? 'broadcast' : 'unicast', broadcast && encoding ? encoding : null);
       toast.success('OTA update job created');
 
       // Reset form
       setSelectedType('');
       setSelectedFirmware('');
       setForceUpdate(false);
+      setBroadcast(false);
+      setEncoding('');
 
       onSuccess();
     } catch (err) {
@@ -281,6 +287,31 @@ function OTACreateForm({ firmware, onSuccess }) {
         <span className="text-xs text-gray-500" title="Forces update even if node already has this firmware version">
           ?
         </span>
+        <label className="flex items-center gap-2 text-sm text-gray-300 cursor-pointer ml-4">
+          <input
+            type="checkbox"
+            checked={broadcast}
+            onChange={(e) => setBroadcast(e.target.checked)}
+            className="w-4 h-4 rounded bg-gray-700 border-gray-600 text-blue-600 focus:ring-blue-500"
+          />
+          Broadcast
+        </label>
+        <span className="text-xs text-gray-500" title="Sends the image once to every node of the type; nodes ask for the chunks they missed">
+          ?
+        </span>
+        {broadcast && (
+          <select
+            value={encoding}
+            onChange={(e) => setEncoding(e.target.value)}
+            className="ml-4 px-2 py-1 bg-gray-700 border border-gray-600 rounded-lg text-sm text-white focus:outline-none focus:ring-2 focus:ring-blue-500"
+            title="Delta only installs on nodes running the image it was built against"
+          >
+            <option value="">Auto</option>
+            <option value="raw">Raw</option>
+            <option value="compressed" disabled={!chosen?.compressed_size}>Compressed</option>
+            <option value="delta" disabled={!chosen?.delta_size}>Delta</option>
+          </select>
+        )}
       </div>
     </form>
   );
@@ -23,6 +23,16 @@ CREATE TABLE telemetry (
     uptime_sec INTEGER,
     peer_count INTEGER,
     role VARCHAR(10),
+    -- Node PerfStats window (firmware/lib/MeshSwarmExt/PerfStats.h)
+    loop_avg_us INTEGER,
+    loop_max_us INTEGER,
+    update_max_us INTEGER,
+    watcher_max_us INTEGER,
+    frame_max_us INTEGER,
+    heap_min INTEGER,
+    heap_max_block INTEGER,
+    loop_hist INTEGER[],               -- <0.5/1/2/5/10/20/50/more ms
+    msg_counts JSONB,                  -- {"in": {"state": n, ...}, "out": {...}}
     CONSTRAINT telemetry_pkey PRIMARY KEY (time, node_id)
 );
 SELECT create_hypertable('telemetry', 'time');
@@ -68,6 +78,14 @@ CREATE TABLE firmware (
     binary_data BYTEA NOT NULL,
     release_notes TEXT,
     is_stable BOOLEAN DEFAULT false,
+    -- Broadcast OTA payloads, NULL when not smaller than the image
+    compressed_data BYTEA,
+    compressed_size INTEGER,
+    compressed_md5 VARCHAR(32),
+    delta_base_id INTEGER REFERENCES firmware(id) ON DELETE SET NULL,  -- Image the delta applies to
+    delta_data BYTEA,
+    delta_size INTEGER,
+    delta_md5 VARCHAR(32),
     created_at TIMESTAMPTZ DEFAULT NOW(),
     UNIQUE(node_type, version, hardware)
 );
@@ -82,6 +100,8 @@ CREATE TABLE ota_updates (
     target_node_type VARCHAR(30),
     status VARCHAR(20) DEFAULT 'pending',    -- pending/distributing/completed/failed
     force_update BOOLEAN DEFAULT false,
+    mode VARCHAR(10) DEFAULT 'unicast',      -- unicast (per node) / broadcast (chunked, all nodes of type)
+    encoding VARCHAR(10) DEFAULT 'raw',      -- broadcast payload: raw / compressed / delta
     created_at TIMESTAMPTZ DEFAULT NOW(),
     started_at TIMESTAMPTZ,
     completed_at TIMESTAMPTZ